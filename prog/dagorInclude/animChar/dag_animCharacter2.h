@@ -205,6 +205,7 @@ public:
   FastPhysSystem *getFastPhysSystem() const { return fastPhysSystem; }
   void setFastPhysSystem(FastPhysSystem *system);
   void setFastPhysSystemGravityDirection(const Point3 &gravity_direction);
+  void setFastPhysLod(int lod); // see FastPhysSystem::lod
   bool resetFastPhysSystem();
   void updateFastPhys(float dt);
   void resetFastPhysWtmOfs(vec3f wofs);
@@ -108,6 +108,9 @@ public:
 
   int firstIntegratePoint;
 
+  // 0 is full quality, higher lods (e.g. render lod of character) skip wind turbulence noise and clip lines with fewer segments
+  int lod = 0;
+
   FastPhysSystem();
   ~FastPhysSystem();
 
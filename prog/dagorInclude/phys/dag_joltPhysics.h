@@ -43,6 +43,7 @@ public:
 
 namespace jolt_api
 {
+// physics system of main (first created) PhysWorld, additional worlds have their own ones (see PhysWorld::getScene())
 extern JPH::PhysicsSystem *physicsSystem;
 
 inline JPH::PhysicsSystem &phys_sys() { return *physicsSystem; }
@@ -62,7 +63,7 @@ public:
   ~PhysBody();
 
 
-  static auto &api() { return jolt_api::body_api(); }
+  JPH::BodyInterface &api() const; // of body's world
 
   struct ObjFilter : public JPH::ObjectLayerFilter
   {
@@ -88,30 +89,9 @@ public:
   };
 
   template <typename Callable>
-  static void lock_body_rw(JPH::BodyID body_id, Callable f)
-  {
-    JPH::BodyLockWrite lock(jolt_api::body_lock(), body_id);
-    if (lock.Succeeded())
-      f(lock.GetBody());
-  }
-  template <typename Callable>
-  void lockRW(Callable f)
-  {
-    lock_body_rw(bodyId, f);
-  }
-
-  template <typename Callable>
-  static void lock_body_ro(JPH::BodyID body_id, Callable f)
-  {
-    JPH::BodyLockRead lock(jolt_api::body_lock(), body_id);
-    if (lock.Succeeded())
-      f(lock.GetBody());
-  }
+  void lockRW(Callable f);
   template <typename Callable>
-  void lockRO(Callable f) const
-  {
-    lock_body_ro(bodyId, f);
-  }
+  void lockRO(Callable f) const;
 
   void setTm(const TMatrix &wtm);
   void getTm(TMatrix &wtm) const;
@@ -142,10 +122,12 @@ public:
   void setMassMatrix(real mass, real ixx, real iyy, real izz);
   real getMass() const
   {
-    JPH::BodyLockRead lock(jolt_api::body_lock(), bodyId);
-    if (lock.Succeeded() && !lock.GetBody().IsStatic())
-      return safeinv(lock.GetBody().GetMotionProperties()->GetInverseMass());
-    return 0;
+    real mass = 0;
+    lockRO([&](const JPH::Body &body) {
+      if (!body.IsStatic())
+        mass = safeinv(body.GetMotionProperties()->GetInverseMass());
+    });
+    return mass;
   }
   void getMassMatrix(real &mass, real &ixx, real &iyy, real &izz);
   void getInvMassMatrix(real &mass, real &ixx, real &iyy, real &izz);
@@ -204,8 +186,7 @@ public:
 
   JPH::BodyID bodyId;
 
-  static PhysBody *from_body_id(JPH::BodyID bid) { return (PhysBody *)(void *)(uintptr_t)api().GetUserData(bid); }
-  static JPH::RefConst<JPH::Shape> get_shape(JPH::BodyID bid) { return api().GetShape(bid); }
+  static PhysBody *from_body_id(JPH::BodyID bid, const PhysWorld *w);
   JPH::RefConst<JPH::Shape> getShape() const { return api().GetShape(bodyId); }
 
 protected:
@@ -260,11 +241,12 @@ public:
   real getLength() const { return hit.mFraction * maxLength; }
   Point3 getPoint() const { return to_point3(pos + dir * hit.mFraction); }
   Point3 getNormal() const;
-  PhysBody *getBody() const { return !hit.mBodyID.IsInvalid() ? PhysBody::from_body_id(hit.mBodyID) : nullptr; }
+  PhysBody *getBody() const { return !hit.mBodyID.IsInvalid() ? PhysBody::from_body_id(hit.mBodyID, hitWorld) : nullptr; }
   int getMaterial() { return 0; }
 
 protected:
   PhysWorld *ownWorld;
+  PhysWorld *hitWorld = nullptr; // world of last forceUpdate()
 
   JPH::Vec3 pos;
   JPH::Vec3 dir;
@@ -275,13 +257,42 @@ protected:
   uint16_t filterMask = 0xFFFF;
 };
 
+// Binary state of physics world simulation (bodies with their sleep state, contact cache, constraints), see PhysWorld::saveState().
+// Configuration (shapes, friction, motion quality, etc.) is not included, world must have the same bodies on restore.
+// Buffer capacity is kept on re-save, so snapshots kept in ring for rollback don't reallocate each tick.
+class PhysWorldSnapshot
+{
+public:
+  void clear()
+  {
+    data.clear();
+    dataHash = layoutHash = 0;
+  }
+  bool empty() const { return data.empty(); }
+  uint32_t size() const { return data.size(); }
+  // returns -1 if snapshots are equal, otherwise offset of first different byte
+  int findFirstDifference(const PhysWorldSnapshot &other) const;
+
+private:
+  Tab<uint8_t> data;
+  uint64_t dataHash = 0;   // validates whole stream before anything is restored
+  uint64_t layoutHash = 0; // bodies and constraints world had on save, restore fails midway if they differ
+
+  friend class PhysWorld;
+};
+
+struct JoltSimJob;
+
+// Each world has its own Jolt physics system and bodies (first created world uses jolt_api::physicsSystem), so worlds are fully
+// isolated and can be simulated concurrently. Job system is shared, additional worlds are sized by "physJolt/additionalWorld"
+// settings.
 class PhysWorld
 {
 public:
   static void init_engine(bool single_threaded = false);
   static void term_engine();
-  static JPH::PhysicsSystem &phys_sys() { return jolt_api::phys_sys(); }
-  static JPH::BodyInterface &body_api() { return jolt_api::body_api(); }
+  JPH::PhysicsSystem &phys_sys() const { return *physSystem; }
+  JPH::BodyInterface &body_api() const { return physSystem->GetBodyInterface(); }
 
   PhysWorld(real default_static_friction, real default_dynamic_friction, real default_restitution, real default_softness);
   ~PhysWorld();
@@ -374,7 +385,7 @@ public:
   void setMaxSubSteps(int num_sub_steps) { maxSubSteps = num_sub_steps; }
   void setFixedTimeStep(float fts) { fixedTimeStep = fts; }
 
-  static JPH::PhysicsSystem *getScene() { return jolt_api::physicsSystem; }
+  JPH::PhysicsSystem *getScene() const { return physSystem; }
 
   void shapeQuery(const PhysBody *body, const TMatrix &from, const TMatrix &to, dag::ConstSpan<PhysBody *> bodies,
     PhysShapeQueryResult &out, int filter_grp = 0x1, int filter_mask = 0xFFFF);
@@ -415,6 +426,30 @@ public:
     return false;
   }
 
+  // Save/restore of simulated state for rollback and replay seeking, simulation must not be running (see fetchSimRes())
+  // Snapshot is validated (stream integrity and same bodies/constraints in world) before restore, so failed restore (returns false)
+  // leaves world untouched.
+  void saveState(PhysWorldSnapshot &out) const;
+  bool restoreState(const PhysWorldSnapshot &snapshot);
+  // Debug helper: simulates num_steps of dt twice from current state and compares resulting states.
+  // World is left in the state after simulation. Returns false (and logs first difference) if simulation is not deterministic.
+  bool checkDeterminism(float dt, int num_steps);
+
+  // sphere (capsuleHalfHeight == 0) or capsule cast against whole world, capsule is oriented along normalized capsuleAxis
+  struct ShapeCastDesc
+  {
+    Point3 from, to;
+    float radius = 0.f;
+    float capsuleHalfHeight = 0.f;
+    Point3 capsuleAxis = Point3(0.f, 1.f, 0.f);
+    int filterGrp = 0x1, filterMask = 0xFFFF;
+  };
+
+  // Batched queries, result of each item is the same as of single query (PhysRayCast::forceUpdate(), convexSweepTest() with
+  // sphere/capsule shape). Large batches are split between threadpool workers, the call returns when all items are done.
+  void rayCastBatch(dag::Span<PhysRayCast *> rays);
+  void shapeCastBatch(dag::ConstSpan<ShapeCastDesc> casts, dag::Span<PhysShapeQueryResult> out);
+
   template <typename C>
   struct ContactResultCB final : public JPH::CollideShapeCollector, public JPH::BodyFilter
   {
@@ -424,12 +459,15 @@ public:
     // void  C::visualDebugForSingleResult(const PhysBody *bodyA, const PhysBody *bodyB, const C::contact_data_t &c)
     // bool  C::needsCollision(C::obj_user_data_t *objB, bool b_is_static)
     C &c;
+    const PhysWorld *world; // queried one, bodies of pair test can be from other worlds
     const PhysBody *pbA, *pb2;
 
-    ContactResultCB(C &_c, const PhysBody *pb_a, const PhysBody *pb_b = nullptr) : c(_c), pbA(pb_a), pb2(pb_b) {}
+    ContactResultCB(C &_c, const PhysWorld *w, const PhysBody *pb_a, const PhysBody *pb_b = nullptr) :
+      c(_c), world(w), pbA(pb_a), pb2(pb_b)
+    {}
     void AddHit(const JPH::CollideShapeResult &cp) override
     {
-      auto *pbB = pb2 ? pb2 : PhysBody::from_body_id(cp.mBodyID2);
+      auto *pbB = pb2 ? pb2 : PhysBody::from_body_id(cp.mBodyID2, world);
       void *userPtrA = pbA->getUserData();
       void *userPtrB = pbB ? pbB->getUserData() : nullptr;
 
@@ -438,8 +476,9 @@ public:
       cdata.wpos = to_point3(cp.mContactPointOn1);
       cdata.wposB = to_point3(cp.mContactPointOn2);
       cdata.wnormB = to_point3(-cp.mPenetrationAxis.Normalized());
-      cdata.posA = to_point3(body_api().GetWorldTransform(pbA->bodyId).Inversed() * cp.mContactPointOn1);
-      cdata.posB = to_point3(body_api().GetWorldTransform(pb2 ? pb2->bodyId : cp.mBodyID2).Inversed() * cp.mContactPointOn2);
+      cdata.posA = to_point3(pbA->api().GetWorldTransform(pbA->bodyId).Inversed() * cp.mContactPointOn1);
+      JPH::RMat44 tmB = pb2 ? pb2->api().GetWorldTransform(pb2->bodyId) : world->body_api().GetWorldTransform(cp.mBodyID2);
+      cdata.posB = to_point3(tmB.Inversed() * cp.mContactPointOn2);
       c.visualDebugForSingleResult(pbA, pbB, cdata);
       c.addSingleResult(cdata, (typename C::obj_user_data_t *)userPtrA, (typename C::obj_user_data_t *)userPtrB, nullptr);
     }
@@ -454,19 +493,19 @@ public:
   template <typename C>
   void contactTest(const PhysBody *shape, C &contact_cb, int filter_grp = 1u, int filter_mask = 0xFFFFu)
   {
-    ContactResultCB<C> cb(contact_cb, shape);
+    ContactResultCB<C> cb(contact_cb, this, shape);
     phys_sys().GetNarrowPhaseQuery().CollideShape(shape->getShape(), JPH::Vec3::sReplicate(1.0f),
-      body_api().GetCenterOfMassTransform(shape->bodyId), defCollideShapeStg, JPH::Vec3::sZero(), cb, {},
+      shape->api().GetCenterOfMassTransform(shape->bodyId), defCollideShapeStg, JPH::Vec3::sZero(), cb, {},
       PhysBody::ObjFilter(filter_grp, filter_mask), cb);
   }
   template <typename C>
   void contactTestPair(const PhysBody *shape, const PhysBody *shapeB, C &contact_cb, int filter_grp = 1u, int filter_mask = 0xFFFFu)
   {
-    ContactResultCB<C> cb(contact_cb, shape, shapeB);
+    ContactResultCB<C> cb(contact_cb, this, shape, shapeB);
     if (needsCollision(shapeB, contact_cb, filter_grp, filter_mask))
       JPH::CollisionDispatch::sCollideShapeVsShape(shape->getShape(), shapeB->getShape(), JPH::Vec3::sReplicate(1.0f),
-        JPH::Vec3::sReplicate(1.0f), body_api().GetCenterOfMassTransform(shape->bodyId),
-        body_api().GetCenterOfMassTransform(shapeB->bodyId), {}, {}, defCollideShapeStg, cb);
+        JPH::Vec3::sReplicate(1.0f), shape->api().GetCenterOfMassTransform(shape->bodyId),
+        shapeB->api().GetCenterOfMassTransform(shapeB->bodyId), {}, {}, defCollideShapeStg, cb);
   }
 
   template <typename C, typename UDT = typename C::obj_user_data_t>
@@ -474,10 +513,14 @@ public:
   {
     if (!bodyB || !(bodyB->groupMask & filter_mask) || !(filter_grp & bodyB->layerMask))
       return false;
-    return c.needsCollision((UDT *)bodyB->getUserData(), body_api().GetMotionType(bodyB->bodyId) == JPH::EMotionType::Static);
+    return c.needsCollision((UDT *)bodyB->getUserData(),
+      bodyB->api().GetMotionType(bodyB->bodyId) == JPH::EMotionType::Static);
   }
 
 protected:
+  JPH::PhysicsSystem *physSystem = nullptr;
+  JPH::TempAllocator *tempAllocator = nullptr;
+  JoltSimJob *simJob = nullptr;
   int maxSubSteps = 3;
   float fixedTimeStep = 1.f / 60.f;
 
@@ -485,20 +528,45 @@ protected:
   Tab<Material> materials;
 
   PhysJoint *regJoint(PhysJoint *j);
+  bool isSimulating() const;
 
   friend class PhysBody;
   friend class PhysCollision;
 
   static void shape_query(const JPH::Shape *shape, const TMatrix &from, const Point3 &dir, PhysWorld *,
     dag::ConstSpan<PhysBody *> bodies, PhysShapeQueryResult &out, int filter_grp, int filter_mask);
-  static bool convex_shape_sweep_test(const JPH::Shape *shape, const Point3 &from, const Point3 &to,
+  bool convex_shape_sweep_test(const JPH::Shape *shape, const Point3 &from, const Point3 &to,
     JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> &closestCb, PhysShapeQueryResult &out,
-    const JPH::ObjectLayerFilter &obj_filter, const JPH::BodyFilter &body_filter);
+    const JPH::ObjectLayerFilter &obj_filter, const JPH::BodyFilter &body_filter, JPH::QuatArg rot = JPH::Quat::sIdentity()) const;
 
   static JPH::ShapeCastSettings defShapeCastStg;
   static JPH::CollideShapeSettings defCollideShapeStg;
+
+  friend struct JoltSimJob;
 };
 
+inline JPH::BodyInterface &PhysBody::api() const { return world->body_api(); }
+
+template <typename Callable>
+inline void PhysBody::lockRW(Callable f)
+{
+  JPH::BodyLockWrite lock(world->getScene()->GetBodyLockInterface(), bodyId);
+  if (lock.Succeeded())
+    f(lock.GetBody());
+}
+template <typename Callable>
+inline void PhysBody::lockRO(Callable f) const
+{
+  JPH::BodyLockRead lock(world->getScene()->GetBodyLockInterface(), bodyId);
+  if (lock.Succeeded())
+    f(lock.GetBody());
+}
+
+inline PhysBody *PhysBody::from_body_id(JPH::BodyID bid, const PhysWorld *w)
+{
+  return (PhysBody *)(void *)(uintptr_t)w->body_api().GetUserData(bid);
+}
+
 inline void init_jolt_physics_engine(bool single_threaded = false) { PhysWorld::init_engine(single_threaded); }
 inline void close_jolt_physics_engine() { PhysWorld::term_engine(); }
 
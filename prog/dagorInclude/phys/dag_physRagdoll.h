@@ -61,11 +61,30 @@ public:
 
   bool wakeUp(); // Return false if was not started
 
+  // Bodies are put to sleep once their velocities stay below thresholds for time_to_sleep (0 disables it).
+  void setSleepParams(float lin_vel_thres, float ang_vel_thres, float time_to_sleep);
+  bool isSleeping() const { return sleeping; }
+
+  // Releases physics instance keeping last pose, which is then applied to node tree on each update.
+  void bake();
+  bool isBaked() const { return !bakedNodes.empty(); }
+
+  // Max number of simulated (started and not baked) ragdolls, negative means unlimited.
+  static void set_active_budget(int max_active);
+  static int get_active_count();
+  // Bakes ragdolls over budget: sleeping first, then farthest from view_pos, then oldest.
+  // Must not be called concurrently with ragdolls update and destruction (ragdolls can be started from any thread meanwhile).
+  static void enforce_budget(const Point3 &view_pos);
+
 protected:
   static void onPreSolve(PhysBody *body, void *other, const Point3 &pos, Point3 &norm, IPhysContactData *&contact_data);
   void initNodeHelpers(const GeomNodeTree &tree, dag::Span<TMatrix> last_node_tms = {});
   void setBodiesTm(const GeomNodeTree &tree, dag::Span<TMatrix> last_node_tms = {}, float dt = 0.f);
   void applyOverriddenVelocities();
+  void updateSleep(real dt);
+  void applyNodeAlignCtrl(GeomNodeTree &tree);
+  void addToActive();
+  void removeFromActive();
 
   struct NodeAlignCtrl
   {
@@ -87,8 +106,19 @@ protected:
   SmallTab<TMatrix, TmpmemAlloc> lastNodeTms;
   Tab<NodeAlignCtrl> nodeAlignCtrl;
   Tab<int> nodeBody;
+  struct BakedNode
+  {
+    TMatrix wtm;
+    dag::Index16 nodeId;
+  };
+  SmallTab<BakedNode, MidmemAlloc> bakedNodes;
+
+  float sleepLinVelThresSq = 0.f, sleepAngVelThresSq = 0.f;
+  float timeToSleep = 0.f, settledTime = 0.f;
+  uint32_t startNo = 0;
 
   bool recalcWtms;
+  bool sleeping = false;
   bool ccdMode;
   bool shouldOverrideVelocity;
   bool shouldOverrideOmega;
@@ -6,8 +6,8 @@
 #pragma once
 
 #include <phys/dag_physDecl.h>
-
-class Point3;
+#include <math/dag_Point3.h>
+#include <generic/dag_span.h>
 
 
 class IPhysVehicle
@@ -48,6 +48,35 @@ public:
       const Point3 &wheel_dir, float slip_speed) = 0;
   };
 
+  struct WheelRay
+  {
+    Point3 pos, dir; // in: ray start and normalized direction
+    float t;         // in: max distance, out: hit distance
+    Point3 norm;     // out
+    int pmid;        // out
+    bool hit;        // out
+
+    static constexpr float REUSE_MAX_MOVE = 0.05f;     // meters
+    static constexpr float REUSE_MIN_DIR_COS = 0.999f; // ~2.5 degrees
+
+    // Result of this traced ray for another ray (of same wheel moved a little since trace): hit plane is intersected with it.
+    // Returns false when ray moved or turned too much, or hit is out of max_t, so it should be traced again
+    bool reuseFor(const Point3 &from, const Point3 &ray_dir, float max_t, float &out_t, bool &out_hit) const
+    {
+      if ((from - pos).lengthSq() > REUSE_MAX_MOVE * REUSE_MAX_MOVE || ray_dir * dir < REUSE_MIN_DIR_COS)
+        return false;
+      out_hit = hit;
+      out_t = max_t;
+      if (!hit)
+        return true;
+      const float dirDotNorm = ray_dir * norm;
+      if (dirDotNorm > -1e-3f)
+        return false;
+      out_t = ((pos + dir * t - from) * norm) / dirDotNorm;
+      return out_t >= 0.f && out_t <= max_t;
+    }
+  };
+
   class IWheelData
   {
     int classLabel;
@@ -114,4 +143,9 @@ public:
   static IPhysVehicle *createRayCarBullet(PhysBody *car, int iter_count = 1);
 
   static void bulletSetStaticTracer(bool (*traceray)(const Point3 &p, const Point3 &d, float &mt, Point3 &out_n, int &out_pmid));
+  static void bulletSetStaticMultiTracer(void (*trace_multiray)(dag::Span<WheelRay> rays));
+
+  // Traces wheel rays of all vehicles with single static multi tracer call (does nothing if it is not set).
+  // Results are used by next update() of each vehicle (see WheelRay::reuseFor()).
+  static void bulletTraceWheelsBatch(dag::ConstSpan<IPhysVehicle *> vehicles);
 };
@@ -134,6 +134,12 @@ void AnimcharBaseComponent::setFastPhysSystemGravityDirection(const Point3 &grav
     fastPhysSystem->gravityDirection = gravity_direction;
 }
 
+void AnimcharBaseComponent::setFastPhysLod(int lod)
+{
+  if (fastPhysSystem)
+    fastPhysSystem->lod = lod;
+}
+
 bool AnimcharBaseComponent::resetFastPhysSystem()
 {
   if (!fastPhysSystem)
@@ -192,6 +192,8 @@ public:
       return;
     }
 
+    const vec3f gravityDir = v_ldu_p3(&sys.gravityDirection.x);
+    const vec4f vDt = v_splats(dt), vHalfDt = v_splats(dt * 0.5f);
     for (int i = firstPoint; i < endPoint; ++i)
     {
       FastPhysSystem::Point &pt = sys.points[i];
@@ -200,20 +202,23 @@ public:
       if (vk < 0)
         vk = 0;
 
-      Point3 acc = pt.acc;
-      acc += sys.gravityDirection * pt.gravity;
+      vec3f acc = v_madd(gravityDir, v_splats(pt.gravity), v_ldu_p3(&pt.acc.x));
       float wind = sys.windPower * pt.windK;
-      if (float_nonzero(wind))
+      if (float_nonzero(wind) && sys.lod > 0)
+        acc = v_madd(v_ldu_p3(&sys.windVel.x), v_splats(wind), acc);
+      else if (float_nonzero(wind))
       {
         Point3 p = (sys.windPos + pt.pos) * sys.windScale;
-        acc += (sys.windVel + Point3(perlin_noise::noise3(p), perlin_noise::noise3(p + Point3(0, 1, 0)),
-                                perlin_noise::noise3(p + Point3(0, 0, 1))) *
-                                sys.windTurb) *
-               wind;
+        Point3 windAcc = (sys.windVel + Point3(perlin_noise::noise3(p), perlin_noise::noise3(p + Point3(0, 1, 0)),
+                                          perlin_noise::noise3(p + Point3(0, 0, 1))) *
+                                          sys.windTurb) *
+                         wind;
+        acc = v_add(acc, v_ldu_p3(&windAcc.x));
       }
 
-      pt.pos += (pt.vel + acc * (dt * 0.5f)) * dt;
-      pt.vel = pt.vel * vk + acc * dt;
+      vec3f vel = v_ldu_p3(&pt.vel.x);
+      v_stu_p3(&pt.pos.x, v_madd(v_madd(acc, vHalfDt, vel), vDt, v_ldu_p3(&pt.pos.x)));
+      v_stu_p3(&pt.vel.x, v_madd(vel, v_splats(vk), v_mul(acc, vDt)));
 
       pt.acc = Point3(0, 0, 0);
     }
@@ -858,7 +863,7 @@ public:
     {
       FastPhysSystem::Point &pt1 = sys.points[lines[i].p1Index];
       FastPhysSystem::Point &pt2 = sys.points[lines[i].p2Index];
-      int segs = lines[i].numSegs;
+      int segs = max(lines[i].numSegs >> min(sys.lod, 8), 1);
 
       Point3 lineVec = pt2.pos - pt1.pos;
 
@@ -1042,7 +1047,7 @@ public:
     {
       FastPhysSystem::Point &pt1 = sys.points[lines[i].p1Index];
       FastPhysSystem::Point &pt2 = sys.points[lines[i].p2Index];
-      int segs = lines[i].numSegs;
+      int segs = max(lines[i].numSegs >> min(sys.lod, 8), 1);
 
       Point3 lineVec = pt2.pos - pt1.pos;
 
@@ -0,0 +1,106 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <phys/dag_fastPhys.h>
+#include <math/dag_geomTree.h>
+#include <ioSys/dag_memIo.h>
+#include <math/dag_noise.h>
+
+// Rope of points hanging from fixed first point (not integrated), points are joined with bones
+struct FastPhysRopeFixture
+{
+  static constexpr int POINT_COUNT = 8;
+  static constexpr float DT = 1.f / 30.f;
+
+  GeomNodeTree tree; // empty, rope is not attached to nodes
+
+  FastPhysRopeFixture() { perlin_noise::init_noise(12345); }
+
+  void load(FastPhysSystem &sys)
+  {
+    DynamicMemGeneralSaveCB cwr(tmpmem, 0, 1 << 10);
+    cwr.writeInt(FastPhys::FILE_ID);
+    cwr.writeInt(POINT_COUNT);
+    for (int i = 0; i < POINT_COUNT; ++i)
+    {
+      cwr.writeReal(1.f);  // gravity
+      cwr.writeReal(0.5f); // damping
+      cwr.writeReal(1.f);  // windK
+    }
+
+    cwr.writeInt(POINT_COUNT);
+    for (int i = 0; i < POINT_COUNT; ++i)
+    {
+      cwr.writeInt(FastPhys::AID_INIT_POINT);
+      cwr.writeInt(i);
+      const Point3 pos(i * 0.2f, 0.f, 0.f);
+      cwr.write(&pos, sizeof(pos));
+      cwr.writeString("");
+    }
+
+    cwr.writeInt(POINT_COUNT);
+    cwr.writeInt(FastPhys::AID_INTEGRATE);
+    cwr.writeInt(1);
+    cwr.writeInt(POINT_COUNT);
+    for (int i = 1; i < POINT_COUNT; ++i)
+    {
+      cwr.writeInt(FastPhys::AID_SET_BONE_LENGTH);
+      cwr.writeInt(i - 1);
+      cwr.writeInt(i);
+      cwr.writeReal(0.1f); // damping
+    }
+
+    InPlaceMemLoadCB crd(cwr.data(), cwr.size());
+    sys.load(crd);
+    sys.init(tree);
+    sys.windVel = Point3(0.f, 0.f, 3.f);
+    sys.windPower = 1.f;
+  }
+
+  static void simulate(FastPhysSystem &sys, int steps)
+  {
+    for (int i = 0; i < steps; ++i)
+      sys.update(DT);
+  }
+};
+
+// Far lods apply only steady wind without turbulence noise
+TEST_FIXTURE(FastPhysRopeFixture, FarLodSkipsWindTurbulence)
+{
+  FastPhysSystem turbulent, steady, farLod, windless;
+  load(turbulent);
+  load(steady);
+  load(farLod);
+  load(windless);
+  turbulent.windTurb = farLod.windTurb = 5.f;
+  steady.windTurb = 0.f;
+  windless.windPower = 0.f;
+  farLod.lod = 2;
+  simulate(turbulent, 30);
+  simulate(steady, 30);
+  simulate(farLod, 30);
+  simulate(windless, 30);
+
+  float turbulenceDiff = 0.f, windDiff = 0.f;
+  for (int i = 0; i < POINT_COUNT; ++i)
+  {
+    CHECK_CLOSE(0.f, length(steady.points[i].pos - farLod.points[i].pos), 1e-4f);
+    turbulenceDiff = max(turbulenceDiff, length(turbulent.points[i].pos - farLod.points[i].pos));
+    windDiff = max(windDiff, length(windless.points[i].pos - farLod.points[i].pos));
+  }
+  CHECK(turbulenceDiff > 1e-3f);
+  CHECK(windDiff > 1e-2f);
+}
+
+// Lod doesn't change simulation of systems without wind and clipped lines
+TEST_FIXTURE(FastPhysRopeFixture, LodKeepsSimulationWithoutWind)
+{
+  FastPhysSystem nearLod, farLod;
+  load(nearLod);
+  load(farLod);
+  nearLod.windPower = farLod.windPower = 0.f;
+  farLod.lod = 3;
+  simulate(nearLod, 30);
+  simulate(farLod, 30);
+  for (int i = 0; i < POINT_COUNT; ++i)
+    CHECK(nearLod.points[i].pos == farLod.points[i].pos && nearLod.points[i].vel == farLod.points[i].vel);
+  CHECK(nearLod.points[POINT_COUNT - 1].pos.y < -0.1f); // rope falls
+}
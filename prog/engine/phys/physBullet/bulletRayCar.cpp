@@ -5,6 +5,7 @@
 #include <debug/dag_debug.h>
 #include <debug/dag_log.h>
 #include <workCycle/dag_workCyclePerf.h>
+#include <memory/dag_framemem.h>
 #if BT_BULLET_VERSION >= 325
 #include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
 #endif
@@ -21,6 +22,10 @@ inline btVector3 getPointVelocity(btRigidBody *rb, btVector3 pt)
   return btCross(rb->getAngularVelocity(), pt - rb->getCenterOfMassPosition()) + rb->getLinearVelocity();
 }
 static bool (*custom_tracer)(const Point3 &p, const Point3 &d, float &mt, Point3 &out_n, int &out_pmid) = nullptr;
+static void (*custom_multi_tracer)(dag::Span<IPhysVehicle::WheelRay> rays) = nullptr;
+
+// unknown material of traced surface is default one, same for single, batched and Bullet traces
+static inline int wheel_hit_pmid(int pmid) { return pmid >= 0 ? pmid : 0; }
 
 
 void BulletRbRayCar::Wheel::init(PhysBody *_body, PhysBody *_wheel, float wheel_rad, const btVector3 &_axis, int physmat_id)
@@ -44,72 +49,87 @@ void BulletRbRayCar::Wheel::setParameters(float _mass)
   inertia = 1.0f / 2.0f * radius * radius * _mass;
 }
 
-void BulletRbRayCar::Wheel::addRayQuery(float ifps)
+void BulletRbRayCar::Wheel::calcRay(btVector3 &from, btVector3 &dir, float &max_dist) const
 {
   btTransform body_m44;
   body->getMotionState()->getWorldTransform(body_m44);
-  btVector3 spring_fixpt = body_m44 * spring.fixPt;
-  wSpringAxis = normalize(body_m44.getBasis() * spring.axis);
+  from = body_m44 * spring.fixPt;
+  dir = normalize(body_m44.getBasis() * spring.axis);
+  max_dist = spring.lmax + radius;
+}
 
-  longForce = latForce = btVector3(0, 0, 0);
-  Hit hit;
-  hit.distance = spring.lmax + radius;
+bool BulletRbRayCar::Wheel::traceRay(const btVector3 &from, const btVector3 &dir, Hit &hit) const
+{
   if (custom_tracer)
   {
     int pmid;
-    if (custom_tracer(to_point3(spring_fixpt), to_point3(wSpringAxis), hit.distance, to_point3(hit.worldNormal), pmid))
-    {
-      hit.materialIndex = pmid;
-      onWheelContact(true, hit, ifps);
-    }
-    else
-      onWheelContact(false, hit, ifps);
+    if (!custom_tracer(to_point3(from), to_point3(dir), hit.distance, to_point3(hit.worldNormal), pmid))
+      return false;
+    hit.materialIndex = wheel_hit_pmid(pmid);
+    return true;
   }
-  else
+
+  struct RayCastCallback : public btCollisionWorld::ClosestRayResultCallback
   {
-    struct RayCastCallback : public btCollisionWorld::ClosestRayResultCallback
+    RayCastCallback(const btVector3 &p0, const btVector3 &p1, void *rb0, void *rb1) :
+      btCollisionWorld::ClosestRayResultCallback(p0, p1), excl_rb0(rb0), excl_rb1(rb1)
+    {}
+    bool needsCollision(btBroadphaseProxy *proxy0) const override
     {
-      RayCastCallback(const btVector3 &p0, const btVector3 &p1, void *rb0, void *rb1) :
-        btCollisionWorld::ClosestRayResultCallback(p0, p1), excl_rb0(rb0), excl_rb1(rb1)
-      {}
-      bool needsCollision(btBroadphaseProxy *proxy0) const override
-      {
-        bool collides = (proxy0->m_collisionFilterGroup & m_collisionFilterMask) != 0;
-        collides = collides && (m_collisionFilterGroup & proxy0->m_collisionFilterMask);
-        void *o = proxy0->m_clientObject;
-        if (collides && o)
-          collides = o != excl_rb0 && o != excl_rb1;
-        return collides;
-      }
-      void *excl_rb0, *excl_rb1;
-    };
-
-    btVector3 p0 = spring_fixpt, p1 = spring_fixpt + wSpringAxis * hit.distance;
-    RayCastCallback resultCallback(p0, p1, body, wheel);
+      bool collides = (proxy0->m_collisionFilterGroup & m_collisionFilterMask) != 0;
+      collides = collides && (m_collisionFilterGroup & proxy0->m_collisionFilterMask);
+      void *o = proxy0->m_clientObject;
+      if (collides && o)
+        collides = o != excl_rb0 && o != excl_rb1;
+      return collides;
+    }
+    void *excl_rb0, *excl_rb1;
+  };
+
+  btVector3 p0 = from, p1 = from + dir * hit.distance;
+  RayCastCallback resultCallback(p0, p1, body, wheel);
 #if BT_BULLET_VERSION >= 325
-    resultCallback.m_flags |= btTriangleRaycastCallback::kF_UseGjkConvexCastRaytest;
+  resultCallback.m_flags |= btTriangleRaycastCallback::kF_UseGjkConvexCastRaytest;
 #endif
-    physWorld->getScene()->rayTest(p0, p1, resultCallback);
-    if (resultCallback.hasHit())
-    {
-      hit.worldNormal = resultCallback.m_hitNormalWorld;
-      if (resultCallback.m_collisionObject)
-        if (auto *physBody = PhysBody::from_bt_body(resultCallback.m_collisionObject))
-          hit.body = physBody;
-
-      hit.distance *= resultCallback.m_closestHitFraction;
-      if (hit.body)
-        hit.materialIndex = PhysMat::getMaterialIdByPhysBodyMaterial(hit.body->getMaterialId());
-      if (hit.materialIndex == -1)
-        hit.materialIndex = 0;
-      // debug("hit[%d]: pt=%@ n=%@ car=%p rb=%p", wid,
-      //   to_point3(spring_fixpt + wSpringAxis*hit.distance), to_point3(hit.worldNormal), body, hit.body ? hit.body->getActor() :
-      //   nullptr);
-      onWheelContact(true, hit, ifps);
-    }
-    else
-      onWheelContact(false, hit, ifps);
+  physWorld->getScene()->rayTest(p0, p1, resultCallback);
+  if (!resultCallback.hasHit())
+    return false;
+
+  hit.worldNormal = resultCallback.m_hitNormalWorld;
+  if (resultCallback.m_collisionObject)
+    if (auto *physBody = PhysBody::from_bt_body(resultCallback.m_collisionObject))
+      hit.body = physBody;
+
+  hit.distance *= resultCallback.m_closestHitFraction;
+  if (hit.body)
+    hit.materialIndex = PhysMat::getMaterialIdByPhysBodyMaterial(hit.body->getMaterialId());
+  hit.materialIndex = wheel_hit_pmid(hit.materialIndex);
+  // debug("hit[%d]: pt=%@ n=%@ car=%p rb=%p", wid,
+  //   to_point3(from + dir*hit.distance), to_point3(hit.worldNormal), body, hit.body ? hit.body->getActor() :
+  //   nullptr);
+  return true;
+}
+
+void BulletRbRayCar::Wheel::addRayQuery(float ifps)
+{
+  btVector3 spring_fixpt;
+  Hit hit;
+  calcRay(spring_fixpt, wSpringAxis, hit.distance);
+
+  longForce = latForce = btVector3(0, 0, 0);
+  bool hasHit;
+  float batchedT;
+  if (batchedValid && batched.reuseFor(to_point3(spring_fixpt), to_point3(wSpringAxis), hit.distance, batchedT, hasHit))
+  {
+    // car pose may be changed since batch (e.g. by steer assist), batched hit is adjusted to current ray
+    hit.distance = batchedT;
+    hit.worldNormal = to_btVector3(batched.norm);
+    hit.materialIndex = wheel_hit_pmid(batched.pmid);
   }
+  else
+    hasHit = traceRay(spring_fixpt, wSpringAxis, hit);
+  batchedValid = false;
+  onWheelContact(hasHit, hit, ifps);
 
   if (contact && wheelContactCb)
   {
@@ -786,3 +806,44 @@ void IPhysVehicle::bulletSetStaticTracer(bool (*traceray)(const Point3 &, const
 {
   custom_tracer = traceray;
 }
+
+void IPhysVehicle::bulletSetStaticMultiTracer(void (*trace_multiray)(dag::Span<WheelRay> rays))
+{
+  custom_multi_tracer = trace_multiray;
+}
+
+void IPhysVehicle::bulletTraceWheelsBatch(dag::ConstSpan<IPhysVehicle *> vehicles)
+{
+  // static tracer ignores dynamic bodies anyway, so batch results are equivalent to it; without static tracer wheels are traced
+  // with Bullet rayTest against whole scene (excluding own bodies) and batch can't replace that
+  if (!custom_multi_tracer || !custom_tracer)
+    return;
+
+  Tab<WheelRay> rays(framemem_ptr());
+  Tab<BulletRbRayCar::Wheel *> rayWheels(framemem_ptr());
+  for (IPhysVehicle *v : vehicles)
+    for (BulletRbRayCar::Wheel *w : static_cast<BulletRbRayCar *>(v)->getWheels())
+    {
+      btVector3 from, dir;
+      WheelRay &ray = rays.push_back();
+      w->calcRay(from, dir, ray.t);
+      ray.pos = to_point3(from);
+      ray.dir = to_point3(dir);
+      ray.pmid = -1;
+      ray.hit = false;
+      rayWheels.push_back(w);
+    }
+  if (rays.empty())
+    return;
+
+  int ft = workcycleperf::get_frame_timepos_usec();
+  custom_multi_tracer(make_span(rays));
+  if (workcycleperf::debug_on)
+    debug(" -- %d: trace wheels batch: %d rays, %d usec", ft, rays.size(), workcycleperf::get_frame_timepos_usec() - ft);
+
+  for (int i = 0; i < rays.size(); i++)
+  {
+    rayWheels[i]->batched = rays[i];
+    rayWheels[i]->batchedValid = true;
+  }
+}
@@ -44,6 +44,8 @@ public:
     void init(PhysBody *phbody, PhysBody *wheel, float wheel_rad, const btVector3 &axis, int physmat_id);
     void setParameters(float mass);
 
+    void calcRay(btVector3 &from, btVector3 &dir, float &max_dist) const;
+    bool traceRay(const btVector3 &from, const btVector3 &dir, Hit &hit) const;
     void addRayQuery(float ifps);
     void onWheelContact(bool has_hit, const Hit &hit, float ifps);
     void response();
@@ -113,6 +115,10 @@ public:
 
     IPhysVehicle::ICalcWheelContactForces *cwcf = nullptr;
     IPhysVehicle::IWheelContactCB *wheelContactCb = nullptr;
+
+    // result of IPhysVehicle::bulletTraceWheelsBatch(), valid until next addRayQuery()
+    IPhysVehicle::WheelRay batched;
+    bool batchedValid = false;
   };
 
   struct Axle
@@ -197,6 +203,7 @@ public:
     float wheel_ang_vel, const Point3 &ground_vel, float cpt_friction, float &out_lat_force, float &out_long_force) override;
 
   void findContacts(float ifps);
+  dag::ConstSpan<Wheel *> getWheels() const { return wheels; }
   void calculateForce(float ifps);
   void integratePosition(float ifps);
 
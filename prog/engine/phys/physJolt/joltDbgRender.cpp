@@ -111,7 +111,7 @@ void physdbg::renderWorld(PhysWorld *pw, physdbg::RenderFlags rflg, const Point3
   if (!pw || !JPH::DebugRenderer::sInstance)
     return;
 
-  if (auto *scn = jolt_api::physicsSystem)
+  if (auto *scn = pw->getScene())
     if (auto *dbgRend = JPH::DebugRenderer::sInstance)
     {
       JPH::BodyManager::DrawSettings mBodyDrawSettings;
@@ -140,11 +140,11 @@ void physdbg::renderWorld(PhysWorld *pw, physdbg::RenderFlags rflg, const Point3
 }
 void physdbg::renderOneBody(PhysWorld *pw, const PhysBody *pb, RenderFlags rflg, unsigned col)
 {
-  physdbg::renderOneBody(pw, pb, to_tmatrix(jolt_api::body_api().GetWorldTransform(pb->bodyId)), rflg, col);
+  physdbg::renderOneBody(pw, pb, to_tmatrix(pb->api().GetWorldTransform(pb->bodyId)), rflg, col);
 }
 void physdbg::renderOneBody(PhysWorld *pw, const PhysBody *pb, const TMatrix &tm, RenderFlags rflg, unsigned col)
 {
-  auto *scn = jolt_api::physicsSystem;
+  auto *scn = pb->getPhysWorld()->getScene();
   auto *dbgRend = JPH::DebugRenderer::sInstance;
   if (!scn || !dbgRend)
     return;
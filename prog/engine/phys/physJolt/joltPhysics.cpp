@@ -22,6 +22,7 @@
 #include <Jolt/Physics/Collision/ShapeCast.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/StateRecorder.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Core/JobSystemSingleThreaded.h>
@@ -31,11 +32,13 @@
 #include <osApiWrappers/dag_spinlock.h>
 #include <memory/dag_fixedBlockAllocator.h>
 #include <memory/dag_framemem.h>
+#include <util/dag_parallelForInline.h>
 #include <generic/dag_relocatableFixedVector.h>
 #include <ioSys/dag_dataBlock.h>
 #include <startup/dag_globalSettings.h>
 #include <osApiWrappers/dag_miscApi.h>
 #include <perfMon/dag_statDrv.h>
+#include <util/dag_hash.h>
 
 namespace layers
 {
@@ -86,9 +89,10 @@ public:
 
 static JPH::JobSystem *jobSystem = nullptr;
 JPH::PhysicsSystem *jolt_api::physicsSystem = nullptr;
+static PhysWorld *main_phys_world = nullptr; // owner of jolt_api::physicsSystem
 static BPLayerInterfaceImpl broadPhaseLayerInterface;
 static JPH::PhysicsSettings physicsSettings;
-static JPH::TempAllocatorImpl *tempAllocator = nullptr;
+static JPH::TempAllocatorImpl *main_temp_allocator = nullptr;
 JPH::ShapeCastSettings PhysWorld::defShapeCastStg;
 JPH::CollideShapeSettings PhysWorld::defCollideShapeStg;
 
@@ -564,6 +568,31 @@ private:
 };
 JoltJobSystemImpl2 *JoltJobSystemImpl2::self = nullptr;
 
+struct PhysSystemConfig
+{
+  uint32_t maxBodiesNum, maxBodiesPairsNum, maxContactConstraints, numBodyMutexes, tempAllocSz;
+
+  void load(const DataBlock &blk, const PhysSystemConfig &def)
+  {
+    maxBodiesNum = blk.getInt("maxBodiesNum", def.maxBodiesNum);
+    maxBodiesPairsNum = blk.getInt("maxBodiesPairsNum", def.maxBodiesPairsNum);
+    maxContactConstraints = blk.getInt("maxContactConstraints", def.maxContactConstraints);
+    numBodyMutexes = blk.getInt("numBodyMutexes", def.numBodyMutexes);
+    tempAllocSz = blk.getInt("tempAllocatorSizeKB", def.tempAllocSz >> 10) << 10;
+  }
+};
+static PhysSystemConfig main_sys_cfg, additional_sys_cfg;
+
+static JPH::PhysicsSystem *create_physics_system(const PhysSystemConfig &cfg)
+{
+  JPH::PhysicsSystem *sys = new JPH::PhysicsSystem();
+  sys->Init(cfg.maxBodiesNum, cfg.numBodyMutexes, cfg.maxBodiesPairsNum, cfg.maxContactConstraints, broadPhaseLayerInterface,
+    broadphase_f, objects_f);
+  sys->SetPhysicsSettings(physicsSettings);
+  sys->SetGravity(JPH::Vec3(0, -9.8065f, 0));
+  return sys;
+}
+
 void PhysWorld::init_engine(bool single_threaded)
 {
   using namespace jolt_api;
@@ -572,28 +601,28 @@ void PhysWorld::init_engine(bool single_threaded)
 
   const DataBlock &phys_blk = *dgs_get_settings()->getBlockByNameEx("physJolt");
   // To consider: use different defaults for client & dedicated/offline
-  uint32_t maxBodiesNum = phys_blk.getInt("maxBodiesNum", 24 << 10);
-  uint32_t maxBodiesPairsNum = phys_blk.getInt("maxBodiesPairsNum", 65536);
-  uint32_t maxContactConstraints = phys_blk.getInt("maxContactConstraints", 10240);
-  uint32_t tempAllocSz = phys_blk.getInt("tempAllocatorSizeKB", 10 << 10) << 10;
+  PhysSystemConfig defCfg;
+  defCfg.maxBodiesNum = 24 << 10;
+  defCfg.maxBodiesPairsNum = 65536;
+  defCfg.maxContactConstraints = 10240;
+  defCfg.numBodyMutexes = (threadpool::get_num_workers() + 1) * phys_blk.getInt("numBodyMutexesMult", 2);
+  defCfg.tempAllocSz = 10 << 20;
+  main_sys_cfg.load(phys_blk, defCfg);
+  additional_sys_cfg.load(*phys_blk.getBlockByNameEx("additionalWorld"), main_sys_cfg);
+  uint32_t maxBodiesNum = main_sys_cfg.maxBodiesNum;
+  uint32_t tempAllocSz = main_sys_cfg.tempAllocSz;
   uint32_t maxJobs = phys_blk.getInt("maxJobs", 1024);
   uint32_t maxBarriers = phys_blk.getInt("maxBarriers", 2); // Note: only 1 barrier seems to be used, do we really need pool of them?
   uint32_t maxWorkers = phys_blk.getInt("maxWorkers", 16);
-  uint32_t defNumBodyMutexes = (threadpool::get_num_workers() + 1) * phys_blk.getInt("numBodyMutexesMult", 2);
-  uint32_t numBodyMutexes = phys_blk.getInt("numBodyMutexes", defNumBodyMutexes);
   JPH::HeightField16Shape::sUseActiveEdges = phys_blk.getBool("htFieldBuildActiveEdges", true);
 
   JPH_IF_ENABLE_ASSERTS(JPH::AssertFailed = joltAssertFailed;)
   JPH::RegisterDefaultAllocator();
-  tempAllocator = new JPH::TempAllocatorImpl(tempAllocSz);
+  main_temp_allocator = new JPH::TempAllocatorImpl(tempAllocSz);
   JPH::Factory::sInstance = new JPH::Factory;
   JPH::RegisterTypes();
   JPH::HeightField16Shape::sRegister();
-  physicsSystem = new JPH::PhysicsSystem();
-  physicsSystem->Init(maxBodiesNum, numBodyMutexes, maxBodiesPairsNum, maxContactConstraints, broadPhaseLayerInterface, broadphase_f,
-    objects_f);
-  physicsSystem->SetPhysicsSettings(physicsSettings);
-  physicsSystem->SetGravity(JPH::Vec3(0, -9.8065f, 0));
+  physicsSystem = create_physics_system(main_sys_cfg);
 
   switch (phys_blk.getInt("jobSysType", single_threaded ? 0 : 1))
   {
@@ -630,11 +659,12 @@ void PhysWorld::term_engine()
 {
   using namespace jolt_api;
 
-  // Note: phys world which does `fetchSimRes` in its dtor is assumed to be destroyed at this point
+  // Note: phys worlds which do `fetchSimRes` in their dtor are assumed to be destroyed at this point
+  G_ASSERTF(!main_phys_world, "main phys world should be destroyed before phys engine");
   del_it(jobSystem);
 
   del_it(physicsSystem);
-  del_it(tempAllocator);
+  del_it(main_temp_allocator);
 }
 
 PhysBody::PhysBody(PhysWorld *w, float mass, const PhysCollision *coll, const TMatrix &tm, const PhysBodyCreationData &s) : world(w)
@@ -703,7 +733,7 @@ PhysBody::PhysBody(PhysWorld *w, float mass, const PhysCollision *coll, const TM
   }
   else
     LOGERR_ONCE("Failed to create body with collType=%d @ %@. cur/maxBodies=%d/%d", coll->collType, tm,
-      PhysWorld::getScene()->GetNumBodies(), PhysWorld::getScene()->GetMaxBodies());
+      world->getScene()->GetNumBodies(), world->getScene()->GetMaxBodies());
 }
 PhysBody::~PhysBody()
 {
@@ -717,7 +747,7 @@ void PhysBody::setTm(const TMatrix &wtm)
 {
   lockRW([&](JPH::Body &b) { // Lock explicitly to save read-lock call on `IsAdded`
     auto act = b.IsInBroadPhase() ? JPH::EActivation::Activate : JPH::EActivation::DontActivate;
-    jolt_api::physicsSystem->GetBodyInterfaceNoLock().SetPositionAndRotation(bodyId, to_jVec3(wtm.getcol(3)), to_jQuat(wtm), act);
+    world->getScene()->GetBodyInterfaceNoLock().SetPositionAndRotation(bodyId, to_jVec3(wtm.getcol(3)), to_jQuat(wtm), act);
   });
 }
 
@@ -1161,10 +1191,25 @@ void PhysBody::setCcdParams(float rad, float threshold) {}
 
 ////////////////////////////////////////////////////////////
 
+// Joint is added to physics system of its bodies, that system is kept in constraint's user data for removal
+static JPH::Body *get_joint_body(PhysBody *body)
+{
+  return body ? body->getPhysWorld()->getScene()->GetBodyLockInterface().TryGetBody(body->bodyId) : &JPH::Body::sFixedToWorld;
+}
+
+static void add_joint_constraint(JPH::Constraint *constr, PhysBody *body1, PhysBody *body2)
+{
+  G_ASSERTF(!body1 || !body2 || body1->getPhysWorld() == body2->getPhysWorld(), "joint bodies %p, %p are from different worlds",
+    body1, body2);
+  JPH::PhysicsSystem *physSys = (body2 ? body2 : body1)->getPhysWorld()->getScene();
+  constr->SetUserData((uintptr_t)physSys);
+  physSys->AddConstraint(constr);
+}
+
 PhysJoint::~PhysJoint()
 {
   G_ASSERT(joint);
-  jolt_api::phys_sys().RemoveConstraint(joint);
+  ((JPH::PhysicsSystem *)(uintptr_t)joint->GetUserData())->RemoveConstraint(joint);
 }
 
 PhysRagdollHingeJoint::PhysRagdollHingeJoint(PhysBody *body1, PhysBody *body2, const Point3 &pos, const Point3 &axis,
@@ -1182,8 +1227,8 @@ PhysRagdollHingeJoint::PhysRagdollHingeJoint(PhysBody *body1, PhysBody *body2, c
   hingeSettings.mLimitsMax = +ang_limit;
   hingeSettings.mMaxFrictionTorque = damping * 0.2;
 
-  JPH::Body *b1 = jolt_api::body_lock().TryGetBody(body1->bodyId);
-  JPH::Body *b2 = jolt_api::body_lock().TryGetBody(body2->bodyId);
+  JPH::Body *b1 = get_joint_body(body1);
+  JPH::Body *b2 = get_joint_body(body2);
   G_ASSERTF(b1 && b2, "%p->bodyId=0x%x (%p)  %p->bodyId=0x%x (%p)", body1, body1->bodyId.GetIndexAndSequenceNumber(), b1, body2,
     body2->bodyId.GetIndexAndSequenceNumber(), b2);
 
@@ -1191,7 +1236,7 @@ PhysRagdollHingeJoint::PhysRagdollHingeJoint(PhysBody *body1, PhysBody *body2, c
   float inertiaFromConstraint = (body2Inertia * to_jVec3(axis)).Length();
 
   JPH::HingeConstraint *hinge = static_cast<JPH::HingeConstraint *>(hingeSettings.Create(*b1, *b2));
-  jolt_api::phys_sys().AddConstraint(joint = hinge);
+  add_joint_constraint(joint = hinge, body1, body2);
 }
 
 PhysRagdollBallJoint::PhysRagdollBallJoint(PhysBody *body1, PhysBody *body2, const TMatrix &_tm, const Point3 &min_limit,
@@ -1216,13 +1261,13 @@ PhysRagdollBallJoint::PhysRagdollBallJoint(PhysBody *body1, PhysBody *body2, con
   ballSettings.mTwistMaxAngle = max_limit.x;
   ballSettings.mMaxFrictionTorque = damping * 0.1;
 
-  JPH::Body *b1 = jolt_api::body_lock().TryGetBody(body1->bodyId);
-  JPH::Body *b2 = jolt_api::body_lock().TryGetBody(body2->bodyId);
+  JPH::Body *b1 = get_joint_body(body1);
+  JPH::Body *b2 = get_joint_body(body2);
   G_ASSERTF(b1 && b2, "%p->bodyId=0x%x (%p)  %p->bodyId=0x%x (%p)", body1, body1->bodyId.GetIndexAndSequenceNumber(), b1, body2,
     body2->bodyId.GetIndexAndSequenceNumber(), b2);
 
   JPH::SwingTwistConstraint *constr = static_cast<JPH::SwingTwistConstraint *>(ballSettings.Create(*b1, *b2));
-  jolt_api::phys_sys().AddConstraint(joint = constr);
+  add_joint_constraint(joint = constr, body1, body2);
 }
 
 Phys6DofJoint::Phys6DofJoint(PhysBody *body1, PhysBody *body2, const TMatrix &frame1, const TMatrix &frame2) : PhysJoint(PJ_6DOF)
@@ -1233,8 +1278,8 @@ Phys6DofJoint::Phys6DofJoint(PhysBody *body1, PhysBody *body2, const TMatrix &fr
   if (!body2)
     eastl::swap(body1, body2);
 
-  JPH::Body *b1 = body1 ? jolt_api::body_lock().TryGetBody(body1->bodyId) : &JPH::Body::sFixedToWorld;
-  JPH::Body *b2 = jolt_api::body_lock().TryGetBody(body2->bodyId);
+  JPH::Body *b1 = get_joint_body(body1);
+  JPH::Body *b2 = get_joint_body(body2);
   G_ASSERTF(b1 && b2, "%p->bodyId=0x%x (%p)  %p->bodyId=0x%x (%p)", body1, body1 ? body1->bodyId.GetIndexAndSequenceNumber() : 0, b1,
     body2, body2 ? body2->bodyId.GetIndexAndSequenceNumber() : 0, b2);
 
@@ -1268,7 +1313,7 @@ Phys6DofJoint::Phys6DofJoint(PhysBody *body1, PhysBody *body2, const TMatrix &fr
   }
 
   auto constr = static_cast<JPH::SixDOFConstraint *>(sixDofSettings.Create(*b1, *b2));
-  jolt_api::phys_sys().AddConstraint(joint = constr);
+  add_joint_constraint(joint = constr, body1, body2);
 }
 void Phys6DofJoint::setLimit(int index, const Point2 &limits)
 {
@@ -1322,17 +1367,17 @@ Phys6DofSpringJoint::Phys6DofSpringJoint(PhysBody *body1, PhysBody *body2, const
   sixDofSettings.mAxisX2 = to_jVec3(frame2.getcol(0));
   sixDofSettings.mAxisY2 = to_jVec3(frame2.getcol(1));
 
-  JPH::Body *b1 = body1 ? jolt_api::body_lock().TryGetBody(body1->bodyId) : &JPH::Body::sFixedToWorld;
-  JPH::Body *b2 = body2 ? jolt_api::body_lock().TryGetBody(body2->bodyId) : &JPH::Body::sFixedToWorld;
+  JPH::Body *b1 = get_joint_body(body1);
+  JPH::Body *b2 = get_joint_body(body2);
   G_ASSERTF(b1 && b2, "%p->bodyId=0x%x (%p)  %p->bodyId=0x%x (%p)", body1, body1 ? body1->bodyId.GetIndexAndSequenceNumber() : 0, b1,
     body2, body2 ? body2->bodyId.GetIndexAndSequenceNumber() : 0, b2);
 
   auto constr = static_cast<JPH::SixDOFConstraint *>(sixDofSettings.Create(*b1, *b2));
-  jolt_api::phys_sys().AddConstraint(joint = constr);
+  add_joint_constraint(joint = constr, body1, body2);
 }
 Phys6DofSpringJoint::Phys6DofSpringJoint(PhysBody *body1, PhysBody *body2, const TMatrix &in_tm) :
-  Phys6DofSpringJoint(body1, body2, inverse(to_tmatrix(jolt_api::body_api().GetWorldTransform(body1->bodyId))) * in_tm,
-    inverse(to_tmatrix(jolt_api::body_api().GetWorldTransform(body2->bodyId))) * in_tm)
+  Phys6DofSpringJoint(body1, body2, inverse(to_tmatrix(body1->api().GetWorldTransform(body1->bodyId))) * in_tm,
+    inverse(to_tmatrix(body2->api().GetWorldTransform(body2->bodyId))) * in_tm)
 {}
 void Phys6DofSpringJoint::setSpring(int index, bool on, float stiffness, float damping, const Point2 &limits)
 {
@@ -1405,39 +1450,31 @@ void PhysRayCast::forceUpdate(PhysWorld *world)
   SpecifiedBroadPhaseLayerFilter sbflt(blr);
   BroadPhaseLayerFilter nobflt;
   BroadPhaseLayerFilter &flt = __popcount(filterMask) == 1 ? sbflt : nobflt;
-  hasHit = jolt_api::phys_sys().GetNarrowPhaseQuery().CastRay(ray, hit, flt, PhysBody::ObjFilter(filterMask, filterMask));
+  hitWorld = world;
+  hasHit = world->phys_sys().GetNarrowPhaseQuery().CastRay(ray, hit, flt, PhysBody::ObjFilter(filterMask, filterMask));
   // debug("ray(from=%@, dir=%@, maxlen=%g)=%d f=%g", to_point3(pos), to_point3(dir), maxLength, hasHit, hit.mFraction);
 }
 Point3 PhysRayCast::getNormal() const
 {
   if (hit.mBodyID.IsInvalid())
     return Point3(0, 1, 0);
-  JPH::Vec3 normal;
-  PhysBody::lock_body_ro(hit.mBodyID,
-    [&](const JPH::Body &hit_body) { normal = hit_body.GetWorldSpaceSurfaceNormal(hit.mSubShapeID2, pos + dir * hit.mFraction); });
+  JPH::Vec3 normal = JPH::Vec3::sAxisY();
+  JPH::BodyLockRead lock(hitWorld->getScene()->GetBodyLockInterface(), hit.mBodyID);
+  if (lock.Succeeded())
+    normal = lock.GetBody().GetWorldSpaceSurfaceNormal(hit.mSubShapeID2, pos + dir * hit.mFraction);
   return to_point3(normal);
 }
 
-PhysWorld::PhysWorld(real default_static_friction, real default_dynamic_friction, real default_restitution, real default_softness)
-{
-  Material material;
-  material.friction = default_static_friction;
-  material.restitution = default_restitution;
-  materials.push_back(material);
-}
-
-PhysWorld::~PhysWorld() { fetchSimRes(true); }
-
-// interaction layers
-void PhysWorld::setInteractionLayers(unsigned int mask1, unsigned int mask2, bool make_contacts) {}
-
 struct JoltSimJob final : public cpujobs::IJob
 {
+  PhysWorld *world;
   int maxSubSteps = 3;
   float fixedTimeStep = 1. / 60.f;
   uint32_t qPos = 0;
   float time = 0;
 
+  explicit JoltSimJob(PhysWorld *w) : world(w) {}
+
   void setup(int mss, float fts, float dt)
   {
     maxSubSteps = mss;
@@ -1449,7 +1486,7 @@ struct JoltSimJob final : public cpujobs::IJob
   {
     if (JoltJobSystemImpl2::self)
       JoltJobSystemImpl2::self->StartWorkerJobs();
-    jolt_api::phys_sys().Update(dt, nsteps, tempAllocator, jobSystem);
+    world->phys_sys().Update(dt, nsteps, world->tempAllocator, jobSystem);
     if (JoltJobSystemImpl2::self)
       JoltJobSystemImpl2::self->StopWorkerJobs();
   }
@@ -1469,25 +1506,173 @@ struct JoltSimJob final : public cpujobs::IJob
       update(time);
   }
 };
-static JoltSimJob sim_job;
+
+PhysWorld::PhysWorld(real default_static_friction, real default_dynamic_friction, real default_restitution, real default_softness)
+{
+  Material material;
+  material.friction = default_static_friction;
+  material.restitution = default_restitution;
+  materials.push_back(material);
+
+  G_ASSERTF(jolt_api::physicsSystem, "PhysWorld::init_engine() should be called before creation of phys world");
+  if (!main_phys_world)
+  {
+    main_phys_world = this;
+    physSystem = jolt_api::physicsSystem;
+    tempAllocator = main_temp_allocator;
+  }
+  else
+  {
+    physSystem = create_physics_system(additional_sys_cfg);
+    tempAllocator = new JPH::TempAllocatorImpl(additional_sys_cfg.tempAllocSz);
+  }
+  simJob = new JoltSimJob(this);
+}
+
+PhysWorld::~PhysWorld()
+{
+  fetchSimRes(true);
+  del_it(simJob);
+  if (main_phys_world == this)
+    main_phys_world = nullptr;
+  else
+  {
+    del_it(physSystem);
+    del_it(tempAllocator);
+  }
+}
+
+// interaction layers
+void PhysWorld::setInteractionLayers(unsigned int mask1, unsigned int mask2, bool make_contacts) {}
 
 void PhysWorld::startSim(real dt, bool wake_up_thread)
 {
-  G_ASSERT(interlocked_acquire_load(sim_job.done) == 1);
-  sim_job.setup(maxSubSteps, fixedTimeStep, dt);
+  G_ASSERT(interlocked_acquire_load(simJob->done) == 1);
+  simJob->setup(maxSubSteps, fixedTimeStep, dt);
   threadpool::AddFlags flags = threadpool::AddFlags::IgnoreNotDone;
   if (wake_up_thread)
     flags |= threadpool::AddFlags::WakeOnAdd;
-  threadpool::add(&sim_job, threadpool::PRIO_DEFAULT, sim_job.qPos, flags);
+  threadpool::add(simJob, threadpool::PRIO_DEFAULT, simJob->qPos, flags);
 }
 bool PhysWorld::fetchSimRes(bool wait, PhysBody *)
 {
-  if (wait && interlocked_acquire_load(sim_job.done) == 0)
+  if (wait && interlocked_acquire_load(simJob->done) == 0)
   {
-    threadpool::barrier_active_wait_for_job(&sim_job, threadpool::PRIO_DEFAULT, sim_job.qPos);
-    threadpool::wait(&sim_job);
+    threadpool::barrier_active_wait_for_job(simJob, threadpool::PRIO_DEFAULT, simJob->qPos);
+    threadpool::wait(simJob);
   }
-  return interlocked_acquire_load(sim_job.done) == 1;
+  return interlocked_acquire_load(simJob->done) == 1;
+}
+
+// StateRecorder over PhysWorldSnapshot memory instead of stringstream of JPH::StateRecorderImpl
+class SnapshotStateRecorder final : public JPH::StateRecorder
+{
+public:
+  explicit SnapshotStateRecorder(Tab<uint8_t> &dest) : writeTo(&dest), readFrom(dest.data()), readSize(dest.size()) {}
+  explicit SnapshotStateRecorder(dag::ConstSpan<uint8_t> src) : readFrom(src.data()), readSize(src.size()) {}
+
+  void WriteBytes(const void *data, size_t size) override
+  {
+    G_ASSERT_RETURN(writeTo, );
+    append_items(*writeTo, size, (const uint8_t *)data);
+  }
+  void ReadBytes(void *data, size_t size) override
+  {
+    if (readPos + size > readSize)
+    {
+      failed = true;
+      memset(data, 0, size);
+      return;
+    }
+    memcpy(data, readFrom + readPos, size);
+    readPos += size;
+  }
+  bool IsEOF() const override { return readPos >= readSize; }
+  bool IsFailed() const override { return failed; }
+
+private:
+  Tab<uint8_t> *writeTo = nullptr;
+  const uint8_t *readFrom = nullptr;
+  size_t readSize = 0, readPos = 0;
+  bool failed = false;
+};
+
+int PhysWorldSnapshot::findFirstDifference(const PhysWorldSnapshot &other) const
+{
+  const uint32_t cnt = min(data.size(), other.data.size());
+  for (uint32_t i = 0; i < cnt; ++i)
+    if (data[i] != other.data[i])
+      return i;
+  return data.size() == other.data.size() ? -1 : int(cnt);
+}
+
+// Jolt saves bodies (that are in broadphase) by id and constraints by index, restore fails midway when they don't match
+static uint64_t calc_state_layout_hash(const JPH::PhysicsSystem &sys)
+{
+  JPH::BodyIDVector bodies;
+  sys.GetBodies(bodies);
+  const JPH::BodyInterface &bi = sys.GetBodyInterfaceNoLock();
+  uint64_t hash = fnv1a_step<64>(sys.GetMaxBodies());
+  for (const JPH::BodyID &id : bodies)
+    if (bi.IsAdded(id))
+      hash = fnv1a_step<64>(id.GetIndexAndSequenceNumber(), hash);
+  const JPH::Constraints constraints = sys.GetConstraints();
+  hash = fnv1a_step<64>(constraints.size(), hash);
+  for (const JPH::Ref<JPH::Constraint> &c : constraints)
+    hash = fnv1a_step<64>(uint32_t(c->GetSubType()), hash);
+  return hash;
+}
+
+void PhysWorld::saveState(PhysWorldSnapshot &out) const
+{
+  G_ASSERT(interlocked_acquire_load(simJob->done) == 1);
+  TIME_PROFILE(jolt_save_state);
+  out.data.clear();
+  SnapshotStateRecorder recorder(out.data);
+  phys_sys().SaveState(recorder);
+  out.dataHash = mem_hash_fnv1<64>((const char *)out.data.data(), out.data.size());
+  out.layoutHash = calc_state_layout_hash(phys_sys());
+}
+
+bool PhysWorld::restoreState(const PhysWorldSnapshot &snapshot)
+{
+  G_ASSERT(interlocked_acquire_load(simJob->done) == 1);
+  TIME_PROFILE(jolt_restore_state);
+  if (snapshot.empty() || mem_hash_fnv1<64>((const char *)snapshot.data.data(), snapshot.data.size()) != snapshot.dataHash)
+  {
+    logerr("jolt: physics state snapshot of %d bytes is corrupted", snapshot.data.size());
+    return false;
+  }
+  if (calc_state_layout_hash(phys_sys()) != snapshot.layoutHash)
+  {
+    logerr("jolt: physics state snapshot was saved with other bodies or constraints in world");
+    return false;
+  }
+  SnapshotStateRecorder recorder(make_span_const(snapshot.data));
+  const bool restored = phys_sys().RestoreState(recorder) && !recorder.IsFailed();
+  G_ASSERTF(restored, "jolt: failed to restore validated physics state snapshot of %d bytes", snapshot.data.size());
+  return restored;
+}
+
+bool PhysWorld::checkDeterminism(float dt, int num_steps)
+{
+  fetchSimRes(true);
+  PhysWorldSnapshot initial, first, second;
+  saveState(initial);
+  // fixed steps directly, substep time accumulation of sim job would differ between runs
+  for (int i = 0; i < num_steps; ++i)
+    simJob->update(dt);
+  saveState(first);
+  if (!restoreState(initial))
+    return false;
+  for (int i = 0; i < num_steps; ++i)
+    simJob->update(dt);
+  saveState(second);
+  const int diffOfs = first.findFirstDifference(second);
+  if (diffOfs >= 0)
+    logerr("jolt: simulation is not deterministic, states after %d steps of %gs differ at offset %d (sizes %d/%d)", num_steps, dt,
+      diffOfs, first.size(), second.size());
+  return diffOfs < 0;
 }
 
 
@@ -1535,13 +1720,15 @@ PhysJoint *PhysWorld::regJoint(PhysJoint *j)
   return j;
 }
 
-static Point3 get_velocity_from_hit(const JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> &cb)
+static Point3 get_velocity_from_hit(const JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> &cb,
+  const JPH::BodyInterface &body_api)
 {
   if (cb.mHit.mBodyID2.IsInvalid())
     return Point3(0, 0, 0);
-  return to_point3(jolt_api::body_api().GetLinearVelocity(cb.mHit.mBodyID2));
+  return to_point3(body_api.GetLinearVelocity(cb.mHit.mBodyID2));
 }
 
+// bodies are not required to be in this world (e.g. rendinst collision bodies of main world are queried by additional worlds)
 void PhysWorld::shape_query(const JPH::Shape *shape, const TMatrix &from, const Point3 &dir, PhysWorld *,
   dag::ConstSpan<PhysBody *> bodies, PhysShapeQueryResult &out, int filter_grp, int filter_mask)
 {
@@ -1549,14 +1736,19 @@ void PhysWorld::shape_query(const JPH::Shape *shape, const TMatrix &from, const
 
   JPH::TransformedShape tshape;
   JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> closestCb;
+  const PhysBody *hitBody = nullptr;
 
   for (auto b : bodies)
   {
-    tshape = body_api().GetTransformedShape(b->bodyId);
+    if (!(b->getGroupMask() & filter_mask) || !(filter_grp & b->getInteractionLayer()))
+      continue;
+    tshape = b->api().GetTransformedShape(b->bodyId);
     closestCb.SetContext(&tshape);
-    if ((b->getGroupMask() & filter_mask) && (filter_grp & b->getInteractionLayer()))
-      JPH::CollisionDispatch::sCastShapeVsShapeWorldSpace(shape_cast, defShapeCastStg, b->getShape(), JPH::Vec3::sReplicate(1.0f), {},
-        body_api().GetCenterOfMassTransform(b->bodyId), {}, {}, closestCb);
+    const float prevFraction = closestCb.GetEarlyOutFraction();
+    JPH::CollisionDispatch::sCastShapeVsShapeWorldSpace(shape_cast, defShapeCastStg, b->getShape(), JPH::Vec3::sReplicate(1.0f), {},
+      b->api().GetCenterOfMassTransform(b->bodyId), {}, {}, closestCb);
+    if (closestCb.GetEarlyOutFraction() < prevFraction)
+      hitBody = b;
   }
 
   // debug("shape_query(from=%@, dir=%@, out.t=%g)=%d f=%g", from, dir, out.t, closestCb.HadHit(), closestCb.mHit.mFraction);
@@ -1565,14 +1757,15 @@ void PhysWorld::shape_query(const JPH::Shape *shape, const TMatrix &from, const
     out.t = closestCb.mHit.mFraction;
     out.res = to_point3(closestCb.mHit.mContactPointOn1);
     out.norm = to_point3(-closestCb.mHit.mPenetrationAxis.Normalized());
-    out.vel = get_velocity_from_hit(closestCb);
+    out.vel = hitBody ? hitBody->getVelocity() : Point3(0, 0, 0);
   }
 }
 bool PhysWorld::convex_shape_sweep_test(const JPH::Shape *shape, const Point3 &from, const Point3 &to,
   JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> &closestCb, PhysShapeQueryResult &out,
-  const JPH::ObjectLayerFilter &obj_filter, const JPH::BodyFilter &body_filter)
+  const JPH::ObjectLayerFilter &obj_filter, const JPH::BodyFilter &body_filter, JPH::QuatArg rot) const
 {
-  JPH::RShapeCast shape_cast(shape, JPH::Vec3::sReplicate(1.0f), JPH::Mat44::sTranslation(to_jVec3(from)), to_jVec3(to - from));
+  JPH::RShapeCast shape_cast(shape, JPH::Vec3::sReplicate(1.0f), JPH::Mat44::sRotationTranslation(rot, to_jVec3(from)),
+    to_jVec3(to - from));
   closestCb.mHit.mFraction = out.t;
   phys_sys().GetNarrowPhaseQuery().CastShape(shape_cast, defShapeCastStg, JPH::Vec3::sZero(), closestCb, {}, obj_filter, body_filter);
   if (closestCb.HadHit() && closestCb.mHit.mFraction < out.t)
@@ -1580,11 +1773,62 @@ bool PhysWorld::convex_shape_sweep_test(const JPH::Shape *shape, const Point3 &f
     out.t = closestCb.mHit.mFraction;
     out.res = to_point3(closestCb.mHit.mContactPointOn1);
     out.norm = to_point3(-closestCb.mHit.mPenetrationAxis.Normalized());
-    out.vel = get_velocity_from_hit(closestCb);
+    out.vel = get_velocity_from_hit(closestCb, body_api());
   }
   return out.t < 1.f;
 }
 
+static constexpr uint32_t QUERIES_PER_JOB = 16;
+
+template <typename Cb>
+static void run_query_batch(uint32_t count, Cb cb)
+{
+  if (count <= QUERIES_PER_JOB || !threadpool::get_num_workers())
+  {
+    for (uint32_t i = 0; i < count; ++i)
+      cb(i);
+    return;
+  }
+  // narrow phase queries only take body read locks, so they can run concurrently (but not during simulation step)
+  threadpool::parallel_for_inline(0, count, QUERIES_PER_JOB, [&](uint32_t begin, uint32_t end, uint32_t) {
+    for (uint32_t i = begin; i < end; ++i)
+      cb(i);
+  });
+}
+
+// narrow phase queries are not synchronized with body updates of simulation step, only with each other
+bool PhysWorld::isSimulating() const { return interlocked_acquire_load(simJob->done) == 0; }
+
+void PhysWorld::rayCastBatch(dag::Span<PhysRayCast *> rays)
+{
+  G_ASSERTF(!isSimulating(), "%s is called while simulation step is running", __FUNCTION__);
+  TIME_PROFILE(jolt_ray_cast_batch);
+  run_query_batch(rays.size(), [&](uint32_t i) { rays[i]->forceUpdate(this); });
+}
+
+void PhysWorld::shapeCastBatch(dag::ConstSpan<ShapeCastDesc> casts, dag::Span<PhysShapeQueryResult> out)
+{
+  G_ASSERT_RETURN(out.size() >= casts.size(), );
+  G_ASSERTF(!isSimulating(), "%s is called while simulation step is running", __FUNCTION__);
+  TIME_PROFILE(jolt_shape_cast_batch);
+  run_query_batch(casts.size(), [&](uint32_t i) {
+    const ShapeCastDesc &desc = casts[i];
+    JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> closestCb;
+    PhysBody::ObjFilter objf(desc.filterGrp, desc.filterMask);
+    if (desc.capsuleHalfHeight > 0.f)
+    {
+      JPH::CapsuleShape convex(desc.capsuleHalfHeight, desc.radius); // along Y
+      convex_shape_sweep_test(&convex, desc.from, desc.to, closestCb, out[i], objf, {},
+        JPH::Quat::sFromTo(JPH::Vec3::sAxisY(), to_jVec3(desc.capsuleAxis)));
+    }
+    else
+    {
+      JPH::SphereShape convex(desc.radius);
+      convex_shape_sweep_test(&convex, desc.from, desc.to, closestCb, out[i], objf, {});
+    }
+  });
+}
+
 void PhysWorld::shapeQuery(const PhysBody *body, const TMatrix &from, const TMatrix &to, dag::ConstSpan<PhysBody *> bodies,
   PhysShapeQueryResult &out, int filter_grp, int filter_mask)
 {
@@ -5,6 +5,16 @@
 #include <math/twistCtrl.h>
 #include <stddef.h>
 #include <perfMon/dag_statDrv.h>
+#include <memory/dag_framemem.h>
+#include <osApiWrappers/dag_critSec.h>
+#include <EASTL/sort.h>
+
+// ragdolls are started and destroyed from different threads (e.g. ES jobs), so list is guarded.
+// Lock is recursive, enforce_budget() holds it while baking, so ragdolls can't be destroyed meanwhile.
+static WinCritSec active_ragdolls_lock;
+static Tab<PhysRagdoll *> active_ragdolls;
+static int active_ragdolls_budget = -1;
+static uint32_t ragdolls_started = 0;
 
 PhysRagdoll::PhysRagdoll() :
   physSys(NULL),
@@ -23,7 +33,30 @@ PhysRagdoll::PhysRagdoll() :
 }
 
 
-PhysRagdoll::~PhysRagdoll() { del_it(physSys); }
+PhysRagdoll::~PhysRagdoll()
+{
+  removeFromActive();
+  del_it(physSys);
+}
+
+void PhysRagdoll::addToActive()
+{
+  WinAutoLock lock(active_ragdolls_lock);
+  startNo = ++ragdolls_started;
+  active_ragdolls.push_back(this);
+}
+
+void PhysRagdoll::removeFromActive()
+{
+  WinAutoLock lock(active_ragdolls_lock);
+  for (int i = 0; i < active_ragdolls.size(); ++i)
+    if (active_ragdolls[i] == this)
+    {
+      active_ragdolls[i] = active_ragdolls.back();
+      active_ragdolls.pop_back();
+      return;
+    }
+}
 
 void PhysRagdoll::initNodeHelpers(const GeomNodeTree &tree, dag::Span<TMatrix> last_node_tms)
 {
@@ -73,8 +106,49 @@ void PhysRagdoll::applyOverriddenVelocities()
     }
 }
 
+void PhysRagdoll::updateSleep(real dt)
+{
+  bool anyActive = false, settled = true;
+  for (int i = 0; i < physSys->getBodyCount(); ++i)
+  {
+    const PhysBody *body = physSys->getBody(i);
+    anyActive |= body->isActive();
+    settled = settled && lengthSq(body->getVelocity()) < sleepLinVelThresSq &&
+              lengthSq(body->getAngularVelocity()) < sleepAngVelThresSq;
+  }
+  sleeping = !anyActive;
+  if (sleeping || timeToSleep <= 0.f)
+    return;
+  settledTime = settled ? settledTime + dt : 0.f;
+  if (settledTime < timeToSleep)
+    return;
+  for (int i = 0; i < physSys->getBodyCount(); ++i)
+    physSys->getBody(i)->activateBody(false);
+  settledTime = 0.f;
+}
+
+void PhysRagdoll::applyNodeAlignCtrl(GeomNodeTree &tree)
+{
+  for (int j = 0; j < nodeAlignCtrl.size(); j++)
+    apply_twist_ctrl(tree, nodeAlignCtrl[j].node0Id, nodeAlignCtrl[j].node1Id,
+      make_span(nodeAlignCtrl[j].twistId, nodeAlignCtrl[j].twistCnt), nodeAlignCtrl[j].angDiff);
+}
+
 void PhysRagdoll::update(real dt, GeomNodeTree &tree, AnimV20::AnimcharBaseComponent *)
 {
+  if (DAGOR_UNLIKELY(isBaked()))
+  {
+    for (const BakedNode &n : bakedNodes)
+    {
+      if (recalcWtms)
+        tree.partialCalcWtm(n.nodeId);
+      tree.setNodeWtmScalar(n.nodeId, n.wtm);
+      if (recalcWtms)
+        tree.invalidateWtm(n.nodeId);
+    }
+    applyNodeAlignCtrl(tree);
+    return;
+  }
   if (!physSys)
     return;
 
@@ -125,7 +199,9 @@ void PhysRagdoll::update(real dt, GeomNodeTree &tree, AnimV20::AnimcharBaseCompo
     }
   }
 
-  physSys->updateTms();
+  updateSleep(dt);
+  if (!sleeping) // helpers keep tms of sleeping bodies
+    physSys->updateTms();
 
   for (dag::Index16 i(0), ie(nodeHelpers.size()); i != ie; ++i)
   {
@@ -137,9 +213,7 @@ void PhysRagdoll::update(real dt, GeomNodeTree &tree, AnimV20::AnimcharBaseCompo
     if (recalcWtms)
       tree.invalidateWtm(i);
   }
-  for (int j = 0; j < nodeAlignCtrl.size(); j++)
-    apply_twist_ctrl(tree, nodeAlignCtrl[j].node0Id, nodeAlignCtrl[j].node1Id,
-      make_span(nodeAlignCtrl[j].twistId, nodeAlignCtrl[j].twistCnt), nodeAlignCtrl[j].angDiff);
+  applyNodeAlignCtrl(tree);
 }
 
 
@@ -197,6 +271,10 @@ void PhysRagdoll::startRagdoll(int interact_layer, int interact_mask, const Geom
 
   physSys = new PhysSystemInstance(physRes, physWorld, nullptr, &ud, interact_layer, interact_mask);
   clear_and_shrink(lastNodeTms);
+  clear_and_shrink(bakedNodes);
+  sleeping = false;
+  settledTime = 0.f;
+  addToActive();
 
   if (tree)
   {
@@ -229,6 +307,8 @@ void PhysRagdoll::startRagdoll(int interact_layer, int interact_mask, const Geom
 
 void PhysRagdoll::endRagdoll()
 {
+  removeFromActive();
+  clear_and_shrink(bakedNodes);
   del_it(physSys);
   clear_and_shrink(nodeHelpers);
   clear_and_shrink(nodeAlignCtrl);
@@ -274,3 +354,77 @@ bool PhysRagdoll::wakeUp()
     physSys->getBody(i)->wakeUp();
   return physSys != nullptr;
 }
+
+
+void PhysRagdoll::setSleepParams(float lin_vel_thres, float ang_vel_thres, float time_to_sleep)
+{
+  sleepLinVelThresSq = sqr(lin_vel_thres);
+  sleepAngVelThresSq = sqr(ang_vel_thres);
+  timeToSleep = time_to_sleep;
+  settledTime = 0.f;
+}
+
+void PhysRagdoll::bake()
+{
+  // there is no pose to keep until first update
+  if (!physSys || nodeHelpers.empty() || !lastNodeTms.empty())
+    return;
+
+  TIME_PROFILE(ragdoll_bake);
+  if (!sleeping)
+    physSys->updateTms();
+  int cnt = 0;
+  for (const TMatrix *helper : nodeHelpers)
+    cnt += helper ? 1 : 0;
+  clear_and_resize(bakedNodes, cnt);
+  for (int i = 0, j = 0; i < nodeHelpers.size(); ++i)
+    if (nodeHelpers[i])
+      bakedNodes[j++] = BakedNode{*nodeHelpers[i], dag::Index16(i)};
+
+  removeFromActive();
+  del_it(physSys);
+  clear_and_shrink(nodeHelpers); // they point to physSys
+}
+
+void PhysRagdoll::set_active_budget(int max_active) { active_ragdolls_budget = max_active; }
+
+int PhysRagdoll::get_active_count()
+{
+  WinAutoLock lock(active_ragdolls_lock);
+  return active_ragdolls.size();
+}
+
+void PhysRagdoll::enforce_budget(const Point3 &view_pos)
+{
+  if (active_ragdolls_budget < 0)
+    return;
+
+  TIME_PROFILE(ragdoll_enforce_budget);
+  struct Candidate
+  {
+    PhysRagdoll *ragdoll;
+    float distSq;
+  };
+  Tab<Candidate> candidates(framemem_ptr());
+  WinAutoLock lock(active_ragdolls_lock);
+  if (active_ragdolls.size() <= active_ragdolls_budget)
+    return;
+  candidates.reserve(active_ragdolls.size());
+  for (PhysRagdoll *ragdoll : active_ragdolls)
+    if (!ragdoll->nodeHelpers.empty() && ragdoll->lastNodeTms.empty() && ragdoll->physSys->getBodyCount())
+    {
+      TMatrix tm;
+      ragdoll->physSys->getBody(0)->getTm(tm);
+      candidates.push_back(Candidate{ragdoll, lengthSq(tm.getcol(3) - view_pos)});
+    }
+  const int toBake = min<int>(active_ragdolls.size() - active_ragdolls_budget, candidates.size());
+  eastl::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+    if (a.ragdoll->sleeping != b.ragdoll->sleeping)
+      return a.ragdoll->sleeping;
+    if (a.distSq != b.distSq)
+      return a.distSq > b.distSq;
+    return a.ragdoll->startNo < b.ragdoll->startNo;
+  });
+  for (int i = 0; i < toBake; ++i) // bake() removes ragdoll from list under the same (recursive) lock
+    candidates[i].ragdoll->bake();
+}
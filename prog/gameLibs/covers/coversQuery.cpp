@@ -0,0 +1,158 @@
+#include <covers/covers.h>
+#include <perfMon/dag_cpuFreq.h>
+#include <math/dag_mathBase.h>
+#include <math/dag_Point2.h>
+
+namespace covers
+{
+static constexpr int CHECK_TIME_EVERY_GROUPS = 16; // groups of 4 covers
+
+void build_query_data(const Tab<Cover> &covers, float cone_half_angle, CoversQueryData &data_out)
+{
+  data_out.coneCos = clamp(cosf(cone_half_angle), 0.f, 1.f);
+  data_out.posDir.resize(covers.size());
+  data_out.posY.resize(covers.size());
+  for (int i = 0; i < covers.size(); i++)
+  {
+    const Cover &cover = covers[i];
+    const Point3 pos = (cover.groundLeft + cover.groundRight) * 0.5f;
+    Point2 dir = Point2::xz(cover.dir);
+    const float dirLen = length(dir);
+    dir = dirLen > 1e-6f ? dir / dirLen : Point2(0, 0);
+    data_out.posDir[i] = v_make_vec4f(pos.x, pos.z, dir.x, dir.y);
+    data_out.posY[i] = pos.y;
+  }
+}
+
+static inline bool is_occupied(dag::ConstSpan<uint32_t> occupied_bits, int idx)
+{
+  return (idx >> 5) < occupied_bits.size() && (occupied_bits[idx >> 5] & (1u << (idx & 31)));
+}
+
+// keeps out[first..] sorted by score (descending) and not longer than max_count
+static void insert_result(Tab<CoverQueryResult> &out, int first, int max_count, int cover_idx, float score)
+{
+  if (out.size() - first == max_count)
+  {
+    if (score <= out.back().score)
+      return;
+    out.back() = CoverQueryResult{cover_idx, score};
+  }
+  else
+    out.push_back(CoverQueryResult{cover_idx, score});
+  for (int i = out.size() - 1; i > first && out[i - 1].score < out[i].score; --i)
+    eastl::swap(out[i - 1], out[i]);
+}
+
+static void gather_candidates(const scene::TiledScene &scene, bbox3f_cref box, Tab<int> &candidates)
+{
+  scene.boxCull<false, false>(box, 0, 0,
+    [&](scene::node_index ni, mat44f_cref) { candidates.push_back(scene.getNodeIndex(ni)); });
+}
+
+static bbox3f query_box(const CoverQuery &query)
+{
+  const vec3f pos = v_ldu(&query.pos.x);
+  const vec3f ext = v_make_vec4f(query.maxDist, query.maxHeightDiff, query.maxDist, 0.f);
+  bbox3f box;
+  box.bmin = v_sub(pos, ext);
+  box.bmax = v_add(pos, ext);
+  return box;
+}
+
+// scores candidates 4 at a time: each threat is tested against protection cones of 4 covers at once
+static bool score_covers(const CoversQueryData &data, dag::ConstSpan<int> candidates, const CoverQuery &query,
+  dag::ConstSpan<Point3> threats, dag::ConstSpan<uint32_t> occupied_bits, int max_count, Tab<CoverQueryResult> &out, int64_t reft,
+  int time_budget_usec)
+{
+  const int first = out.size();
+  const vec4f agentX = v_splats(query.pos.x), agentZ = v_splats(query.pos.z);
+  const vec4f maxDistSq = v_splats(sqr(query.maxDist));
+  const vec4f minThreatDistSq = v_splats(sqr(query.minThreatDist));
+  const vec4f minCovered = v_splats(query.minCoveredPart * threats.size() - 1e-3f);
+  const float invThreats = threats.empty() ? 0.f : 1.f / threats.size();
+  const float distScale = query.distWeight / max(query.maxDist, 1e-3f);
+  const vec4f coneCosSq = v_splats(sqr(data.coneCos));
+  const int count = candidates.size();
+  for (int i = 0, group = 0; i < count; i += 4, group++)
+  {
+    if (time_budget_usec > 0 && group % CHECK_TIME_EVERY_GROUPS == CHECK_TIME_EVERY_GROUPS - 1 &&
+        get_time_usec(reft) > time_budget_usec)
+      return false;
+
+    int idx[4];
+    for (int j = 0; j < 4; j++)
+      idx[j] = candidates[min(i + j, count - 1)];
+    vec4f x = data.posDir[idx[0]], z = data.posDir[idx[1]], dx = data.posDir[idx[2]], dz = data.posDir[idx[3]];
+    v_mat44_transpose(x, z, dx, dz);
+
+    const vec4f ax = v_sub(agentX, x), az = v_sub(agentZ, z);
+    const vec4f distSq = v_madd(ax, ax, v_mul(az, az));
+    vec4f valid = v_cmp_ge(maxDistSq, distSq);
+    vec4f covered = v_zero();
+    for (const Point3 &threat : threats)
+    {
+      const vec4f tx = v_sub(v_splats(threat.x), x), tz = v_sub(v_splats(threat.z), z);
+      const vec4f lenSq = v_madd(tx, tx, v_mul(tz, tz));
+      const vec4f dot = v_madd(tx, dx, v_mul(tz, dz));
+      // threat is in front of cover and inside of its cone: dot > 0 && dot^2 >= cos^2 * len^2
+      const vec4f inCone = v_and(v_cmp_gt(dot, v_zero()), v_cmp_ge(v_mul(dot, dot), v_mul(coneCosSq, lenSq)));
+      covered = v_add(covered, v_and(inCone, V_C_ONE));
+      valid = v_and(valid, v_cmp_ge(lenSq, minThreatDistSq));
+    }
+    valid = v_and(valid, v_cmp_ge(covered, minCovered));
+
+    const int mask = v_signmask(valid) & ((1 << min(4, count - i)) - 1);
+    if (!mask)
+      continue;
+    alignas(16) float coveredF[4], distF[4];
+    v_st(coveredF, covered);
+    v_st(distF, v_sqrt4(distSq));
+    for (int j = 0; j < 4; j++)
+      if ((mask & (1 << j)) && fabsf(data.posY[idx[j]] - query.pos.y) <= query.maxHeightDiff &&
+          !is_occupied(occupied_bits, idx[j]))
+        insert_result(out, first, max_count, idx[j], coveredF[j] * invThreats - distF[j] * distScale);
+  }
+  return true;
+}
+
+bool find_best_covers(const CoversQueryData &data, const scene::TiledScene &scene, const CoverQuery &query,
+  dag::ConstSpan<Point3> threats, dag::ConstSpan<uint32_t> occupied_bits, int max_count, Tab<CoverQueryResult> &out,
+  int time_budget_usec)
+{
+  out.clear();
+  if (max_count <= 0)
+    return true;
+  const int64_t reft = ref_time_ticks();
+  Tab<int> candidates(framemem_ptr());
+  gather_candidates(scene, query_box(query), candidates);
+  return score_covers(data, candidates, query, threats, occupied_bits, max_count, out, reft, time_budget_usec);
+}
+
+bool find_best_covers_batch(const CoversQueryData &data, const scene::TiledScene &scene, dag::ConstSpan<CoverQuery> queries,
+  dag::ConstSpan<Point3> threats, dag::ConstSpan<uint32_t> occupied_bits, int max_count, Tab<CoverQueryResult> &out,
+  Tab<int> &out_ofs, int time_budget_usec)
+{
+  out.clear();
+  out_ofs.resize(queries.size() + 1);
+  mem_set_0(out_ofs);
+  if (queries.empty() || max_count <= 0)
+    return true;
+
+  const int64_t reft = ref_time_ticks();
+  bbox3f box = query_box(queries[0]);
+  for (int i = 1; i < queries.size(); i++)
+    v_bbox3_add_box(box, query_box(queries[i]));
+  Tab<int> candidates(framemem_ptr());
+  gather_candidates(scene, box, candidates);
+
+  bool inTime = true;
+  for (int i = 0; i < queries.size(); i++)
+  {
+    if (inTime)
+      inTime = score_covers(data, candidates, queries[i], threats, occupied_bits, max_count, out, reft, time_budget_usec);
+    out_ofs[i + 1] = out.size();
+  }
+  return inTime;
+}
+} // namespace covers
@@ -0,0 +1,112 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <covers/covers.h>
+#include <math/dag_mathBase.h>
+#include <string.h>
+
+static covers::Cover make_cover(const Point3 &pos, const Point3 &dir)
+{
+  covers::Cover cover;
+  memset(&cover, 0, sizeof(cover));
+  const Point3 side = Point3(dir.z, 0.f, -dir.x) * 0.5f;
+  cover.dir = dir;
+  cover.groundLeft = pos - side;
+  cover.groundRight = pos + side;
+  cover.hLeft = cover.hRight = 1.f;
+  return cover;
+}
+
+// Covers along X axis with step 4m: even ones face +Z, odd ones face -Z
+struct CoversFixture
+{
+  static constexpr int COUNT = 21;
+  Tab<covers::Cover> list;
+  scene::TiledScene scene;
+  covers::CoversQueryData data;
+
+  CoversFixture()
+  {
+    for (int i = 0; i < COUNT; i++)
+      list.push_back(make_cover(Point3((i - COUNT / 2) * 4.f, 0.f, 0.f), Point3(0.f, 0.f, (i & 1) ? -1.f : 1.f)));
+    CHECK(covers::build(16.f, 4, list, scene));
+    covers::build_query_data(list, DegToRad(60.f), data);
+  }
+  static Point3 coverPos(int idx) { return Point3((idx - COUNT / 2) * 4.f, 0.f, 0.f); }
+  static bool facesThreats(int idx) { return !(idx & 1); }
+};
+
+TEST_FIXTURE(CoversFixture, BestCoversAreSortedAndFaceThreats)
+{
+  const Point3 threats[] = {Point3(0.f, 0.f, 30.f), Point3(6.f, 0.f, 28.f)};
+  covers::CoverQuery query;
+  query.pos = Point3(1.f, 0.f, -2.f);
+  Tab<covers::CoverQueryResult> out;
+  CHECK(covers::find_best_covers(data, scene, query, make_span_const(threats, 2), {}, 4, out));
+  CHECK_EQUAL(4, out.size());
+  for (int i = 0; i < out.size(); i++)
+  {
+    CHECK(facesThreats(out[i].coverIdx));
+    if (i > 0)
+      CHECK(out[i - 1].score >= out[i].score);
+  }
+  CHECK_EQUAL(COUNT / 2, out[0].coverIdx); // the nearest one facing threats, at (0, 0, 0)
+}
+
+TEST_FIXTURE(CoversFixture, QueryLimitsAreApplied)
+{
+  const Point3 threat(0.f, 0.f, 30.f);
+  covers::CoverQuery query;
+  query.maxDist = 10.f;
+  Tab<covers::CoverQueryResult> out;
+  CHECK(covers::find_best_covers(data, scene, query, make_span_const(&threat, 1), {}, COUNT, out));
+  CHECK_EQUAL(3, out.size()); // facing covers at x = -8, 0, 8
+  for (const covers::CoverQueryResult &res : out)
+    CHECK(length(coverPos(res.coverIdx)) <= query.maxDist);
+
+  // covers too close to threat are rejected
+  const Point3 nearThreat(0.f, 0.f, 3.f);
+  CHECK(covers::find_best_covers(data, scene, query, make_span_const(&nearThreat, 1), {}, COUNT, out));
+  for (const covers::CoverQueryResult &res : out)
+    CHECK(res.coverIdx != COUNT / 2);
+
+  // threat outside of protection cone of all covers
+  const Point3 sideThreat(100.f, 0.f, 1.f);
+  CHECK(covers::find_best_covers(data, scene, query, make_span_const(&sideThreat, 1), {}, COUNT, out));
+  CHECK_EQUAL(0, out.size());
+}
+
+TEST_FIXTURE(CoversFixture, OccupiedCoversAreSkipped)
+{
+  const Point3 threat(0.f, 0.f, 30.f);
+  covers::CoverQuery query;
+  uint32_t occupied[(COUNT + 31) / 32] = {};
+  occupied[0] |= 1u << (COUNT / 2);
+  Tab<covers::CoverQueryResult> out;
+  CHECK(covers::find_best_covers(data, scene, query, make_span_const(&threat, 1), make_span_const(occupied, 1), 1, out));
+  CHECK_EQUAL(1, out.size());
+  CHECK(out[0].coverIdx != COUNT / 2);
+  CHECK(facesThreats(out[0].coverIdx));
+}
+
+TEST_FIXTURE(CoversFixture, BatchMatchesSingleQueries)
+{
+  const Point3 threats[] = {Point3(-10.f, 0.f, 25.f), Point3(10.f, 0.f, 25.f)};
+  covers::CoverQuery queries[3];
+  queries[0].pos = Point3(-30.f, 0.f, -5.f);
+  queries[1].pos = Point3(0.f, 0.f, -5.f);
+  queries[2].pos = Point3(25.f, 0.f, -5.f);
+  queries[2].minCoveredPart = 0.5f;
+  Tab<covers::CoverQueryResult> batchOut, out;
+  Tab<int> ofs;
+  CHECK(covers::find_best_covers_batch(data, scene, make_span_const(queries, 3), make_span_const(threats, 2), {}, 3, batchOut, ofs));
+  CHECK_EQUAL(4, ofs.size());
+  for (int q = 0; q < 3; q++)
+  {
+    CHECK(covers::find_best_covers(data, scene, queries[q], make_span_const(threats, 2), {}, 3, out));
+    CHECK_EQUAL(out.size(), ofs[q + 1] - ofs[q]);
+    for (int i = 0; i < out.size() && ofs[q] + i < ofs[q + 1]; i++)
+    {
+      CHECK_EQUAL(out[i].coverIdx, batchOut[ofs[q] + i].coverIdx);
+      CHECK_CLOSE(out[i].score, batchOut[ofs[q] + i].score, 1e-6f);
+    }
+  }
+}
@@ -156,7 +156,7 @@ ObjectReplica *Connection::getReplicaByEid(ecs::EntityId eid)
   return repl;
 }
 
-ObjectReplica *Connection::addObjectInScope(Object &obj)
+ObjectReplica *Connection::addObjectInScope(Object &obj, float priority)
 {
   if (!isReplicatingFrom())
     return NULL;
@@ -164,6 +164,8 @@ ObjectReplica *Connection::addObjectInScope(Object &obj)
   if (repl)
   {
     repl->flags |= ObjectReplica::InScope;
+    repl->scopePriority = priority;
+    repl->priority = priority * obj.getReplicationPriority();
     return repl;
   }
   if (numReplicas >= MaxReplicas)
@@ -178,6 +180,9 @@ ObjectReplica *Connection::addObjectInScope(Object &obj)
   repl->eidStorage = (ecs::entity_id_t)obj.getEid();
   repl->cmp = uint32_t(MAX_OBJ_CREATION_SEQ - (lastCreationSeq++ & MAX_OBJ_CREATION_SEQ)) | // Inverted for reverse iteration
               (uint32_t(ObjectReplica::InScope | ObjectReplica::NotYetReplicated) << 24);   // Note: 'flags' is union with MSB of cmp
+  repl->scopePriority = priority;
+  repl->priority = priority * obj.getReplicationPriority();
+  repl->priorityAcc = 0.f;
   repl->remoteCompVers.assign(obj.compVers.begin(), obj.compVers.end());
 
   // attach to list of all replicas for this object
@@ -214,6 +219,7 @@ void Connection::pushToNonDirty(ObjectReplica *repl)
   G_ASSERT(replicas[repl->arrayIndex] == repl);
   G_ASSERT(repl->arrayIndex < numDirtyReplicas);
   G_ASSERT(!repl->isFree());
+  repl->priorityAcc = 0.f;
   numDirtyReplicas--;
   if (repl->arrayIndex != numDirtyReplicas)
   {
@@ -295,6 +301,8 @@ void Connection::setReplicatingFrom()
     rr.conn = this;
     rr.flags = ObjectReplica::Free;
     rr.gen = 0;
+    rr.scopePriority = rr.priority = 1.f;
+    rr.priorityAcc = 0.f;
     replicas[i] = &rr;
     i++;
   }
@@ -359,15 +367,24 @@ int Connection::prepareWritePackets()
       else if (repl->isNeedInitialUpdate())
         res |= PWR_CONSTRUCTION;
       else
+      {
+        repl->priorityAcc += repl->priority; // objects that didn't fit into budget gain priority until they are sent
         res |= PWR_REPLICATION;
+      }
     }
   }
 
   if (numDirtyReplicas > 1)
   {
     dag::Span<ObjectReplica *> dirtyReplicas(replicas.data(), numDirtyReplicas);
-    stlsort::sort_branchless(dirtyReplicas.begin(), dirtyReplicas.end(),
-      [](const ObjectReplica *a, const ObjectReplica *b) { return a->cmp < b->cmp; });
+    // Creation/destruction goes first in creation order (its flags are above any replication-only ones in 'cmp'), all replication
+    // (regardless of AlwaysInScope) is ordered by accumulated priority, so that budget is never taken by one group of objects only
+    stlsort::sort_branchless(dirtyReplicas.begin(), dirtyReplicas.end(), [](const ObjectReplica *a, const ObjectReplica *b) {
+      constexpr uint8_t ctorDtorFlags = ObjectReplica::NotYetReplicated | ObjectReplica::ToKill;
+      if (!((a->flags | b->flags) & ctorDtorFlags) && a->priorityAcc != b->priorityAcc)
+        return a->priorityAcc < b->priorityAcc;
+      return a->cmp < b->cmp;
+    });
     int ai = 0;
     for (ObjectReplica *repl : dirtyReplicas)
       repl->arrayIndex = ai++;
@@ -389,20 +389,25 @@ void CNetwork::syncStateUpdates(int cur_time, uint8_t replication_channel)
       bs.ResetWritePointer();
       bs.Write((char)ID_ENTITY_REPLICATION);
       bs.Write(cur_time); // for RTT calculations, TODO: 16 bit
+      const int replBudget = conn->replicationBudgetBytes;
+      int replBytesSent = 0;
       int iterGuard = 0;
       do
       {
         G_ASSERT(iterGuard++ < (16 << 10));
         G_UNUSED(iterGuard);
         bs.SetWriteOffset(BYTES_TO_BITS(headerSize));
-        if (!conn->writeReplicationPacket(bs, tmpBs, limitReplBytes)) // limit replication packet size to MTU
+        // limit replication packet size to MTU and to what is left of budget, otherwise budget less than MTU is never reached
+        const int limitBytes = replBudget ? eastl::min<int>(limitReplBytes, headerSize + replBudget - replBytesSent) : limitReplBytes;
+        if (!conn->writeReplicationPacket(bs, tmpBs, limitBytes))
           break;
         const uint32_t threshold = DEFAULT_COMPRESSION_THRESHOLD;
         const uint8_t ptype = ID_ENTITY_REPLICATION_COMPRESSED;
         const danet::BitStream &bsToSend = bitstream_compress(bs, headerSize, ptype, bsCompressed, threshold);
         TRACE_NET_STAT(tx, str_msg_ids[ID_ENTITY_REPLICATION - ID_MSG_BASE], bs, bsToSend, conn);
         conn->sendAckedPacket(bsToSend, cur_time, connTimeout, replication_channel);
-      } while (1);
+        replBytesSent += (int)bsToSend.GetNumberOfBytesUsed();
+      } while (!replBudget || replBytesSent < replBudget);
     }
   }
 }
@@ -216,6 +216,13 @@ void Object::initCompVers()
     repl->debugVerifyRemoteCompVers(compVers);
 }
 
+void Object::setReplicationPriority(float priority)
+{
+  replicationPriority = priority;
+  for (ObjectReplica *repl = replicasLinkList; repl; repl = repl->nextRepl)
+    repl->priority = repl->scopePriority * priority;
+}
+
 void Object::forceReplicaVersion(CompVersMap::const_iterator cit, ecs::component_index_t cidx, ObjectReplica *replica) const
 {
   if (cit != compVers.end() && cit->first == cidx) // just force correct remoteCompVer
@@ -37,6 +37,10 @@ struct ObjectReplica
     };
   };
 
+  float scopePriority; // relevance for connection as given by scope query (distance, tags, etc...), 1 by default
+  float priority;      // 'scopePriority' multiplied by priority of object itself
+  float priorityAcc;   // 'priority' accumulated on each update while replica stays dirty, reset when it's sent
+
   ecs::entity_id_t eidStorage; // entity_id instead of EntityId to avoid init by default
   Connection *conn;
   CompVersMap remoteCompVers;         // remote versions of all components for this object (from server's POV)
@@ -91,6 +91,35 @@ static ecs::EntitySystemDesc replication_es_event_handler_es_desc
   ecs::EventSetBuilder<ecs::EventEntityRecreated>::build(),
   0
 ,"net,server");
+static constexpr ecs::ComponentDesc replication_priority_es_event_handler_comps[] =
+{
+//start of 1 rw components at [0]
+  {ECS_HASH("replication"), ecs::ComponentTypeInfo<net::Object>()},
+//start of 1 ro components at [1]
+  {ECS_HASH("replication__priority"), ecs::ComponentTypeInfo<float>()}
+};
+static void replication_priority_es_event_handler_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
+{
+  auto comp = components.begin(), compE = components.end(); G_ASSERT(comp!=compE); do
+    net::replication_priority_es_event_handler(evt
+        , ECS_RW_COMP(replication_priority_es_event_handler_comps, "replication", net::Object)
+    , ECS_RO_COMP(replication_priority_es_event_handler_comps, "replication__priority", float)
+    );
+  while (++comp != compE);
+}
+static ecs::EntitySystemDesc replication_priority_es_event_handler_es_desc
+(
+  "replication_priority_es",
+  "prog/gameLibs/daECS/net/replicationES.cpp.inl",
+  ecs::EntitySystemOps(nullptr, replication_priority_es_event_handler_all_events),
+  make_span(replication_priority_es_event_handler_comps+0, 1)/*rw*/,
+  make_span(replication_priority_es_event_handler_comps+1, 1)/*ro*/,
+  empty_span(),
+  empty_span(),
+  ecs::EventSetBuilder<ecs::EventEntityCreated,
+                       ecs::EventComponentsAppear>::build(),
+  0
+,"net,server","replication__priority");
 static constexpr ecs::ComponentDesc replication_validation_es_event_handler_comps[] =
 {
 //start of 1 rw components at [0]
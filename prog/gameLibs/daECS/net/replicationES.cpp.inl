@@ -1,6 +1,7 @@
 #include <daECS/net/object.h>
 #include <daECS/net/compBlacklist.h>
 #include <daECS/core/entityManager.h>
+#include <daECS/core/componentTypes.h>
 #include <daECS/core/entitySystem.h>
 #include <daECS/core/coreEvents.h>
 
@@ -53,6 +54,14 @@ inline void replication_es_event_handler(const ecs::EventEntityRecreated &, net:
     replication.addToDirty();
 }
 
+ECS_TAG(server, net)
+ECS_ON_EVENT(on_appear)
+ECS_TRACK(replication__priority)
+inline void replication_priority_es_event_handler(const ecs::Event &, net::Object &replication, float replication__priority)
+{
+  replication.setReplicationPriority(replication__priority);
+}
+
 ECS_TAG(netClient, dev)
 ECS_ON_EVENT(on_appear)
 inline void replication_validation_es_event_handler(const ecs::Event &, net::Object &replication)
@@ -0,0 +1,126 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <daECS/core/entityManager.h>
+#include <daECS/core/componentTypes.h>
+#include <daECS/core/template.h>
+#include <daECS/net/object.h>
+#include <daECS/net/connection.h>
+#include <daNet/bitStream.h>
+#include <EASTL/vector.h>
+#include <EASTL/algorithm.h>
+#include "../objectReplica.h"
+
+namespace net
+{
+void server_replication_cb(ecs::EntityId eid, ecs::component_index_t cidx); // replicationES.cpp.inl
+}
+
+// Server side of loopback: packets are acked immediately (as for replay), nothing is actually sent
+class LoopbackConnection final : public net::Connection
+{
+public:
+  LoopbackConnection() : net::Connection(net::ConnectionId(0)) { setReplicatingFrom(); }
+  bool send(int, const danet::BitStream &, PacketPriority, PacketReliability, uint8_t, int) override { return true; }
+  bool isBlackHole() const override { return true; }
+  int getMTU() const override { return 1200; }
+  danet::PeerQoSStat getPeerQoSStat() const override { return danet::PeerQoSStat{}; }
+  uint32_t getIP() const override { return 0; }
+  const char *getIPStr() const override { return "loopback"; }
+  bool isResponsive() const override { return true; }
+};
+
+static void add_test_template(const char *name, float priority)
+{
+  ecs::ComponentsMap map;
+  map[ECS_HASH("replication")] = ecs::ChildComponent();
+  map[ECS_HASH("replication__priority")] = priority;
+  map[ECS_HASH("test__counter")] = 0;
+  ecs::Template::component_set tracked, replicated;
+  tracked.insert(ECS_HASH("test__counter").hash);
+  replicated.insert(ECS_HASH("test__counter").hash);
+  g_entity_mgr->addTemplate(
+    ecs::Template(name, eastl::move(map), eastl::move(tracked), eastl::move(replicated), ecs::Template::component_set(), false));
+}
+
+// Same as CNetwork::syncStateUpdates() for one connection, returns false if nothing was sent
+static bool sync_state_updates(net::Connection &conn, int cur_time, int repl_budget)
+{
+  net::Connection::collapseDirtyObjects();
+  int pwrRes = conn.prepareWritePackets();
+  danet::BitStream bs, tmpBs;
+  if (pwrRes & net::Connection::PWR_CONSTRUCTION)
+    for (bs.ResetWritePointer(); conn.writeConstructionPacket(bs, tmpBs, 64 << 10); bs.ResetWritePointer())
+      ;
+  if (!(pwrRes & net::Connection::PWR_REPLICATION))
+    return pwrRes != net::Connection::PWR_NONE;
+  int replBytesSent = 0;
+  do
+  {
+    bs.ResetWritePointer();
+    if (!conn.writeReplicationPacket(bs, tmpBs, eastl::min(conn.getMTU(), repl_budget - replBytesSent)))
+      break;
+    conn.sendAckedPacket(bs, cur_time, 1000, 0);
+    replBytesSent += (int)bs.GetNumberOfBytesUsed();
+  } while (replBytesSent < repl_budget);
+  return true;
+}
+
+// Synthetic population: near objects (high scope priority), far ones (low scope priority) and objects always in scope with low
+// priority of their own. Budget allows to send only small part of objects on each update.
+TEST(ReplicationPriorityBudget)
+{
+  g_entity_mgr.demandInit();
+  g_entity_mgr->setEidsReservationMode(true);
+  g_entity_mgr->setReplicationCb(net::server_replication_cb);
+
+  add_test_template("repl_test_normal", 1.f);
+  add_test_template("repl_test_always", 0.25f);
+
+  constexpr int NEAR_COUNT = 64, FAR_COUNT = 128, ALWAYS_COUNT = 64, TICKS = 200, BUDGET_BYTES = 256;
+  constexpr float NEAR_PRIORITY = 4.f, FAR_PRIORITY = 1.f;
+  eastl::vector<ecs::EntityId> eids;
+  for (int i = 0; i < NEAR_COUNT + FAR_COUNT; ++i)
+    eids.push_back(g_entity_mgr->createEntitySync("repl_test_normal"));
+  for (int i = 0; i < ALWAYS_COUNT; ++i)
+    eids.push_back(g_entity_mgr->createEntitySync("repl_test_always"));
+
+  LoopbackConnection conn;
+  for (int i = 0; i < NEAR_COUNT + FAR_COUNT; ++i)
+    CHECK(conn.addObjectInScope(*net::Object::getByEid(eids[i]), i < NEAR_COUNT ? NEAR_PRIORITY : FAR_PRIORITY) != nullptr);
+  for (int i = NEAR_COUNT + FAR_COUNT; i < eids.size(); ++i)
+    CHECK(conn.setObjectInScopeAlways(*net::Object::getByEid(eids[i])) != ecs::ECS_INVALID_ENTITY_ID_VAL);
+
+  CHECK(sync_state_updates(conn, 0, BUDGET_BYTES)); // creation of all objects
+
+  eastl::vector<int> sentCount(eids.size(), 0);
+  for (int tick = 1; tick <= TICKS; ++tick)
+  {
+    for (ecs::EntityId eid : eids)
+      g_entity_mgr->set(eid, ECS_HASH("test__counter"), tick);
+    g_entity_mgr->performTrackChanges(true);
+    CHECK(sync_state_updates(conn, tick * 33, BUDGET_BYTES));
+    for (int i = 0; i < eids.size(); ++i)
+    {
+      const net::ObjectReplica *repl = conn.getReplicaByEid(eids[i]);
+      CHECK(repl != nullptr);
+      if (repl && repl->priorityAcc == 0.f) // accumulated priority is reset only when replica is sent
+        sentCount[i]++;
+    }
+  }
+
+  auto avgSent = [&](int from, int count) {
+    int sum = 0;
+    for (int i = from; i < from + count; ++i)
+      sum += sentCount[i];
+    return float(sum) / count;
+  };
+  const float nearAvg = avgSent(0, NEAR_COUNT), farAvg = avgSent(NEAR_COUNT, FAR_COUNT),
+              alwaysAvg = avgSent(NEAR_COUNT + FAR_COUNT, ALWAYS_COUNT);
+  CHECK(*eastl::min_element(sentCount.begin(), sentCount.end()) > 0); // no object starves
+  CHECK(nearAvg < TICKS);                                              // budget is actually limiting
+  CHECK(nearAvg > farAvg * 2.f);
+  CHECK(farAvg > alwaysAvg * 2.f); // objects always in scope don't take budget first
+
+  for (ecs::EntityId eid : eids)
+    g_entity_mgr->destroyEntity(eid);
+  g_entity_mgr->tick(true);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <daNet/bitStream.h>
+
+namespace danet
+{
+
+// collects bits in order they go to stream and writes them at once
+struct BitPacker
+{
+  static constexpr uint32_t MAX_BITS = 56; // with unaligned start all touched bytes fit in 64 bits
+
+  uint64_t acc = 0;
+  uint32_t numBits = 0;
+
+  // WriteBits() takes whole bytes of input (from high bit) and then low bits of the last byte,
+  // val is reordered the same way to be appended to already collected bits
+  static uint32_t toStreamOrder(uint32_t val, uint32_t bits)
+  {
+    if (bits <= 8)
+      return val & ((1u << bits) - 1);
+    uint32_t r = 0;
+    for (; bits >= 8; bits -= 8, val >>= 8)
+      r = (r << 8) | (val & 0xff);
+    return bits ? (r << bits) | (val & ((1u << bits) - 1)) : r;
+  }
+
+  void put(BitStream &bs, uint32_t val, uint32_t bits) // bits <= 32
+  {
+    if (numBits + bits > MAX_BITS)
+      flush(bs);
+    acc = (acc << bits) | toStreamOrder(val, bits);
+    numBits += bits;
+  }
+
+  // same result as WriteBits(): stream bits go from high to low bit of each byte, bits after written ones are kept
+  void flush(BitStream &bs)
+  {
+    if (!numBits)
+      return;
+    const uint32_t pos = bs.GetWriteOffset();
+    bs.reserveBits(numBits);
+    uint8_t *dest = bs.GetData() + (pos >> 3);
+    const uint32_t totalBits = (pos & 7) + numBits;
+    const uint32_t bytes = (totalBits + 7) >> 3;
+    uint64_t word = 0;
+    for (uint32_t i = 0; i < bytes; ++i)
+      word = (word << 8) | dest[i];
+    const uint32_t shift = bytes * 8 - totalBits;
+    word = (word & ~(((uint64_t(1) << numBits) - 1) << shift)) | (acc << shift);
+    for (uint32_t i = bytes; i > 0; --i, word >>= 8)
+      dest[i - 1] = uint8_t(word);
+    bs.SetWriteOffset(pos + numBits);
+    acc = 0;
+    numBits = 0;
+  }
+};
+
+} // namespace danet
@@ -6,6 +6,7 @@
 #include <debug/dag_assert.h>
 
 #include "sizeCoder.h"
+#include "bitPacker.h"
 
 namespace danet
 {
@@ -132,8 +133,10 @@ void IdFieldSerializer255::writeFieldsIndex(BitStream &to, BitSize_t at) const
   Index countToWrite = currWrId | (bitsPerIdToWrite << BITS_PER_COUNT);
   to.Write(countToWrite);
   to.SetWriteOffset(endBody);
+  BitPacker packer;
   for (Index j = 0; j < currWrId; ++j)
-    to.WriteBits(reinterpret_cast<const uint8_t *>(&indices[j]), bitsPerIdToWrite);
+    packer.put(to, indices[j], bitsPerIdToWrite);
+  packer.flush(to);
 }
 
 inline static BitSize_t alingedToByte(BitSize_t count) { return count + 8 - (((count - 1) & 7) + 1); }
@@ -175,11 +178,18 @@ void IdFieldSerializer255::writeFieldsSize(BitStream &to, BitSize_t at) const
   to.AlignWriteToByteBoundary();
   BitSize_t offset = BITS_TO_BYTES(to.GetWriteOffset() - at);
   G_ASSERT(offset <= USHRT_MAX);
+  BitPacker packer; // same bits as writeSize() for each field, but headers are written in batches
   for (Index j = 0; j < currWrSz; ++j)
   {
     G_ASSERT(sizes[j]);
-    writeSize(to, sizes[j]);
+    const uint8_t hdr = getSizeHeader(sizes[j]);
+    packer.put(to, hdr, 3);
+    if (hdr)
+      continue;
+    packer.flush(to);
+    to.WriteCompressed(sizes[j]);
   }
+  packer.flush(to);
   to.AlignWriteToByteBoundary();
   BitSize_t end = to.GetWriteOffset();
   to.SetWriteOffset(at);
@@ -1,5 +1,6 @@
 #include <daNet/reflection.h>
 #include <daNet/idFieldSerializer.h>
+#include "bitPacker.h"
 #include <math/dag_TMatrix.h>
 #include <math/dag_Quat.h>
 #include <util/dag_string.h>
@@ -7,6 +8,9 @@
 #include <debug/dag_debug.h>
 #include <math/dag_adjpow2.h>
 #include <util/dag_stlqsort.h>
+#include <util/dag_hash.h>
+#include <generic/dag_tab.h>
+#include <EASTL/unique_ptr.h>
 
 #define LOGLEVEL_DEBUG _MAKE4C('DNET')
 
@@ -92,6 +96,9 @@ void on_reflection_var_changed(danet::ReflectionVarMeta *meta, danet::Reflectabl
 static void writeIntBits(danet::BitStream &bs, uint32_t val, uint32_t numBits);
 static bool readIntBits(danet::BitStream &bs, uint32_t &retVal, uint32_t numBits);
 
+static inline uint32_t quantize_norm_float(float normVal, uint32_t numBits) { return (uint32_t)(float((1 << numBits) - 1) * normVal); }
+static inline float norm_float_min_max(float val, float min_, float max_) { return safediv(clamp(val, min_, max_) - min_, max_ - min_); }
+
 void ReflectableObject::markVarWithFlag(ReflectionVarMeta *var, uint16_t f, bool set)
 {
   checkWatermark();
@@ -109,6 +116,191 @@ void ReflectableObject::markVarWithFlag(ReflectionVarMeta *var, uint16_t f, bool
     var->flags &= ~f;
 }
 
+// Per class encode plan: one entry per var (in varList order) with coder kind and bit width resolved once.
+// Vars with known default coders are encoded inline and adjacent ones are packed into single WriteBits() call,
+// output is bit exact with calling coders one by one. Var which coder, bits or format flags differ from plan
+// (changed at runtime) is written with its coder.
+enum EncodeKind : uint8_t
+{
+  EK_CODER,         // call meta->coder
+  EK_RAW_BITS,      // first encodedBits of value as is (ints, raw floats and vectors)
+  EK_NORM_FLOAT,    // default_float_coder with RVF_NORMALIZED
+  EK_MIN_MAX_FLOAT, // default_float_coder with RVF_MIN_MAX_SPECIFIED
+  EK_NORM_FVEC,     // default_fvec_coder with RVF_NORMALIZED, 16 bits per component
+};
+
+static constexpr uint16_t ENCODE_FORMAT_FLAGS = RVF_NORMALIZED | RVF_UNSIGNED | RVF_MIN_MAX_SPECIFIED;
+
+struct EncodePlanEntry
+{
+  reflection_var_encoder coder;
+  uint16_t numBits;
+  uint16_t formatFlags;
+  uint16_t encodedBits;
+  uint8_t kind;
+
+  bool isValidFor(const ReflectionVarMeta *v) const
+  {
+    return kind != EK_CODER && v->coder == coder && v->numBits == numBits && (v->flags & ENCODE_FORMAT_FLAGS) == formatFlags;
+  }
+};
+
+struct ReflectionEncodePlan
+{
+  uint32_t hash;
+  Tab<EncodePlanEntry> entries;
+};
+
+static WinCritSec encode_plans_critical_section;
+static Tab<eastl::unique_ptr<ReflectionEncodePlan>> encode_plans; // one per distinct vars layout, never freed
+
+static uint32_t get_raw_coder_bits(reflection_var_encoder coder)
+{
+  static const struct
+  {
+    reflection_var_encoder coder;
+    uint32_t bits;
+  } rawCoders[] = {
+    {&readwrite_var_raw<int>, BYTES_TO_BITS(sizeof(int))},
+    {&readwrite_var_raw<uint32_t>, BYTES_TO_BITS(sizeof(uint32_t))},
+    {&readwrite_var_raw<float>, BYTES_TO_BITS(sizeof(float))},
+    {&readwrite_var_raw<short>, BYTES_TO_BITS(sizeof(short))},
+    {&readwrite_var_raw<uint16_t>, BYTES_TO_BITS(sizeof(uint16_t))},
+    {&readwrite_var_raw<char>, BYTES_TO_BITS(sizeof(char))},
+    {&readwrite_var_raw<uint8_t>, BYTES_TO_BITS(sizeof(uint8_t))},
+  };
+  for (const auto &rc : rawCoders)
+    if (rc.coder == coder)
+      return rc.bits;
+  return 0;
+}
+
+static void build_plan_entry(const ReflectionVarMeta *v, EncodePlanEntry &e)
+{
+  memset(&e, 0, sizeof(e)); // entries are hashed and compared as memory
+  e.coder = v->coder;
+  e.numBits = v->numBits;
+  e.formatFlags = v->flags & ENCODE_FORMAT_FLAGS;
+  e.kind = EK_CODER;
+  const uint32_t numBits = v->numBits;
+  if (v->coder == &default_int_coder)
+  {
+    e.kind = EK_RAW_BITS;
+    e.encodedBits = min(numBits, (uint32_t)BYTES_TO_BITS(sizeof(int)));
+  }
+  else if (v->coder == &default_float_coder)
+  {
+    const uint32_t floatBits = numBits ? numBits : BYTES_TO_BITS(sizeof(short));
+    if (floatBits >= BYTES_TO_BITS(sizeof(float)) || !(e.formatFlags & (RVF_MIN_MAX_SPECIFIED | RVF_NORMALIZED)))
+    {
+      e.kind = EK_RAW_BITS;
+      e.encodedBits = BYTES_TO_BITS(sizeof(float));
+    }
+    else
+    {
+      e.kind = (e.formatFlags & RVF_MIN_MAX_SPECIFIED) ? EK_MIN_MAX_FLOAT : EK_NORM_FLOAT;
+      e.encodedBits = floatBits;
+    }
+  }
+  else if (v->coder == &default_fvec_coder)
+  {
+    const uint32_t numBytes = BITS_TO_BYTES(numBits);
+    if (numBytes >= sizeof(Point2) && numBytes <= sizeof(Point4))
+    {
+      e.kind = (e.formatFlags & RVF_NORMALIZED) ? EK_NORM_FVEC : EK_RAW_BITS;
+      e.encodedBits = (e.formatFlags & RVF_NORMALIZED) ? BYTES_TO_BITS(sizeof(short)) * (numBytes / sizeof(float)) : numBits;
+    }
+  }
+  else
+  {
+    e.kind = EK_RAW_BITS;
+    e.encodedBits = get_raw_coder_bits(v->coder);
+  }
+  if (!e.encodedBits)
+    e.kind = EK_CODER;
+}
+
+const ReflectionEncodePlan *ReflectableObject::getEncodePlan()
+{
+  if (encodePlan)
+    return encodePlan;
+  Tab<EncodePlanEntry> entries;
+  for (const ReflectionVarMeta *v = varList.head; v; v = v->next)
+    build_plan_entry(v, entries.push_back());
+  const uint32_t hash = mem_hash_fnv1<32>((const char *)entries.data(), data_size(entries));
+
+  WinAutoLock l(encode_plans_critical_section);
+  for (const eastl::unique_ptr<ReflectionEncodePlan> &plan : encode_plans)
+    if (plan->hash == hash && plan->entries.size() == entries.size() &&
+        memcmp(plan->entries.data(), entries.data(), data_size(entries)) == 0)
+      return encodePlan = plan.get();
+  ReflectionEncodePlan *plan = encode_plans.emplace_back(eastl::make_unique<ReflectionEncodePlan>()).get();
+  plan->hash = hash;
+  plan->entries = eastl::move(entries);
+  return encodePlan = plan;
+}
+
+static inline uint16_t quantize_snorm16(float v) { return (uint16_t)(short)clamp(v * 32767.f, -32767.f, 32767.f); }
+
+static void encode_planned_var(const EncodePlanEntry &e, const ReflectionVarMeta *v, BitStream &bs, BitPacker &packer)
+{
+  const uint32_t bits = e.encodedBits;
+  switch (e.kind)
+  {
+    case EK_RAW_BITS:
+      if (bits > 32)
+      {
+        packer.flush(bs);
+        bs.WriteBits(&v->getValue<uint8_t>(), bits);
+      }
+      else if (bits <= 8)
+        packer.put(bs, v->getValue<uint8_t>(), bits);
+      else if (bits <= 16)
+        packer.put(bs, v->getValue<uint16_t>(), bits);
+      else // only 4 byte types are encoded with more than 16 bits
+        packer.put(bs, v->getValue<uint32_t>(), bits);
+      break;
+    case EK_NORM_FLOAT:
+    {
+      const float fval = v->getValue<float>();
+      G_ASSERT(fabsf(fval) < 1.000001f);
+      G_ASSERT(!(e.formatFlags & RVF_UNSIGNED) || fval >= 0.f);
+      const float nval = (e.formatFlags & RVF_UNSIGNED) ? fval : (fval + 1.f) * 0.5f;
+      packer.put(bs, quantize_norm_float(nval, bits), bits);
+      break;
+    }
+    case EK_MIN_MAX_FLOAT:
+    {
+      const float *fa = &v->getValue<float>(); // [value, min, max]
+      packer.put(bs, quantize_norm_float(norm_float_min_max(fa[0], fa[1], fa[2]), bits), bits);
+      break;
+    }
+    case EK_NORM_FVEC:
+    {
+      const float *p = &v->getValue<float>();
+      for (uint32_t i = 0, n = bits / 16; i < n; ++i)
+        packer.put(bs, quantize_snorm16(p[i]), 16);
+      break;
+    }
+    default: G_ASSERT(0);
+  }
+}
+
+static inline bool need_serialize_var(uint16_t var_flags, uint16_t flags_to_have, bool fth_all, uint16_t flags_to_ignore, bool fti_all)
+{
+  if (var_flags & RVF_EXCLUDED)
+    return false;
+
+  const bool allIgnoreFlagsExists = flags_to_ignore && (var_flags & flags_to_ignore) == flags_to_ignore;
+  const bool anyIgnoreFlagsExists = (var_flags & flags_to_ignore) != 0;
+  if (fti_all ? allIgnoreFlagsExists : anyIgnoreFlagsExists)
+    return false;
+
+  const bool allFlagsExists = (var_flags & flags_to_have) == flags_to_have;
+  const bool anyFlagsExists = (var_flags & flags_to_have) != 0;
+  return !flags_to_have || (fth_all ? allFlagsExists : anyFlagsExists);
+}
+
 int ReflectableObject::serialize(BitStream &bs, uint16_t flags_to_have, bool fth_all, uint16_t flags_to_ignore, bool fti_all,
   bool do_reset_changed_flag)
 {
@@ -120,28 +312,20 @@ int ReflectableObject::serialize(BitStream &bs, uint16_t flags_to_have, bool fth
   G_ASSERT(flags_to_have || fth_all);
 
   ReflectionVarMeta *varsToWrite[DANET_REFLECTION_MAX_VARS_PER_OBJECT];
-  G_STATIC_ASSERT(sizeof(varsToWrite) <= 4096); // to much stack?
+  uint16_t varsPlanIdx[DANET_REFLECTION_MAX_VARS_PER_OBJECT];
+  G_STATIC_ASSERT(sizeof(varsToWrite) + sizeof(varsPlanIdx) <= 4096); // to much stack?
   G_STATIC_ASSERT(DANET_REFLECTION_MAX_VARS_PER_OBJECT <= IdFieldSerializer255::MAX_FIELDS_NUM);
+  const ReflectionEncodePlan *plan = (option_flags & NO_REFLECTION_ENCODE_PLAN) ? NULL : getEncodePlan();
 
   BitSize_t data_size_pos = ~0u;
   // first pass - fill in indexes only
   BitSize_t numVarsPos = 0;
   uint32_t numSerializedVars = 0; // in current reflectable
   IdFieldSerializer255 idFieldSerializer;
-  for (ReflectionVarMeta *v = varList.head; v; v = v->next)
+  int varIdx = 0;
+  for (ReflectionVarMeta *v = varList.head; v; v = v->next, ++varIdx)
   {
-    if (v->flags & RVF_EXCLUDED)
-      continue;
-
-    const bool allIgnoreFlagsExists = flags_to_ignore && (v->flags & flags_to_ignore) == flags_to_ignore;
-    const bool anyIgnoreFlagsExists = (v->flags & flags_to_ignore) != 0;
-    if (fti_all ? allIgnoreFlagsExists : anyIgnoreFlagsExists)
-      continue;
-
-    const bool allFlagsExists = (v->flags & flags_to_have) == flags_to_have;
-    const bool anyFlagsExists = (v->flags & flags_to_have) != 0;
-
-    if (!flags_to_have || (fth_all ? allFlagsExists : anyFlagsExists))
+    if (need_serialize_var(v->flags, flags_to_have, fth_all, flags_to_ignore, fti_all))
     {
       if (numSerializedVars == 0) // write header on first var write
       {
@@ -154,6 +338,7 @@ int ReflectableObject::serialize(BitStream &bs, uint16_t flags_to_have, bool fth
       }
 
       idFieldSerializer.setFieldId(v->persistentId);
+      varsPlanIdx[numSerializedVars] = varIdx;
       varsToWrite[numSerializedVars++] = v;
     }
   }
@@ -164,19 +349,32 @@ int ReflectableObject::serialize(BitStream &bs, uint16_t flags_to_have, bool fth
     G_ASSERT(data_size_pos != ~0u);
 
     // second pass - write var data
+    BitPacker packer;
     for (int i = 0; i < numSerializedVars; ++i)
     {
       ReflectionVarMeta *v = varsToWrite[i];
       G_ASSERT(v->coder);
 #if DEBUG_BORDERS_REFLECTION
+      packer.flush(bs);
       bs.Write((uint8_t)117);
 #endif
-      BitSize_t pos_before_write = bs.GetWriteOffset();
-      (*v->coder)(DANET_REFLECTION_OP_ENCODE, v, this, &bs);
-      BitSize_t pos_after_write = bs.GetWriteOffset();
-      G_ASSERTF(pos_after_write > pos_before_write, "%s in object '%s' var coder 0x%p for var '%s' (0x%p) did not writed any data",
-        __FUNCTION__, getClassName(), (void *)v->coder, v->getVarName(), v);
-      idFieldSerializer.setFieldSize(pos_after_write - pos_before_write);
+      const EncodePlanEntry *planned = (plan && varsPlanIdx[i] < plan->entries.size()) ? &plan->entries[varsPlanIdx[i]] : NULL;
+      if (planned && planned->isValidFor(v))
+      {
+        encode_planned_var(*planned, v, bs, packer);
+        idFieldSerializer.setFieldSize(planned->encodedBits);
+      }
+      else
+      {
+        packer.flush(bs);
+        BitSize_t pos_before_write = bs.GetWriteOffset();
+        (*v->coder)(DANET_REFLECTION_OP_ENCODE, v, this, &bs);
+        BitSize_t pos_after_write = bs.GetWriteOffset();
+        G_ASSERTF(pos_after_write > pos_before_write,
+          "%s in object '%s' var coder 0x%p for var '%s' (0x%p) did not writed any data", __FUNCTION__, getClassName(),
+          (void *)v->coder, v->getVarName(), v);
+        idFieldSerializer.setFieldSize(pos_after_write - pos_before_write);
+      }
 
 #if DAGOR_DBGLEVEL > 0
       if ((option_flags & DUMP_REFLECTION) || (v->flags & RVF_DEBUG) || (reflectionFlags & DEBUG_REFLECTION))
@@ -185,11 +383,13 @@ int ReflectableObject::serialize(BitStream &bs, uint16_t flags_to_have, bool fth
 #endif
 
 #if DEBUG_BORDERS_REFLECTION
+      packer.flush(bs);
       bs.Write((uint8_t)118);
 #endif
       if (do_reset_changed_flag)
         v->flags &= ~RVF_CHANGED;
     }
+    packer.flush(bs);
 
     // third pass - write var ids and var data sizes
     idFieldSerializer.writeFieldsIndex(bs, numVarsPos);
@@ -661,7 +861,7 @@ static void writeIntBits(danet::BitStream &bs, uint32_t val, uint32_t numBits) {
 static void writeNormFloat(danet::BitStream &bs, float normVal, uint32_t numBits)
 {
   G_ASSERT(fabsf(normVal) < 1.000001f);
-  writeIntBits(bs, (uint32_t)(float((1 << numBits) - 1) * normVal), numBits);
+  writeIntBits(bs, quantize_norm_float(normVal, numBits), numBits);
 }
 
 static bool readIntBits(danet::BitStream &bs, uint32_t &retVal, uint32_t numBits)
@@ -713,7 +913,7 @@ int default_int_coder(DANET_ENCODER_SIGNATURE)
 
 static void writeFloatMinMax(danet::BitStream &bs, float val, float min_, float max_, uint32_t numBits)
 {
-  writeNormFloat(bs, safediv(clamp(val, min_, max_) - min_, max_ - min_), numBits);
+  writeNormFloat(bs, norm_float_min_max(val, min_, max_), numBits);
 }
 
 static bool readFloatMinMax(danet::BitStream &bs, float &val, float min_, float max_, uint32_t numBits)
@@ -8,36 +8,25 @@
 namespace danet
 {
 
-void writeSize(BitStream &to, uint32_t size_in_bits)
+uint8_t getSizeHeader(uint32_t size_in_bits)
 {
-  G_ASSERT(size_in_bits);
-  uint8_t hdr = 0;
-
   switch (size_in_bits)
   {
-    case 1:
-      hdr = 1; // 1 bit
-      break;
-    case 8:
-      hdr = 2; // 1 byte
-      break;
-    case 16:
-      hdr = 3; // 2 bytes
-      break;
-    case 32:
-      hdr = 4; // 4 bytes
-      break;
-    case 64:
-      hdr = 5; // 8 bytes
-      break;
-    case 96:
-      hdr = 6; // 12 bytes
-      break;
-    case 128:
-      hdr = 7; // 16 bytes
-      break;
-    default: hdr = 0; // var int bits
+    case 1: return 1;   // 1 bit
+    case 8: return 2;   // 1 byte
+    case 16: return 3;  // 2 bytes
+    case 32: return 4;  // 4 bytes
+    case 64: return 5;  // 8 bytes
+    case 96: return 6;  // 12 bytes
+    case 128: return 7; // 16 bytes
+    default: return 0;  // var int bits
   }
+}
+
+void writeSize(BitStream &to, uint32_t size_in_bits)
+{
+  G_ASSERT(size_in_bits);
+  uint8_t hdr = getSizeHeader(size_in_bits);
 
   to.WriteBits(&hdr, 3);
   if (hdr > 0)
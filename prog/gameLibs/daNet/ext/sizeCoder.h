@@ -8,6 +8,7 @@ namespace danet
 
 class BitStream;
 
+uint8_t getSizeHeader(uint32_t size_in_bits); // 3 bits written by writeSize(), 0 - compressed size follows
 void writeSize(BitStream &to, uint32_t size_in_bits);
 uint32_t readSize(const BitStream &from);
 
@@ -0,0 +1,135 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <daNet/reflection.h>
+#include <math/dag_TMatrix.h>
+#include <math/random/dag_random.h>
+#include <perfMon/dag_cpuFreq.h>
+#include <generic/dag_tab.h>
+#include <EASTL/unique_ptr.h>
+#include <stdio.h>
+#include <limits.h>
+
+class ReflTestObject : public danet::ReflectableObject
+{
+public:
+  DECL_REFLECTION(ReflTestObject, danet::ReflectableObject);
+
+  REFL_VAR(1, int, intVar);
+  REFL_VAR_EXT(2, int, smallInt, RVF_UNSIGNED, 5, DANET_STD_ENCODER(int));
+  REFL_VAR_EXT(3, float, normFloat, RVF_NORMALIZED, 12, DANET_STD_ENCODER(float));
+  REFL_VAR_EXT(4, float, unormFloat, RVF_NORMALIZED | RVF_UNSIGNED, 7, DANET_STD_ENCODER(float));
+  REFL_FLOAT_MIN_MAX(5, rangeFloat, -10.f, 250.f, 0, 11);
+  REFL_VAR(6, float, rawFloat);
+  REFL_VAR_EXT(7, Point4, dir, RVF_NORMALIZED, 0, DANET_STD_ENCODER(Point4));
+  REFL_VAR(8, Point2, pos);
+  REFL_VAR(9, uint8_t, byteVar);
+  REFL_VAR(10, TMatrix, tm);
+  REFL_VAR_EXT(11, int, int13, 0, 13, DANET_STD_ENCODER(int));
+  REFL_VAR_EXT(12, Point2, dir2, RVF_NORMALIZED, 0, DANET_STD_ENCODER(Point2));
+
+  ReflTestObject() : danet::ReflectableObject(1) { enableReflection(); }
+
+  void randomize(int &seed)
+  {
+    intVar = _rnd(seed) - 16384;
+    smallInt = _rnd(seed) & 31;
+    normFloat = _srnd(seed);
+    unormFloat = _frnd(seed);
+    rangeFloat = -10.f + _frnd(seed) * 260.f;
+    rawFloat = _srnd(seed) * 1000.f;
+    dir = normalize(Point4(_srnd(seed), _srnd(seed), _srnd(seed) + 2.f, _srnd(seed)));
+    pos = Point2(_srnd(seed), _srnd(seed)) * 1000.f;
+    byteVar = uint8_t(_rnd(seed));
+    TMatrix m = TMatrix::IDENT;
+    m.setcol(3, Point3::x0y(pos.get()));
+    tm = m;
+    int13 = (_rnd(seed) & 8191) - 4096;
+    dir2 = normalize(Point2(_srnd(seed), _srnd(seed) + 2.f));
+  }
+};
+
+static void serialize_objects(dag::ConstSpan<eastl::unique_ptr<ReflTestObject>> objects, danet::BitStream &bs, bool use_plan)
+{
+  const uint32_t prevFlags = danet::option_flags;
+  danet::option_flags = use_plan ? (prevFlags & ~danet::NO_REFLECTION_ENCODE_PLAN) : (prevFlags | danet::NO_REFLECTION_ENCODE_PLAN);
+  bs.Reset();
+  for (const eastl::unique_ptr<ReflTestObject> &obj : objects)
+  {
+    obj->serialize(bs, 0, true, 0, false, false);
+    bs.AlignWriteToByteBoundary();
+  }
+  danet::option_flags = prevFlags;
+}
+
+static void make_objects(Tab<eastl::unique_ptr<ReflTestObject>> &objects, int count)
+{
+  int seed = 12345;
+  for (int i = 0; i < count; ++i)
+  {
+    objects.push_back(eastl::make_unique<ReflTestObject>());
+    objects.back()->randomize(seed);
+  }
+}
+
+TEST(ReflectionEncodePlanIsBitExact)
+{
+  Tab<eastl::unique_ptr<ReflTestObject>> objects;
+  make_objects(objects, 64);
+  danet::BitStream planned, plain;
+  serialize_objects(objects, planned, true);
+  serialize_objects(objects, plain, false);
+  CHECK_EQUAL(plain.GetNumberOfBitsUsed(), planned.GetNumberOfBitsUsed());
+  CHECK(memcmp(plain.GetData(), planned.GetData(), plain.GetNumberOfBytesUsed()) == 0);
+
+  // only changed vars
+  objects[0]->resetChangeFlag();
+  objects[0]->smallInt = 7;
+  objects[0]->rawFloat = 1.f;
+  objects[0]->dir2 = Point2(0.f, -1.f);
+  plain.Reset();
+  planned.Reset();
+  danet::option_flags |= danet::NO_REFLECTION_ENCODE_PLAN;
+  objects[0]->serialize(plain, RVF_CHANGED, true, 0, false, false);
+  danet::option_flags &= ~danet::NO_REFLECTION_ENCODE_PLAN;
+  objects[0]->serialize(planned, RVF_CHANGED, true, 0, false, true);
+  CHECK_EQUAL(plain.GetNumberOfBitsUsed(), planned.GetNumberOfBitsUsed());
+  CHECK(memcmp(plain.GetData(), planned.GetData(), plain.GetNumberOfBytesUsed()) == 0);
+}
+
+TEST(ReflectionEncodePlanRoundTrip)
+{
+  Tab<eastl::unique_ptr<ReflTestObject>> objects;
+  make_objects(objects, 2);
+  danet::BitStream bs;
+  objects[0]->serialize(bs, 0, true, 0, false, false);
+  uint16_t dataSize = 0;
+  mpi::ObjectID oid = mpi::INVALID_OBJECT_ID;
+  CHECK(bs.Read(dataSize));
+  CHECK(bs.Read(oid));
+  CHECK(objects[1]->deserialize(bs));
+  CHECK_EQUAL(objects[0]->intVar.get(), objects[1]->intVar.get());
+  CHECK_EQUAL(objects[0]->smallInt.get(), objects[1]->smallInt.get());
+  CHECK_EQUAL(objects[0]->int13.get(), objects[1]->int13.get());
+  CHECK_EQUAL(objects[0]->byteVar.get(), objects[1]->byteVar.get());
+  CHECK_EQUAL(objects[0]->rawFloat.get(), objects[1]->rawFloat.get());
+  CHECK_CLOSE(objects[0]->normFloat.get(), objects[1]->normFloat.get(), 1e-3f);
+  CHECK_CLOSE(objects[0]->rangeFloat.get(), objects[1]->rangeFloat.get(), 0.2f);
+  CHECK_CLOSE(objects[0]->dir.get().w, objects[1]->dir.get().w, 1e-3f);
+}
+
+// not a correctness check, prints best serialization time with and without encode plan
+TEST(ReflectionEncodePlanBenchmark)
+{
+  const int OBJECTS_NUM = 4096, RUNS = 32;
+  Tab<eastl::unique_ptr<ReflTestObject>> objects;
+  make_objects(objects, OBJECTS_NUM);
+  danet::BitStream bs(OBJECTS_NUM * 128);
+  int bestUsec[2] = {INT_MAX, INT_MAX};
+  for (int i = 0; i < RUNS; ++i)
+    for (int usePlan = 0; usePlan < 2; ++usePlan)
+    {
+      int64_t reft = ref_time_ticks();
+      serialize_objects(objects, bs, usePlan);
+      bestUsec[usePlan] = min(bestUsec[usePlan], get_time_usec(reft));
+    }
+  printf("reflection serialize of %d objects: %d us with coders, %d us with encode plan\n", OBJECTS_NUM, bestUsec[0], bestUsec[1]);
+}
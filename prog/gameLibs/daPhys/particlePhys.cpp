@@ -6,6 +6,8 @@
 #include <memory/dag_framemem.h>
 #include <ioSys/dag_dataBlock.h>
 #include <debug/dag_debug3d.h>
+#include <util/dag_parallelForInline.h>
+#include <perfMon/dag_statDrv.h>
 
 using namespace daphys;
 
@@ -759,6 +761,16 @@ void ParticlePhysSystem::update()
   }
 }
 
+void ParticlePhysSystem::update_batch(dag::ConstSpan<ParticlePhysSystem *> systems)
+{
+  TIME_PROFILE(particle_phys_update_batch);
+  // systems are small (few constraints each), so several of them per job
+  threadpool::parallel_for_inline(0, systems.size(), 16, [&systems](uint32_t begin, uint32_t end, uint32_t) {
+    for (uint32_t i = begin; i < end; ++i)
+      systems[i]->update();
+  });
+}
+
 void ParticlePhysSystem::updateGeomNodeTree(GeomNodeTree *tree, const TMatrix &render_space_tm)
 {
   for (int i = 0; i < constraints.size(); ++i)
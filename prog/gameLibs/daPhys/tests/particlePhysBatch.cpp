@@ -0,0 +1,145 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <daPhys/particlePhys.h>
+#include <math/dag_geomTree.h>
+#include <math/random/dag_random.h>
+#include <ioSys/dag_dataBlock.h>
+#include <ioSys/dag_memIo.h>
+#include <util/dag_threadPool.h>
+#include <generic/dag_tab.h>
+
+using namespace daphys;
+
+// Suspension-like system: two wheels and axle joined with edges, middle point on edge between wheels is projected to it
+static const char PARTICLE_PHYS_BLK[] = R"(
+find:t="^body$"
+points{
+  wheel_l{ name:t="wheel_l"; limitMin:p3=-0.5, -0.5, -0.5; limitMax:p3=0.5, 0.5, 0.5; }
+  wheel_r{ name:t="wheel_r"; limitMin:p3=-0.5, -0.5, -0.5; limitMax:p3=0.5, 0.5, 0.5; }
+  axle{ name:t="axle"; limitMin:p3=-0.2, -0.2, -0.2; limitMax:p3=0.2, 0.2, 0.2; }
+  middle{
+    createOnEdge{ point1:t="wheel_l"; point2:t="wheel_r"; pos:r=0.5; }
+    limitMin:p3=-0.3, -0.3, -0.3; limitMax:p3=0.3, 0.3, 0.3;
+  }
+}
+constraints{
+  edge{ from:t="wheel_l"; to:t="axle"; }
+  edge{ from:t="wheel_r"; to:t="axle"; }
+  edge{ from:t="wheel_l"; to:t="wheel_r"; }
+  projection{ point:t="middle"; from:t="wheel_l"; to:t="wheel_r"; }
+}
+)";
+
+struct ParticlePhysBatchFixture
+{
+  static constexpr int SYSTEM_COUNT = 40; // several jobs of batch
+  static constexpr int POINT_COUNT = 4;
+
+  GeomNodeTree tree;
+  DataBlock blk;
+  Tab<ParticlePhysSystem *> sequential, batched;
+  int seed = 7531;
+
+  ParticlePhysBatchFixture()
+  {
+    threadpool::init(3, 256);
+    loadTree();
+    blk.loadText(PARTICLE_PHYS_BLK, sizeof(PARTICLE_PHYS_BLK) - 1);
+    for (int i = 0; i < SYSTEM_COUNT; ++i)
+    {
+      sequential.push_back(new ParticlePhysSystem);
+      sequential.back()->loadFromBlk(&blk, &tree);
+      batched.push_back(new ParticlePhysSystem);
+      batched.back()->loadFromBlk(&blk, &tree);
+    }
+  }
+  ~ParticlePhysBatchFixture()
+  {
+    clear_all_ptr_items(sequential);
+    clear_all_ptr_items(batched);
+    threadpool::shutdown();
+  }
+
+  // root "body" with wheels and axle as children, stored in dump format of GeomNodeTree::load()
+  void loadTree()
+  {
+    struct DumpNode
+    {
+      mat44f tm, wtm;
+      uint64_t childOfsCount, childReserved;
+      uint64_t parentOfs, nameOfs;
+    };
+    static const char *names[] = {"body", "wheel_l", "wheel_r", "axle"};
+    static const Point3 positions[] = {
+      Point3(0.f, 1.f, 0.f), Point3(-1.f, 0.f, 0.f), Point3(1.f, 0.f, 0.f), Point3(0.f, 0.5f, 0.3f)};
+    constexpr int NODE_COUNT = countof(names);
+    DumpNode nodes[NODE_COUNT];
+    memset(nodes, 0, sizeof(nodes));
+    Tab<char> namePool;
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+      v_mat44_ident(nodes[i].tm);
+      nodes[i].tm.col3 = v_make_vec4f(positions[i].x, positions[i].y, positions[i].z, 1.f);
+      nodes[i].wtm = nodes[i].tm;
+      if (i > 0)
+        nodes[i].wtm.col3 = v_add(nodes[0].tm.col3, v_and(nodes[i].tm.col3, v_cast_vec4f(V_CI_MASK1110)));
+      nodes[i].parentOfs = i > 0 ? 0 : uint64_t(-1);
+      nodes[i].nameOfs = sizeof(nodes) + namePool.size();
+      append_items(namePool, strlen(names[i]) + 1, names[i]);
+    }
+    nodes[0].childOfsCount = sizeof(DumpNode) | (uint64_t(NODE_COUNT - 1) << 32);
+
+    DynamicMemGeneralSaveCB cwr(tmpmem, 0, 1 << 10);
+    cwr.writeInt(sizeof(nodes) + namePool.size());
+    cwr.writeInt(NODE_COUNT);
+    cwr.write(nodes, sizeof(nodes));
+    cwr.write(namePool.data(), namePool.size());
+    InPlaceMemLoadCB crd(cwr.data(), cwr.size());
+    tree.load(crd);
+    tree.calcWtm();
+  }
+
+  // same random displacement of corresponding particles of both sets, as game code moves them before update
+  void displaceParticles()
+  {
+    for (int i = 0; i < SYSTEM_COUNT; ++i)
+      for (int p = 0; p < POINT_COUNT; ++p)
+      {
+        const Point3 delta(_srnd(seed) * 0.2f, _srnd(seed) * 0.2f, _srnd(seed) * 0.2f);
+        sequential[i]->getParticle(p)->addDelta(delta);
+        batched[i]->getParticle(p)->addDelta(delta);
+      }
+  }
+};
+
+TEST_FIXTURE(ParticlePhysBatchFixture, BatchUpdateMatchesSequential)
+{
+  CHECK(!sequential[0]->empty());
+  CHECK(sequential[0]->getParticle(POINT_COUNT - 1) && !sequential[0]->getParticle(POINT_COUNT));
+
+  float maxSolveDelta = 0.f;
+  for (int frame = 0; frame < 10; ++frame)
+  {
+    displaceParticles();
+    const Point3 displacedPos = sequential[0]->getParticle(0)->getPos();
+    for (ParticlePhysSystem *system : sequential)
+      system->update();
+    ParticlePhysSystem::update_batch(batched);
+    maxSolveDelta = max(maxSolveDelta, length(sequential[0]->getParticle(0)->getPos() - displacedPos));
+
+    for (int i = 0; i < SYSTEM_COUNT; ++i)
+      for (int p = 0; p < POINT_COUNT; ++p)
+        CHECK(memcmp(&sequential[i]->getParticle(p)->tm, &batched[i]->getParticle(p)->tm, sizeof(TMatrix)) == 0);
+  }
+  CHECK(maxSolveDelta > 1e-3f); // constraints moved particles
+}
+
+// Empty batch and batch smaller than job size are updated in place
+TEST_FIXTURE(ParticlePhysBatchFixture, SmallBatchMatchesSequential)
+{
+  ParticlePhysSystem::update_batch({});
+  displaceParticles();
+  sequential[0]->update();
+  ParticlePhysSystem::update_batch(make_span(batched.data(), 1));
+  for (int p = 0; p < POINT_COUNT; ++p)
+    CHECK(memcmp(&sequential[0]->getParticle(p)->tm, &batched[0]->getParticle(p)->tm, sizeof(TMatrix)) == 0);
+}
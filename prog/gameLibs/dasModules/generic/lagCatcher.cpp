@@ -14,6 +14,10 @@ public:
 
     das::addExtern<DAS_BIND_FUN(lagcatcher::stop)>(*this, lib, "lagcatcher_stop", das::SideEffects::modifyExternal,
       "lagcatcher::stop");
+    das::addExtern<DAS_BIND_FUN(lagcatcher::init_stall_detector)>(*this, lib, "lagcatcher_init_stall_detector",
+      das::SideEffects::modifyExternal, "lagcatcher::init_stall_detector");
+    das::addExtern<DAS_BIND_FUN(lagcatcher::tick)>(*this, lib, "lagcatcher_tick", das::SideEffects::modifyExternal,
+      "lagcatcher::tick");
 
     verifyAotReady();
   }
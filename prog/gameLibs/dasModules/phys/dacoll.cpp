@@ -6,7 +6,7 @@
 DAS_BASE_BIND_ENUM_98(dacoll::PhysLayer, PhysLayer, EPL_DEFAULT, EPL_STATIC, EPL_KINEMATIC, EPL_DEBRIS, EPL_SENSOR, EPL_CHARACTER,
   EPL_ALL);
 DAS_BASE_BIND_ENUM_98(dacoll::CollType, CollType, ETF_LMESH, ETF_FRT, ETF_RI, ETF_RESTORABLES, ETF_OBJECTS_GROUP, ETF_STRUCTURES,
-  ETF_HEIGHTMAP, ETF_STATIC, ETF_RI_TREES, ETF_RI_PHYS, ETF_DEFAULT, ETF_ALL);
+  ETF_HEIGHTMAP, ETF_STATIC, ETF_RI_TREES, ETF_RI_PHYS, ETF_PHYS_WORLD, ETF_DEFAULT, ETF_ALL);
 struct TraceMeshFacesAnnotation : das::ManagedStructureAnnotation<TraceMeshFaces, false>
 {
   TraceMeshFacesAnnotation(das::ModuleLibrary &ml) : ManagedStructureAnnotation("TraceMeshFaces", ml)
@@ -261,6 +261,7 @@ public:
     das::addConstant<int>(*this, "ETF_STATIC", dacoll::ETF_STATIC);
     das::addConstant<int>(*this, "ETF_RI_TREES", dacoll::ETF_RI_TREES);
     das::addConstant<int>(*this, "ETF_RI_PHYS", dacoll::ETF_RI_PHYS);
+    das::addConstant<int>(*this, "ETF_PHYS_WORLD", dacoll::ETF_PHYS_WORLD);
     das::addConstant<int>(*this, "ETF_DEFAULT", dacoll::ETF_DEFAULT);
     das::addConstant<int>(*this, "ETF_ALL", dacoll::ETF_ALL);
 
@@ -427,12 +427,13 @@ static constexpr ecs::ComponentDesc animchar_update_ecs_query_comps[] =
   {ECS_HASH("animchar__accumDt"), ecs::ComponentTypeInfo<float>(), ecs::CDF_OPTIONAL},
   {ECS_HASH("animchar_node_wtm"), ecs::ComponentTypeInfo<AnimcharNodesMat44>(), ecs::CDF_OPTIONAL},
   {ECS_HASH("animchar_render__root_pos"), ecs::ComponentTypeInfo<vec3f>(), ecs::CDF_OPTIONAL},
-//start of 4 ro components at [4]
+//start of 5 ro components at [4]
   {ECS_HASH("animchar__dtThreshold"), ecs::ComponentTypeInfo<float>(), ecs::CDF_OPTIONAL},
+  {ECS_HASH("animchar_render"), ecs::ComponentTypeInfo<AnimV20::AnimcharRendComponent>(), ecs::CDF_OPTIONAL},
   {ECS_HASH("transform"), ecs::ComponentTypeInfo<TMatrix>()},
   {ECS_HASH("animchar__turnDir"), ecs::ComponentTypeInfo<bool>(), ecs::CDF_OPTIONAL},
   {ECS_HASH("animchar__updatable"), ecs::ComponentTypeInfo<bool>(), ecs::CDF_OPTIONAL},
-//start of 2 no components at [8]
+//start of 2 no components at [9]
   {ECS_HASH("animchar__actOnDemand"), ecs::ComponentTypeInfo<ecs::Tag>()},
   {ECS_HASH("animchar__physSymDependence"), ecs::ComponentTypeInfo<ecs::Tag>()}
 };
@@ -440,9 +441,9 @@ static ecs::CompileTimeQueryDesc animchar_update_ecs_query_desc
 (
   "animchar_update_ecs_query",
   make_span(animchar_update_ecs_query_comps+0, 4)/*rw*/,
-  make_span(animchar_update_ecs_query_comps+4, 4)/*ro*/,
+  make_span(animchar_update_ecs_query_comps+4, 5)/*ro*/,
   empty_span(),
-  make_span(animchar_update_ecs_query_comps+8, 2)/*no*/
+  make_span(animchar_update_ecs_query_comps+9, 2)/*no*/
   , 1);
 template<typename Callable>
 inline void animchar_update_ecs_query(Callable function)
@@ -460,6 +461,7 @@ inline void animchar_update_ecs_query(Callable function)
             , ECS_RO_COMP_PTR(animchar_update_ecs_query_comps, "animchar__dtThreshold", float)
             , ECS_RW_COMP_PTR(animchar_update_ecs_query_comps, "animchar_node_wtm", AnimcharNodesMat44)
             , ECS_RW_COMP_PTR(animchar_update_ecs_query_comps, "animchar_render__root_pos", vec3f)
+            , ECS_RO_COMP_PTR(animchar_update_ecs_query_comps, "animchar_render", AnimV20::AnimcharRendComponent)
             , ECS_RO_COMP(animchar_update_ecs_query_comps, "transform", TMatrix)
             , ECS_RO_COMP_OR(animchar_update_ecs_query_comps, "animchar__turnDir", bool(false))
             );
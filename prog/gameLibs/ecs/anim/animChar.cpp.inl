@@ -36,6 +36,17 @@ static inline void animchar_set_tm(AnimV20::AnimcharBaseComponent &ac, bool turn
   ac.setTm(tm4, true);
 }
 
+// fastphys of characters is as detailed as their render lod chosen on previous frame, not rendered ones get the farthest lod
+static inline int get_fast_phys_lod(const AnimV20::AnimcharRendComponent &animchar_render)
+{
+  constexpr int FAR_FAST_PHYS_LOD = 3;
+  const DynamicRenderableSceneInstance *scene = animchar_render.getSceneInstance();
+  if (!scene || !(animchar_render.getVisBits() & AnimV20::AnimcharRendComponent::VISFLG_IN_RANGE))
+    return FAR_FAST_PHYS_LOD;
+  const int lod = scene->getCurrentLodNo();
+  return lod >= 0 ? min(lod, FAR_FAST_PHYS_LOD) : FAR_FAST_PHYS_LOD;
+}
+
 static bool is_tex_harmonization_required()
 {
   if (EASTL_UNLIKELY(harmonization_required < 0))
@@ -303,7 +314,11 @@ static __forceinline void animchar__updater_es(const UpdateAnimcharEvent &info)
       float *animchar__accumDt, const float *animchar__dtThreshold,
       AnimcharNodesMat44 *animchar_node_wtm, // always on client, never on server
       vec3f *animchar_render__root_pos,      // always on client, never on server
-      const TMatrix &transform, bool animchar__turnDir = false) { ANIMCHAR_ACT(info.dt, animchar__accumDt, animchar__dtThreshold); });
+      const AnimV20::AnimcharRendComponent *animchar_render, const TMatrix &transform, bool animchar__turnDir = false) {
+      if (animchar_render && animchar.getFastPhysSystem())
+        animchar.setFastPhysLod(get_fast_phys_lod(*animchar_render));
+      ANIMCHAR_ACT(info.dt, animchar__accumDt, animchar__dtThreshold);
+    });
 }
 
 ECS_AFTER(anim_phys_es)
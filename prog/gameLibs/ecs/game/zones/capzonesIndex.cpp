@@ -0,0 +1,199 @@
+#include "capzonesIndex.h"
+#include <math/dag_mathUtils.h>
+#include <math/dag_math3d.h>
+
+namespace capzones
+{
+bool is_point_in_zone(const IndexedZone &zone, const Point3 &pos, float zone_scale)
+{
+  bool isIn = false;
+  switch (zone.shape)
+  {
+    case ZoneShape::Box:
+    {
+      const float halfScale = zone_scale * 0.5f;
+      isIn = BBox3(Point3(-halfScale, -halfScale, -halfScale), Point3(halfScale, halfScale, halfScale)) & (zone.itm * pos);
+      break;
+    }
+    case ZoneShape::Sphere: isIn = lengthSq(zone.itm * pos) < sqr(zone.radius * zone_scale); break;
+    case ZoneShape::Poly:
+      if (pos.y > zone.minHeight && pos.y < zone.maxHeight)
+      {
+        unsigned int crossings = 0;
+        for (const PolyEdge &e : zone.edges)
+          if (pos.x >= e.lo.x && pos.x < e.hiX && e.d.y * (pos.x - e.lo.x) > (pos.z - e.lo.y) * e.d.x)
+            crossings++;
+        isIn = (crossings & 1) != 0;
+      }
+      break;
+    default: G_ASSERT(0);
+  }
+  return zone.inverted ^ isIn;
+}
+
+void CapzonesIndex::setSphere(ecs::EntityId eid, const TMatrix &transform, float radius, bool inverted)
+{
+  ScopedLockWriteTemplate<OSReadWriteLock> scopedLock(lock);
+  IndexedZone &zone = add(eid, ZoneShape::Sphere);
+  zone.itm = inverse(transform);
+  zone.radius = radius;
+  zone.inverted = inverted;
+  const BBox3 wbox = transform * BBox3(Point3(0, 0, 0), radius * 2.f);
+  zone.wbox = BBox2(Point2::xz(wbox[0]), Point2::xz(wbox[1]));
+}
+
+void CapzonesIndex::setBox(ecs::EntityId eid, const TMatrix &transform, bool inverted)
+{
+  ScopedLockWriteTemplate<OSReadWriteLock> scopedLock(lock);
+  IndexedZone &zone = add(eid, ZoneShape::Box);
+  zone.itm = inverse(transform);
+  zone.inverted = inverted;
+  const BBox3 wbox = transform * BBox3(Point3(0, 0, 0), 1.f); // game::IDENTITY_BBOX3
+  zone.wbox = BBox2(Point2::xz(wbox[0]), Point2::xz(wbox[1]));
+}
+
+void CapzonesIndex::setPoly(ecs::EntityId eid, dag::ConstSpan<Point2> points, float min_height, float max_height, bool inverted)
+{
+  ScopedLockWriteTemplate<OSReadWriteLock> scopedLock(lock);
+  IndexedZone &zone = add(eid, ZoneShape::Poly);
+  zone.minHeight = min_height;
+  zone.maxHeight = max_height;
+  zone.inverted = inverted;
+  zone.wbox.setempty();
+  const int count = points.size();
+  if (count < 3) // never inside, same as is_point_in_poly
+    return;
+  zone.edges.reserve(count);
+  Point2 a = points[count - 1];
+  for (const Point2 &b : points)
+  {
+    zone.wbox += b;
+    if (a.x != b.x) // vertical edges are never crossed
+    {
+      const Point2 &lo = a.x < b.x ? a : b, &hi = a.x < b.x ? b : a;
+      zone.edges.push_back(PolyEdge{lo, hi - lo, hi.x});
+    }
+    a = b;
+  }
+}
+
+IndexedZone &CapzonesIndex::add(ecs::EntityId eid, ZoneShape shape)
+{
+  gridDirty = true;
+  uint32_t &slot = slotsByEid[(ecs::entity_id_t)eid].slot[(int)shape];
+  if (slot == ~0u)
+  {
+    slot = zones.size();
+    zones.push_back();
+  }
+  IndexedZone &zone = zones[slot];
+  zone.eid = eid;
+  zone.shape = shape;
+  zone.inverted = false;
+  zone.edges.clear();
+  return zone;
+}
+
+void CapzonesIndex::remove(ecs::EntityId eid, ZoneShape shape)
+{
+  ScopedLockWriteTemplate<OSReadWriteLock> scopedLock(lock);
+  auto it = slotsByEid.find((ecs::entity_id_t)eid);
+  if (it == slotsByEid.end() || it->second.slot[(int)shape] == ~0u)
+    return;
+  gridDirty = true;
+  uint32_t slot = it->second.slot[(int)shape];
+  it->second.slot[(int)shape] = ~0u;
+  if (slot != zones.size() - 1)
+  {
+    zones[slot] = eastl::move(zones.back());
+    slotsByEid[(ecs::entity_id_t)zones[slot].eid].slot[(int)zones[slot].shape] = slot;
+  }
+  zones.pop_back();
+  const ZoneSlots &slots = it->second;
+  if (slots.slot[0] == ~0u && slots.slot[1] == ~0u && slots.slot[2] == ~0u)
+    slotsByEid.erase(it);
+}
+
+void CapzonesIndex::lockQuery()
+{
+  for (;;)
+  {
+    lock.lockRead();
+    if (!gridDirty)
+      return;
+    lock.unlockRead();
+    lock.lockWrite();
+    if (gridDirty)
+      rebuildGrid();
+    lock.unlockWrite();
+  }
+}
+
+void CapzonesIndex::rebuildGrid()
+{
+  gridDirty = false;
+  globalZones.clear();
+  cellZones.clear();
+  gridBox.setempty();
+  for (uint32_t i = 0; i < zones.size(); ++i)
+  {
+    IndexedZone &zone = zones[i];
+    const Point2 width = zone.wbox.width();
+    zone.inGrid = !zone.inverted && !zone.wbox.isempty() && check_finite(width.x) && check_finite(width.y);
+    if (zone.inGrid)
+      gridBox += zone.wbox;
+    else
+      globalZones.push_back(i);
+  }
+  if (gridBox.isempty())
+  {
+    gridW = gridH = 0;
+    clear_and_resize(cellOfs, 1);
+    cellOfs[0] = 0;
+    return;
+  }
+  const Point2 width = gridBox.width();
+  const float cellSize = max(max(width.x, width.y) / GRID_MAX_DIM, GRID_MIN_CELL_SIZE);
+  invCellSize = 1.f / cellSize;
+  gridW = clamp((int)ceilf(width.x * invCellSize), 1, GRID_MAX_DIM);
+  gridH = clamp((int)ceilf(width.y * invCellSize), 1, GRID_MAX_DIM);
+
+  // counting sort of zones by covered cells
+  clear_and_resize(cellOfs, gridW * gridH + 1);
+  mem_set_0(cellOfs);
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (uint32_t i = 0; i < zones.size(); ++i)
+    {
+      const IndexedZone &zone = zones[i];
+      if (!zone.inGrid)
+        continue;
+      IPoint2 c0 = getCell(zone.wbox[0]), c1 = getCell(zone.wbox[1]);
+      for (int z = c0.y; z <= c1.y; ++z)
+        for (int x = c0.x; x <= c1.x; ++x)
+        {
+          uint32_t &ofs = cellOfs[z * gridW + x];
+          if (pass)
+            cellZones[ofs++] = i;
+          else
+            ofs++;
+        }
+    }
+    if (!pass)
+    {
+      uint32_t total = 0;
+      for (uint32_t &ofs : cellOfs)
+      {
+        uint32_t cnt = ofs;
+        ofs = total;
+        total += cnt;
+      }
+      clear_and_resize(cellZones, total);
+    }
+  }
+  // fill pass moved each offset to the start of the next cell
+  for (int i = cellOfs.size() - 1; i > 0; --i)
+    cellOfs[i] = cellOfs[i - 1];
+  cellOfs[0] = 0;
+}
+} // namespace capzones
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <daECS/core/entityId.h>
+#include <math/dag_TMatrix.h>
+#include <math/dag_bounds2.h>
+#include <math/integer/dag_IPoint2.h>
+#include <osApiWrappers/dag_rwLock.h>
+#include <generic/dag_tab.h>
+#include <ska_hash_map/flat_hash_map2.hpp>
+#include <EASTL/vector.h>
+#include <EASTL/sort.h>
+
+// Index of active capzones, entries are updated by ES on zone changes and XZ grid over them is rebuilt lazily on next query.
+// Inverted zones contain (almost) whole world, so they are kept out of grid and tested on each query.
+namespace capzones
+{
+// order of shapes is order of results, same as order of ECS queries which were used before index
+enum class ZoneShape : uint8_t
+{
+  Sphere,
+  Box,
+  Poly,
+  Count
+};
+
+// edge of polygon which can be crossed by +Y ray from point, points ordered by X (same math as in is_point_in_poly)
+struct PolyEdge
+{
+  Point2 lo, d;
+  float hiX;
+};
+
+struct IndexedZone
+{
+  TMatrix itm; // inverse of transform (box and sphere)
+  BBox2 wbox;  // XZ world bounds
+  float radius;
+  float minHeight, maxHeight;
+  dag::Vector<PolyEdge> edges;
+  ecs::EntityId eid;
+  ZoneShape shape;
+  bool inverted;
+  bool inGrid;
+};
+
+bool is_point_in_zone(const IndexedZone &zone, const Point3 &pos, float zone_scale = 1.f);
+
+struct ZoneSlots
+{
+  uint32_t slot[(int)ZoneShape::Count] = {~0u, ~0u, ~0u};
+};
+
+struct CapzonesIndex
+{
+  static constexpr int GRID_MAX_DIM = 64;
+  static constexpr float GRID_MIN_CELL_SIZE = 16.f;
+
+  OSReadWriteLock lock;
+  eastl::vector<IndexedZone> zones;
+  ska::flat_hash_map<ecs::entity_id_t, ZoneSlots> slotsByEid;
+
+  bool gridDirty = true;
+  BBox2 gridBox;
+  float invCellSize = 0.f;
+  int gridW = 0, gridH = 0;
+  Tab<uint32_t> cellOfs;     // gridW * gridH + 1, offsets in cellZones
+  Tab<uint32_t> cellZones;   // zone indices
+  Tab<uint32_t> globalZones; // zones which are tested for every point
+
+  // these take write lock
+  void setSphere(ecs::EntityId eid, const TMatrix &transform, float radius, bool inverted);
+  void setBox(ecs::EntityId eid, const TMatrix &transform, bool inverted);
+  void setPoly(ecs::EntityId eid, dag::ConstSpan<Point2> points, float min_height, float max_height, bool inverted);
+  void remove(ecs::EntityId eid, ZoneShape shape);
+
+  // must be called under lock
+  const IndexedZone *get(ecs::EntityId eid, ZoneShape shape) const
+  {
+    auto it = slotsByEid.find((ecs::entity_id_t)eid);
+    if (it == slotsByEid.end() || it->second.slot[(int)shape] == ~0u)
+      return nullptr;
+    return &zones[it->second.slot[(int)shape]];
+  }
+
+  // read locks index with up to date grid
+  void lockQuery();
+  void unlockQuery() { lock.unlockRead(); }
+
+  // appends indices of zones which contain pos and pass filter(zone_idx) to hits, ordered by shape and then by index,
+  // must be called under lockQuery()
+  template <typename Filter>
+  void gatherZones(const Point3 &pos, const Filter &filter, Tab<uint32_t> &hits) const
+  {
+    const int first = hits.size();
+    forEachCandidate(pos, [&](uint32_t i) {
+      if (filter(i) && is_point_in_zone(zones[i], pos))
+        hits.push_back(i);
+    });
+    eastl::sort(hits.begin() + first, hits.end(), [this](uint32_t a, uint32_t b) {
+      return zones[a].shape != zones[b].shape ? zones[a].shape < zones[b].shape : a < b;
+    });
+  }
+
+  // calls cb(zone_idx) for each zone which bounds can contain pos
+  template <typename Cb>
+  void forEachCandidate(const Point3 &pos, const Cb &cb) const
+  {
+    for (uint32_t i : globalZones)
+      cb(i);
+    const Point2 p = Point2::xz(pos);
+    if (!(gridBox & p))
+      return;
+    IPoint2 c = getCell(p);
+    const uint32_t cellI = c.y * gridW + c.x;
+    for (uint32_t i = cellOfs[cellI], ie = cellOfs[cellI + 1]; i < ie; ++i)
+      cb(cellZones[i]);
+  }
+
+private:
+  IndexedZone &add(ecs::EntityId eid, ZoneShape shape);
+  void rebuildGrid();
+  IPoint2 getCell(const Point2 &p) const
+  {
+    return IPoint2(clamp((int)floorf((p.x - gridBox[0].x) * invCellSize), 0, gridW - 1),
+      clamp((int)floorf((p.y - gridBox[0].y) * invCellSize), 0, gridH - 1));
+  }
+};
+} // namespace capzones
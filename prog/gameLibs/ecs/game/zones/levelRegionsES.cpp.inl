@@ -10,6 +10,7 @@
 #include <quirrel/bindQuirrelEx/autoBind.h>
 
 #include <math/dag_math2d.h>
+#include <memory/dag_framemem.h>
 #include <levelSplines/splineRegions.h>
 
 ECS_REGISTER_RELOCATABLE_TYPE(LevelRegions, nullptr);
@@ -136,11 +137,27 @@ const splineregions::SplineRegion *get_region_by_pos(const Point2 &pos)
 {
   ecs::EntityId eid = g_entity_mgr->getSingletonEntity(ECS_HASH("level_regions"));
   const LevelRegions *level_regions = g_entity_mgr->getNullable<LevelRegions>(eid, ECS_HASH("level_regions"));
-  if (level_regions)
-    for (const splineregions::SplineRegion &reg : *level_regions)
-      if (reg.checkPoint(pos))
-        return &reg;
-  return nullptr;
+  if (!level_regions)
+    return nullptr;
+  int idx = splineregions::find_region(*level_regions, pos);
+  return idx >= 0 ? &(*level_regions)[idx] : nullptr;
+}
+
+void get_regions_by_pos(dag::ConstSpan<Point2> pos, dag::Span<const splineregions::SplineRegion *> out_regions)
+{
+  G_ASSERT(pos.size() == out_regions.size());
+  ecs::EntityId eid = g_entity_mgr->getSingletonEntity(ECS_HASH("level_regions"));
+  const LevelRegions *level_regions = g_entity_mgr->getNullable<LevelRegions>(eid, ECS_HASH("level_regions"));
+  if (!level_regions)
+  {
+    mem_set_0(out_regions);
+    return;
+  }
+  Tab<int> regionIdx(framemem_ptr());
+  regionIdx.resize(pos.size());
+  splineregions::find_regions(*level_regions, pos, make_span(regionIdx));
+  for (int i = 0; i < pos.size(); ++i)
+    out_regions[i] = regionIdx[i] >= 0 ? &(*level_regions)[regionIdx[i]] : nullptr;
 }
 
 const char *get_region_name_by_pos(const Point2 &pos)
@@ -0,0 +1,188 @@
+#include <UnitTest++/UnitTestPP.h>
+#include "../capzonesIndex.h"
+#include <math/dag_math2d.h>
+#include <math/dag_mathUtils.h>
+#include <math/dag_bounds3.h>
+#include <math/random/dag_random.h>
+#include <EASTL/vector.h>
+#include <EASTL/sort.h>
+
+using capzones::CapzonesIndex;
+using capzones::ZoneShape;
+
+// Zone as ECS components, point is tested with the same math as ECS queries did before index
+struct TestZone
+{
+  ecs::EntityId eid;
+  ZoneShape shape;
+  TMatrix tm;
+  float radius;
+  eastl::vector<Point2> points;
+  float minHeight, maxHeight;
+  bool inverted;
+  bool active;
+
+  bool isPointIn(const Point3 &pos) const
+  {
+    switch (shape)
+    {
+      case ZoneShape::Sphere: return inverted ^ (lengthSq(inverse(tm) * pos) < sqr(radius));
+      case ZoneShape::Box: return inverted ^ (BBox3(Point3(-0.5f, -0.5f, -0.5f), Point3(0.5f, 0.5f, 0.5f)) & (inverse(tm) * pos));
+      case ZoneShape::Poly:
+        return inverted ^ ((pos.y > minHeight && pos.y < maxHeight) && is_point_in_poly(Point2::xz(pos), points.data(), points.size()));
+      default: return false;
+    }
+  }
+};
+
+static const float WORLD_SIZE = 2000.f;
+
+static TMatrix random_tm(int &seed, float scale)
+{
+  TMatrix tm = rotyTM(_frnd(seed) * TWOPI) * rotxTM(_srnd(seed) * 0.3f);
+  tm.setcol(0, tm.getcol(0) * (scale * (0.5f + _frnd(seed))));
+  tm.setcol(1, tm.getcol(1) * (scale * (0.5f + _frnd(seed))));
+  tm.setcol(2, tm.getcol(2) * (scale * (0.5f + _frnd(seed))));
+  tm.setcol(3, Point3(_frnd(seed) * WORLD_SIZE, _srnd(seed) * 20.f, _frnd(seed) * WORLD_SIZE));
+  return tm;
+}
+
+static void randomize_zone(TestZone &zone, int &seed)
+{
+  zone.inverted = _rnd(seed) % 16 == 0;
+  zone.active = _rnd(seed) % 8 != 0;
+  switch (zone.shape)
+  {
+    case ZoneShape::Sphere:
+      zone.tm = TMatrix::IDENT;
+      zone.tm.setcol(3, Point3(_frnd(seed) * WORLD_SIZE, _srnd(seed) * 20.f, _frnd(seed) * WORLD_SIZE));
+      zone.radius = 5.f + _frnd(seed) * 150.f;
+      break;
+    case ZoneShape::Box: zone.tm = random_tm(seed, 10.f + _frnd(seed) * 200.f); break;
+    case ZoneShape::Poly:
+    {
+      const Point2 center(_frnd(seed) * WORLD_SIZE, _frnd(seed) * WORLD_SIZE);
+      const int count = _rnd(seed) % 10; // including degenerate ones
+      zone.points.clear();
+      for (int i = 0; i < count; ++i)
+      {
+        const float angle = TWOPI * (i + _frnd(seed) * 0.5f) / count;
+        const float dist = 10.f + _frnd(seed) * 200.f;
+        zone.points.push_back(center + Point2(cosf(angle), sinf(angle)) * dist);
+      }
+      zone.minHeight = -10.f - _frnd(seed) * 10.f;
+      zone.maxHeight = _frnd(seed) * 20.f;
+      break;
+    }
+    default: break;
+  }
+}
+
+static void apply_zone(CapzonesIndex &index, const TestZone &zone)
+{
+  if (!zone.active)
+    index.remove(zone.eid, zone.shape);
+  else if (zone.shape == ZoneShape::Sphere)
+    index.setSphere(zone.eid, zone.tm, zone.radius, zone.inverted);
+  else if (zone.shape == ZoneShape::Box)
+    index.setBox(zone.eid, zone.tm, zone.inverted);
+  else
+    index.setPoly(zone.eid, make_span_const(zone.points.data(), zone.points.size()), zone.minHeight, zone.maxHeight, zone.inverted);
+}
+
+static Point3 random_point(int &seed)
+{
+  return Point3(_frnd(seed) * WORLD_SIZE * 1.2f - WORLD_SIZE * 0.1f, _srnd(seed) * 30.f,
+    _frnd(seed) * WORLD_SIZE * 1.2f - WORLD_SIZE * 0.1f);
+}
+
+static uint64_t zone_key(ZoneShape shape, ecs::EntityId eid) { return (uint64_t(shape) << 32) | (ecs::entity_id_t)eid; }
+
+static void check_queries(CapzonesIndex &index, const eastl::vector<TestZone> &zones, int &seed, int points_count)
+{
+  Tab<uint32_t> hits;
+  for (int i = 0; i < points_count; ++i)
+  {
+    const Point3 pos = random_point(seed);
+    eastl::vector<uint64_t> expected;
+    for (const TestZone &zone : zones)
+      if (zone.active && (ecs::entity_id_t)zone.eid % 5 != 0 && zone.isPointIn(pos))
+        expected.push_back(zone_key(zone.shape, zone.eid));
+    eastl::sort(expected.begin(), expected.end());
+
+    hits.clear();
+    index.lockQuery();
+    index.gatherZones(pos, [&](uint32_t zone_idx) { return (ecs::entity_id_t)index.zones[zone_idx].eid % 5 != 0; }, hits);
+    eastl::vector<uint64_t> got;
+    for (uint32_t zoneIdx : hits)
+      got.push_back(zone_key(index.zones[zoneIdx].shape, index.zones[zoneIdx].eid));
+    index.unlockQuery();
+
+    for (int j = 1; j < got.size(); ++j)
+      CHECK(got[j - 1] >> 32 <= got[j] >> 32); // spheres, boxes, then polygons
+    eastl::sort(got.begin(), got.end());
+    CHECK(got == expected);
+  }
+}
+
+TEST(CapzonesIndexMatchesBruteForce)
+{
+  int seed = 4242;
+  CapzonesIndex index;
+  eastl::vector<TestZone> zones;
+  for (int i = 0; i < 300; ++i)
+  {
+    TestZone zone;
+    zone.eid = ecs::EntityId(i / 2 + 1); // same entity can have several shapes
+    zone.shape = ZoneShape(i % 3);
+    randomize_zone(zone, seed);
+    apply_zone(index, zone);
+    zones.push_back(eastl::move(zone));
+  }
+  check_queries(index, zones, seed, 5000);
+
+  // zones move, change shape params, get (de)activated and inverted, grid is rebuilt on next query
+  for (int step = 0; step < 20; ++step)
+  {
+    for (int i = 0; i < 30; ++i)
+    {
+      TestZone &zone = zones[_rnd(seed) % zones.size()];
+      randomize_zone(zone, seed);
+      apply_zone(index, zone);
+    }
+    check_queries(index, zones, seed, 500);
+  }
+
+  for (TestZone &zone : zones)
+  {
+    zone.active = false;
+    apply_zone(index, zone);
+  }
+  CHECK(index.zones.empty());
+  CHECK(index.slotsByEid.empty());
+  check_queries(index, zones, seed, 100);
+}
+
+TEST(CapzonesIndexIsPointInZone)
+{
+  int seed = 17;
+  CapzonesIndex index;
+  for (int i = 0; i < 90; ++i)
+  {
+    TestZone zone;
+    zone.eid = ecs::EntityId(i + 1);
+    zone.shape = ZoneShape(i % 3);
+    randomize_zone(zone, seed);
+    zone.active = true;
+    apply_zone(index, zone);
+    const capzones::IndexedZone *indexed = index.get(zone.eid, zone.shape);
+    CHECK(indexed != nullptr);
+    if (!indexed)
+      continue;
+    for (int j = 0; j < 200; ++j)
+    {
+      const Point3 pos = random_point(seed);
+      CHECK_EQUAL(zone.isPointIn(pos), capzones::is_point_in_zone(*indexed, pos));
+    }
+  }
+}
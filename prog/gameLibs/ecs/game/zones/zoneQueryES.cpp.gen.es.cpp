@@ -2,7 +2,7 @@
 ECS_DEF_PULL_VAR(zoneQuery);
 //built with ECS codegen version 1.0
 #include <daECS/core/internal/performQuery.h>
-static constexpr ecs::ComponentDesc active_sphere_capzones_ecs_query_comps[] =
+static constexpr ecs::ComponentDesc capzone_sphere_index_es_event_handler_comps[] =
 {
 //start of 5 ro components at [0]
   {ECS_HASH("eid"), ecs::ComponentTypeInfo<ecs::EntityId>()},
@@ -13,35 +13,34 @@ static constexpr ecs::ComponentDesc active_sphere_capzones_ecs_query_comps[] =
 //start of 1 rq components at [5]
   {ECS_HASH("capzone"), ecs::ComponentTypeInfo<ecs::Tag>()}
 };
-static ecs::CompileTimeQueryDesc active_sphere_capzones_ecs_query_desc
-(
-  "active_sphere_capzones_ecs_query",
-  empty_span(),
-  make_span(active_sphere_capzones_ecs_query_comps+0, 5)/*ro*/,
-  make_span(active_sphere_capzones_ecs_query_comps+5, 1)/*rq*/,
-  empty_span());
-template<typename Callable>
-inline void active_sphere_capzones_ecs_query(Callable function)
+static void capzone_sphere_index_es_event_handler_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
 {
-  perform_query(g_entity_mgr, active_sphere_capzones_ecs_query_desc.getHandle(),
-    [&function](const ecs::QueryView& __restrict components)
-    {
-        auto comp = components.begin(), compE = components.end(); G_ASSERT(comp != compE); do
-        {
-          if ( !(ECS_RO_COMP_OR(active_sphere_capzones_ecs_query_comps, "active", bool( true))) )
-            continue;
-          function(
-              ECS_RO_COMP(active_sphere_capzones_ecs_query_comps, "eid", ecs::EntityId)
-            , ECS_RO_COMP(active_sphere_capzones_ecs_query_comps, "transform", TMatrix)
-            , ECS_RO_COMP(active_sphere_capzones_ecs_query_comps, "sphere_zone__radius", float)
-            , ECS_RO_COMP_OR(active_sphere_capzones_ecs_query_comps, "sphere_zone__inverted", bool(false))
-            );
-
-        }while (++comp != compE);
-      }
-  );
+  auto comp = components.begin(), compE = components.end(); G_ASSERT(comp!=compE); do
+    capzone_sphere_index_es_event_handler(evt
+        , ECS_RO_COMP(capzone_sphere_index_es_event_handler_comps, "eid", ecs::EntityId)
+    , ECS_RO_COMP(capzone_sphere_index_es_event_handler_comps, "transform", TMatrix)
+    , ECS_RO_COMP(capzone_sphere_index_es_event_handler_comps, "sphere_zone__radius", float)
+    , ECS_RO_COMP_OR(capzone_sphere_index_es_event_handler_comps, "sphere_zone__inverted", bool(false))
+    , ECS_RO_COMP_OR(capzone_sphere_index_es_event_handler_comps, "active", bool(true))
+    );
+  while (++comp != compE);
 }
-static constexpr ecs::ComponentDesc active_box_capzones_ecs_query_comps[] =
+static ecs::EntitySystemDesc capzone_sphere_index_es_event_handler_es_desc
+(
+  "capzone_sphere_index_es",
+  "prog/gameLibs/ecs/game/zones/./zoneQueryES.cpp.inl",
+  ecs::EntitySystemOps(nullptr, capzone_sphere_index_es_event_handler_all_events),
+  empty_span(),
+  make_span(capzone_sphere_index_es_event_handler_comps+0, 5)/*ro*/,
+  make_span(capzone_sphere_index_es_event_handler_comps+5, 1)/*rq*/,
+  empty_span(),
+  ecs::EventSetBuilder<ecs::EventEntityCreated,
+                       ecs::EventComponentsAppear,
+                       ecs::EventEntityDestroyed,
+                       ecs::EventComponentsDisappear>::build(),
+  0
+,nullptr,"active,sphere_zone__inverted,sphere_zone__radius,transform");
+static constexpr ecs::ComponentDesc capzone_box_index_es_event_handler_comps[] =
 {
 //start of 4 ro components at [0]
   {ECS_HASH("eid"), ecs::ComponentTypeInfo<ecs::EntityId>()},
@@ -52,34 +51,33 @@ static constexpr ecs::ComponentDesc active_box_capzones_ecs_query_comps[] =
   {ECS_HASH("box_zone"), ecs::ComponentTypeInfo<ecs::Tag>()},
   {ECS_HASH("capzone"), ecs::ComponentTypeInfo<ecs::Tag>()}
 };
-static ecs::CompileTimeQueryDesc active_box_capzones_ecs_query_desc
-(
-  "active_box_capzones_ecs_query",
-  empty_span(),
-  make_span(active_box_capzones_ecs_query_comps+0, 4)/*ro*/,
-  make_span(active_box_capzones_ecs_query_comps+4, 2)/*rq*/,
-  empty_span());
-template<typename Callable>
-inline void active_box_capzones_ecs_query(Callable function)
+static void capzone_box_index_es_event_handler_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
 {
-  perform_query(g_entity_mgr, active_box_capzones_ecs_query_desc.getHandle(),
-    [&function](const ecs::QueryView& __restrict components)
-    {
-        auto comp = components.begin(), compE = components.end(); G_ASSERT(comp != compE); do
-        {
-          if ( !(ECS_RO_COMP_OR(active_box_capzones_ecs_query_comps, "active", bool( true))) )
-            continue;
-          function(
-              ECS_RO_COMP(active_box_capzones_ecs_query_comps, "eid", ecs::EntityId)
-            , ECS_RO_COMP(active_box_capzones_ecs_query_comps, "transform", TMatrix)
-            , ECS_RO_COMP_OR(active_box_capzones_ecs_query_comps, "box_zone__inverted", bool(false))
-            );
-
-        }while (++comp != compE);
-      }
-  );
+  auto comp = components.begin(), compE = components.end(); G_ASSERT(comp!=compE); do
+    capzone_box_index_es_event_handler(evt
+        , ECS_RO_COMP(capzone_box_index_es_event_handler_comps, "eid", ecs::EntityId)
+    , ECS_RO_COMP(capzone_box_index_es_event_handler_comps, "transform", TMatrix)
+    , ECS_RO_COMP_OR(capzone_box_index_es_event_handler_comps, "box_zone__inverted", bool(false))
+    , ECS_RO_COMP_OR(capzone_box_index_es_event_handler_comps, "active", bool(true))
+    );
+  while (++comp != compE);
 }
-static constexpr ecs::ComponentDesc active_relative_poly_capzones_ecs_query_comps[] =
+static ecs::EntitySystemDesc capzone_box_index_es_event_handler_es_desc
+(
+  "capzone_box_index_es",
+  "prog/gameLibs/ecs/game/zones/./zoneQueryES.cpp.inl",
+  ecs::EntitySystemOps(nullptr, capzone_box_index_es_event_handler_all_events),
+  empty_span(),
+  make_span(capzone_box_index_es_event_handler_comps+0, 4)/*ro*/,
+  make_span(capzone_box_index_es_event_handler_comps+4, 2)/*rq*/,
+  empty_span(),
+  ecs::EventSetBuilder<ecs::EventEntityCreated,
+                       ecs::EventComponentsAppear,
+                       ecs::EventEntityDestroyed,
+                       ecs::EventComponentsDisappear>::build(),
+  0
+,nullptr,"active,box_zone__inverted,transform");
+static constexpr ecs::ComponentDesc capzone_poly_index_es_event_handler_comps[] =
 {
 //start of 6 ro components at [0]
   {ECS_HASH("eid"), ecs::ComponentTypeInfo<ecs::EntityId>()},
@@ -91,35 +89,34 @@ static constexpr ecs::ComponentDesc active_relative_poly_capzones_ecs_query_comp
 //start of 1 rq components at [6]
   {ECS_HASH("capzone"), ecs::ComponentTypeInfo<ecs::Tag>()}
 };
-static ecs::CompileTimeQueryDesc active_relative_poly_capzones_ecs_query_desc
-(
-  "active_relative_poly_capzones_ecs_query",
-  empty_span(),
-  make_span(active_relative_poly_capzones_ecs_query_comps+0, 6)/*ro*/,
-  make_span(active_relative_poly_capzones_ecs_query_comps+6, 1)/*rq*/,
-  empty_span());
-template<typename Callable>
-inline void active_relative_poly_capzones_ecs_query(Callable function)
+static void capzone_poly_index_es_event_handler_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
 {
-  perform_query(g_entity_mgr, active_relative_poly_capzones_ecs_query_desc.getHandle(),
-    [&function](const ecs::QueryView& __restrict components)
-    {
-        auto comp = components.begin(), compE = components.end(); G_ASSERT(comp != compE); do
-        {
-          if ( !(ECS_RO_COMP_OR(active_relative_poly_capzones_ecs_query_comps, "active", bool( true))) )
-            continue;
-          function(
-              ECS_RO_COMP(active_relative_poly_capzones_ecs_query_comps, "eid", ecs::EntityId)
-            , ECS_RO_COMP(active_relative_poly_capzones_ecs_query_comps, "capzone__areaPoints", ecs::Point2List)
-            , ECS_RO_COMP(active_relative_poly_capzones_ecs_query_comps, "capzone__minHeight", float)
-            , ECS_RO_COMP(active_relative_poly_capzones_ecs_query_comps, "capzone__maxHeight", float)
-            , ECS_RO_COMP_OR(active_relative_poly_capzones_ecs_query_comps, "poly_zone__inverted", bool(false))
-            );
-
-        }while (++comp != compE);
-      }
-  );
+  auto comp = components.begin(), compE = components.end(); G_ASSERT(comp!=compE); do
+    capzone_poly_index_es_event_handler(evt
+        , ECS_RO_COMP(capzone_poly_index_es_event_handler_comps, "eid", ecs::EntityId)
+    , ECS_RO_COMP(capzone_poly_index_es_event_handler_comps, "capzone__areaPoints", ecs::Point2List)
+    , ECS_RO_COMP(capzone_poly_index_es_event_handler_comps, "capzone__minHeight", float)
+    , ECS_RO_COMP(capzone_poly_index_es_event_handler_comps, "capzone__maxHeight", float)
+    , ECS_RO_COMP_OR(capzone_poly_index_es_event_handler_comps, "poly_zone__inverted", bool(false))
+    , ECS_RO_COMP_OR(capzone_poly_index_es_event_handler_comps, "active", bool(true))
+    );
+  while (++comp != compE);
 }
+static ecs::EntitySystemDesc capzone_poly_index_es_event_handler_es_desc
+(
+  "capzone_poly_index_es",
+  "prog/gameLibs/ecs/game/zones/./zoneQueryES.cpp.inl",
+  ecs::EntitySystemOps(nullptr, capzone_poly_index_es_event_handler_all_events),
+  empty_span(),
+  make_span(capzone_poly_index_es_event_handler_comps+0, 6)/*ro*/,
+  make_span(capzone_poly_index_es_event_handler_comps+6, 1)/*rq*/,
+  empty_span(),
+  ecs::EventSetBuilder<ecs::EventEntityCreated,
+                       ecs::EventComponentsAppear,
+                       ecs::EventEntityDestroyed,
+                       ecs::EventComponentsDisappear>::build(),
+  0
+,nullptr,"active,capzone__areaPoints,capzone__maxHeight,capzone__minHeight,poly_zone__inverted");
 static constexpr ecs::ComponentDesc box_zone_ecs_query_comps[] =
 {
 //start of 2 ro components at [0]
@@ -1,50 +1,104 @@
 #include <ecs/game/zones/zoneQuery.h>
 #include <ecs/core/entityManager.h>
+#include <daECS/core/coreEvents.h>
 #include <math/dag_mathUtils.h>
 #include <math/dag_math2d.h>
 #include <math/dag_math3d.h>
-
-template <typename Callable>
-inline void active_sphere_capzones_ecs_query(Callable c);
-template <typename Callable>
-inline void active_box_capzones_ecs_query(Callable c);
-template <typename Callable>
-inline void active_relative_poly_capzones_ecs_query(Callable c);
+#include <math/dag_bounds2.h>
+#include <memory/dag_framemem.h>
+#include "capzonesIndex.h"
 
 namespace game
 {
 extern const BBox3 IDENTITY_BBOX3(Point3(-0.5f, -0.5f, -0.5f), Point3(0.5f, 0.5f, 0.5f));
 }
 
+using capzones::ZoneShape;
+
+static capzones::CapzonesIndex capzones_index;
+
+static inline bool is_zone_disappear_event(const ecs::Event &evt)
+{
+  return evt.is<ecs::EventEntityDestroyed>() || evt.is<ecs::EventComponentsDisappear>();
+}
+
+ECS_TRACK(transform, sphere_zone__radius, sphere_zone__inverted, active)
+ECS_ON_EVENT(on_appear, on_disappear)
+ECS_REQUIRE(ecs::Tag capzone)
+static void capzone_sphere_index_es_event_handler(const ecs::Event &evt, ecs::EntityId eid, const TMatrix &transform,
+  float sphere_zone__radius, bool sphere_zone__inverted = false, bool active = true)
+{
+  if (!active || is_zone_disappear_event(evt))
+    capzones_index.remove(eid, ZoneShape::Sphere);
+  else
+    capzones_index.setSphere(eid, transform, sphere_zone__radius, sphere_zone__inverted);
+}
+
+ECS_TRACK(transform, box_zone__inverted, active)
+ECS_ON_EVENT(on_appear, on_disappear)
+ECS_REQUIRE(ecs::Tag capzone)
+ECS_REQUIRE(ecs::Tag box_zone)
+static void capzone_box_index_es_event_handler(const ecs::Event &evt, ecs::EntityId eid, const TMatrix &transform,
+  bool box_zone__inverted = false, bool active = true)
+{
+  if (!active || is_zone_disappear_event(evt))
+    capzones_index.remove(eid, ZoneShape::Box);
+  else
+    capzones_index.setBox(eid, transform, box_zone__inverted);
+}
+
+ECS_TRACK(capzone__areaPoints, capzone__minHeight, capzone__maxHeight, poly_zone__inverted, active)
+ECS_ON_EVENT(on_appear, on_disappear)
+ECS_REQUIRE(ecs::Tag capzone)
+static void capzone_poly_index_es_event_handler(const ecs::Event &evt, ecs::EntityId eid, const ecs::Point2List &capzone__areaPoints,
+  float capzone__minHeight, float capzone__maxHeight, bool poly_zone__inverted = false, bool active = true)
+{
+  if (!active || is_zone_disappear_event(evt))
+    capzones_index.remove(eid, ZoneShape::Poly);
+  else
+    capzones_index.setPoly(eid, capzone__areaPoints, capzone__minHeight, capzone__maxHeight, poly_zone__inverted);
+}
+
+// zones are returned in order of shapes (spheres, boxes, then polygons) as ECS queries used to return them
 void game::get_active_capzones_on_pos(const Point3 &pos, const char *tag_to_have_not_null, Tab<ecs::EntityId> &zones_in)
 {
   const ecs::EntityManager *emgr = g_entity_mgr.operator->();
   ecs::HashedConstString tagToHave = ECS_HASH_SLOW(tag_to_have_not_null);
-  active_sphere_capzones_ecs_query([&](ECS_REQUIRE(eastl::true_type active = true) ECS_REQUIRE(ecs::Tag capzone) ecs::EntityId eid,
-                                     const TMatrix &transform, float sphere_zone__radius, bool sphere_zone__inverted = false) {
-    if (emgr->has(eid, tagToHave))
-      if (sphere_zone__inverted ^ (lengthSq(inverse(transform) * pos) < sqr(sphere_zone__radius)))
-        zones_in.push_back(eid);
-  });
-  active_box_capzones_ecs_query(
-    [&](ECS_REQUIRE(eastl::true_type active = true) ECS_REQUIRE(ecs::Tag capzone) ECS_REQUIRE(ecs::Tag box_zone) ecs::EntityId eid,
-      const TMatrix &transform, bool box_zone__inverted = false) {
-      if (emgr->has(eid, tagToHave))
-        if (box_zone__inverted ^ (IDENTITY_BBOX3 & (inverse(transform) * pos)))
-          zones_in.push_back(eid);
-    });
-  active_relative_poly_capzones_ecs_query(
-    [&](ECS_REQUIRE(eastl::true_type active = true) ECS_REQUIRE(ecs::Tag capzone) ecs::EntityId eid,
-      const ecs::Point2List &capzone__areaPoints, const float capzone__minHeight, const float capzone__maxHeight,
-      bool poly_zone__inverted = false) {
-      if (emgr->has(eid, tagToHave))
-      {
-        const bool isInPolyZone = (pos.y > capzone__minHeight && pos.y < capzone__maxHeight) &&
-                                  is_point_in_poly(Point2::xz(pos), capzone__areaPoints.data(), capzone__areaPoints.size());
-        if (poly_zone__inverted ^ isInPolyZone)
-          zones_in.push_back(eid);
-      }
-    });
+  Tab<uint32_t> hits(framemem_ptr());
+  capzones_index.lockQuery();
+  capzones_index.gatherZones(
+    pos, [&](uint32_t zone_idx) { return emgr->has(capzones_index.zones[zone_idx].eid, tagToHave); }, hits);
+  for (uint32_t zoneIdx : hits)
+    zones_in.push_back(capzones_index.zones[zoneIdx].eid);
+  capzones_index.unlockQuery();
+}
+
+void game::get_active_capzones_on_points(dag::ConstSpan<Point3> points, const char *tag_to_have_not_null,
+  Tab<ecs::EntityId> &zones_in, Tab<int> &zones_ofs)
+{
+  const ecs::EntityManager *emgr = g_entity_mgr.operator->();
+  ecs::HashedConstString tagToHave = ECS_HASH_SLOW(tag_to_have_not_null);
+  clear_and_resize(zones_ofs, points.size() + 1);
+  Tab<uint32_t> hits(framemem_ptr());
+  capzones_index.lockQuery();
+  Tab<int8_t> hasTag(framemem_ptr()); // tag check is cached per zone, -1 is not checked yet
+  hasTag.resize(capzones_index.zones.size(), -1);
+  auto filter = [&](uint32_t zone_idx) {
+    int8_t &tagCheck = hasTag[zone_idx];
+    if (tagCheck < 0)
+      tagCheck = emgr->has(capzones_index.zones[zone_idx].eid, tagToHave) ? 1 : 0;
+    return tagCheck != 0;
+  };
+  for (int i = 0; i < points.size(); ++i)
+  {
+    zones_ofs[i] = zones_in.size();
+    hits.clear();
+    capzones_index.gatherZones(points[i], filter, hits);
+    for (uint32_t zoneIdx : hits)
+      zones_in.push_back(capzones_index.zones[zoneIdx].eid);
+  }
+  zones_ofs[points.size()] = zones_in.size();
+  capzones_index.unlockQuery();
 }
 
 template <typename Callable>
@@ -62,6 +116,13 @@ inline bool relative_box_zone_ecs_query(ecs::EntityId eid, Callable c);
 bool game::is_point_in_capzone(const Point3 &pos, ecs::EntityId zone_eid, float zone_scale)
 {
   bool res = false;
+  { // active capzones are indexed with all their shapes, so check can be done on cached data with same priority of shapes
+    ScopedLockReadTemplate<OSReadWriteLock> lock(capzones_index.lock);
+    for (ZoneShape shape : {ZoneShape::Box, ZoneShape::Sphere, ZoneShape::Poly})
+      if (const capzones::IndexedZone *zone = capzones_index.get(zone_eid, shape))
+        return capzones::is_point_in_zone(*zone, pos, zone_scale);
+  }
+
   if (box_zone_ecs_query(zone_eid, [&](ECS_REQUIRE(ecs::Tag box_zone) const TMatrix &transform, bool box_zone__inverted = false) {
         float halfScale = zone_scale * 0.5f;
         const BBox3 box = BBox3(Point3(-halfScale, -halfScale, -halfScale), Point3(halfScale, halfScale, halfScale));
@@ -6,6 +6,9 @@
 #include <ioSys/dag_dataBlock.h>
 
 #include <ecs/anim/anim.h>
+#include <ecs/anim/animcharUpdateEvent.h>
+#include <math/dag_geomTree.h>
+#include <perfMon/dag_statDrv.h>
 
 #include <util/dag_convar.h>
 
@@ -29,6 +32,51 @@ static __forceinline void particle_phys_es_event_handler(const ecs::EventEntityC
   particle_phys.loadFromBlk(blockName ? blk.getBlockByName(blockName) : &blk, animchar.getOriginalNodeTree());
 }
 
+template <typename Callable>
+static void gather_particle_phys_ecs_query(Callable c);
+
+// all systems are solved in one batch on threadpool, then solved particles are applied to animated node trees
+ECS_TAG(render)
+ECS_AFTER(animchar__updater_es)
+ECS_BEFORE(after_animchar_update_sync)
+static __forceinline void particle_phys_update_es(const UpdateAnimcharEvent &)
+{
+  struct ParticlePhysEntity
+  {
+    AnimV20::AnimcharBaseComponent *animchar;
+    AnimcharNodesMat44 *nodeWtm;
+    vec3f *rootPos;
+    const TMatrix *transform;
+  };
+  Tab<daphys::ParticlePhysSystem *> systems(framemem_ptr());
+  Tab<ParticlePhysEntity> entities(framemem_ptr());
+  gather_particle_phys_ecs_query(
+    [&](daphys::ParticlePhysSystem &particle_phys, AnimV20::AnimcharBaseComponent &animchar, AnimcharNodesMat44 *animchar_node_wtm,
+      vec3f *animchar_render__root_pos, const TMatrix &transform) {
+      if (particle_phys.empty())
+        return;
+      systems.push_back(&particle_phys);
+      entities.push_back(ParticlePhysEntity{&animchar, animchar_node_wtm, animchar_render__root_pos, &transform});
+    });
+  if (systems.empty())
+    return;
+
+  daphys::ParticlePhysSystem::update_batch(systems);
+
+  TIME_PROFILE(particle_phys_update_node_trees);
+  for (int i = 0; i < systems.size(); ++i)
+  {
+    const ParticlePhysEntity &e = entities[i];
+    GeomNodeTree &tree = e.animchar->getNodeTree();
+    systems[i]->updateGeomNodeTree(&tree, *e.transform);
+    tree.validateTm();
+    tree.invalidateWtm();
+    tree.calcWtm();
+    if (e.nodeWtm && e.rootPos)
+      animchar_copy_nodes(*e.animchar, *e.nodeWtm, *e.rootPos);
+  }
+}
+
 ECS_NO_ORDER
 ECS_TAG(render, dev)
 inline void particle_phys_debug_es(const ecs::UpdateStageInfoRenderDebug &, const TMatrix &transform,
@@ -1,6 +1,26 @@
 #include "particlePhysSys.cpp"
 //built with ECS codegen version 1.0
 #include <daECS/core/internal/performQuery.h>
+//static constexpr ecs::ComponentDesc particle_phys_update_es_comps[] ={};
+static void particle_phys_update_es_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
+{
+  G_UNUSED(components);
+  G_FAST_ASSERT(evt.is<UpdateAnimcharEvent>());
+  particle_phys_update_es(static_cast<const UpdateAnimcharEvent&>(evt)
+        );
+}
+static ecs::EntitySystemDesc particle_phys_update_es_es_desc
+(
+  "particle_phys_update_es",
+  "prog/gameLibs/ecs/phys/particlePhysSys.cpp",
+  ecs::EntitySystemOps(nullptr, particle_phys_update_es_all_events),
+  empty_span(),
+  empty_span(),
+  empty_span(),
+  empty_span(),
+  ecs::EventSetBuilder<UpdateAnimcharEvent>::build(),
+  0
+,"render",nullptr,"after_animchar_update_sync","animchar__updater_es");
 static constexpr ecs::ComponentDesc particle_phys_debug_es_comps[] =
 {
 //start of 2 ro components at [0]
@@ -60,3 +80,40 @@ static ecs::EntitySystemDesc particle_phys_es_event_handler_es_desc
   ecs::EventSetBuilder<ecs::EventEntityCreated>::build(),
   0
 ,"render");
+static constexpr ecs::ComponentDesc gather_particle_phys_ecs_query_comps[] =
+{
+//start of 4 rw components at [0]
+  {ECS_HASH("particle_phys"), ecs::ComponentTypeInfo<daphys::ParticlePhysSystem>()},
+  {ECS_HASH("animchar"), ecs::ComponentTypeInfo<AnimV20::AnimcharBaseComponent>()},
+  {ECS_HASH("animchar_node_wtm"), ecs::ComponentTypeInfo<AnimcharNodesMat44>(), ecs::CDF_OPTIONAL},
+  {ECS_HASH("animchar_render__root_pos"), ecs::ComponentTypeInfo<vec3f>(), ecs::CDF_OPTIONAL},
+//start of 1 ro components at [4]
+  {ECS_HASH("transform"), ecs::ComponentTypeInfo<TMatrix>()}
+};
+static ecs::CompileTimeQueryDesc gather_particle_phys_ecs_query_desc
+(
+  "gather_particle_phys_ecs_query",
+  make_span(gather_particle_phys_ecs_query_comps+0, 4)/*rw*/,
+  make_span(gather_particle_phys_ecs_query_comps+4, 1)/*ro*/,
+  empty_span(),
+  empty_span());
+template<typename Callable>
+inline void gather_particle_phys_ecs_query(Callable function)
+{
+  perform_query(g_entity_mgr, gather_particle_phys_ecs_query_desc.getHandle(),
+    [&function](const ecs::QueryView& __restrict components)
+    {
+        auto comp = components.begin(), compE = components.end(); G_ASSERT(comp != compE); do
+        {
+          function(
+              ECS_RW_COMP(gather_particle_phys_ecs_query_comps, "particle_phys", daphys::ParticlePhysSystem)
+            , ECS_RW_COMP(gather_particle_phys_ecs_query_comps, "animchar", AnimV20::AnimcharBaseComponent)
+            , ECS_RW_COMP_PTR(gather_particle_phys_ecs_query_comps, "animchar_node_wtm", AnimcharNodesMat44)
+            , ECS_RW_COMP_PTR(gather_particle_phys_ecs_query_comps, "animchar_render__root_pos", vec3f)
+            , ECS_RO_COMP(gather_particle_phys_ecs_query_comps, "transform", TMatrix)
+            );
+
+        }while (++comp != compE);
+    }
+  );
+}
@@ -51,6 +51,26 @@ static ecs::EntitySystemDesc ragdoll_start_es_event_handler_es_desc
   ecs::EventSetBuilder<ParallelUpdateFrameDelayed>::build(),
   0
 ,nullptr,nullptr,"start_async_phys_sim_es");
+//static constexpr ecs::ComponentDesc ragdoll_budget_es_comps[] ={};
+static void ragdoll_budget_es_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
+{
+  G_UNUSED(components);
+  G_FAST_ASSERT(evt.is<ParallelUpdateFrameDelayed>());
+  ragdoll_budget_es(static_cast<const ParallelUpdateFrameDelayed&>(evt)
+        );
+}
+static ecs::EntitySystemDesc ragdoll_budget_es_es_desc
+(
+  "ragdoll_budget_es",
+  "prog/gameLibs/ecs/phys/ragdollES.cpp.inl",
+  ecs::EntitySystemOps(nullptr, ragdoll_budget_es_all_events),
+  empty_span(),
+  empty_span(),
+  empty_span(),
+  empty_span(),
+  ecs::EventSetBuilder<ParallelUpdateFrameDelayed>::build(),
+  0
+,nullptr,nullptr,"start_async_phys_sim_es","ragdoll_start_es");
 static constexpr ecs::ComponentDesc ragdoll_alive_es_event_handler_comps[] =
 {
 //start of 1 rw components at [0]
@@ -121,3 +141,36 @@ static ecs::EntitySystemDesc ragdoll_dead_es_event_handler_es_desc
   ecs::EventSetBuilder<EventOnPhysImpulse>::build(),
   0
 );
+static constexpr ecs::ComponentDesc get_ragdoll_budget_view_pos_ecs_query_comps[] =
+{
+//start of 2 ro components at [0]
+  {ECS_HASH("transform"), ecs::ComponentTypeInfo<TMatrix>()},
+  {ECS_HASH("camera__active"), ecs::ComponentTypeInfo<bool>()},
+//start of 1 rq components at [2]
+  {ECS_HASH("camera_view"), ecs::ComponentTypeInfo<ecs::Tag>()}
+};
+static ecs::CompileTimeQueryDesc get_ragdoll_budget_view_pos_ecs_query_desc
+(
+  "get_ragdoll_budget_view_pos_ecs_query",
+  empty_span(),
+  make_span(get_ragdoll_budget_view_pos_ecs_query_comps+0, 2)/*ro*/,
+  make_span(get_ragdoll_budget_view_pos_ecs_query_comps+2, 1)/*rq*/,
+  empty_span());
+template<typename Callable>
+inline void get_ragdoll_budget_view_pos_ecs_query(Callable function)
+{
+  perform_query(g_entity_mgr, get_ragdoll_budget_view_pos_ecs_query_desc.getHandle(),
+    [&function](const ecs::QueryView& __restrict components)
+    {
+        auto comp = components.begin(), compE = components.end(); G_ASSERT(comp != compE); do
+        {
+          if ( !(ECS_RO_COMP(get_ragdoll_budget_view_pos_ecs_query_comps, "camera__active", bool)) )
+            continue;
+          function(
+              ECS_RO_COMP(get_ragdoll_budget_view_pos_ecs_query_comps, "transform", TMatrix)
+            );
+
+        }while (++comp != compE);
+      }
+  );
+}
@@ -8,12 +8,18 @@
 #include <phys/dag_physDecl.h>
 #include <phys/dag_physics.h>
 #include <daECS/net/time.h>
+#include <startup/dag_globalSettings.h>
+#include <ioSys/dag_dataBlock.h>
+#include <util/dag_convar.h>
 
 #define PHYS_ECS_EVENT ECS_REGISTER_EVENT
 PHYS_ECS_EVENTS
 #undef PHYS_ECS_EVENT
 typedef PhysRagdoll ragdoll_t;
 
+template <typename Callable>
+inline void get_ragdoll_budget_view_pos_ecs_query(Callable c);
+
 class RagdollCTM final : public ecs::ComponentTypeManager
 {
 public:
@@ -30,6 +36,8 @@ public:
 
     ragdoll->setRecalcWtms(true);
     ragdoll->setContinuousCollisionMode(mgr.getOr(eid, ECS_HASH("ragdoll__use_ccd"), false));
+    ragdoll->setSleepParams(mgr.getOr(eid, ECS_HASH("ragdoll__sleepLinVel"), 0.1f), mgr.getOr(eid, ECS_HASH("ragdoll__sleepAngVel"), 0.2f),
+      mgr.getOr(eid, ECS_HASH("ragdoll__sleepTime"), 0.f));
 
     if (mgr.getOr(eid, ECS_HASH("ragdoll__active"), false))
     {
@@ -158,6 +166,27 @@ inline void ragdoll_start_es_event_handler(const ParallelUpdateFrameDelayed &inf
   ragdoll__applyParams = false;
 }
 
+CONSOLE_INT_VAL("phys", ragdoll_active_budget, -1, -1, 4096); // overrides settings when not negative
+
+// Simulated ragdolls over budget (ragdoll{activeBudget:i=...} in settings or phys.ragdoll_active_budget, unlimited by default) are
+// baked, farthest from camera first. Runs before physics simulation is started, as ragdolls are destroyed on baking.
+ECS_BEFORE(start_async_phys_sim_es)
+ECS_AFTER(ragdoll_start_es)
+static inline void ragdoll_budget_es(const ParallelUpdateFrameDelayed &)
+{
+  const int budget = ragdoll_active_budget.get() >= 0 ? ragdoll_active_budget.get()
+                                                      : ::dgs_get_settings()->getBlockByNameEx("ragdoll")->getInt("activeBudget", -1);
+  PhysRagdoll::set_active_budget(budget);
+  if (budget < 0)
+    return;
+  if (PhysRagdoll::get_active_count() <= budget)
+    return;
+  Point3 viewPos(0.f, 0.f, 0.f);
+  get_ragdoll_budget_view_pos_ecs_query(
+    [&](const TMatrix &transform ECS_REQUIRE(eastl::true_type camera__active, ecs::Tag camera_view)) { viewPos = transform.getcol(3); });
+  PhysRagdoll::enforce_budget(viewPos);
+}
+
 ECS_REQUIRE(eastl::true_type isAlive)
 inline void ragdoll_alive_es_event_handler(const EventOnPhysImpulse &evt, ProjectileImpulse &projectile_impulse,
   float projectile_impulse__impulseSaveDeltaTime = 1.f)
@@ -73,11 +73,14 @@ static ecs::EntitySystemDesc floating_phys_ripples_render_debug_es_es_desc
 ,"dev,render",nullptr,"*");
 static constexpr ecs::ComponentDesc update_floating_rendinsts_es_comps[] =
 {
-//start of 4 ro components at [0]
+//start of 7 ro components at [0]
   {ECS_HASH("floatingRiSystem__randomWavesAmplitude"), ecs::ComponentTypeInfo<float>()},
   {ECS_HASH("floatingRiSystem__randomWavesLength"), ecs::ComponentTypeInfo<float>()},
   {ECS_HASH("floatingRiSystem__randomWavesPeriod"), ecs::ComponentTypeInfo<float>()},
-  {ECS_HASH("floatingRiSystem__randomWavesVelocity"), ecs::ComponentTypeInfo<Point2>()}
+  {ECS_HASH("floatingRiSystem__randomWavesVelocity"), ecs::ComponentTypeInfo<Point2>()},
+  {ECS_HASH("floatingRiSystem__waterHeightReuseDist"), ecs::ComponentTypeInfo<float>(), ecs::CDF_OPTIONAL},
+  {ECS_HASH("floatingRiSystem__waterHeightReuseTime"), ecs::ComponentTypeInfo<float>(), ecs::CDF_OPTIONAL},
+  {ECS_HASH("floatingRiSystem__waterHeightReuseMaxError"), ecs::ComponentTypeInfo<float>(), ecs::CDF_OPTIONAL}
 };
 static void update_floating_rendinsts_es_all_events(const ecs::Event &__restrict evt, const ecs::QueryView &__restrict components)
 {
@@ -88,6 +91,9 @@ static void update_floating_rendinsts_es_all_events(const ecs::Event &__restrict
     , ECS_RO_COMP(update_floating_rendinsts_es_comps, "floatingRiSystem__randomWavesLength", float)
     , ECS_RO_COMP(update_floating_rendinsts_es_comps, "floatingRiSystem__randomWavesPeriod", float)
     , ECS_RO_COMP(update_floating_rendinsts_es_comps, "floatingRiSystem__randomWavesVelocity", Point2)
+    , ECS_RO_COMP_OR(update_floating_rendinsts_es_comps, "floatingRiSystem__waterHeightReuseDist", float(0.05f))
+    , ECS_RO_COMP_OR(update_floating_rendinsts_es_comps, "floatingRiSystem__waterHeightReuseTime", float(0.1f))
+    , ECS_RO_COMP_OR(update_floating_rendinsts_es_comps, "floatingRiSystem__waterHeightReuseMaxError", float(0.01f))
     );
   while (++comp != compE);
 }
@@ -97,7 +103,7 @@ static ecs::EntitySystemDesc update_floating_rendinsts_es_es_desc
   "prog/gameLibs/ecs/rendInst/./rendinstFloatingES.cpp.inl",
   ecs::EntitySystemOps(nullptr, update_floating_rendinsts_es_all_events),
   empty_span(),
-  make_span(update_floating_rendinsts_es_comps+0, 4)/*ro*/,
+  make_span(update_floating_rendinsts_es_comps+0, 7)/*ro*/,
   empty_span(),
   empty_span(),
   ecs::EventSetBuilder<ParallelUpdateFrameDelayed>::build(),
@@ -190,11 +190,11 @@ static bool is_ri_on_ground(int res_idx, int inst_idx, float dist_tolerance)
   return tracingResult && (groundHeight > bottomHeight - dist_tolerance);
 }
 
-static int remove_invalid_floating_phys_instances(eastl::vector<rendinstfloating::RiFloatingPhys> &instances,
-  dag::ConstSpan<mat43f> ri_tm)
+static int remove_invalid_floating_phys_instances(eastl::vector<rendinstfloating::RiFloatingPhys> &instances, int res_idx,
+  int ri_count)
 {
-  auto newEnd = eastl::remove_if(instances.begin(), instances.end(), [&ri_tm](const auto &ri_floating_phys) {
-    return ri_floating_phys.riInstId >= ri_tm.size() || !rendinst::riex_is_instance_valid(ri_tm[ri_floating_phys.riInstId]);
+  auto newEnd = eastl::remove_if(instances.begin(), instances.end(), [res_idx, ri_count](const auto &ri_floating_phys) {
+    return ri_floating_phys.riInstId >= ri_count || !rendinst::riex_is_instance_valid(res_idx, ri_floating_phys.riInstId);
   });
   int removedCnt = instances.end() - newEnd;
   instances.resize(newEnd - instances.begin());
@@ -291,7 +291,8 @@ static rendinstfloating::RiFloatingPhys create_ri_floating_phys(mat43f_cref ri_t
 static void update_floating_phys(float at_time, int &cur_tick, int interaction_type, float inv_mass, float elasticity,
   float phys_update_dt, float max_shift_dist, Point3 inv_moment_of_inertia, float spheres_radius, float spheres_viscosity,
   const dag::Vector<Point3> &spheres_coords, BBox3 phys_bbox, const Obstacle *obstacles, int obstacles_cnt, float waves_amplitude,
-  float waves_inv_length, float waves_inv_period, Point2 waves_velocity, rendinstfloating::RiFloatingPhys &phys)
+  float waves_inv_length, float waves_inv_period, Point2 waves_velocity,
+  const gamephys::floating_volumes::WaterHeightsReuse &water_heights_reuse, rendinstfloating::RiFloatingPhys &phys)
 {
   const float dt = phys_update_dt;
   static const float MAX_ADD_INTERACTION_VELOCITY = 10.0f;
@@ -303,6 +304,8 @@ static void update_floating_phys(float at_time, int &cur_tick, int interaction_t
   Point3 &velocity = phys.velocity;
   Point3 &omega = phys.omega;
 
+  gamephys::floating_volumes::WaterHeightsCache *waterHeightsCache = phys.waterHeights.prepare(water_heights_reuse);
+
   int volumeCount = spheres_coords.size();
   BSphere3 volumes[gamephys::floating_volumes::MAX_VOLUMES];
   Point3 center_of_gravity(0, 0, 0);
@@ -319,13 +322,14 @@ static void update_floating_phys(float at_time, int &cur_tick, int interaction_t
     Quat invOrient = inverse(location.O.getQuat());
     Point3 pos = tm.getcol(3);
 
+    Point3 volumesWorldPos[gamephys::floating_volumes::MAX_VOLUMES];
     float waterDists[gamephys::floating_volumes::MAX_VOLUMES];
+    gamephys::floating_volumes::get_water_heights(volumes, volumeCount, tm, curTime, 200.f, 0.1f, volumesWorldPos, waterDists,
+      waterHeightsCache, water_heights_reuse);
     for (int i = 0; i < volumeCount; ++i)
     {
-      Point3 volumeWorldPos = tm * volumes[i].c;
-      bool underwater;
-      float shallowHt = volumes[i].r + 0.1f;
-      float waterHeight = dacoll::traceht_water_at_time(volumeWorldPos, 200.f, curTime, underwater, shallowHt);
+      const Point3 &volumeWorldPos = volumesWorldPos[i];
+      float waterHeight = waterDists[i];
       if (waves_amplitude != 0.0f)
       {
         Point2 wavesShift = curTime * waves_velocity;
@@ -499,11 +503,18 @@ void rendinstfloating::init_floating_ri_res_groups(const DataBlock *ri_config, b
 
 ECS_TAG(gameClient)
 static void update_floating_rendinsts_es(const ParallelUpdateFrameDelayed &info, float floatingRiSystem__randomWavesAmplitude,
-  float floatingRiSystem__randomWavesLength, float floatingRiSystem__randomWavesPeriod, Point2 floatingRiSystem__randomWavesVelocity)
+  float floatingRiSystem__randomWavesLength, float floatingRiSystem__randomWavesPeriod, Point2 floatingRiSystem__randomWavesVelocity,
+  float floatingRiSystem__waterHeightReuseDist = 0.05f, float floatingRiSystem__waterHeightReuseTime = 0.1f,
+  float floatingRiSystem__waterHeightReuseMaxError = 0.01f)
 {
   if (!dacoll::get_water())
     return;
 
+  gamephys::floating_volumes::WaterHeightsReuse waterHeightsReuse;
+  waterHeightsReuse.dist = floatingRiSystem__waterHeightReuseDist;
+  waterHeightsReuse.time = floatingRiSystem__waterHeightReuseTime;
+  waterHeightsReuse.maxHeightError = floatingRiSystem__waterHeightReuseMaxError;
+
   bool prepared = false;
   vec3f viewPos = get_camera_pos();
   static float maxUpdateDistSq = 0.0f; // Will be one frame delay, but it's ok. TODO: move to floating_rendinst_res_group component
@@ -528,19 +539,19 @@ static void update_floating_rendinsts_es(const ParallelUpdateFrameDelayed &info,
     int removedCnt;
     {
       rendinst::ScopedRIExtraReadLock rlock;
-      dag::ConstSpan<mat43f> riTm = rendinst::riex_get_instance_matrices(resIdx);
+      const int riCount = rendinst::riex_get_instance_count(resIdx);
       int &processedRiTmCount = floatingRiGroup__riPhysFloatingModel.processedRiTmCount;
-      if (riTm.size() != processedRiTmCount)
+      if (riCount != processedRiTmCount)
       {
         if (EASTL_LIKELY(!processedRiTmCount))
         {
           bool foundClose = false;
           vec4f udsq = v_set_x(floatingRiGroup__updateDistSq);
           // Note: can be further optimized by iterating like
-          // for (int riInstId = dagor_frame_no() % 3; rendinst < riTm.size(); riInstId += 3)
-          for (const mat43f &m : riTm)
+          // for (int riInstId = dagor_frame_no() % 3; rendinst < riCount; riInstId += 3)
+          for (int riInstId = 0; riInstId < riCount; ++riInstId)
           {
-            vec3f ripos = v_perm_xyab(v_perm_xaxa(v_splat_w(m.row0), v_splat_w(m.row1)), v_splat_w(m.row2));
+            vec3f ripos = rendinst::riex_get_instance_pos(resIdx, riInstId);
             if (v_test_vec_x_le(v_length3_sq_x(v_sub(viewPos, ripos)), udsq))
             {
               foundClose = true;
@@ -551,19 +562,19 @@ static void update_floating_rendinsts_es(const ParallelUpdateFrameDelayed &info,
             return;
         }
 
-        for (int riInstId = processedRiTmCount; riInstId < riTm.size(); ++riInstId)
+        for (int riInstId = processedRiTmCount; riInstId < riCount; ++riInstId)
         {
-          if (rendinst::riex_is_instance_valid(riTm[riInstId]) && is_ri_on_water(resIdx, riInstId) &&
+          if (rendinst::riex_is_instance_valid(resIdx, riInstId) && is_ri_on_water(resIdx, riInstId) &&
               !is_ri_on_ground(resIdx, riInstId, floatingRiGroup__minDistToGround))
           {
-            floatingRiGroup__riPhysFloatingModel.instances.push_back(
-              create_ri_floating_phys(riTm[riInstId], riInstId, floatingRiGroup__riPhysFloatingModel.physBbox));
+            floatingRiGroup__riPhysFloatingModel.instances.push_back(create_ri_floating_phys(
+              rendinst::riex_get_instance_matrix(resIdx, riInstId), riInstId, floatingRiGroup__riPhysFloatingModel.physBbox));
           }
         }
 
-        processedRiTmCount = riTm.size();
+        processedRiTmCount = riCount;
       }
-      removedCnt = remove_invalid_floating_phys_instances(floatingRiGroup__riPhysFloatingModel.instances, riTm);
+      removedCnt = remove_invalid_floating_phys_instances(floatingRiGroup__riPhysFloatingModel.instances, resIdx, riCount);
     }
 
     if (EASTL_UNLIKELY(!prepared))
@@ -611,7 +622,8 @@ static void update_floating_rendinsts_es(const ParallelUpdateFrameDelayed &info,
         floatingRiGroup__physUpdateDt, floatingRiGroup__maxShiftDist,
         floatingRiGroup__riPhysFloatingModel.invMomentOfInertiaCoeff * invMass, floatingRiGroup__riPhysFloatingModel.spheresRad,
         floatingRiGroup__viscosity, floatingRiGroup__riPhysFloatingModel.spheresCoords, floatingRiGroup__riPhysFloatingModel.physBbox,
-        obstacles.data(), obstacles.size(), wavesAmplitude, wavesInvLength, wavesInvPeriod, wavesVelocity, riFloatingPhys);
+        obstacles.data(), obstacles.size(), wavesAmplitude, wavesInvLength, wavesInvPeriod, wavesVelocity, waterHeightsReuse,
+        riFloatingPhys);
 
       // Moving rendinst is too expensive, so check here if it was really moved.
       Quat orientDiffQuat = riFloatingPhys.visualLoc.O.getQuat() - riFloatingPhys.prevVisualLoc.O.getQuat();
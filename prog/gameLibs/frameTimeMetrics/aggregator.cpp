@@ -19,6 +19,7 @@ void FrameTimeMetricsAggregator::update(const float current_time_msec, const uin
     displayMode = PerfDisplayMode::OFF; // To reset counter
   minFrameTime = min(dt, minFrameTime);
   maxFrameTime = max(dt, maxFrameTime);
+  frameTimeHistogram.record(uint32_t(dt * 1e6f));
   if (int(current_time_msec) > (lastPeriod + 1) * update_rate_msec.get() || display_mode != displayMode)
   {
     displayMode = display_mode;
@@ -40,6 +41,10 @@ void FrameTimeMetricsAggregator::update(const float current_time_msec, const uin
     maxFrameTime = 0.f;
     minFrameTime = 1000.f;
 
+    FrameTimeHistogram::Snapshot frameTimes;
+    frameTimeHistogram.merge(frameTimes);
+    lastP99FrameTime = frameTimes.getPercentileUs(99.f) / 1000.f;
+
     lowlatency::LatencyData latencyData;
     if (display_mode != PerfDisplayMode::OFF && display_mode != PerfDisplayMode::FPS)
     {
@@ -60,8 +65,8 @@ void FrameTimeMetricsAggregator::update(const float current_time_msec, const uin
     else if (displayMode == PerfDisplayMode::COMPACT)
       fpsText.sprintf("FPS:%5.1f", lastAverageFps);
     else
-      fpsText.sprintf("%s FPS:%5.1f (%4.1f<%4.1f %4.1f)", d3d::get_driver_name(), lastAverageFps, lastMinFrameTime, lastMaxFrameTime,
-        lastAverageFrameTime);
+      fpsText.sprintf("%s FPS:%5.1f (%4.1f<%4.1f %4.1f p99:%4.1f)", d3d::get_driver_name(), lastAverageFps, lastMinFrameTime,
+        lastMaxFrameTime, lastAverageFrameTime, lastP99FrameTime);
     switch (display_mode)
     {
       case PerfDisplayMode::OFF:
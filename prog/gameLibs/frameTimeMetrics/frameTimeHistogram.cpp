@@ -0,0 +1,118 @@
+#include "frameTimeMetrics/frameTimeHistogram.h"
+#include <osApiWrappers/dag_atomic.h>
+#include <util/dag_globDef.h>
+#include <util/dag_compilerDefs.h>
+#include <math/dag_mathBase.h>
+#include <string.h>
+#include <limits.h>
+
+static constexpr int SHARED_SHARD = FrameTimeHistogram::MAX_SHARDS - 1;
+static volatile int threads_registered = 0;
+static thread_local int thread_shard = -1;
+
+static inline int get_thread_shard()
+{
+  if (DAGOR_UNLIKELY(thread_shard < 0))
+    thread_shard = min(interlocked_increment(threads_registered) - 1, SHARED_SHARD);
+  return thread_shard;
+}
+
+// only owner thread writes to shard, so no read-modify-write instruction is needed
+static inline void owned_add(volatile uint32_t &v, uint32_t inc) { interlocked_relaxed_store(v, interlocked_relaxed_load(v) + inc); }
+
+FrameTimeHistogram::FrameTimeHistogram()
+{
+  memset((void *)shards, 0, sizeof(shards));
+  memset(merged, 0, sizeof(merged));
+  for (Shard &shard : shards)
+    shard.minUs = UINT_MAX;
+}
+
+void FrameTimeHistogram::record(uint32_t usec)
+{
+  const int shardNo = get_thread_shard();
+  Shard &shard = shards[shardNo];
+  if (DAGOR_LIKELY(shardNo != SHARED_SHARD))
+  {
+    owned_add(shard.counts[getBucket(usec)], 1);
+    owned_add(shard.sumUs, usec);
+  }
+  else
+  {
+    interlocked_increment(shard.counts[getBucket(usec)]);
+    interlocked_add(shard.sumUs, usec);
+  }
+  // min/max are reset only by merge() and rarely change after that, so CAS is almost never executed
+  for (uint32_t cur = interlocked_relaxed_load(shard.minUs); usec < cur;)
+  {
+    const uint32_t prev = interlocked_compare_exchange(shard.minUs, usec, cur);
+    if (prev == cur)
+      break;
+    cur = prev;
+  }
+  for (uint32_t cur = interlocked_relaxed_load(shard.maxUs); usec > cur;)
+  {
+    const uint32_t prev = interlocked_compare_exchange(shard.maxUs, usec, cur);
+    if (prev == cur)
+      break;
+    cur = prev;
+  }
+}
+
+void FrameTimeHistogram::merge(Snapshot &out)
+{
+  const int usedShards = min(interlocked_acquire_load(threads_registered), MAX_SHARDS);
+  for (int i = 0; i < usedShards; ++i)
+  {
+    Shard &shard = shards[i];
+    Merged &prev = merged[i];
+    // counters are only read here, so values recorded meanwhile go either to this merge or to next one (differences are correct
+    // for wrapped around counters too)
+    for (int b = 0; b < BUCKETS_COUNT; ++b)
+    {
+      const uint32_t total = interlocked_relaxed_load(shard.counts[b]);
+      const uint32_t cnt = total - prev.counts[b];
+      prev.counts[b] = total;
+      out.counts[b] += cnt;
+      out.count += cnt;
+    }
+    const uint32_t sumUs = interlocked_relaxed_load(shard.sumUs);
+    out.sumUs += sumUs - prev.sumUs;
+    prev.sumUs = sumUs;
+    out.minUs = min(out.minUs, interlocked_exchange(shard.minUs, uint32_t(UINT_MAX)));
+    out.maxUs = max(out.maxUs, interlocked_exchange(shard.maxUs, 0u));
+  }
+}
+
+void FrameTimeHistogram::Snapshot::reset()
+{
+  memset(counts, 0, sizeof(counts));
+  count = sumUs = 0;
+  minUs = UINT_MAX;
+  maxUs = 0;
+}
+
+void FrameTimeHistogram::Snapshot::add(const Snapshot &other)
+{
+  for (int b = 0; b < BUCKETS_COUNT; ++b)
+    counts[b] += other.counts[b];
+  count += other.count;
+  sumUs += other.sumUs;
+  minUs = min(minUs, other.minUs);
+  maxUs = max(maxUs, other.maxUs);
+}
+
+uint32_t FrameTimeHistogram::Snapshot::getPercentileUs(float percentile) const
+{
+  if (!count)
+    return 0;
+  const uint64_t target = max(uint64_t(1), uint64_t(double(count) * clamp(percentile, 0.f, 100.f) / 100.0 + 0.5));
+  uint64_t acc = 0;
+  for (int b = 0; b < BUCKETS_COUNT; ++b)
+  {
+    acc += counts[b];
+    if (acc >= target)
+      return clamp(getBucketLowerBound(b), minUs, maxUs);
+  }
+  return maxUs;
+}
@@ -0,0 +1,99 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <frameTimeMetrics/frameTimeHistogram.h>
+#include <EASTL/unique_ptr.h>
+#include <limits.h>
+
+using Histogram = FrameTimeHistogram;
+
+TEST(GetBucket)
+{
+  for (uint32_t v = 0; v < Histogram::SUB_BUCKETS; v++)
+    CHECK_EQUAL(int(v), Histogram::getBucket(v));
+  CHECK_EQUAL(16, Histogram::getBucket(16));
+  CHECK_EQUAL(31, Histogram::getBucket(31));
+  CHECK_EQUAL(32, Histogram::getBucket(32));
+  CHECK_EQUAL(32, Histogram::getBucket(33));
+  CHECK_EQUAL(33, Histogram::getBucket(34));
+  CHECK_EQUAL(Histogram::BUCKETS_COUNT - 1, Histogram::getBucket(UINT_MAX));
+
+  int prev = 0;
+  for (uint32_t v = 1; v < (1u << 20); v += (v >> 6) + 1)
+  {
+    const int bucket = Histogram::getBucket(v);
+    CHECK(bucket >= prev && bucket < Histogram::BUCKETS_COUNT);
+    prev = bucket;
+  }
+}
+
+TEST(GetBucketLowerBound)
+{
+  for (int b = 0; b < Histogram::BUCKETS_COUNT; b++)
+  {
+    const uint32_t lower = Histogram::getBucketLowerBound(b);
+    CHECK_EQUAL(b, Histogram::getBucket(lower));
+    if (b > 0)
+      CHECK_EQUAL(b - 1, Histogram::getBucket(lower - 1));
+  }
+  // relative error of lower bound is less than 1 / SUB_BUCKETS
+  for (uint32_t v = 1; v < UINT_MAX / 2; v += (v >> 3) + 1)
+  {
+    const uint32_t lower = Histogram::getBucketLowerBound(Histogram::getBucket(v));
+    CHECK(lower <= v);
+    CHECK(double(v - lower) < double(v) / Histogram::SUB_BUCKETS);
+  }
+}
+
+TEST(Percentiles)
+{
+  eastl::unique_ptr<Histogram> hist = eastl::make_unique<Histogram>();
+  Histogram::Snapshot snap;
+  CHECK_EQUAL(0u, snap.getPercentileUs(50.f));
+
+  for (uint32_t v = 1; v <= 100; v++)
+    hist->record(v);
+  hist->merge(snap);
+  CHECK_EQUAL(100u, snap.count);
+  CHECK_EQUAL(5050u, snap.sumUs);
+  CHECK_EQUAL(1u, snap.minUs);
+  CHECK_EQUAL(100u, snap.maxUs);
+  CHECK_CLOSE(50.5f, snap.getAverageUs(), 1e-3f);
+  CHECK_EQUAL(1u, snap.getPercentileUs(0.f));
+  CHECK_EQUAL(10u, snap.getPercentileUs(10.f)); // exact below SUB_BUCKETS
+  CHECK_EQUAL(50u, snap.getPercentileUs(50.f));
+  CHECK_EQUAL(96u, snap.getPercentileUs(99.f)); // lower bound of [96, 100) bucket
+  CHECK_EQUAL(100u, snap.getPercentileUs(100.f));
+
+  // outliers move high percentiles only
+  for (int i = 0; i < 5; i++)
+    hist->record(100000);
+  Histogram::Snapshot snap2;
+  hist->merge(snap2);
+  snap.add(snap2);
+  CHECK_EQUAL(105u, snap.count);
+  CHECK_EQUAL(100000u, snap.maxUs);
+  CHECK(snap.getPercentileUs(50.f) <= 55u);
+  CHECK(snap.getPercentileUs(99.f) <= 100000u && snap.getPercentileUs(99.f) > 100000u * 15 / 16);
+}
+
+TEST(MergeTakesOnlyNewValues)
+{
+  eastl::unique_ptr<Histogram> hist = eastl::make_unique<Histogram>();
+  hist->record(1000);
+  hist->record(3000);
+  Histogram::Snapshot snap;
+  hist->merge(snap);
+  CHECK_EQUAL(2u, snap.count);
+
+  snap.reset();
+  hist->merge(snap);
+  CHECK_EQUAL(0u, snap.count);
+  CHECK_EQUAL(0u, snap.sumUs);
+  CHECK_EQUAL(0u, snap.maxUs);
+
+  hist->record(2000);
+  hist->merge(snap);
+  CHECK_EQUAL(1u, snap.count);
+  CHECK_EQUAL(2000u, snap.sumUs);
+  CHECK_EQUAL(2000u, snap.minUs); // min/max are since previous merge too
+  CHECK_EQUAL(2000u, snap.maxUs);
+}
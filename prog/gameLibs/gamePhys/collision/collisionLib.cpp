@@ -26,6 +26,7 @@
 
 #include <util/dag_lookup.h>
 #include <util/dag_roNameMap.h>
+#include <util/dag_console.h>
 
 #include <scene/dag_physMat.h>
 #include <physMap/physMap.h>
@@ -33,24 +34,64 @@
 
 #include "collisionGlobals.h"
 
+// Physics world with static level collision bodies. Additional worlds (see dacoll::create_collision_world()) share static data these
+// bodies are built from (frt, landmesh and heightmap tracers, rendinst collision resources) with main one.
+struct dacoll::CollisionWorld
+{
+  PhysWorld *physWorld = nullptr;
+  Tab<PhysBody *> frtObj{midmem}; // frt and custom heightmaps
+  Tab<PhysBody *> lmeshObj{midmem};
+  PhysBody *hmapObj = nullptr;
+  PhysBody *sphereCastShape = nullptr;
+  PhysBody *boxCastShape = nullptr;
+  dacoll::gather_game_objects_collision_on_ray_cb gatherGameObjsCb = nullptr;
+};
+// All dacoll calls work with main world, additional worlds are accessed only by functions which take world explicitly
+static dacoll::CollisionWorld main_world;
+static Tab<dacoll::CollisionWorld *> additional_worlds;
+
+struct HmapCustomCollSrc
+{
+  Point3 pos;
+  BBox3 box;
+  Point2 hmapOffset;
+  float hmapScale;
+  int hmapStep;
+};
+
+// static collision added to main world, it's added to additional worlds too
+static struct
+{
+  dacoll::InitFlags initFlags = dacoll::InitFlags::Default;
+  LandMeshManager *hmapLand = nullptr;
+  float hmapRestitution = 0.f;
+  LandMeshManager *lmeshLand = nullptr;
+  float lmeshRestitution = 0.f;
+  Tab<HmapCustomCollSrc> hmapCustom;
+} static_coll_src;
+
+template <typename F>
+static void for_each_additional_world(F f)
+{
+  for (dacoll::CollisionWorld *world : additional_worlds)
+  {
+    world->physWorld->fetchSimRes(true);
+    f(*world);
+  }
+}
+
 static bool enable_apex = false;
-static PhysWorld *phys_world = NULL;
-static Tab<PhysBody *> frtObj(midmem);
-static PhysBody *sphere_cast_shape = nullptr;
-static PhysBody *box_cast_shape = nullptr;
 static bool debugDrawerForced = false, debugDrawerInited = false;
 static DeserializedStaticSceneRayTracer *scene_ray_tracer = NULL;
 static BuildableStaticSceneRayTracer *water_ray_tracer = NULL;
 static SmallTab<unsigned char, MidmemAlloc> pmid;
 static bool scene_ray_owned = false;
-static PhysBody *hmapObj = NULL;
 static LandMeshManager *lmeshMgr = NULL;
 static PhysMat::MatID lmesh_mat_id = -1;
 static PhysMap *phys_map = NULL;
 static CollisionObject sphere_collision;
 static CollisionObject capsule_collision;
 static CollisionObject box_collision;
-static Tab<PhysBody *> lmeshObj(midmem);
 static int numBorderCellsXPos = 2;
 static int numBorderCellsXNeg = 2;
 static int numBorderCellsZPos = 2;
@@ -62,39 +103,57 @@ static bool only_water2d = false;
 static float collapse_contact_threshold = 0.f;
 
 
-static void create_cast_shapes()
+static void create_cast_shapes(dacoll::CollisionWorld &world)
 {
   PhysSphereCollision sphShape(1.f);
   PhysBoxCollision boxShape(1.f, 1.f, 1.f);
   PhysBodyCreationData pbcd;
   pbcd.addToWorld = false;
-  sphere_cast_shape = new PhysBody(dacoll::get_phys_world(), 0.f, &sphShape, TMatrix::IDENT, pbcd);
-  box_cast_shape = new PhysBody(dacoll::get_phys_world(), 0.f, &boxShape, TMatrix::IDENT, pbcd);
+  world.sphereCastShape = new PhysBody(world.physWorld, 0.f, &sphShape, TMatrix::IDENT, pbcd);
+  world.boxCastShape = new PhysBody(world.physWorld, 0.f, &boxShape, TMatrix::IDENT, pbcd);
 }
 
-void dacoll::init_collision_world(dacoll::InitFlags flags, float collapse_contact_thr)
+static void create_phys_world(dacoll::CollisionWorld &world, dacoll::InitFlags flags)
 {
-  term_collision_world();
-
-  init_physics_engine((flags & InitFlags::SingleThreaded) != InitFlags::None);
-  phys_world = new PhysWorld(0.9f, 0.7f, 0.4f, 1.f);
+  PhysWorld *physWorld = world.physWorld = new PhysWorld(0.9f, 0.7f, 0.4f, 1.f);
   const DataBlock &physBlk = *dgs_get_settings()->getBlockByNameEx("phys");
-  phys_world->setMaxSubSteps(physBlk.getInt("maxSubSteps", 3));
-  phys_world->setFixedTimeStep(1.f / physBlk.getInt("fixedTimeStepHz", 60));
+  physWorld->setMaxSubSteps(physBlk.getInt("maxSubSteps", 3));
+  physWorld->setFixedTimeStep(1.f / physBlk.getInt("fixedTimeStepHz", 60));
 #if defined(USE_BULLET_PHYSICS)
-  phys_world->setMultithreadedUpdate(physBlk.getBool("multithreaded", true));
-  phys_world->getScene()->getSolverInfo().m_erp2 = 0.8f;
-  phys_world->getScene()->getSolverInfo().m_solverMode = SOLVER_SIMD | SOLVER_USE_WARMSTARTING;
-  phys_world->getScene()->getDispatchInfo().m_allowedCcdPenetration = 0.01f;
-  phys_world->getScene()->setForceUpdateAllAabbs((flags & InitFlags::ForceUpdateAABB) != InitFlags::None);
-  gContactBreakingThreshold = collapse_contact_thr;
+  physWorld->setMultithreadedUpdate(physBlk.getBool("multithreaded", true));
+  physWorld->getScene()->getSolverInfo().m_erp2 = 0.8f;
+  physWorld->getScene()->getSolverInfo().m_solverMode = SOLVER_SIMD | SOLVER_USE_WARMSTARTING;
+  physWorld->getScene()->getDispatchInfo().m_allowedCcdPenetration = 0.01f;
+  physWorld->getScene()->setForceUpdateAllAabbs((flags & dacoll::InitFlags::ForceUpdateAABB) != dacoll::InitFlags::None);
 #else
   G_UNUSED(physBlk);
   G_UNUSED(flags);
 #endif
+  create_cast_shapes(world);
+}
 
-  create_cast_shapes();
+static void destroy_phys_world(dacoll::CollisionWorld &world)
+{
+  del_it(world.sphereCastShape);
+  del_it(world.boxCastShape);
+  del_it(world.physWorld);
+}
+
+void dacoll::init_collision_world(dacoll::InitFlags flags, float collapse_contact_thr)
+{
+  term_collision_world();
+
+  init_physics_engine((flags & InitFlags::SingleThreaded) != InitFlags::None);
+  create_phys_world(main_world, flags);
+  static_coll_src.initFlags = flags;
+#if defined(USE_BULLET_PHYSICS)
+  gContactBreakingThreshold = collapse_contact_thr;
+#endif
   collapse_contact_threshold = collapse_contact_thr;
+#if defined(USE_BULLET_PHYSICS)
+  if (dgs_get_settings()->getBlockByNameEx("phys")->getBool("staticWheelTraces", false))
+    set_vehicle_wheel_tracers(ETF_DEFAULT);
+#endif
 
 #if DAGOR_DBGLEVEL > 0
   if ((flags & InitFlags::EnableDebugDraw) != InitFlags::None)
@@ -107,9 +166,10 @@ void dacoll::init_collision_world(dacoll::InitFlags flags, float collapse_contac
 
 void dacoll::term_collision_world()
 {
-  del_it(sphere_cast_shape);
-  del_it(box_cast_shape);
-  del_it(phys_world);
+  G_ASSERTF(additional_worlds.empty(), "%d additional collision worlds should be destroyed before main one",
+    additional_worlds.size());
+  set_vehicle_wheel_tracers(0);
+  destroy_phys_world(main_world);
   close_physics_engine();
 #if DAGOR_DBGLEVEL > 0
   physdbg::term<PhysWorld>();
@@ -117,16 +177,65 @@ void dacoll::term_collision_world()
 #endif
 }
 
+static void create_frt_body(dacoll::CollisionWorld &world, DeserializedStaticSceneRayTracer *frt);
+static void create_hmap_body(dacoll::CollisionWorld &world, LandMeshManager *land, float restitution);
+static void create_lmesh_bodies(dacoll::CollisionWorld &world, LandMeshManager *land, float restitution);
+static void create_hmap_custom_body(dacoll::CollisionWorld &world, const HmapCustomCollSrc &src);
+
+static void destroy_static_bodies(dacoll::CollisionWorld &world)
+{
+  for (PhysBody *&body : world.frtObj)
+    del_it(body);
+  clear_and_shrink(world.frtObj);
+  for (PhysBody *&body : world.lmeshObj)
+    del_it(body);
+  clear_and_shrink(world.lmeshObj);
+  del_it(world.hmapObj);
+}
+
+dacoll::CollisionWorld *dacoll::create_collision_world()
+{
+  G_ASSERT_RETURN(main_world.physWorld, nullptr);
+  CollisionWorld *world = new CollisionWorld;
+  create_phys_world(*world, static_coll_src.initFlags);
+  if (scene_ray_tracer)
+    create_frt_body(*world, scene_ray_tracer);
+  for (const HmapCustomCollSrc &src : static_coll_src.hmapCustom)
+    create_hmap_custom_body(*world, src);
+  if (static_coll_src.hmapLand)
+    create_hmap_body(*world, static_coll_src.hmapLand, static_coll_src.hmapRestitution);
+  if (static_coll_src.lmeshLand)
+    create_lmesh_bodies(*world, static_coll_src.lmeshLand, static_coll_src.lmeshRestitution);
+  additional_worlds.push_back(world);
+  return world;
+}
+
+void dacoll::destroy_collision_world(CollisionWorld *world)
+{
+  if (!world)
+    return;
+  G_ASSERT_RETURN(world != &main_world, );
+  erase_item_by_value(additional_worlds, world);
+  world->physWorld->fetchSimRes(true);
+  destroy_static_bodies(*world);
+  destroy_phys_world(*world);
+  delete world;
+}
+
+dacoll::CollisionWorld *dacoll::get_main_collision_world() { return &main_world; }
+
+PhysWorld *dacoll::get_phys_world(const CollisionWorld *world) { return (world ? world : &main_world)->physWorld; }
+
 void dacoll::clear_collision_world()
 {
   fetch_sim_res(true);
-  del_it(sphere_cast_shape);
-  del_it(box_cast_shape);
+  del_it(main_world.sphereCastShape);
+  del_it(main_world.boxCastShape);
 #if defined(USE_BULLET_PHYSICS)
   free_all_bt_collobjects_memory();
 #endif
-  phys_world->clear();
-  create_cast_shapes();
+  main_world.physWorld->clear();
+  create_cast_shapes(main_world);
 }
 
 float dacoll::get_collision_object_collapse_threshold(const CollisionObject &co)
@@ -142,17 +251,15 @@ float dacoll::get_collision_object_collapse_threshold(const CollisionObject &co)
 
 void dacoll::destroy_static_collision()
 {
+  // bodies of all worlds are destroyed before static collision data they are built from
+  for_each_additional_world(destroy_static_bodies);
+  static_coll_src.hmapLand = static_coll_src.lmeshLand = nullptr;
+  clear_and_shrink(static_coll_src.hmapCustom);
+  destroy_static_bodies(main_world);
   if (scene_ray_owned)
     del_it(scene_ray_tracer);
   scene_ray_tracer = NULL;
-  for (int i = 0; i < frtObj.size(); ++i)
-    del_it(frtObj[i]);
-  del_it(hmapObj);
-  for (int i = 0; i < lmeshObj.size(); ++i)
-    del_it(lmeshObj[i]);
-  clear_and_shrink(lmeshObj);
   lmeshMgr = NULL;
-  clear_and_shrink(frtObj);
   clear_ri_instances();
   destroy_dynamic_collision(sphere_collision);
   sphere_collision.clear_ptrs();
@@ -194,11 +301,27 @@ BuildableStaticSceneRayTracer *dacoll::get_water_tracer() { return water_ray_tra
 dag::ConstSpan<unsigned char> dacoll::get_pmid() { return pmid; }
 
 
+static void create_frt_body(dacoll::CollisionWorld &world, DeserializedStaticSceneRayTracer *frt)
+{
+  debug("frt: %p,%d  %p,%d", &frt->verts(0), frt->getVertsCount(), frt->faces(0).v, frt->getFacesCount() * 3);
+  PhysTriMeshCollision shape(make_span_const(&frt->verts(0), frt->getVertsCount()),
+    make_span_const(frt->faces(0).v, frt->getFacesCount() * 3));
+
+  PhysBodyCreationData pbcd;
+  pbcd.useMotionState = false;
+  pbcd.materialId = -1;
+  pbcd.friction = 1.f;
+  pbcd.autoMask = false;
+  pbcd.group = dacoll::EPL_STATIC, pbcd.mask = dacoll::EPL_ALL & ~(dacoll::EPL_KINEMATIC | dacoll::EPL_STATIC);
+  PhysBody *body = new PhysBody(world.physWorld, 0.f, &shape, TMatrix::IDENT, pbcd);
+  world.frtObj.push_back(body);
+}
+
 void dacoll::add_static_collision_frt(DeserializedStaticSceneRayTracer *frt, const char *name, dag::ConstSpan<unsigned char> *in_pmid)
 {
   scene_ray_tracer = frt;
   scene_ray_owned = false;
-  if (!phys_world || !phys_world->getScene())
+  if (!main_world.physWorld || !main_world.physWorld->getScene())
     return;
 
 #if ENABLE_APEX == 1
@@ -208,18 +331,8 @@ void dacoll::add_static_collision_frt(DeserializedStaticSceneRayTracer *frt, con
   (void)name;
 #endif
 
-  debug("frt: %p,%d  %p,%d", &frt->verts(0), frt->getVertsCount(), frt->faces(0).v, frt->getFacesCount() * 3);
-  PhysTriMeshCollision shape(make_span_const(&frt->verts(0), frt->getVertsCount()),
-    make_span_const(frt->faces(0).v, frt->getFacesCount() * 3));
-
-  PhysBodyCreationData pbcd;
-  pbcd.useMotionState = false;
-  pbcd.materialId = -1;
-  pbcd.friction = 1.f;
-  pbcd.autoMask = false;
-  pbcd.group = EPL_STATIC, pbcd.mask = EPL_ALL & ~(EPL_KINEMATIC | EPL_STATIC);
-  PhysBody *body = new PhysBody(dacoll::get_phys_world(), 0.f, &shape, TMatrix::IDENT, pbcd);
-  frtObj.push_back(body);
+  create_frt_body(main_world, frt);
+  for_each_additional_world([frt](dacoll::CollisionWorld &world) { create_frt_body(world, frt); });
 
   if (in_pmid)
   {
@@ -284,42 +397,46 @@ bool dacoll::load_static_collision_frt(IGenLoad *crd)
 
 void dacoll::set_water_tracer(BuildableStaticSceneRayTracer *tracer) { water_ray_tracer = tracer; }
 
-int dacoll::get_hmap_step() { return hmapObj ? phys_body_get_hmap_step(hmapObj) : -1; }
+int dacoll::get_hmap_step() { return main_world.hmapObj ? phys_body_get_hmap_step(main_world.hmapObj) : -1; }
 
-int dacoll::set_hmap_step(int step) { return hmapObj ? phys_body_set_hmap_step(hmapObj, step) : -1; }
+int dacoll::set_hmap_step(int step) { return main_world.hmapObj ? phys_body_set_hmap_step(main_world.hmapObj, step) : -1; }
+
+static void create_hmap_custom_body(dacoll::CollisionWorld &world, const HmapCustomCollSrc &src)
+{
+  using namespace dacoll;
+  LandMeshManager *land = get_lmesh();
+  PhysHeightfieldCollision coll(land->getHmapHandler(), src.hmapOffset, src.box, src.hmapScale, src.hmapStep,
+    land->getHolesManager());
+  PhysBodyCreationData pbcd;
+  pbcd.useMotionState = false;
+  pbcd.materialId = -1;
+  pbcd.friction = 1.f;
+  pbcd.autoMask = false;
+  pbcd.group = EPL_STATIC, pbcd.mask = EPL_ALL & ~(EPL_KINEMATIC | EPL_STATIC);
+  TMatrix tm = TMatrix::IDENT;
+  tm.setcol(3, src.pos);
+  world.frtObj.push_back(new PhysBody(world.physWorld, 0.f, &coll, tm, pbcd));
+}
 
 void dacoll::add_collision_hmap_custom(const Point3 &collision_pos, const BBox3 &collision_box, const Point2 &hmap_offset,
   float hmap_scale, int hmap_step)
 {
   LandMeshManager *land = get_lmesh();
-  if (!phys_world || !phys_world->getScene() || !land || !land->getLandTracer())
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !land || !land->getLandTracer())
     return;
 
   if (land->getHmapHandler())
   {
-    PhysHeightfieldCollision coll(land->getHmapHandler(), hmap_offset, collision_box, hmap_scale, hmap_step, land->getHolesManager());
-    PhysBodyCreationData pbcd;
-    pbcd.useMotionState = false;
-    pbcd.materialId = -1;
-    pbcd.friction = 1.f;
-    pbcd.autoMask = false;
-    pbcd.group = EPL_STATIC, pbcd.mask = EPL_ALL & ~(EPL_KINEMATIC | EPL_STATIC);
-    TMatrix tm = TMatrix::IDENT;
-    tm.setcol(3, collision_pos);
-    frtObj.push_back(new PhysBody(dacoll::get_phys_world(), 0.f, &coll, tm, pbcd));
+    const HmapCustomCollSrc &src =
+      static_coll_src.hmapCustom.push_back(HmapCustomCollSrc{collision_pos, collision_box, hmap_offset, hmap_scale, hmap_step});
+    create_hmap_custom_body(main_world, src);
+    for_each_additional_world([&src](dacoll::CollisionWorld &world) { create_hmap_custom_body(world, src); });
   }
 }
 
-void dacoll::add_collision_hmap(LandMeshManager *land, float restitution)
+static void create_hmap_body(dacoll::CollisionWorld &world, LandMeshManager *land, float restitution)
 {
-  if (!phys_world || !phys_world->getScene() || !land || !land->getLandTracer())
-    return;
-
-#if ENABLE_APEX == 1
-  if (enable_apex)
-    physx_add_static_collision_heightmap(land);
-#endif
-
+  using namespace dacoll;
   if (land->getHmapHandler())
   {
     auto hmap = land->getHmapHandler();
@@ -333,27 +450,33 @@ void dacoll::add_collision_hmap(LandMeshManager *land, float restitution)
     pbcd.restitution = restitution;
     pbcd.autoMask = false;
     pbcd.group = EPL_STATIC, pbcd.mask = EPL_ALL & ~(EPL_KINEMATIC | EPL_STATIC);
-    hmapObj = new PhysBody(dacoll::get_phys_world(), 0.f, &coll, TMatrix::IDENT, pbcd);
+    world.hmapObj = new PhysBody(world.physWorld, 0.f, &coll, TMatrix::IDENT, pbcd);
   }
   else
-    hmapObj = NULL;
+    world.hmapObj = NULL;
 }
 
-void dacoll::add_collision_landmesh(LandMeshManager *land, const char *name, float restitution)
+void dacoll::add_collision_hmap(LandMeshManager *land, float restitution)
 {
-  PhysWorld *physWorld = dacoll::get_phys_world();
-  if (!physWorld || !physWorld->getScene() || !land || !land->getLandTracer())
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !land || !land->getLandTracer())
     return;
 
 #if ENABLE_APEX == 1
   if (enable_apex)
-    physx_add_static_collision_landmesh(land, name);
-#else
-  (void)name;
+    physx_add_static_collision_heightmap(land);
 #endif
 
+  create_hmap_body(main_world, land, restitution);
+  for_each_additional_world([&](dacoll::CollisionWorld &world) { create_hmap_body(world, land, restitution); });
+  static_coll_src.hmapLand = land;
+  static_coll_src.hmapRestitution = restitution;
+}
+
+static void create_lmesh_bodies(dacoll::CollisionWorld &world, LandMeshManager *land, float restitution)
+{
+  using namespace dacoll;
   LandRayTracer *lray = land->getLandTracer();
-  lmeshObj.resize(lray->getCellCount());
+  world.lmeshObj.resize(lray->getCellCount());
   TMatrix tm = TMatrix::IDENT;
   PhysBodyCreationData pbcd;
   pbcd.useMotionState = false;
@@ -372,13 +495,32 @@ void dacoll::add_collision_landmesh(LandMeshManager *land, const char *name, flo
       const float *ofs = lray->getCellPackOffsetF(i);
       tm.setcol(3, Point3(ofs[0], ofs[1], ofs[2]));
       PhysTriMeshCollision shape(lray->getCellVerts(i), lray->getCellFaces(i), lray->getCellPackScaleF(i), true);
-      lmeshObj[i] = new PhysBody(dacoll::get_phys_world(), 0.f, &shape, tm, pbcd);
+      world.lmeshObj[i] = new PhysBody(world.physWorld, 0.f, &shape, tm, pbcd);
     }
     else
-      lmeshObj[i] = NULL;
+      world.lmeshObj[i] = NULL;
   }
+}
+
+void dacoll::add_collision_landmesh(LandMeshManager *land, const char *name, float restitution)
+{
+  PhysWorld *physWorld = dacoll::get_phys_world();
+  if (!physWorld || !physWorld->getScene() || !land || !land->getLandTracer())
+    return;
+
+#if ENABLE_APEX == 1
+  if (enable_apex)
+    physx_add_static_collision_landmesh(land, name);
+#else
+  (void)name;
+#endif
+
+  create_lmesh_bodies(main_world, land, restitution);
+  for_each_additional_world([&](dacoll::CollisionWorld &world) { create_lmesh_bodies(world, land, restitution); });
   lmesh_mat_id = PhysMat::physMatCount() > 0 ? PhysMat::getMaterialId("horLandMesh") : PHYSMAT_INVALID;
   lmeshMgr = land;
+  static_coll_src.lmeshLand = land;
+  static_coll_src.lmeshRestitution = restitution;
 }
 
 void dacoll::set_landmesh_mirroring(int cells_x_pos, int cells_x_neg, int cells_z_pos, int cells_z_neg)
@@ -471,7 +613,7 @@ CollisionObject dacoll::add_dynamic_box_collision(const TMatrix &tm, const Point
 CollisionObject dacoll::add_dynamic_collision(const DataBlock &props, void *userPtr, bool is_player, bool add_to_world, int mask,
   const TMatrix *wtm)
 {
-  if (!phys_world || !phys_world->getScene())
+  if (!main_world.physWorld || !main_world.physWorld->getScene())
     return CollisionObject();
 
 #if ENABLE_APEX == 1
@@ -620,7 +762,7 @@ static PhysCollision *create_shape_from_collision_node(const char *shape_type, c
 CollisionObject dacoll::add_simple_dynamic_collision_from_coll_resource(const DataBlock &props, const CollisionResource *resource,
   GeomNodeTree *tree, float margin, float scale, Point3 &out_center, TMatrix &out_tm, TMatrix &out_tm_in_model)
 {
-  if (!phys_world || !phys_world->getScene() || !resource)
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !resource)
     return CollisionObject();
 
   PhysCompoundCollision shape;
@@ -699,7 +841,7 @@ void dacoll::build_dynamic_collision_from_coll_resource(const CollisionResource
 CollisionObject dacoll::build_dynamic_collision_from_coll_resource(const CollisionResource *coll_resource, bool add_to_world,
   int phys_layer, int mask, PhysBodyProperties &out_properties)
 {
-  if (!phys_world || !phys_world->getScene() || !coll_resource)
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !coll_resource)
     return CollisionObject();
 
   // Start with just an overal box from coll_resource
@@ -714,7 +856,7 @@ CollisionObject dacoll::build_dynamic_collision_from_coll_resource(const Collisi
 CollisionObject dacoll::add_dynamic_collision_from_coll_resource(const DataBlock *props, const CollisionResource *coll_resource,
   void *user_ptr, int flags, int phys_layer, int mask, const TMatrix *wtm)
 {
-  if (!phys_world || !phys_world->getScene() || !coll_resource ||
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !coll_resource ||
       (!coll_resource->meshNodesHead && !coll_resource->boxNodesHead && !coll_resource->sphereNodesHead &&
         !coll_resource->capsuleNodesHead))
     return CollisionObject();
@@ -959,18 +1101,18 @@ CollisionObject dacoll::add_dynamic_collision_convex_from_coll_resource(dag::Con
 
 void dacoll::add_object_to_world(CollisionObject co)
 {
-  if (!phys_world || !phys_world->getScene())
+  if (!main_world.physWorld || !main_world.physWorld->getScene())
     return;
-  phys_world->fetchSimRes(true);
-  phys_world->addBody(co.body, true);
+  main_world.physWorld->fetchSimRes(true);
+  main_world.physWorld->addBody(co.body, true);
 }
 
 void dacoll::remove_object_from_world(CollisionObject co)
 {
-  if (!phys_world || !phys_world->getScene() || !co)
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !co)
     return;
-  phys_world->fetchSimRes(true);
-  phys_world->removeBody(co.body);
+  main_world.physWorld->fetchSimRes(true);
+  main_world.physWorld->removeBody(co.body);
 }
 
 void dacoll::destroy_dynamic_collision(CollisionObject co)
@@ -988,24 +1130,24 @@ void dacoll::destroy_dynamic_collision(CollisionObject co)
 
 void dacoll::fetch_sim_res(bool wait)
 {
-  if (phys_world)
-    phys_world->fetchSimRes(wait);
+  if (main_world.physWorld)
+    main_world.physWorld->fetchSimRes(wait);
 }
 
 
-PhysWorld *dacoll::get_phys_world() { return phys_world; }
+PhysWorld *dacoll::get_phys_world() { return main_world.physWorld; }
 
 void dacoll::phys_world_start_sim(float dt, bool wake)
 {
-  if (phys_world)
-    phys_world->startSim(dt, wake);
+  if (main_world.physWorld)
+    main_world.physWorld->startSim(dt, wake);
 }
 
 void dacoll::phys_world_set_invalid_fetch_sim_res_thread(int64_t tid)
 {
 #if defined(USE_BULLET_PHYSICS)
-  if (phys_world)
-    phys_world->setInvalidFetchSimResThread(tid);
+  if (main_world.physWorld)
+    main_world.physWorld->setInvalidFetchSimResThread(tid);
 #else
   G_UNUSED(tid); //==
 #endif
@@ -1014,8 +1156,8 @@ void dacoll::phys_world_set_invalid_fetch_sim_res_thread(int64_t tid)
 void dacoll::phys_world_set_control_thread_id(int64_t tid)
 {
 #if defined(USE_BULLET_PHYSICS)
-  if (phys_world)
-    phys_world->setControlThreadId(tid);
+  if (main_world.physWorld)
+    main_world.physWorld->setControlThreadId(tid);
 #else
   G_UNUSED(tid); //==
 #endif
@@ -1049,39 +1191,39 @@ CollisionObject &dacoll::get_reusable_box_collision()
 
 void dacoll::set_collision_object_tm(const CollisionObject &co, const TMatrix &tm)
 {
-  phys_world->fetchSimRes(true);
+  main_world.physWorld->fetchSimRes(true);
   co.body->setTmInstant(tm, true);
 }
 
 void dacoll::set_vert_capsule_shape_size(const CollisionObject &co, float cap_rad, float cap_cyl_ht)
 {
-  phys_world->fetchSimRes(true);
+  main_world.physWorld->fetchSimRes(true);
   co.body->setVertCapsuleShapeSize(cap_rad, cap_cyl_ht);
 }
 
 
 bool dacoll::test_collision_frt(const CollisionObject &co, Tab<gamephys::CollisionContactData> &out_contacts, int mat_id)
 {
-  if (!phys_world)
+  if (!main_world.physWorld)
     return false;
-  phys_world->fetchSimRes(true);
+  main_world.physWorld->fetchSimRes(true);
   int prev_cont = out_contacts.size();
   WrapperContactResultCB collCb(out_contacts, mat_id, dacoll::get_collision_object_collapse_threshold(co));
   // TODO: per-face collision material id
-  for (int i = 0; i < frtObj.size(); i++)
-    phys_world->contactTestPair(co.body, frtObj[i], collCb);
+  for (int i = 0; i < main_world.frtObj.size(); i++)
+    main_world.physWorld->contactTestPair(co.body, main_world.frtObj[i], collCb);
   return out_contacts.size() > prev_cont;
 }
 
 bool dacoll::test_collision_world(const CollisionObject &co, Tab<gamephys::CollisionContactData> &out_contacts, int mat_id,
   dacoll::PhysLayer group, int mask)
 {
-  if (!phys_world)
+  if (!main_world.physWorld)
     return false;
-  phys_world->fetchSimRes(true);
+  main_world.physWorld->fetchSimRes(true);
   int prev_cont = out_contacts.size();
   WrapperContactResultCB collCb(out_contacts, mat_id, dacoll::get_collision_object_collapse_threshold(co));
-  phys_world->contactTest(co.body, collCb, group, mask);
+  main_world.physWorld->contactTest(co.body, collCb, group, mask);
   return out_contacts.size() > prev_cont;
 }
 
@@ -1152,19 +1294,19 @@ bool dacoll::test_box_collision_world(const TMatrix &tm, int mat_id, Tab<gamephy
 bool dacoll::test_collision_lmesh(const CollisionObject &co, const TMatrix &tm, float max_rad, int def_mat_id,
   Tab<gamephys::CollisionContactData> &out_contacts, int mat_id)
 {
-  if (!phys_world || !lmeshMgr)
+  if (!main_world.physWorld || !lmeshMgr)
     return false;
-  phys_world->fetchSimRes(true);
+  main_world.physWorld->fetchSimRes(true);
   int prev_cont = out_contacts.size();
   WrapperContactResultCB collCb(out_contacts, mat_id, dacoll::get_collision_object_collapse_threshold(co));
   collCb.collMatId = def_mat_id;
   int land_idx[256];
   for (int j = 0, je = lmeshMgr->getLandTracer()->getCellIdxNear(land_idx, countof(land_idx), tm[3][0], tm[3][2], max_rad); j < je;
        j++)
-    if (lmeshObj[land_idx[j]])
-      phys_world->contactTestPair(co.body, lmeshObj[land_idx[j]], collCb);
-  if (hmapObj)
-    phys_world->contactTestPair(co.body, hmapObj, collCb);
+    if (main_world.lmeshObj[land_idx[j]])
+      main_world.physWorld->contactTestPair(co.body, main_world.lmeshObj[land_idx[j]], collCb);
+  if (main_world.hmapObj)
+    main_world.physWorld->contactTestPair(co.body, main_world.hmapObj, collCb);
   return out_contacts.size() > prev_cont;
 }
 
@@ -1293,11 +1435,11 @@ PhysBody *dacoll::get_convex_shape(CollisionObject co) { return co.body && co.bo
 
 void dacoll::shape_query_frt(const PhysBody *shape, const TMatrix &from, const TMatrix &to, dacoll::ShapeQueryOutput &out)
 {
-  phys_world->shapeQuery(shape, from, to, frtObj, out);
+  main_world.physWorld->shapeQuery(shape, from, to, main_world.frtObj, out);
 }
 void dacoll::shape_query_frt(const PhysSphereCollision &shape, const TMatrix &from, const TMatrix &to, dacoll::ShapeQueryOutput &out)
 {
-  phys_world->shapeQuery(shape, from, to, frtObj, out);
+  main_world.physWorld->shapeQuery(shape, from, to, main_world.frtObj, out);
 }
 
 void dacoll::shape_query_lmesh(const PhysBody *shape, const TMatrix &from, const TMatrix &to, dacoll::ShapeQueryOutput &out)
@@ -1310,9 +1452,9 @@ void dacoll::shape_query_lmesh(const PhysBody *shape, const TMatrix &from, const
   StaticTab<PhysBody *, 64> land_body;
   for (int j = 0, je = lmeshMgr->getLandTracer()->getCellIdxNear(land_idx, countof(land_idx), from[3][0], from[3][2], maxRad); j < je;
        j++)
-    if (auto *b = lmeshObj[land_idx[j]])
+    if (auto *b = main_world.lmeshObj[land_idx[j]])
       land_body.push_back(b);
-  phys_world->shapeQuery(shape, from, to, land_body, out);
+  main_world.physWorld->shapeQuery(shape, from, to, land_body, out);
 }
 void dacoll::shape_query_lmesh(const PhysSphereCollision &shape, const TMatrix &from, const TMatrix &to, dacoll::ShapeQueryOutput &out)
 {
@@ -1324,15 +1466,15 @@ void dacoll::shape_query_lmesh(const PhysSphereCollision &shape, const TMatrix &
   StaticTab<PhysBody *, 64> land_body;
   for (int j = 0, je = lmeshMgr->getLandTracer()->getCellIdxNear(land_idx, countof(land_idx), from[3][0], from[3][2], maxRad); j < je;
        j++)
-    if (auto *b = lmeshObj[land_idx[j]])
+    if (auto *b = main_world.lmeshObj[land_idx[j]])
       land_body.push_back(b);
-  phys_world->shapeQuery(shape, from, to, land_body, out);
+  main_world.physWorld->shapeQuery(shape, from, to, land_body, out);
 }
 
 bool dacoll::sphere_query_ri(const Point3 &from, const Point3 &to, float rad, dacoll::ShapeQueryOutput &out, int cast_mat_id,
   Tab<rendinst::RendInstDesc> *out_desc, const TraceMeshFaces *handle)
 {
-  if (!phys_world || !phys_world->getScene() || !sphere_cast_shape)
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !main_world.sphereCastShape)
     return false;
 
   TMatrix fromTm = TMatrix::IDENT;
@@ -1340,10 +1482,10 @@ bool dacoll::sphere_query_ri(const Point3 &from, const Point3 &to, float rad, da
   fromTm.setcol(3, from);
   toTm.setcol(3, to);
 
-  phys_world->fetchSimRes(true);
-  sphere_cast_shape->setSphereShapeRad(rad);
+  main_world.physWorld->fetchSimRes(true);
+  main_world.sphereCastShape->setSphereShapeRad(rad);
 
-  shape_query_ri(sphere_cast_shape, fromTm, toTm, rad, out, cast_mat_id, out_desc, handle);
+  shape_query_ri(main_world.sphereCastShape, fromTm, toTm, rad, out, cast_mat_id, out_desc, handle);
 
   return out.t < 1.f;
 }
@@ -1355,25 +1497,27 @@ bool dacoll::sphere_cast(const Point3 &from, const Point3 &to, float rad, dacoll
     EPL_ALL & ~(EPL_CHARACTER | EPL_KINEMATIC | EPL_DEBRIS));
 }
 
-static dacoll::gather_game_objects_collision_on_ray_cb gather_game_objs_cb = nullptr;
-
-void dacoll::set_gather_game_objects_on_ray_cb(gather_game_objects_collision_on_ray_cb cb) { gather_game_objs_cb = cb; }
+void dacoll::set_gather_game_objects_on_ray_cb(gather_game_objects_collision_on_ray_cb cb, CollisionWorld *world)
+{
+  (world ? world : &main_world)->gatherGameObjsCb = cb;
+}
 
-static bool shape_cast_ex(PhysBody *shape_body, const TMatrix &from_tm, const TMatrix &to_tm, float rad, dacoll::ShapeQueryOutput &out,
-  int cast_mat_id, dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle, int mask, int hmap_step)
+static bool shape_cast_ex(dacoll::CollisionWorld &world, PhysBody *shape_body, const TMatrix &from_tm, const TMatrix &to_tm,
+  float rad, dacoll::ShapeQueryOutput &out, int cast_mat_id, dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle,
+  int mask, int hmap_step)
 {
   out.vel.zero();
 
   // TODO: add per-object sphere_cast, so we don't really need world to perform it.
   // TODO: test it now! it's added, maybe we don't need a world at all (fetching the world)
-  phys_world->fetchSimRes(true);
+  world.physWorld->fetchSimRes(true);
 
   const Point3 &from = from_tm.getcol(3);
   const Point3 &to = to_tm.getcol(3);
 
   // frt
-  phys_world->shapeQuery(shape_body, from_tm, to_tm, frtObj, out);
-  const int prevStep = hmap_step > 0 ? dacoll::set_hmap_step(hmap_step) : -1;
+  world.physWorld->shapeQuery(shape_body, from_tm, to_tm, world.frtObj, out);
+  const int prevStep = hmap_step > 0 && world.hmapObj ? phys_body_set_hmap_step(world.hmapObj, hmap_step) : -1;
   // lmesh
   if (lmeshMgr)
   {
@@ -1382,24 +1526,25 @@ static bool shape_cast_ex(PhysBody *shape_body, const TMatrix &from_tm, const TM
     const float maxRad = length(Point2::xz(to - from)) / 2.f + rad;
     int land_idx[256];
     for (int j = 0, je = lmeshMgr->getLandTracer()->getCellIdxNear(land_idx, countof(land_idx), px, pz, maxRad); j < je; j++)
-      if (lmeshObj[land_idx[j]])
-        phys_world->shapeQuery(shape_body, from_tm, to_tm, make_span_const(&lmeshObj[land_idx[j]], 1), out);
+      if (world.lmeshObj[land_idx[j]])
+        world.physWorld->shapeQuery(shape_body, from_tm, to_tm, make_span_const(&world.lmeshObj[land_idx[j]], 1), out);
   }
-  if (hmapObj)
-    phys_world->shapeQuery(shape_body, from_tm, to_tm, make_span_const(&hmapObj, 1), out);
-  if (gather_game_objs_cb)
+  if (world.hmapObj)
+    world.physWorld->shapeQuery(shape_body, from_tm, to_tm, make_span_const(&world.hmapObj, 1), out);
+  if (world.gatherGameObjsCb)
   {
     MatAndGroupConvexCallback matCb{cast_mat_id, ignore_objs, dacoll::EPL_DEFAULT, mask};
     Tab<PhysBody *> bodies(framemem_ptr());
-    gather_game_objs_cb(from, to, rad, [&](CollisionObject obj) {
+    world.gatherGameObjsCb(from, to, rad, [&](CollisionObject obj) {
       if (obj.body && matCb.needsCollision(obj.body, obj.body->getUserData()))
         bodies.push_back(obj.body);
     });
-    phys_world->shapeQuery(shape_body, from_tm, to_tm, bodies, out);
+    world.physWorld->shapeQuery(shape_body, from_tm, to_tm, bodies, out);
   }
   if (prevStep > 0)
-    dacoll::set_hmap_step(prevStep);
+    phys_body_set_hmap_step(world.hmapObj, prevStep);
 
+  // rendinst collision bodies are shared by all worlds, they are only queried and never added to world
   dacoll::shape_query_ri(shape_body, from_tm, to_tm, rad, out, cast_mat_id, nullptr, handle);
 
   return out.t < 1.f;
@@ -1408,7 +1553,14 @@ static bool shape_cast_ex(PhysBody *shape_body, const TMatrix &from_tm, const TM
 bool dacoll::sphere_cast_ex(const Point3 &from, const Point3 &to, float rad, dacoll::ShapeQueryOutput &out, int cast_mat_id,
   dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle, int mask, int hmap_step /*  = -1 */)
 {
-  if (!phys_world || !phys_world->getScene() || !sphere_cast_shape)
+  return sphere_cast_ex(&main_world, from, to, rad, out, cast_mat_id, ignore_objs, handle, mask, hmap_step);
+}
+
+bool dacoll::sphere_cast_ex(CollisionWorld *world_, const Point3 &from, const Point3 &to, float rad, dacoll::ShapeQueryOutput &out,
+  int cast_mat_id, dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle, int mask, int hmap_step)
+{
+  CollisionWorld &world = world_ ? *world_ : main_world;
+  if (!world.physWorld || !world.physWorld->getScene() || !world.sphereCastShape)
     return false;
 
   TIME_PROFILE_DEV(sphere_cast);
@@ -1418,9 +1570,74 @@ bool dacoll::sphere_cast_ex(const Point3 &from, const Point3 &to, float rad, dac
   TMatrix toTm = TMatrix::IDENT;
   toTm.setcol(3, to);
 
-  sphere_cast_shape->setSphereShapeRad(rad);
+  world.sphereCastShape->setSphereShapeRad(rad);
+
+  return shape_cast_ex(world, world.sphereCastShape, fromTm, toTm, rad, out, cast_mat_id, ignore_objs, handle, mask, hmap_step);
+}
+
+void dacoll::phys_world_sphere_cast_batch(dag::ConstSpan<SphereCastDesc> casts, dag::Span<ShapeQueryOutput> out, int mask,
+  CollisionWorld *world)
+{
+  G_ASSERT_RETURN(out.size() >= casts.size(), );
+  PhysWorld *physWorld = get_phys_world(world);
+  if (!physWorld || !physWorld->getScene())
+    return;
+  TIME_PROFILE_DEV(phys_world_sphere_cast_batch);
+#if defined(USE_JOLT_PHYSICS)
+  Tab<PhysWorld::ShapeCastDesc> descs(framemem_ptr());
+  descs.resize(casts.size());
+  for (int i = 0; i < casts.size(); ++i)
+  {
+    descs[i].from = casts[i].from;
+    descs[i].to = casts[i].to;
+    descs[i].radius = casts[i].rad;
+    descs[i].filterGrp = EPL_DEFAULT;
+    descs[i].filterMask = mask;
+  }
+  physWorld->shapeCastBatch(descs, out);
+#else
+  MatAndGroupConvexCallback matCb{-1, {}, EPL_DEFAULT, mask};
+  for (int i = 0; i < casts.size(); ++i)
+  {
+    PhysSphereCollision sphere(casts[i].rad);
+    physWorld->convexSweepTest(sphere, casts[i].from, casts[i].to, matCb, out[i], EPL_DEFAULT, mask);
+  }
+#endif
+}
 
-  return shape_cast_ex(sphere_cast_shape, fromTm, toTm, rad, out, cast_mat_id, ignore_objs, handle, mask, hmap_step);
+bool dacoll::phys_world_traceray_batch(dag::Span<Trace> traces, int mask, CollisionWorld *world)
+{
+  PhysWorld *physWorld = get_phys_world(world);
+  if (!physWorld || !physWorld->getScene() || traces.empty())
+    return false;
+  TIME_PROFILE_DEV(phys_world_traceray_batch);
+  Tab<PhysRayCast> rays(framemem_ptr());
+  rays.reserve(traces.size());
+  for (const Trace &trace : traces)
+  {
+    rays.push_back(PhysRayCast(trace.pos, trace.dir, trace.pos.outT, physWorld));
+    rays.back().setFilterMask(mask);
+  }
+#if defined(USE_JOLT_PHYSICS)
+  Tab<PhysRayCast *> rayPtrs(framemem_ptr());
+  rayPtrs.resize(rays.size());
+  for (int i = 0; i < rays.size(); ++i)
+    rayPtrs[i] = &rays[i];
+  physWorld->rayCastBatch(make_span(rayPtrs));
+#else
+  for (PhysRayCast &ray : rays)
+    ray.forceUpdate(physWorld);
+#endif
+  bool res = false;
+  for (int i = 0; i < traces.size(); ++i)
+    if (rays[i].hasContact())
+    {
+      traces[i].pos.outT = rays[i].getLength();
+      traces[i].outNorm = rays[i].getNormal();
+      traces[i].outMatId = PHYSMAT_DEFAULT; // bodies don't keep material
+      res = true;
+    }
+  return res;
 }
 
 bool dacoll::is_debug_draw_forced() { return debugDrawerForced; }
@@ -1439,19 +1656,19 @@ struct ScopeSetForceDraw
 bool dacoll::box_cast_ex(const TMatrix &from, const TMatrix &to, Point3 dimensions, dacoll::ShapeQueryOutput &out, int cast_mat_id,
   dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle, int mask, int hmap_step)
 {
-  if (!phys_world || !phys_world->getScene() || !box_cast_shape)
+  if (!main_world.physWorld || !main_world.physWorld->getScene() || !main_world.boxCastShape)
     return false;
 
-  box_cast_shape->setBoxShapeExtents(dimensions);
+  main_world.boxCastShape->setBoxShapeExtents(dimensions);
 
   const float rad = max(dimensions.x, max(dimensions.y, dimensions.z));
-  return shape_cast_ex(box_cast_shape, from, to, rad, out, cast_mat_id, ignore_objs, handle, mask, hmap_step);
+  return shape_cast_ex(main_world, main_world.boxCastShape, from, to, rad, out, cast_mat_id, ignore_objs, handle, mask, hmap_step);
 }
 
 void dacoll::force_debug_draw(bool flag)
 {
   if (debugDrawerInited)
-    physdbg::setBufferedForcedDraw(phys_world, debugDrawerForced = flag);
+    physdbg::setBufferedForcedDraw(main_world.physWorld, debugDrawerForced = flag);
 }
 
 void dacoll::draw_phys_body(const PhysBody *body)
@@ -1459,7 +1676,7 @@ void dacoll::draw_phys_body(const PhysBody *body)
   if (!debugDrawerInited)
     return;
   ScopeSetForceDraw flagGuard(true);
-  physdbg::renderOneBody(phys_world, body);
+  physdbg::renderOneBody(main_world.physWorld, body);
 }
 
 void dacoll::draw_collision_object(const CollisionObject &obj)
@@ -1468,7 +1685,7 @@ void dacoll::draw_collision_object(const CollisionObject &obj)
     return;
   ScopeSetForceDraw flagGuard(true);
   if (obj.body)
-    physdbg::renderOneBody(phys_world, obj.body);
+    physdbg::renderOneBody(main_world.physWorld, obj.body);
 }
 
 void dacoll::draw_collision_object(const CollisionObject &obj, const TMatrix &tm)
@@ -1476,7 +1693,7 @@ void dacoll::draw_collision_object(const CollisionObject &obj, const TMatrix &tm
   if (!debugDrawerInited)
     return;
   ScopeSetForceDraw flagGuard(true);
-  physdbg::renderOneBody(phys_world, obj.body, tm);
+  physdbg::renderOneBody(main_world.physWorld, obj.body, tm);
 }
 
 void dacoll::set_obj_motion(CollisionObject obj, const TMatrix &tm, const Point3 &vel, const Point3 &omega)
@@ -1544,3 +1761,23 @@ void dacoll::get_coll_obj_tm(CollisionObject obj, TMatrix &tm)
   if (obj)
     obj.body->getTm(tm);
 }
+
+#if defined(USE_JOLT_PHYSICS)
+static bool dacoll_console_handler(const char *argv[], int argc)
+{
+  int found = 0;
+  CONSOLE_CHECK_NAME("phys", "check_determinism", 1, 3)
+  {
+    PhysWorld *physWorld = dacoll::get_phys_world();
+    if (!physWorld || !physWorld->getScene())
+      return found;
+    const int steps = argc > 1 ? console::to_int(argv[1]) : 60;
+    const float dt = argc > 2 ? console::to_real(argv[2]) : 1.f / 60.f;
+    // debug only: world is left simulated for steps ahead of game time
+    const bool deterministic = physWorld->checkDeterminism(dt, steps);
+    console::print_d("phys world simulation of %d steps of %gs is %sdeterministic", steps, dt, deterministic ? "" : "NOT ");
+  }
+  return found;
+}
+REGISTER_CONSOLE_HANDLER(dacoll_console_handler);
+#endif
@@ -10,8 +10,9 @@
 
 #include <gamePhys/props/atmosphere.h>
 #include <gamePhys/phys/utils.h>
-#include <util/dag_bitArray.h>
 #include <memory/dag_framemem.h>
+#include <util/dag_parallelForInline.h>
+#include <util/dag_convar.h>
 
 #include <gameRes/dag_collisionResource.h>
 
@@ -19,12 +20,17 @@
 
 #include <phys/dag_physics.h>
 
+#include <EASTL/sort.h>
+
 int velocity_iterations = 5;
 int position_iterations = 2;
 
 float linear_sleep_tolerance = 0.1f;
 float angular_sleep_tolerance = 0.1f;
 
+// solve islands on threadpool workers only if there are that many constraints
+CONSOLE_INT_VAL("phys", parallel_islands_min_constraints, 64, 0, 100000);
+
 #if defined(USE_BULLET_PHYSICS)
 typedef btManifoldPoint ManifoldPoint;
 typedef btPersistentManifold PersistentManifold;
@@ -574,6 +580,8 @@ void ContactSolver::initVelocityConstraints()
 
   for (auto &info : manifold)
     addContactConstraint(info, 0.0, 0.0);
+
+  buildIslands();
 }
 
 void ContactSolver::initPositionConstraints()
@@ -585,6 +593,88 @@ void ContactSolver::initPositionConstraints()
 
   for (auto &info : manifold)
     addContactConstraint(info, 0.0, 0.0);
+
+  buildIslands();
+}
+
+// Union-find over bodies connected by constraints, then stable reorder of constraints by island (islands are numbered in order of
+// their first constraint). Order of constraints within island is kept and each island is iterated until its own convergence, so
+// results don't depend on order islands are processed in nor on number of threads.
+void ContactSolver::buildIslands()
+{
+  clear_and_shrink(islands);
+  if (constraints.empty())
+    return;
+
+  Tab<int> parent(framemem_ptr());
+  parent.resize(bodies.size());
+  for (int i = 0; i < parent.size(); ++i)
+    parent[i] = i;
+  auto findRoot = [&parent](int i) {
+    while (parent[i] != i)
+      i = parent[i] = parent[parent[i]];
+    return i;
+  };
+  for (const Constraint &c : constraints)
+    if (c.indexA >= 0 && c.indexB >= 0)
+    {
+      const int rootA = findRoot(c.indexA), rootB = findRoot(c.indexB);
+      if (rootA != rootB)
+        parent[max(rootA, rootB)] = min(rootA, rootB);
+    }
+
+  Tab<int> islandByRoot(framemem_ptr());
+  Tab<int> constraintIsland(framemem_ptr());
+  islandByRoot.resize(bodies.size());
+  mem_set_ff(islandByRoot);
+  constraintIsland.resize(constraints.size());
+  for (int i = 0; i < constraints.size(); ++i)
+  {
+    const Constraint &c = constraints[i];
+    const int root = findRoot(c.indexA >= 0 ? c.indexA : c.indexB);
+    if (islandByRoot[root] < 0)
+    {
+      islandByRoot[root] = islands.size();
+      islands.push_back();
+    }
+    constraintIsland[i] = islandByRoot[root];
+    islands[constraintIsland[i]].constraintsEnd++; // count for now
+  }
+
+  if (islands.size() == 1)
+    return;
+
+  for (int i = 0, ofs = 0; i < islands.size(); ++i)
+  {
+    islands[i].constraintsBegin = ofs;
+    ofs += islands[i].constraintsEnd;
+    islands[i].constraintsEnd = islands[i].constraintsBegin;
+  }
+  Tab<Constraint> sorted;
+  sorted.resize(constraints.size());
+  for (int i = 0; i < constraints.size(); ++i)
+    sorted[islands[constraintIsland[i]].constraintsEnd++] = constraints[i];
+  constraints = eastl::move(sorted);
+}
+
+template <typename Cb>
+void ContactSolver::forEachIsland(Cb cb)
+{
+  const int workers = threadpool::get_num_workers();
+  // solver updated from job (e.g. within other parallel_for) shouldn't wait for nested jobs
+  if (islands.size() < 2 || workers == 0 || constraints.size() < parallel_islands_min_constraints.get() ||
+      threadpool::get_current_worker_id() >= 0)
+  {
+    for (const Island &island : islands)
+      cb(island, 0);
+    return;
+  }
+  // several small islands per job, some of them are large
+  const uint32_t quant = max<uint32_t>(islands.size() / ((workers + 1) * 4), 1);
+  threadpool::parallel_for_inline(0, islands.size(), quant, [&](uint32_t begin, uint32_t end, uint32_t thread_id) {
+    for (uint32_t i = begin; i < end; ++i)
+      cb(islands[i], thread_id);
+  });
 }
 
 ContactSolver::BodyState &ContactSolver::getState(int index) { return index >= 0 ? bodyStates[index] : groundState; }
@@ -615,157 +705,206 @@ void ContactSolver::BodyState::applyPseudoImpulse(double lambda, const DPoint3 &
 
 void ContactSolver::solveVelocityConstraints(double dt)
 {
-  const double invDt = safeinv(dt);
-
-  for (auto &state : bodyStates)
-    mem_set_0(state.appliedForce);
+  forEachIsland([this, dt](const Island &island, uint32_t) { solveIslandVelocityConstraints(island, dt); });
+}
 
-  for (auto &c : constraints)
-  {
-    BodyState &stateA = getState(c.indexA);
-    BodyState &stateB = getState(c.indexB);
-    if (!stateA.isKinematic || stateB.isKinematic)
-      stateA.accumulateForce(c.lambda, c.J[0], c.J[1]);
-    if (!stateB.isKinematic || stateA.isKinematic)
-      stateB.accumulateForce(c.lambda, c.J[2], c.J[3]);
-  }
+// All velocity passes of island are made within single job, each pass is iterated until island converges
+void ContactSolver::solveIslandVelocityConstraints(const Island &island, double dt)
+{
+  const double invDt = safeinv(dt);
+  // ground is never changed by constraints (zero inverse mass), local copy keeps islands from touching shared state
+  BodyState ground = groundState;
+  dag::Span<Constraint> islandConstraints = getIslandConstraints(island);
 
-  for (int iteration = 0; iteration < 10; ++iteration)
+  for (int pass = 0; pass < velocity_iterations; ++pass)
   {
-    bool solved = true;
-
-    for (auto &c : constraints)
+    for (auto &c : islandConstraints)
     {
-      BodyState &stateA = getState(c.indexA);
-      BodyState &stateB = getState(c.indexB);
-
-      const double linProjA = (stateA.velocity + stateA.addVelocity) * c.J[0];
-      const double angProjA = (stateA.omega + stateA.addOmega) * c.J[1];
-      const double linProjB = (stateB.velocity + stateB.addVelocity) * c.J[2];
-      const double angProjB = (stateB.omega + stateB.addOmega) * c.J[3];
+      mem_set_0(getState(c.indexA, ground).appliedForce);
+      mem_set_0(getState(c.indexB, ground).appliedForce);
+    }
 
-      const double relVelAfterContact = max(c.J[0] * (stateB.velocity - stateA.velocity) * c.bouncing, 0.0);
+    for (auto &c : islandConstraints)
+    {
+      BodyState &stateA = getState(c.indexA, ground);
+      BodyState &stateB = getState(c.indexB, ground);
+      if (!stateA.isKinematic || stateB.isKinematic)
+        stateA.accumulateForce(c.lambda, c.J[0], c.J[1]);
+      if (!stateB.isKinematic || stateA.isKinematic)
+        stateB.accumulateForce(c.lambda, c.J[2], c.J[3]);
+    }
 
-      const double bias = c.bias * c.beta * invDt + relVelAfterContact;
-      const double nu = (bias - (linProjA + angProjA + linProjB + angProjB)) * invDt;
+    for (int iteration = 0; iteration < 10; ++iteration)
+      if (solveVelocityIteration(islandConstraints, ground, invDt))
+        break;
 
-      const double ja = stateA.appliedForce[0] * c.J[0] + stateA.appliedForce[1] * c.J[1] + stateB.appliedForce[0] * c.J[2] +
-                        stateB.appliedForce[1] * c.J[3];
+    for (auto &c : islandConstraints)
+    {
+      Cache::Pair *pair = nullptr;
+      if (c.cacheId >= 0)
+        pair = &cache.pairs[c.cacheId];
 
-      double deltaLambda = (nu - ja) * c.invJB;
+      if (pair && c.type == Constraint::Type::Contact)
+        pair->manifold.getContactPoint(c.indexInCache).m_appliedImpulse = c.lambda;
 
-      double prevLambda = c.lambda;
-      c.lambda = max(c.lambdaMin, min(prevLambda + deltaLambda, c.lambdaMax));
-      deltaLambda = c.lambda - prevLambda;
+      if (pair && c.type == Constraint::Type::Friction1)
+        pair->manifold.getContactPoint(c.indexInCache).m_appliedImpulseLateral1 = c.lambda;
 
-      if (!float_nonzero(deltaLambda))
-        continue;
+      if (pair && c.type == Constraint::Type::Friction2)
+        pair->manifold.getContactPoint(c.indexInCache).m_appliedImpulseLateral2 = c.lambda;
 
-      solved = false;
+      BodyState &stateA = getState(c.indexA, ground);
+      BodyState &stateB = getState(c.indexB, ground);
 
       if (!stateA.isKinematic || stateB.isKinematic)
-        stateA.accumulateForce(deltaLambda, c.J[0], c.J[1]);
+        stateA.applyImpulse(c.lambda * dt, c.J[0], c.J[1]);
       if (!stateB.isKinematic || stateA.isKinematic)
-        stateB.accumulateForce(deltaLambda, c.J[2], c.J[3]);
+        stateB.applyImpulse(c.lambda * dt, c.J[2], c.J[3]);
     }
-
-    if (solved)
-      break;
   }
+}
 
-  for (auto &c : constraints)
+bool ContactSolver::solveVelocityIteration(dag::Span<Constraint> island_constraints, BodyState &ground, double inv_dt)
+{
+  bool solved = true;
+
+  for (auto &c : island_constraints)
   {
-    Cache::Pair *pair = nullptr;
-    if (c.cacheId >= 0)
-      pair = &cache.pairs[c.cacheId];
+    BodyState &stateA = getState(c.indexA, ground);
+    BodyState &stateB = getState(c.indexB, ground);
+
+    const double linProjA = (stateA.velocity + stateA.addVelocity) * c.J[0];
+    const double angProjA = (stateA.omega + stateA.addOmega) * c.J[1];
+    const double linProjB = (stateB.velocity + stateB.addVelocity) * c.J[2];
+    const double angProjB = (stateB.omega + stateB.addOmega) * c.J[3];
 
-    if (pair && c.type == Constraint::Type::Contact)
-      pair->manifold.getContactPoint(c.indexInCache).m_appliedImpulse = c.lambda;
+    const double relVelAfterContact = max(c.J[0] * (stateB.velocity - stateA.velocity) * c.bouncing, 0.0);
 
-    if (pair && c.type == Constraint::Type::Friction1)
-      pair->manifold.getContactPoint(c.indexInCache).m_appliedImpulseLateral1 = c.lambda;
+    const double bias = c.bias * c.beta * inv_dt + relVelAfterContact;
+    const double nu = (bias - (linProjA + angProjA + linProjB + angProjB)) * inv_dt;
 
-    if (pair && c.type == Constraint::Type::Friction2)
-      pair->manifold.getContactPoint(c.indexInCache).m_appliedImpulseLateral2 = c.lambda;
+    const double ja = stateA.appliedForce[0] * c.J[0] + stateA.appliedForce[1] * c.J[1] + stateB.appliedForce[0] * c.J[2] +
+                      stateB.appliedForce[1] * c.J[3];
 
-    BodyState &stateA = getState(c.indexA);
-    BodyState &stateB = getState(c.indexB);
+    double deltaLambda = (nu - ja) * c.invJB;
+
+    double prevLambda = c.lambda;
+    c.lambda = max(c.lambdaMin, min(prevLambda + deltaLambda, c.lambdaMax));
+    deltaLambda = c.lambda - prevLambda;
+
+    if (!float_nonzero(deltaLambda))
+      continue;
+
+    solved = false;
 
     if (!stateA.isKinematic || stateB.isKinematic)
-      stateA.applyImpulse(c.lambda * dt, c.J[0], c.J[1]);
+      stateA.accumulateForce(deltaLambda, c.J[0], c.J[1]);
     if (!stateB.isKinematic || stateA.isKinematic)
-      stateB.applyImpulse(c.lambda * dt, c.J[2], c.J[3]);
+      stateB.accumulateForce(deltaLambda, c.J[2], c.J[3]);
   }
+
+  return solved;
 }
 
+// Positions are solved when all islands are solved
 bool ContactSolver::solvePositionConstraints()
 {
-  for (auto &state : bodyStates)
-    mem_set_0(state.appliedForce);
+  Tab<int> unsolvedPerThread(framemem_ptr());
+  unsolvedPerThread.resize(threadpool::get_num_workers() + 1);
+  mem_set_0(unsolvedPerThread);
+  forEachIsland([this, &unsolvedPerThread](const Island &island, uint32_t thread_id) {
+    if (!solveIslandPositionConstraints(island))
+      unsolvedPerThread[thread_id] = 1;
+  });
+
+  for (int unsolved : unsolvedPerThread)
+    if (unsolved)
+      return false;
+  return true;
+}
 
-  double minDistance = DBL_MAX;
+bool ContactSolver::solveIslandPositionConstraints(const Island &island)
+{
+  BodyState ground = groundState;
+  dag::Span<Constraint> islandConstraints = getIslandConstraints(island);
 
-  for (int iteration = 0; iteration < 5; ++iteration)
+  for (int pass = 0; pass < position_iterations; ++pass)
   {
-    bool solved = true;
+    for (auto &c : islandConstraints)
+    {
+      mem_set_0(getState(c.indexA, ground).appliedForce);
+      mem_set_0(getState(c.indexB, ground).appliedForce);
+    }
 
-    for (auto &c : constraints)
+    double minDistance = DBL_MAX;
+    for (int iteration = 0; iteration < 5; ++iteration)
+      if (solvePositionIteration(islandConstraints, ground, iteration, minDistance))
+        break;
+
+    for (auto &c : islandConstraints)
     {
-      if (iteration == 0)
-        c.lambda = 0.0;
+      BodyState &stateA = getState(c.indexA, ground);
+      BodyState &stateB = getState(c.indexB, ground);
+      if (!stateA.isKinematic || stateB.isKinematic)
+        stateA.applyPseudoImpulse(c.lambda, c.J[0], c.J[1]);
+      if (!stateB.isKinematic || stateA.isKinematic)
+        stateB.applyPseudoImpulse(c.lambda, c.J[2], c.J[3]);
+    }
 
-      BodyState &stateA = getState(c.indexA);
-      BodyState &stateB = getState(c.indexB);
+    if (minDistance < 0.05)
+      return true;
+  }
+  return false;
+}
 
-      double ja = stateA.appliedForce[0] * c.J[0] + stateA.appliedForce[1] * c.J[1] + stateB.appliedForce[0] * c.J[2] +
-                  stateB.appliedForce[1] * c.J[3];
+bool ContactSolver::solvePositionIteration(dag::Span<Constraint> island_constraints, BodyState &ground, int iteration,
+  double &min_distance)
+{
+  bool solved = true;
 
-      DPoint3 pA;
-      TMatrix tmA;
-      stateA.location.toTM(tmA);
-      pA = tmA * c.localPosA;
+  for (auto &c : island_constraints)
+  {
+    if (iteration == 0)
+      c.lambda = 0.0;
 
-      DPoint3 pB;
-      TMatrix tmB;
-      stateB.location.toTM(tmB);
-      pB = tmB * c.localPosB;
+    BodyState &stateA = getState(c.indexA, ground);
+    BodyState &stateB = getState(c.indexB, ground);
 
-      double d = (pA - pB) * c.normal;
-      double C = clamp((d - 0.05) * 0.2, 0.0, 0.2);
-      if (C < minDistance)
-        minDistance = C;
-      double deltaLambda = (C - ja) * c.invJB;
+    double ja = stateA.appliedForce[0] * c.J[0] + stateA.appliedForce[1] * c.J[1] + stateB.appliedForce[0] * c.J[2] +
+                stateB.appliedForce[1] * c.J[3];
 
-      double prevLambda = c.lambda;
-      c.lambda = max(c.lambdaMin, min(prevLambda + deltaLambda, c.lambdaMax));
-      deltaLambda = c.lambda - prevLambda;
+    DPoint3 pA;
+    TMatrix tmA;
+    stateA.location.toTM(tmA);
+    pA = tmA * c.localPosA;
 
-      if (!float_nonzero(deltaLambda))
-        continue;
+    DPoint3 pB;
+    TMatrix tmB;
+    stateB.location.toTM(tmB);
+    pB = tmB * c.localPosB;
 
-      solved = false;
+    double d = (pA - pB) * c.normal;
+    double C = clamp((d - 0.05) * 0.2, 0.0, 0.2);
+    if (C < min_distance)
+      min_distance = C;
+    double deltaLambda = (C - ja) * c.invJB;
 
-      if (!stateA.isKinematic || stateB.isKinematic)
-        stateA.accumulateForce(deltaLambda, c.J[0], c.J[1]);
-      if (!stateB.isKinematic || stateA.isKinematic)
-        stateB.accumulateForce(deltaLambda, c.J[2], c.J[3]);
-    }
+    double prevLambda = c.lambda;
+    c.lambda = max(c.lambdaMin, min(prevLambda + deltaLambda, c.lambdaMax));
+    deltaLambda = c.lambda - prevLambda;
 
-    if (solved)
-      break;
-  }
+    if (!float_nonzero(deltaLambda))
+      continue;
+
+    solved = false;
 
-  for (auto &c : constraints)
-  {
-    BodyState &stateA = getState(c.indexA);
-    BodyState &stateB = getState(c.indexB);
     if (!stateA.isKinematic || stateB.isKinematic)
-      stateA.applyPseudoImpulse(c.lambda, c.J[0], c.J[1]);
+      stateA.accumulateForce(deltaLambda, c.J[0], c.J[1]);
     if (!stateB.isKinematic || stateA.isKinematic)
-      stateB.applyPseudoImpulse(c.lambda, c.J[2], c.J[3]);
+      stateB.accumulateForce(deltaLambda, c.J[2], c.J[3]);
   }
 
-  return constraints.empty() || minDistance < 0.05;
+  return solved;
 }
 
 void ContactSolver::clearData()
@@ -774,6 +913,7 @@ void ContactSolver::clearData()
   cache.clearData();
   clear_and_shrink(bodies);
   clear_and_shrink(bodyStates);
+  broadphase.reset();
 }
 
 void ContactSolver::clearData(int index) { cache.clearData(index); }
@@ -801,6 +941,50 @@ void ContactSolver::checkStaticCollisions(int body_no, const ContactSolver::Body
     addContact(-1, body_no, c);
 }
 
+// Sweep and prune of bounding spheres along X with pairs tracked between updates (see gamephys::SweepAndPrune).
+// Pairs are returned as (lower index, higher index) in the same order as exhaustive test of all pairs gives them,
+// solver results don't depend on broadphase.
+void ContactSolver::gatherTestPairs(Tab<int> &test_pairs)
+{
+  Tab<DPoint3> pos(framemem_ptr());
+  pos.resize(bodies.size());
+  broadphase.update(bodies.size(), [this, &pos](int i, double &min_x, double &max_x) {
+    const Body &body = bodies[i];
+    if (!body.phys || !(body.flags & Flags::ProcessBody))
+      return false;
+    pos[i] = body.phys->getCurrentStateLoc().P;
+    min_x = pos[i].x - body.boundingRadius;
+    max_x = pos[i].x + body.boundingRadius;
+    return true;
+  });
+
+  Tab<uint64_t> pairs(framemem_ptr());
+  broadphase.forEachPair([this, &pos, &pairs](int cur_no, int test_no) {
+    const Body &curBody = bodies[cur_no];
+    const Body &testBody = bodies[test_no];
+
+    const int layerNo = curBody.layer + testBody.layer * MAX_LAYERS_NUM;
+    if (!layersMask[layerNo])
+      return;
+
+    if (curBody.phys->isAsleep() && testBody.phys->isAsleep())
+      return;
+
+    if (lengthSq(pos[test_no] - pos[cur_no]) > sqr(curBody.boundingRadius + testBody.boundingRadius))
+      return;
+
+    pairs.push_back((uint64_t(cur_no) << 32) | uint64_t(test_no));
+  });
+
+  eastl::sort(pairs.begin(), pairs.end());
+  test_pairs.reserve(pairs.size() * 2);
+  for (uint64_t pair : pairs)
+  {
+    test_pairs.push_back(int(pair >> 32));
+    test_pairs.push_back(int(pair & 0xFFFFFFFFu));
+  }
+}
+
 void ContactSolver::update(double at_time, double dt)
 {
   const int curTick = gamephys::ceilPhysicsTickNumber(at_time, dt);
@@ -816,70 +1000,15 @@ void ContactSolver::update(double at_time, double dt)
       {
         erase_items(bodies, i, 1);
         erase_items(bodyStates, i, 1);
+        broadphase.reset(); // indices are shifted
       }
   }
 
   atTick = gamephys::nearestPhysicsTickNumber(at_time + dt, dt);
 
-  Bitarray checked(framemem_ptr());
-  Tab<int> testPairs(framemem_ptr());
-
-  const int bodiesCount = bodies.size();
-
   // Broad phase
-  for (int curNo = 0; curNo < bodiesCount; ++curNo)
-  {
-    Body &curBody = bodies[curNo];
-    IPhysBase *curBodyPhys = curBody.phys;
-    if (!curBodyPhys)
-      continue;
-
-    gamephys::Loc curLoc = curBodyPhys->getCurrentStateLoc();
-
-    for (int testNo = 0; testNo < bodiesCount; testNo++)
-    {
-      if (curNo == testNo)
-        continue;
-
-      Body &testBody = bodies[testNo];
-
-      const int layerNo = curBody.layer + testBody.layer * MAX_LAYERS_NUM;
-      if (!layersMask[layerNo])
-        continue;
-
-      const int pair0Idx = curNo + testNo * bodiesCount;
-      const int pair1Idx = testNo + curNo * bodiesCount;
-
-      if (pair0Idx < checked.size() && pair1Idx < checked.size() && checked[pair0Idx] && checked[pair1Idx])
-        continue;
-
-      IPhysBase *testBodyPhys = testBody.phys;
-      if (!testBodyPhys)
-        continue;
-
-      if (!(curBody.flags & Flags::ProcessBody) || !(testBody.flags & Flags::ProcessBody))
-        continue;
-
-      if (curBodyPhys->isAsleep() && testBodyPhys->isAsleep())
-        continue;
-
-      gamephys::Loc testLoc = testBodyPhys->getCurrentStateLoc();
-
-      if (lengthSq(testLoc.P - curLoc.P) > sqr(curBody.boundingRadius + testBody.boundingRadius))
-        continue;
-
-      testPairs.reserve(8);
-      testPairs.push_back() = curNo;
-      testPairs.push_back() = testNo;
-
-      const int maxIdx = max(pair0Idx, pair1Idx);
-      if (maxIdx >= checked.size())
-        checked.resize(maxIdx + 1);
-
-      checked.set(pair0Idx);
-      checked.set(pair1Idx);
-    }
-  }
+  Tab<int> testPairs(framemem_ptr());
+  gatherTestPairs(testPairs);
 
   // Narrow phase
   for (int i = 0; i < testPairs.size(); i += 2)
@@ -921,23 +1050,13 @@ void ContactSolver::update(double at_time, double dt)
   integrateVelocity(dt);
   initVelocityConstraints();
 
-  for (int i = 0; i < velocity_iterations; ++i)
-    solveVelocityConstraints(dt);
+  solveVelocityConstraints(dt);
 
   integratePositions(dt);
 
   initPositionConstraints();
 
-  bool positionsSolved = false;
-  if (solverFlags & SolverFlags::SolvePositions)
-    for (int i = 0; i < position_iterations; ++i)
-    {
-      positionsSolved = solvePositionConstraints();
-      if (positionsSolved)
-        break;
-    }
-  else
-    positionsSolved = true;
+  const bool positionsSolved = !(solverFlags & SolverFlags::SolvePositions) || solvePositionConstraints();
 
   for (auto &c : constraints)
   {
@@ -0,0 +1,230 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <gamePhys/collision/contactSolver.h>
+#include <gamePhys/collision/collisionLib.h>
+#include <gamePhys/collision/collisionObject.h>
+#include <gamePhys/phys/physBase.h>
+#include <ioSys/dag_dataBlock.h>
+#include <startup/dag_globalSettings.h>
+#include <util/dag_threadPool.h>
+#include <util/dag_convar.h>
+#include <osApiWrappers/dag_cpuJobs.h>
+#include <math/random/dag_random.h>
+#include <math/dag_TMatrix.h>
+#include <generic/dag_tab.h>
+
+#if defined(USE_JOLT_PHYSICS)
+
+extern ConVarT<int, true> parallel_islands_min_constraints;
+
+// Sphere body which only keeps state set by solver, positions are integrated by test
+class SpherePhys final : public IPhysBase
+{
+public:
+  static constexpr float RADIUS = 0.5f;
+
+  gamephys::Loc loc;
+  DPoint3 vel = ZERO<DPoint3>();
+  DPoint3 omega = ZERO<DPoint3>();
+  mutable CollisionObject coll;
+  bool asleep = false;
+
+  SpherePhys(const Point3 &pos, const Point3 &velocity) : vel(dpoint3(velocity))
+  {
+    loc.P = dpoint3(pos);
+    loc.O.setQuat(Quat(0.f, 0.f, 0.f, 1.f));
+    coll = dacoll::add_dynamic_sphere_collision(TMatrix::IDENT, RADIUS, nullptr, false);
+  }
+  ~SpherePhys() { dacoll::destroy_dynamic_collision(coll); }
+
+  void integrate(float dt) { loc.P += vel * dt; }
+
+  void validateTraceCache() override {}
+  void updatePhys(float, float, bool) override {}
+  int applyUnapprovedCTAsAt(int32_t, bool, int, uint8_t) override { return 0; }
+  void applyOffset(const Point3 &) override {}
+  void applyVelOmegaDelta(const DPoint3 &, const DPoint3 &) override {}
+  void applyPseudoVelOmegaDelta(const DPoint3 &, const DPoint3 &) override {}
+  float getMass() const override { return 1.f; }
+  DPoint3 calcInertia() const override { return DPoint3(1.0, 1.0, 1.0) * (0.4 * RADIUS * RADIUS); }
+  TraceMeshFaces *getTraceHandle() const override { return nullptr; }
+  IPhysActor *getActor() const override { return nullptr; }
+  dag::ConstSpan<CollisionObject> getCollisionObjects() const override { return make_span_const(&coll, 1); }
+  uint64_t getActiveCollisionObjectsBitMask() const override { return ~0ull; }
+  TMatrix getCollisionObjectsMatrix() const override { return TMatrix::IDENT; }
+  dag::Span<CollisionObject> getMutableCollisionObjects() const override { return make_span(&coll, 1); }
+  void prepareCollisions(daphys::SolverBodyInfo &, daphys::SolverBodyInfo &, bool, dag::Span<gamephys::CollisionContactData>,
+    dag::Span<gamephys::SeqImpulseInfo>) const override
+  {}
+  const gamephys::Loc &getVisualStateLoc() const override { return loc; }
+  const gamephys::Loc &getCurrentStateLoc() const override { return loc; }
+  const DPoint3 &getCurrentStatePosition() const override { return loc.P; }
+  DPoint3 getCurrentStateVelocity() const override { return vel; }
+  DPoint3 getCurrentStateAccel() const override { return ZERO<DPoint3>(); }
+  DPoint3 getCurrentStateOmega() const override { return omega; }
+  DPoint3 getPreviousStateVelocity() const override { return vel; }
+  Point3 getCenterOfMass() const override { return ZERO<Point3>(); }
+  void addOverallShockImpulse(float) override {}
+  float getOverallShockImpulse() const override { return 0.f; }
+  void addSoundShockImpulse(float) override {}
+  float getSoundShockImpulse() const override { return 0.f; }
+  void addVolumetricDamage(const Point3 &, float, bool, void *, int) override {}
+  void setPositionRough(const Point3 &) override {}
+  void setOrientationRough(gamephys::Orient) override {}
+  void stopRotationRough() override {}
+  void setTmRough(TMatrix) override {}
+  void setTmSoft(TMatrix) override {}
+  void setVelocityRough(Point3) override {}
+  void saveAllStates(int32_t) override {}
+  void interpolateVisualPosition(float) override {}
+  void calcPosVelAtTime(double, DPoint3 &, DPoint3 &) const override {}
+  void calcQuatOmegaAtTime(double, Quat &, DPoint3 &) const override {}
+  void setCurrentTick(int32_t) override {}
+  int32_t getCurrentTick() const override { return 0; }
+  int32_t getPreviousTick() const override { return 0; }
+  int32_t getLastAppliedControlsForTick() const override { return 0; }
+  float getTimeStep() const override { return 1.f / 30.f; }
+  void setTimeStep(float) override {}
+  float getMaxTimeDeferredControls() const override { return 0.f; }
+  void setMaxTimeDeferredControls(float) override {}
+  void resetProducedCt() override {}
+  void setLocationFromTm(const TMatrix &) override {}
+  void reset() override {}
+  void repair() override {}
+  bool receiveAuthorityApprovedState(const danet::BitStream &, uint8_t, float) override { return false; }
+  bool receivePartialAuthorityApprovedState(const danet::BitStream &) override { return false; }
+  void rescheduleAuthorityApprovedSend(int) override {}
+  bool receiveControlsPacket(const danet::BitStream &, int, int32_t &) override { return false; }
+  void reportDeserializationError(int) override {}
+  bool isAsleep() const override { return asleep; }
+  void wakeUp() override { asleep = false; }
+  void putToSleep() override { asleep = true; }
+  void setCurrentMinimalState(const gamephys::Loc &l, const DPoint3 &v, const DPoint3 &w) override
+  {
+    loc = l;
+    vel = v;
+    omega = w;
+  }
+  float getFriction() const override { return 0.5f; }
+  void setFriction(float) override {}
+  float getBouncing() const override { return 0.2f; }
+  void setBouncing(float) override {}
+};
+
+// Clusters of three spheres moving into each other, clusters are far apart along X, so each of them is separate island
+struct ContactSolverFixture
+{
+  static constexpr int CLUSTER_COUNT = 40;
+  static constexpr float DT = 1.f / 30.f;
+
+  struct Scene
+  {
+    ContactSolver solver;
+    Tab<SpherePhys *> bodies;
+  };
+  Scene parallel, serial;
+
+  static const DataBlock *get_settings()
+  {
+    static DataBlock blk;
+    return &blk;
+  }
+
+  ContactSolverFixture()
+  {
+    dgs_get_settings = &get_settings;
+    threadpool::init(3, 256);
+    dacoll::init_collision_world();
+    int seed = 4321;
+    for (int i = 0; i < CLUSTER_COUNT; ++i)
+    {
+      const Point3 center(i * 10.f, 0.f, _srnd(seed));
+      for (int j = 0; j < 3; ++j)
+      {
+        const float angle = TWOPI * j / 3 + _srnd(seed) * 0.2f;
+        const Point3 dir(cosf(angle), _srnd(seed) * 0.2f, sinf(angle));
+        const Point3 pos = center + dir * (SpherePhys::RADIUS * 0.55f);
+        const Point3 vel = -dir * (0.5f + _frnd(seed));
+        for (Scene *scene : {&parallel, &serial})
+        {
+          scene->bodies.push_back(new SpherePhys(pos, vel));
+          scene->solver.addBody(scene->bodies.back(), SpherePhys::RADIUS);
+        }
+      }
+    }
+    for (Scene *scene : {&parallel, &serial})
+      scene->solver.updatePolicy = ContactSolver::UpdatePolicy::UpdateAlways;
+  }
+
+  ~ContactSolverFixture()
+  {
+    parallel_islands_min_constraints.set(64);
+    for (Scene *scene : {&parallel, &serial})
+    {
+      scene->solver.clearData();
+      clear_all_ptr_items(scene->bodies);
+    }
+    dacoll::term_collision_world();
+    threadpool::shutdown();
+  }
+
+  static void step(Scene &scene, int tick)
+  {
+    scene.solver.update(tick * DT, DT);
+    for (SpherePhys *body : scene.bodies)
+      body->integrate(DT);
+  }
+
+  static double clusterSpread(const Scene &scene)
+  {
+    double spread = 0.0;
+    for (int i = 0; i < scene.bodies.size(); i += 3)
+      spread += length(scene.bodies[i]->loc.P - scene.bodies[i + 1]->loc.P);
+    return spread / CLUSTER_COUNT;
+  }
+
+  void checkSameState()
+  {
+    for (int i = 0; i < parallel.bodies.size(); ++i)
+    {
+      const SpherePhys &p = *parallel.bodies[i], &s = *serial.bodies[i];
+      CHECK(p.loc == s.loc && p.vel == s.vel && p.omega == s.omega);
+    }
+  }
+};
+
+TEST_FIXTURE(ContactSolverFixture, ParallelIslandsMatchSerial)
+{
+  const double initialSpread = clusterSpread(serial);
+  for (int tick = 0; tick < 20; ++tick)
+  {
+    parallel_islands_min_constraints.set(0);
+    step(parallel, tick);
+    parallel_islands_min_constraints.set(100000);
+    step(serial, tick);
+    checkSameState();
+  }
+  CHECK(clusterSpread(serial) > initialSpread * 1.5); // spheres are pushed apart
+}
+
+// Solver updated from threadpool job solves islands in place instead of waiting for nested jobs
+TEST_FIXTURE(ContactSolverFixture, UpdateFromJobMatchesSerial)
+{
+  struct UpdateJob final : cpujobs::IJob
+  {
+    Scene *scene = nullptr;
+    int tick = 0;
+    void doJob() override { step(*scene, tick); }
+  } job;
+  job.scene = &parallel;
+  parallel_islands_min_constraints.set(0);
+  for (int tick = 0; tick < 10; ++tick)
+  {
+    job.tick = tick;
+    threadpool::add(&job);
+    threadpool::wait(&job);
+    step(serial, tick);
+  }
+  checkSameState();
+}
+
+#endif
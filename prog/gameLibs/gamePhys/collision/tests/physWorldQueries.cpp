@@ -0,0 +1,308 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <gamePhys/collision/collisionLib.h>
+#include <gamePhys/collision/collisionObject.h>
+#include <gameMath/traceUtils.h>
+#include <phys/dag_physics.h>
+#include <ioSys/dag_dataBlock.h>
+#include <startup/dag_globalSettings.h>
+#include <util/dag_threadPool.h>
+#include <math/random/dag_random.h>
+#include <math/dag_TMatrix.h>
+#include <generic/dag_tab.h>
+#include <phys/dag_physBodyCreationData.h>
+
+#if defined(USE_JOLT_PHYSICS)
+
+// Main collision world with random spheres, boxes and capsules, batched queries are compared with single ones
+struct PhysWorldFixture
+{
+  static constexpr int OBJ_COUNT = 60;
+  static constexpr float WORLD_EXT = 20.f;
+
+  Tab<CollisionObject> objects;
+  int seed = 12345;
+
+  static const DataBlock *get_settings()
+  {
+    static DataBlock blk;
+    return &blk;
+  }
+
+  PhysWorldFixture()
+  {
+    dgs_get_settings = &get_settings;
+    threadpool::init(3, 256);
+    dacoll::init_collision_world();
+    for (int i = 0; i < OBJ_COUNT; ++i)
+    {
+      TMatrix tm;
+      tm.makeTM(normalize(Point3(_srnd(seed), _srnd(seed), _srnd(seed)) + Point3(0.f, 0.f, 0.01f)), _srnd(seed) * PI);
+      tm.setcol(3, randomPos());
+      const float size = 0.5f + _frnd(seed) * 2.f;
+      if (i % 3 == 0)
+        objects.push_back(dacoll::add_dynamic_sphere_collision(tm, size));
+      else if (i % 3 == 1)
+        objects.push_back(dacoll::add_dynamic_box_collision(tm, Point3(size, size * 0.5f, size * 2.f)));
+      else
+        objects.push_back(dacoll::add_dynamic_capsule_collision(tm, size * 0.5f, size * 3.f));
+    }
+  }
+
+  ~PhysWorldFixture()
+  {
+    for (CollisionObject &co : objects)
+      dacoll::destroy_dynamic_collision(co);
+    dacoll::term_collision_world();
+    threadpool::shutdown();
+  }
+
+  Point3 randomPos() { return Point3(_srnd(seed) * WORLD_EXT, _srnd(seed) * 5.f, _srnd(seed) * WORLD_EXT); }
+};
+
+struct AllBodiesCb
+{
+  bool needsCollision(PhysBody *, void *) const { return true; }
+};
+
+TEST_FIXTURE(PhysWorldFixture, MultirayMatchesSingleTraces)
+{
+  constexpr int COUNT = 200;
+  constexpr float MAX_T = 60.f;
+  Tab<Trace> traces;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    const Point3 from = randomPos() * 2.f;
+    traces.push_back(Trace(from, normalize(randomPos() - from), MAX_T, nullptr));
+  }
+  Tab<Trace> batch(traces);
+  const bool batchRes = dacoll::traceray_normalized_multiray(make_span(batch), {}, dacoll::ETF_PHYS_WORLD);
+
+  bool anyHit = false;
+  int hits = 0;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    float t = MAX_T;
+    int pmid = -1;
+    Point3 norm(0.f, 0.f, 0.f);
+    const bool hit = dacoll::traceray_normalized(traces[i].pos, traces[i].dir, t, &pmid, &norm, dacoll::ETF_PHYS_WORLD);
+    anyHit |= hit;
+    hits += hit;
+    CHECK_EQUAL(hit, batch[i].pos.outT < MAX_T);
+    CHECK_EQUAL(t, batch[i].pos.outT);
+    if (hit)
+    {
+      CHECK_EQUAL(pmid, batch[i].outMatId);
+      CHECK(norm == Point3(batch[i].outNorm));
+    }
+  }
+  CHECK_EQUAL(anyHit, batchRes);
+  CHECK(hits > COUNT / 10 && hits < COUNT);
+}
+
+// Wheel rays traced in one batch get same results as traced one by one (both tracers are installed to Bullet ray cars together)
+TEST_FIXTURE(PhysWorldFixture, VehicleWheelMultirayMatchesSingleTraces)
+{
+  constexpr int COUNT = 200;
+  dacoll::set_vehicle_wheel_tracers(dacoll::ETF_PHYS_WORLD);
+  Tab<IPhysVehicle::WheelRay> rays;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    IPhysVehicle::WheelRay &ray = rays.push_back();
+    ray.pos = randomPos() + Point3(0.f, 6.f, 0.f);
+    ray.dir = normalize(Point3(_srnd(seed) * 0.3f, -1.f, _srnd(seed) * 0.3f));
+    ray.t = 15.f;
+    ray.norm = Point3(0.f, 1.f, 0.f);
+    ray.pmid = -1;
+    ray.hit = false;
+  }
+  Tab<IPhysVehicle::WheelRay> batch(rays);
+  dacoll::vehicle_wheel_trace_multiray(make_span(batch));
+
+  int hits = 0, reused = 0;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    float t = rays[i].t;
+    Point3 norm = rays[i].norm;
+    int pmid = 0;
+    const bool hit = dacoll::vehicle_wheel_traceray(rays[i].pos, rays[i].dir, t, norm, pmid);
+    hits += hit;
+    CHECK_EQUAL(hit, batch[i].hit);
+    CHECK_EQUAL(t, batch[i].t);
+    CHECK_EQUAL(pmid, batch[i].pmid);
+    CHECK(norm == batch[i].norm);
+
+    // unchanged ray reuses batched result as is, unless hit plane is parallel to ray (ray starts inside or grazes object)
+    float reusedT = 0.f;
+    bool reusedHit = !hit;
+    if (batch[i].reuseFor(rays[i].pos, rays[i].dir, rays[i].t, reusedT, reusedHit))
+    {
+      reused++;
+      CHECK_EQUAL(hit, reusedHit);
+      CHECK_CLOSE(t, reusedT, 1e-4f);
+    }
+    else
+      CHECK(hit && rays[i].dir * norm > -1e-3f);
+  }
+  CHECK(hits > COUNT / 10 && hits < COUNT);
+  CHECK(reused > COUNT * 9 / 10);
+
+  dacoll::set_vehicle_wheel_tracers(0);
+  float t = 15.f;
+  Point3 norm;
+  int pmid;
+  CHECK(!dacoll::vehicle_wheel_traceray(rays[0].pos, rays[0].dir, t, norm, pmid));
+}
+
+// Slightly moved wheel ray reuses batched hit intersecting its plane, otherwise it should be traced again
+TEST(VehicleWheelRayReuse)
+{
+  IPhysVehicle::WheelRay ray;
+  ray.pos = Point3(0.f, 1.f, 0.f);
+  ray.dir = Point3(0.f, -1.f, 0.f);
+  ray.t = 0.8f;
+  ray.norm = normalize(Point3(0.2f, 1.f, 0.f));
+  ray.pmid = 3;
+  ray.hit = true;
+
+  float t = 0.f;
+  bool hit = false;
+  const Point3 hitPos = ray.pos + ray.dir * ray.t;
+  const Point3 moved = ray.pos + Point3(0.03f, 0.02f, -0.02f);
+  CHECK(ray.reuseFor(moved, ray.dir, 1.f, t, hit));
+  CHECK(hit);
+  CHECK_CLOSE(0.f, (moved + ray.dir * t - hitPos) * ray.norm, 1e-5f); // on hit plane
+  CHECK(fabsf(t - ray.t) > 1e-3f);
+
+  const Point3 turned = normalize(Point3(0.03f, -1.f, 0.f));
+  CHECK(ray.reuseFor(ray.pos, turned, 1.f, t, hit));
+  CHECK_CLOSE(0.f, (ray.pos + turned * t - hitPos) * ray.norm, 1e-5f);
+
+  CHECK(!ray.reuseFor(ray.pos + Point3(0.1f, 0.f, 0.f), ray.dir, 1.f, t, hit));            // moved too far
+  CHECK(!ray.reuseFor(ray.pos, normalize(Point3(0.1f, -1.f, 0.f)), 1.f, t, hit));         // turned too much
+  CHECK(!ray.reuseFor(ray.pos + Point3(0.f, 0.04f, 0.f), ray.dir, ray.t + 0.01f, t, hit)); // hit is farther than ray length
+
+  ray.hit = false;
+  CHECK(ray.reuseFor(moved, ray.dir, 1.f, t, hit));
+  CHECK(!hit);
+}
+
+TEST_FIXTURE(PhysWorldFixture, SphereCastBatchMatchesSingleCasts)
+{
+  constexpr int COUNT = 100;
+  Tab<dacoll::SphereCastDesc> casts;
+  for (int i = 0; i < COUNT; ++i)
+    casts.push_back(dacoll::SphereCastDesc{randomPos() * 2.f, randomPos() * 2.f, 0.1f + _frnd(seed)});
+  Tab<dacoll::ShapeQueryOutput> batch;
+  batch.resize(COUNT);
+  dacoll::phys_world_sphere_cast_batch(casts, make_span(batch));
+
+  int hits = 0;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    dacoll::ShapeQueryOutput single;
+    PhysSphereCollision sphere(casts[i].rad);
+    dacoll::get_phys_world()->convexSweepTest(sphere, casts[i].from, casts[i].to, AllBodiesCb(), single, dacoll::EPL_DEFAULT,
+      dacoll::DEFAULT_SPHERE_CAST_MASK);
+    hits += single.t < 1.f;
+    CHECK_EQUAL(single.t, batch[i].t);
+    if (single.t < 1.f)
+    {
+      CHECK(single.res == batch[i].res);
+      CHECK(single.norm == batch[i].norm);
+    }
+  }
+  CHECK(hits > COUNT / 10 && hits < COUNT);
+}
+
+TEST_FIXTURE(PhysWorldFixture, CapsuleCastIsOrientedAlongAxis)
+{
+  // sphere far from other objects, capsules are cast down beside it
+  const float sphereRad = 0.5f, capsuleRad = 0.3f, halfHeight = 2.f;
+  TMatrix tm = TMatrix::IDENT;
+  tm.setcol(3, Point3(1000.f, 0.f, 0.f));
+  objects.push_back(dacoll::add_dynamic_sphere_collision(tm, sphereRad));
+
+  Tab<PhysWorld::ShapeCastDesc> casts;
+  for (const Point3 &axis : {Point3(1.f, 0.f, 0.f), Point3(0.f, 1.f, 0.f), Point3(0.f, 0.f, 1.f)})
+  {
+    PhysWorld::ShapeCastDesc &desc = casts.push_back();
+    desc.from = Point3(1000.f - halfHeight, 10.f, 0.f);
+    desc.to = Point3(1000.f - halfHeight, -10.f, 0.f);
+    desc.radius = capsuleRad;
+    desc.capsuleHalfHeight = halfHeight;
+    desc.capsuleAxis = axis;
+    desc.filterGrp = dacoll::EPL_DEFAULT;
+    desc.filterMask = dacoll::DEFAULT_SPHERE_CAST_MASK;
+  }
+  Tab<PhysShapeQueryResult> out;
+  out.resize(casts.size());
+  dacoll::get_phys_world()->shapeCastBatch(casts, make_span(out));
+
+  // only capsule along X reaches sphere with its end
+  CHECK_CLOSE((10.f - sphereRad - capsuleRad) / 20.f, out[0].t, 1e-3f);
+  CHECK_EQUAL(1.f, out[1].t);
+  CHECK_EQUAL(1.f, out[2].t);
+}
+
+// Bodies of additional world are neither traced nor simulated by main world and vice versa
+TEST_FIXTURE(PhysWorldFixture, AdditionalWorldIsIsolated)
+{
+  dacoll::CollisionWorld *world = dacoll::create_collision_world();
+  CHECK(world != nullptr);
+  if (!world)
+    return;
+  PhysWorld *physWorld = dacoll::get_phys_world(world);
+  CHECK(physWorld != nullptr && physWorld != dacoll::get_phys_world());
+
+  // far from objects of main world
+  const Point3 bodyPos(1000.f, 0.f, 0.f);
+  TMatrix tm = TMatrix::IDENT;
+  tm.setcol(3, bodyPos);
+  PhysSphereCollision sphere(1.f);
+  PhysBodyCreationData pbcd;
+  pbcd.autoMask = false;
+  pbcd.group = dacoll::EPL_DEFAULT;
+  pbcd.mask = dacoll::EPL_ALL;
+  PhysBody *body = new PhysBody(physWorld, 1.f, &sphere, tm, pbcd);
+
+  const Point3 from = bodyPos + Point3(0.f, 10.f, 0.f), dir(0.f, -1.f, 0.f);
+  float t = 20.f;
+  CHECK(!dacoll::traceray_normalized(from, dir, t, nullptr, nullptr, dacoll::ETF_PHYS_WORLD));
+  CHECK(dacoll::traceray_normalized(from, dir, t, nullptr, nullptr, dacoll::ETF_PHYS_WORLD, nullptr, -1, nullptr, world));
+  CHECK_CLOSE(9.f, t, 1e-3f);
+  CHECK(!dacoll::rayhit_normalized(from, dir, 20.f, dacoll::ETF_PHYS_WORLD));
+  CHECK(dacoll::rayhit_normalized(from, dir, 20.f, dacoll::ETF_PHYS_WORLD, -1, nullptr, rendinst::RIEX_HANDLE_NULL, world));
+  t = 20.f;
+  CHECK(dacoll::tracedown_normalized(from, t, nullptr, nullptr, dacoll::ETF_PHYS_WORLD, nullptr, -1, nullptr, world));
+
+  const dacoll::SphereCastDesc cast{from, bodyPos - Point3(0.f, 10.f, 0.f), 0.5f};
+  dacoll::ShapeQueryOutput mainOut, worldOut;
+  dacoll::phys_world_sphere_cast_batch(make_span_const(&cast, 1), make_span(&mainOut, 1));
+  dacoll::phys_world_sphere_cast_batch(make_span_const(&cast, 1), make_span(&worldOut, 1), dacoll::DEFAULT_SPHERE_CAST_MASK, world);
+  CHECK_EQUAL(1.f, mainOut.t);
+  CHECK_CLOSE(8.5f / 20.f, worldOut.t, 1e-3f);
+
+  // objects of main world are not in additional one
+  for (int i = 0; i < 20; ++i)
+  {
+    const Point3 p = randomPos() * 2.f;
+    const Point3 d = normalize(randomPos() - p);
+    float mainT = 60.f, worldT = 60.f;
+    dacoll::traceray_normalized(p, d, mainT, nullptr, nullptr, dacoll::ETF_PHYS_WORLD);
+    CHECK(!dacoll::traceray_normalized(p, d, worldT, nullptr, nullptr, dacoll::ETF_PHYS_WORLD, nullptr, -1, nullptr, world));
+  }
+
+  // simulation of main world doesn't move body, simulation of its world does (gravity)
+  dacoll::get_phys_world()->simulate(0.1f);
+  TMatrix bodyTm;
+  body->getTm(bodyTm);
+  CHECK(bodyTm.getcol(3) == bodyPos);
+  physWorld->simulate(0.1f);
+  body->getTm(bodyTm);
+  CHECK(bodyTm.getcol(3).y < bodyPos.y);
+
+  delete body;
+  dacoll::destroy_collision_world(world);
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <gamePhys/collision/collisionLib.h>
+#include <phys/dag_physics.h>
+#include <phys/dag_physBodyCreationData.h>
+#include <ioSys/dag_dataBlock.h>
+#include <startup/dag_globalSettings.h>
+#include <util/dag_threadPool.h>
+#include <math/random/dag_random.h>
+#include <math/dag_TMatrix.h>
+#include <generic/dag_tab.h>
+
+#if defined(USE_JOLT_PHYSICS)
+
+// Additional world with ground box and pile of falling spheres and boxes, so snapshots include contacts and sleeping bodies
+struct PhysWorldStateFixture
+{
+  static constexpr int BODY_COUNT = 24;
+  static constexpr float DT = 1.f / 60.f; // fixed time step of world, no substep time is accumulated between steps
+
+  dacoll::CollisionWorld *world = nullptr;
+  PhysWorld *physWorld = nullptr;
+  PhysBoxCollision groundShape = PhysBoxCollision(100.f, 1.f, 100.f);
+  PhysSphereCollision sphereShape = PhysSphereCollision(0.5f);
+  PhysBoxCollision boxShape = PhysBoxCollision(0.8f, 0.4f, 1.2f);
+  Tab<PhysBody *> bodies;
+  int seed = 2345;
+
+  static const DataBlock *get_settings()
+  {
+    static DataBlock blk;
+    return &blk;
+  }
+
+  PhysWorldStateFixture()
+  {
+    dgs_get_settings = &get_settings;
+    threadpool::init(3, 256);
+    dacoll::init_collision_world();
+    world = dacoll::create_collision_world();
+    physWorld = dacoll::get_phys_world(world);
+    PhysBodyCreationData pbcd;
+    pbcd.autoMask = false;
+    pbcd.group = dacoll::EPL_DEFAULT;
+    pbcd.mask = dacoll::EPL_ALL;
+    TMatrix tm = TMatrix::IDENT;
+    tm.setcol(3, Point3(0.f, -0.5f, 0.f));
+    bodies.push_back(new PhysBody(physWorld, 0.f, &groundShape, tm, pbcd));
+    for (int i = 0; i < BODY_COUNT; ++i)
+    {
+      tm.makeTM(normalize(Point3(_srnd(seed), _srnd(seed), _srnd(seed)) + Point3(0.f, 0.f, 0.01f)), _srnd(seed) * PI);
+      tm.setcol(3, Point3(_srnd(seed) * 2.f, 1.f + i * 0.6f, _srnd(seed) * 2.f));
+      bodies.push_back(new PhysBody(physWorld, 1.f, (i & 1) ? (PhysCollision *)&sphereShape : &boxShape, tm, pbcd));
+    }
+  }
+
+  ~PhysWorldStateFixture()
+  {
+    for (PhysBody *body : bodies)
+      delete body;
+    dacoll::destroy_collision_world(world);
+    dacoll::term_collision_world();
+    threadpool::shutdown();
+  }
+
+  void simulate(int steps)
+  {
+    for (int i = 0; i < steps; ++i)
+      physWorld->simulate(DT);
+  }
+
+  Tab<TMatrix> getBodyTms() const
+  {
+    Tab<TMatrix> tms;
+    for (const PhysBody *body : bodies)
+      body->getTm(tms.push_back());
+    return tms;
+  }
+};
+
+TEST_FIXTURE(PhysWorldStateFixture, RestoredStateSimulatesTheSame)
+{
+  simulate(30); // bodies collide and stack up
+  PhysWorldSnapshot initial, first, second;
+  physWorld->saveState(initial);
+  CHECK(!initial.empty());
+  simulate(40);
+  physWorld->saveState(first);
+  const Tab<TMatrix> firstTms = getBodyTms();
+
+  CHECK(physWorld->restoreState(initial));
+  simulate(40);
+  physWorld->saveState(second);
+  CHECK_EQUAL(-1, first.findFirstDifference(second));
+  const Tab<TMatrix> secondTms = getBodyTms();
+  for (int i = 0; i < bodies.size(); ++i)
+    CHECK(memcmp(&firstTms[i], &secondTms[i], sizeof(TMatrix)) == 0);
+  CHECK(initial.findFirstDifference(first) >= 0);
+
+  CHECK(physWorld->checkDeterminism(DT, 20));
+}
+
+// Snapshot of world with other bodies is rejected before anything is restored
+TEST_FIXTURE(PhysWorldStateFixture, MismatchedSnapshotLeavesWorldUntouched)
+{
+  simulate(10);
+  PhysWorldSnapshot initial, before, after;
+  physWorld->saveState(initial);
+  simulate(20);
+
+  TMatrix tm = TMatrix::IDENT;
+  tm.setcol(3, Point3(10.f, 5.f, 10.f));
+  PhysBodyCreationData pbcd;
+  bodies.push_back(new PhysBody(physWorld, 1.f, &sphereShape, tm, pbcd));
+  physWorld->saveState(before);
+  CHECK(!physWorld->restoreState(initial));
+  physWorld->saveState(after);
+  CHECK_EQUAL(-1, before.findFirstDifference(after));
+
+  PhysWorldSnapshot empty;
+  CHECK(!physWorld->restoreState(empty));
+  physWorld->saveState(after);
+  CHECK_EQUAL(-1, before.findFirstDifference(after));
+
+  // snapshot of current layout is accepted
+  simulate(5);
+  CHECK(physWorld->restoreState(before));
+  physWorld->saveState(after);
+  CHECK_EQUAL(-1, before.findFirstDifference(after));
+}
+
+#endif
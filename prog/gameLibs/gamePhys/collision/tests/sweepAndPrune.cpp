@@ -0,0 +1,93 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <gamePhys/collision/sweepAndPrune.h>
+#include <math/random/dag_random.h>
+#include <EASTL/vector.h>
+#include <EASTL/sort.h>
+
+using gamephys::SweepAndPrune;
+
+struct Object
+{
+  double x = 0.0;
+  double radius = 0.0;
+  bool active = true;
+};
+
+static eastl::vector<uint64_t> brute_force_pairs(const eastl::vector<Object> &objects)
+{
+  eastl::vector<uint64_t> pairs;
+  for (int i = 0; i < objects.size(); ++i)
+    for (int j = i + 1; j < objects.size(); ++j)
+    {
+      const Object &a = objects[i], &b = objects[j];
+      if (a.active && b.active && a.x - a.radius <= b.x + b.radius && b.x - b.radius <= a.x + a.radius)
+        pairs.push_back((uint64_t(i) << 32) | uint64_t(j));
+    }
+  return pairs;
+}
+
+static eastl::vector<uint64_t> sap_pairs(SweepAndPrune &sap, const eastl::vector<Object> &objects)
+{
+  sap.update(objects.size(), [&objects](int i, double &min_x, double &max_x) {
+    min_x = objects[i].x - objects[i].radius;
+    max_x = objects[i].x + objects[i].radius;
+    return objects[i].active;
+  });
+  eastl::vector<uint64_t> pairs;
+  sap.forEachPair([&pairs](int a, int b) {
+    CHECK(a < b);
+    pairs.push_back((uint64_t(a) << 32) | uint64_t(b));
+  });
+  eastl::sort(pairs.begin(), pairs.end());
+  CHECK_EQUAL((int)pairs.size(), sap.getPairsCount());
+  return pairs;
+}
+
+TEST(SweepAndPruneMatchesBruteForce)
+{
+  int seed = 1234;
+  SweepAndPrune sap;
+  eastl::vector<Object> objects(200);
+  for (Object &o : objects)
+  {
+    o.x = _frnd(seed) * 500.0;
+    o.radius = 0.5 + _frnd(seed) * 5.0;
+  }
+  for (int step = 0; step < 300; ++step)
+  {
+    for (Object &o : objects)
+    {
+      o.x += _srnd(seed) * 2.0; // small motion, mostly incremental updates
+      if (_rnd(seed) % 100 == 0)
+        o.x = _frnd(seed) * 500.0; // teleport
+      if (_rnd(seed) % 50 == 0)
+        o.radius = _frnd(seed) * 8.0;
+    }
+    if (step % 37 == 0)
+      objects[_rnd(seed) % objects.size()].active ^= true;
+    if (step % 53 == 0)
+      objects.push_back(Object{_frnd(seed) * 500.0, 1.0, true});
+    if (step % 61 == 0)
+    {
+      objects.erase(objects.begin() + _rnd(seed) % objects.size());
+      sap.reset();
+    }
+    CHECK(sap_pairs(sap, objects) == brute_force_pairs(objects));
+  }
+}
+
+TEST(SweepAndPruneTouchingAndCoincident)
+{
+  SweepAndPrune sap;
+  eastl::vector<Object> objects = {{0.0, 1.0}, {2.0, 1.0}, {2.0, 1.0}, {10.0, 0.0}, {10.0, 0.0}};
+  CHECK(sap_pairs(sap, objects) == brute_force_pairs(objects));
+  CHECK_EQUAL(4, sap.getPairsCount()); // touching (0,1), (0,2), coincident (1,2) and zero sized (3,4)
+
+  objects[1].x = 2.0001; // moves apart from 0 only
+  objects[4].x = 9.0;
+  CHECK(sap_pairs(sap, objects) == brute_force_pairs(objects));
+  objects[1].x = 2.0;
+  objects[4].x = 10.0;
+  CHECK(sap_pairs(sap, objects) == brute_force_pairs(objects));
+  CHECK_EQUAL(4, sap.getPairsCount());
+}
@@ -98,7 +98,7 @@ bool dacoll::rayhit_normalized_ri(const Point3 &p, const Point3 &dir, real t, re
 }
 
 bool dacoll::rayhit_normalized(const Point3 &p, const Point3 &dir, real t, int flags, int ray_mat_id, const TraceMeshFaces *handle,
-  rendinst::riex_handle_t skip_riex_handle)
+  rendinst::riex_handle_t skip_riex_handle, CollisionWorld *world)
 {
 #if DAGOR_DBGLEVEL > 0 && TIME_PROFILER_ENABLED
   auto do_rayhit = [&]() {
@@ -121,6 +121,13 @@ bool dacoll::rayhit_normalized(const Point3 &p, const Point3 &dir, real t, int f
       if (rayhit_normalized_ri(p, dir, t, additionalTraceFlags, ray_mat_id, handle, skip_riex_handle))
         return true;
     }
+
+    if (flags & ETF_PHYS_WORLD)
+    {
+      Trace trace(p, dir, t, nullptr);
+      if (phys_world_traceray_batch(dag::Span<Trace>(&trace, 1), DEFAULT_SPHERE_CAST_MASK, world))
+        return true;
+    }
     return false;
 #if DAGOR_DBGLEVEL > 0 && TIME_PROFILER_ENABLED
   };
@@ -173,13 +180,13 @@ bool dacoll::traceray_normalized_ri(const Point3 &p, const Point3 &dir, real &t,
 }
 
 bool dacoll::traceray_normalized(const Point3 &p, const Point3 &dir, real &t, int *out_pmid, Point3 *out_norm, int flags,
-  rendinst::RendInstDesc *out_desc, int ray_mat_id, const TraceMeshFaces *handle)
+  rendinst::RendInstDesc *out_desc, int ray_mat_id, const TraceMeshFaces *handle, CollisionWorld *world)
 {
-  return dacoll::traceray_normalized_coll_type(p, dir, t, out_pmid, out_norm, flags, out_desc, nullptr, ray_mat_id, handle);
+  return dacoll::traceray_normalized_coll_type(p, dir, t, out_pmid, out_norm, flags, out_desc, nullptr, ray_mat_id, handle, world);
 }
 
 bool dacoll::traceray_normalized_coll_type(const Point3 &p, const Point3 &dir, real &t, int *out_pmid, Point3 *out_norm, int flags,
-  rendinst::RendInstDesc *out_desc, int *out_coll_type, int ray_mat_id, const TraceMeshFaces *handle)
+  rendinst::RendInstDesc *out_desc, int *out_coll_type, int ray_mat_id, const TraceMeshFaces *handle, CollisionWorld *world)
 {
   G_ASSERTF(!check_nan(p) && p.lengthSq() < 1e11f && !check_nan(dir) && !check_nan(t), "%@ %@ %f", p, dir, t);
 
@@ -215,6 +222,22 @@ bool dacoll::traceray_normalized_coll_type(const Point3 &p, const Point3 &dir, r
         *out_coll_type = ETF_RI;
       res |= trace_res;
     }
+    if (flags & ETF_PHYS_WORLD)
+    {
+      Trace trace(p, dir, t, nullptr);
+      bool trace_res = phys_world_traceray_batch(dag::Span<Trace>(&trace, 1), DEFAULT_SPHERE_CAST_MASK, world);
+      if (trace_res)
+      {
+        t = trace.pos.outT;
+        if (out_pmid)
+          *out_pmid = trace.outMatId;
+        if (out_norm)
+          *out_norm = trace.outNorm;
+        if (out_coll_type)
+          *out_coll_type = ETF_PHYS_WORLD;
+      }
+      res |= trace_res;
+    }
 #if DAGOR_DBGLEVEL > 0 && TIME_PROFILER_ENABLED
   };
   if (handle)
@@ -232,31 +255,101 @@ bool dacoll::traceray_normalized_coll_type(const Point3 &p, const Point3 &dir, r
 }
 
 bool dacoll::traceray_normalized_multiray(dag::Span<Trace> traces, dag::Span<rendinst::RendInstDesc> ri_desc, int flags,
-  int ray_mat_id, const TraceMeshFaces *handle)
+  int ray_mat_id, const TraceMeshFaces *handle, CollisionWorld *world)
 {
-  // TODO: add multiray where possible
-  G_ASSERT(traces.size() == ri_desc.size());
+  // same stages as in traceray_normalized_coll_type(), each one shortens traces for next ones. There are no multiray queries for
+  // frt and landmesh, rendinsts and physics world are queried once for all traces
+  G_ASSERT(ri_desc.empty() || traces.size() == ri_desc.size());
+  TIME_PROFILE_DEV(traceray_multiray);
   bool res = false;
-  int i = 0;
-  for (auto &trace : traces)
+  if (flags & (ETF_FRT | ETF_LMESH | ETF_HEIGHTMAP))
+    for (Trace &trace : traces)
+    {
+      G_ASSERTF(!check_nan(trace.pos) && trace.pos.lengthSq() < 1e11f && !check_nan(trace.dir) && !check_nan(trace.pos.outT),
+        "%@ %@ %f", trace.pos, trace.dir, trace.pos.outT);
+      if (flags & ETF_FRT)
+        res |= traceray_normalized_frt(trace.pos, trace.dir, trace.pos.outT, &trace.outMatId, &trace.outNorm);
+      if ((flags & (ETF_LMESH | ETF_HEIGHTMAP)) &&
+          traceray_normalized_lmesh(trace.pos, trace.dir, trace.pos.outT, &trace.outMatId, &trace.outNorm))
+      {
+        if (handle)
+          trace.outMatId = handle->matMapCache.getMatAt(Point2::xz(trace.pos));
+        res = true;
+      }
+    }
+  if (flags & ETF_RI)
   {
-    if (dacoll::traceray_normalized(trace.pos, trace.dir, trace.pos.outT, &trace.outMatId, &trace.outNorm, flags, &ri_desc[i],
-          ray_mat_id, handle))
-      res = true;
-    else if (flags & ETF_RI)
-      ri_desc[i].invalidate();
-    i++;
+    for (rendinst::RendInstDesc &desc : ri_desc)
+      desc.invalidate();
+    rendinst::TraceFlags traceFlags = rendinst::TraceFlag::Destructible | rendinst::TraceFlag::Meshes;
+    if ((flags & ETF_RI_TREES) != 0)
+      traceFlags |= rendinst::TraceFlag::Trees;
+    if ((flags & ETF_RI_PHYS) != 0)
+      traceFlags |= rendinst::TraceFlag::Phys;
+    const TraceMeshFaces *riHandle = handle;
+    if (riHandle)
+    {
+      bbox3f rayBox;
+      trace_utils::prepare_traces_box(traces, rayBox);
+      bool cacheRes = try_use_trace_cache(rayBox, riHandle);
+      trace_utils::draw_trace_handle_debug_cast_result(riHandle, traces, cacheRes, false);
+      if (!cacheRes)
+        riHandle = nullptr;
+    }
+    if (ri_desc.empty())
+      res |= rendinst::traceRayRIGenNormalized(traces, traceFlags, ray_mat_id, nullptr, riHandle);
+    else
+      res |= rendinst::traceRayRIGenNormalized(traces, ri_desc, traceFlags, ray_mat_id, riHandle);
   }
+  if (flags & ETF_PHYS_WORLD)
+    res |= phys_world_traceray_batch(traces, DEFAULT_SPHERE_CAST_MASK, world);
   return res;
 }
 
+static int vehicle_wheel_trace_flags = 0;
+
+void dacoll::set_vehicle_wheel_tracers(int flags)
+{
+  vehicle_wheel_trace_flags = flags;
+#if defined(USE_BULLET_PHYSICS)
+  IPhysVehicle::bulletSetStaticTracer(flags ? &vehicle_wheel_traceray : nullptr);
+  IPhysVehicle::bulletSetStaticMultiTracer(flags ? &vehicle_wheel_trace_multiray : nullptr);
+#endif
+}
+
+bool dacoll::vehicle_wheel_traceray(const Point3 &p, const Point3 &dir, float &t, Point3 &out_norm, int &out_pmid)
+{
+  out_pmid = -1;
+  return traceray_normalized(p, dir, t, &out_pmid, &out_norm, vehicle_wheel_trace_flags);
+}
+
+void dacoll::vehicle_wheel_trace_multiray(dag::Span<IPhysVehicle::WheelRay> rays)
+{
+  Tab<Trace> traces(framemem_ptr());
+  traces.reserve(rays.size());
+  for (const IPhysVehicle::WheelRay &ray : rays)
+    traces.push_back(Trace(ray.pos, ray.dir, ray.t, nullptr));
+  traceray_normalized_multiray(make_span(traces), {}, vehicle_wheel_trace_flags);
+  for (int i = 0; i < rays.size(); ++i)
+  {
+    IPhysVehicle::WheelRay &ray = rays[i];
+    ray.hit = traces[i].pos.outT < ray.t;
+    ray.pmid = ray.hit ? traces[i].outMatId : -1;
+    if (ray.hit)
+    {
+      ray.t = traces[i].pos.outT;
+      ray.norm = traces[i].outNorm;
+    }
+  }
+}
+
 bool dacoll::tracedown_normalized(const Point3 &p, real &t, int *out_pmid, Point3 *out_norm, int flags,
-  rendinst::RendInstDesc *out_desc, int ray_mat_id, const TraceMeshFaces *handle)
+  rendinst::RendInstDesc *out_desc, int ray_mat_id, const TraceMeshFaces *handle, CollisionWorld *world)
 {
   Trace trace(p, Point3(0.f, -1.f, 0.f), t, nullptr);
   rendinst::RendInstDesc desc;
   if (!tracedown_normalized_multiray(dag::Span<Trace>(&trace, 1), dag::Span<rendinst::RendInstDesc>(&desc, 1), flags, ray_mat_id,
-        handle))
+        handle, world))
     return false;
   t = trace.pos.outT;
   if (out_pmid)
@@ -269,14 +362,14 @@ bool dacoll::tracedown_normalized(const Point3 &p, real &t, int *out_pmid, Point
 }
 
 bool dacoll::tracedown_normalized_multiray(dag::Span<Trace> traces, dag::Span<rendinst::RendInstDesc> ri_desc, int flags,
-  int ray_mat_id, const TraceMeshFaces *handle)
+  int ray_mat_id, const TraceMeshFaces *handle, CollisionWorld *world)
 {
   unsigned trcnt = traces.size();
   if (!trcnt)
     return false;
 
   if (!handle)
-    return dacoll::traceray_normalized_multiray(traces, ri_desc, flags, ray_mat_id, handle);
+    return dacoll::traceray_normalized_multiray(traces, ri_desc, flags, ray_mat_id, handle, world);
 
   TIME_PROFILE_DEV(tracedown_handle);
 
@@ -300,7 +393,7 @@ bool dacoll::tracedown_normalized_multiray(dag::Span<Trace> traces, dag::Span<re
   bool traceRes = try_use_trace_cache(rayBox, handle);
   trace_utils::draw_trace_handle_debug_cast_result(handle, traces, traceRes, false);
   if (!traceRes)
-    return dacoll::traceray_normalized_multiray(traces, ri_desc, flags, ray_mat_id);
+    return dacoll::traceray_normalized_multiray(traces, ri_desc, flags, ray_mat_id, nullptr, world);
 
   bool rendinstsValid = rendinst::checkCachedRiData(handle);
 
@@ -346,7 +439,7 @@ bool dacoll::tracedown_normalized_multiray(dag::Span<Trace> traces, dag::Span<re
                       (rendinstsValid ? ~(ETF_RI | ETF_RI_TREES | ETF_RI_PHYS) : 0xffffffff) &
                       (handle->heightmap.width >= 0 ? ~ETF_HEIGHTMAP : 0xffffffff) &
                       (!handle->hasObjectGroups ? ~ETF_OBJECTS_GROUP : 0xffffffff);
-  res |= dacoll::traceray_normalized_multiray(traces, ri_desc, fallbackFlags, ray_mat_id, handle);
+  res |= dacoll::traceray_normalized_multiray(traces, ri_desc, fallbackFlags, ray_mat_id, handle, world);
 
   return res;
 }
@@ -534,23 +627,28 @@ bool dacoll::trace_sphere_cast_ex(const Point3 &from, const Point3 &to, float ra
   const float invNumCasts = safeinv(float(num_casts));
   float minT = t;
   float minNorm = res ? out.norm * dir : 1.f;
+  Tab<Trace> traces(framemem_ptr());
+  traces.reserve(num_casts);
   for (int i = 0; i < num_casts; ++i)
+    traces.push_back(
+      Trace(from + transform % Point3(0.f, cosf(TWOPI * invNumCasts * i), sinf(TWOPI * invNumCasts * i)) * rad, dir, t, nullptr));
+  dacoll::traceray_normalized_multiray(make_span(traces), {}, flags, cast_mat_id, handle);
+  for (const Trace &trace : traces)
   {
-    Point3 start = from + transform % Point3(0.f, cosf(TWOPI * invNumCasts * i), sinf(TWOPI * invNumCasts * i)) * rad;
-    float outT = t;
-    if (dacoll::traceray_normalized(start, dir, outT, &matId, &norm, flags, nullptr, cast_mat_id, handle))
+    const float outT = trace.pos.outT;
+    if (outT < t) // hit
     {
       if (outT < minT)
       {
         minT = outT;
-        out.res = start + dir * outT;
+        out.res = trace.pos + dir * outT;
         res = true;
       }
-      float normProj = norm * dir;
+      float normProj = trace.outNorm * dir;
       // check if this normal is better, or if we're out of reach of previous results
       if (normProj < minNorm || (t - outT > rad && outT - minT < rad))
       {
-        out.norm = norm;
+        out.norm = trace.outNorm;
         minNorm = normProj;
       }
     }
@@ -72,6 +72,28 @@ bool floating_volumes::update(const FloatingVolume &float_volume, float dt, cons
     waterDists, add_vel, add_omega);
 }
 
+bool floating_volumes::update(const FloatingVolume &float_volume, float at_time, float dt, const VolumeParams &params,
+  DPoint3 &add_vel, DPoint3 &add_omega, WaterHeightsCache *cache, const WaterHeightsReuse &reuse)
+{
+  if (!params.canTraceWorld || float_volume.floatingVolumes.empty())
+    return false;
+
+  G_ASSERT(float_volume.floatingVolumes.size() < MAX_VOLUMES);
+
+  const float waterTraceDist = 200.f;
+  TMatrix tm;
+  params.location.toTM(tm);
+  Point3 volumesWorldPos[MAX_VOLUMES];
+  float waterDists[MAX_VOLUMES];
+  get_water_heights(float_volume.floatingVolumes.data(), float_volume.floatingVolumes.size(), tm, at_time, waterTraceDist, 0.f,
+    volumesWorldPos, waterDists, cache, reuse);
+  for (int i = 0; i < float_volume.floatingVolumes.size(); ++i)
+    waterDists[i] = dacoll::is_valid_water_height(waterDists[i]) ? volumesWorldPos[i].y - waterDists[i] : FLT_MAX;
+
+  return update(float_volume.floatingVolumes.data(), float_volume.floatingVolumes.size(), float_volume.floatVolumesCd, dt, params,
+    waterDists, add_vel, add_omega);
+}
+
 bool floating_volumes::update(const BSphere3 *volumes, int volume_count, float viscosity_cf, float dt, const VolumeParams &params,
   const float *water_dists, DPoint3 &add_vel, DPoint3 &add_omega)
 {
@@ -122,6 +144,48 @@ bool floating_volumes::update(const BSphere3 *volumes, int volume_count, float v
   return totalVolume * waterDensity * params.invMass > 0.5;
 }
 
+void floating_volumes::get_water_heights(const BSphere3 *volumes, int volume_count, const TMatrix &tm, float at_time,
+  float trace_dist, float coast_dist_ofs, Point3 *out_world_pos, float *out_heights, WaterHeightsCache *cache,
+  const WaterHeightsReuse &reuse)
+{
+  G_ASSERT(volume_count <= MAX_VOLUMES);
+  if (cache && cache->count != volume_count)
+  {
+    for (int i = 0; i < volume_count; ++i)
+    {
+      cache->time[i] = -FLT_MAX;
+      cache->heightVel[i] = FLT_MAX;
+    }
+    cache->count = volume_count;
+  }
+  const float reuseDistSq = sqr(reuse.dist);
+  for (int i = 0; i < volume_count; ++i)
+  {
+    const Point3 pos = tm * volumes[i].c;
+    out_world_pos[i] = pos;
+    if (cache)
+    {
+      const float age = fabsf(at_time - cache->time[i]);
+      if (age < reuse.time && fabsf(cache->heightVel[i]) * age < reuse.maxHeightError &&
+          lengthSq(Point2::xz(pos) - Point2::xz(cache->pos[i])) < reuseDistSq)
+      {
+        out_heights[i] = cache->height[i];
+        continue;
+      }
+    }
+    bool underwater;
+    out_heights[i] = dacoll::traceht_water_at_time(pos, trace_dist, at_time, underwater, volumes[i].r + coast_dist_ofs);
+    if (cache)
+    {
+      const float dt = at_time - cache->time[i];
+      cache->heightVel[i] = cache->time[i] > -FLT_MAX && dt > 0.f ? (out_heights[i] - cache->height[i]) / dt : FLT_MAX;
+      cache->pos[i] = pos;
+      cache->height[i] = out_heights[i];
+      cache->time[i] = at_time;
+    }
+  }
+}
+
 bool floating_volumes::update_visual(const FloatingVolume &float_volume, float at_time, const gamephys::Loc &visualLocation,
   float full_mass, bool can_trace_world)
 {
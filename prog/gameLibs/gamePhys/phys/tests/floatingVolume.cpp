@@ -0,0 +1,145 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <gamePhys/phys/floatingVolume.h>
+#include <gamePhys/collision/collisionLib.h>
+#include <sceneRay/dag_sceneRayBuildable.h>
+#include <math/dag_TMatrix.h>
+
+using namespace gamephys;
+
+// Flat water traced with static scene tracers, one for each level (level is changed between ticks by switching tracer),
+// and hull of spheres half sunk into water at zero level
+struct FloatingVolumeFixture
+{
+  static constexpr float DT = 1.f / 30.f;
+  static constexpr float WATER_EXT = 1000.f;
+  static constexpr int LEVEL_COUNT = 3;
+  static constexpr float LEVELS[LEVEL_COUNT] = {0.f, 0.5f, 1.f};
+
+  BuildableStaticSceneRayTracer *waterTracers[LEVEL_COUNT];
+  floating_volumes::FloatingVolume hull;
+  floating_volumes::WaterHeightsReuse reuse;
+
+  FloatingVolumeFixture()
+  {
+    const unsigned faces[] = {0, 2, 1, 0, 3, 2};
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+    {
+      const Point3 verts[] = {Point3(-WATER_EXT, LEVELS[i], -WATER_EXT), Point3(WATER_EXT, LEVELS[i], -WATER_EXT),
+        Point3(WATER_EXT, LEVELS[i], WATER_EXT), Point3(-WATER_EXT, LEVELS[i], WATER_EXT)};
+      waterTracers[i] = create_buildable_staticmeshscene_raytracer(Point3(64.f, 64.f, 64.f), 5);
+      waterTracers[i]->addmesh(verts, countof(verts), faces, sizeof(unsigned) * 3, countof(faces) / 3, nullptr, true);
+    }
+    setWaterLevel(0);
+    for (int i = 0; i < 6; ++i)
+      hull.floatingVolumes.push_back(BSphere3(Point3(i * 1.5f - 4.f, 0.f, (i & 1) ? 1.f : -1.f), 1.f));
+    reuse.dist = 0.05f;
+    reuse.time = 0.1f;
+    reuse.maxHeightError = 0.01f;
+  }
+
+  ~FloatingVolumeFixture()
+  {
+    dacoll::set_water_tracer(nullptr);
+    for (BuildableStaticSceneRayTracer *tracer : waterTracers)
+      delete tracer;
+  }
+
+  void setWaterLevel(int level) { dacoll::set_water_tracer(waterTracers[level]); }
+
+  static floating_volumes::VolumeParams makeParams(const Point3 &pos)
+  {
+    floating_volumes::VolumeParams params;
+    params.canTraceWorld = true;
+    params.invMass = 1.0 / 3000.0;
+    params.invOrient = Quat(0.f, 0.f, 0.f, 1.f);
+    params.invMomOfInertia = DPoint3(1.0, 1.0, 1.0) / 10000.0;
+    params.velocity = DPoint3(1.0, 0.0, 0.5);
+    params.omega = DPoint3(0.0, 0.1, 0.0);
+    params.gravityCenter = ZERO<Point3>();
+    params.location.P = dpoint3(pos);
+    params.location.O.setQuat(Quat(0.f, 0.f, 0.f, 1.f));
+    return params;
+  }
+
+  // height traced (or reused) under first volume of hull moved by ofs
+  float firstVolumeHeight(float at_time, const Point3 &ofs, floating_volumes::WaterHeightsCache *cache)
+  {
+    TMatrix tm = TMatrix::IDENT;
+    tm.setcol(3, ofs);
+    Point3 worldPos[floating_volumes::MAX_VOLUMES];
+    float heights[floating_volumes::MAX_VOLUMES];
+    floating_volumes::get_water_heights(hull.floatingVolumes.data(), hull.floatingVolumes.size(), tm, at_time, 200.f, 0.f, worldPos,
+      heights, cache, reuse);
+    return heights[0];
+  }
+};
+
+// Ship update with water traced under each volume gives the same impulses as update with plane of flat water
+TEST_FIXTURE(FloatingVolumeFixture, ShipTracedWaterMatchesWaterPlane)
+{
+  for (float y : {-0.5f, 0.3f, 0.9f})
+  {
+    floating_volumes::VolumeParams params = makeParams(Point3(10.f, y, 20.f));
+    params.waterPlane = Plane3(Point3(0.f, 1.f, 0.f), Point3(0.f, LEVELS[0], 0.f));
+    DPoint3 planeVel(0, 0, 0), planeOmega(0, 0, 0), tracedVel(0, 0, 0), tracedOmega(0, 0, 0);
+    const bool planeFloats = floating_volumes::update(hull, DT, params, planeVel, planeOmega);
+    const bool tracedFloats = floating_volumes::update(hull, 0.f, DT, params, tracedVel, tracedOmega, nullptr);
+    CHECK_EQUAL(planeFloats, tracedFloats);
+    CHECK(planeVel.y > 0.0);
+    CHECK_CLOSE(0.0, length(planeVel - tracedVel), 1e-6);
+    CHECK_CLOSE(0.0, length(planeOmega - tracedOmega), 1e-6);
+  }
+}
+
+// Cache is allocated only while reuse is enabled, copy of its holder starts with empty cache
+TEST_FIXTURE(FloatingVolumeFixture, CacheAllocatedOnlyForReuse)
+{
+  floating_volumes::WaterHeightsCacheHolder holder;
+  CHECK(!holder.prepare({}) && !holder.get());
+  floating_volumes::WaterHeightsCache *cache = holder.prepare(reuse);
+  CHECK(cache && holder.get() == cache && holder.prepare(reuse) == cache);
+  floating_volumes::WaterHeightsCacheHolder copy(holder);
+  CHECK(!copy.get() && holder.get() == cache);
+  floating_volumes::WaterHeightsReuse noMaxError = reuse;
+  noMaxError.maxHeightError = 0.f;
+  CHECK(!holder.prepare(noMaxError) && !holder.get());
+}
+
+// Height is reused only for small motion, while it is young and while water under volume changed slowly
+TEST_FIXTURE(FloatingVolumeFixture, HeightsReusedOnlyWhileAllowed)
+{
+  floating_volumes::WaterHeightsCacheHolder holder;
+  floating_volumes::WaterHeightsCache *cache = holder.prepare(reuse);
+  const Point3 smallMove(0.01f, 0.f, 0.f), bigMove(0.2f, 0.f, 0.f);
+  CHECK_EQUAL(LEVELS[0], firstVolumeHeight(0.f, ZERO<Point3>(), cache));
+  CHECK_EQUAL(LEVELS[0], firstVolumeHeight(DT, ZERO<Point3>(), cache)); // change rate is unknown after first trace
+  setWaterLevel(1);
+  CHECK_EQUAL(LEVELS[0], firstVolumeHeight(2 * DT, smallMove, cache));
+  CHECK_EQUAL(LEVELS[1], firstVolumeHeight(2 * DT, bigMove, cache));
+  setWaterLevel(2);
+  CHECK_EQUAL(LEVELS[2], firstVolumeHeight(3 * DT, bigMove, cache)); // fast wave
+  CHECK_EQUAL(LEVELS[2], firstVolumeHeight(4 * DT, bigMove, cache));
+  setWaterLevel(0);
+  CHECK_EQUAL(LEVELS[2], firstVolumeHeight(5 * DT, bigMove, cache));
+  CHECK_EQUAL(LEVELS[0], firstVolumeHeight(5 * DT, bigMove, nullptr));
+  CHECK_EQUAL(LEVELS[0], firstVolumeHeight(4 * DT + reuse.time * 1.5f, bigMove, cache)); // too old
+}
+
+// Ship update with cache uses heights of previous ticks while hull is almost still
+TEST_FIXTURE(FloatingVolumeFixture, ShipReusesCachedHeights)
+{
+  floating_volumes::WaterHeightsCacheHolder holder;
+  const floating_volumes::VolumeParams params = makeParams(Point3(10.f, 0.3f, 20.f));
+  DPoint3 vel[3], omega[3];
+  for (int tick = 0; tick < 3; ++tick)
+  {
+    setWaterLevel(tick < 2 ? 0 : 1);
+    vel[tick] = omega[tick] = DPoint3(0, 0, 0);
+    floating_volumes::update(hull, tick * DT, DT, params, vel[tick], omega[tick], holder.prepare(reuse), reuse);
+  }
+  CHECK(vel[0] == vel[2] && omega[0] == omega[2]);
+
+  DPoint3 tracedVel(0, 0, 0), tracedOmega(0, 0, 0);
+  floating_volumes::update(hull, 2 * DT, DT, params, tracedVel, tracedOmega, nullptr);
+  CHECK(tracedVel.y > vel[2].y); // hull is deeper in raised water
+}
@@ -54,6 +54,7 @@ void HeightmapHeightCulling::updateMinMaxHeights(HeightmapHandler *handler, cons
 
   absMin = minMaxHeights[lodOffsets[HEIGHT_CULLING_LOD_COUNT - 1]].x;
   absMax = -minMaxHeights[lodOffsets[HEIGHT_CULLING_LOD_COUNT - 1]].y;
+  ++generation;
 }
 
 bool HeightmapHeightCulling::init(HeightmapHandler *handler)
@@ -350,6 +350,10 @@ void HeightmapHandler::close()
   renderData.reset();
   renderer.close();
   heightmapHeightCulling.reset();
+  for (LodGridCullCandidates &candidates : cullCandidates)
+    candidates.clear();
+  for (CachedCullView &view : cullViewsCache)
+    view.data.eraseAll();
   HeightmapPhysHandler::close();
 }
 
@@ -492,9 +496,46 @@ void HeightmapHandler::frustumCulling(LodGridCullData &cull_data, const Point3 &
     // float align = (1<<(lodGrid.lodsCount-1))*hmapCellSize;
     float lod0AreaSize = 0.f;
     Point3 clippedOrigin = getClippedOrigin(world_pos);
-    cull_lod_grid(cull_data.lodGrid, cull_data.lodGrid.lodsCount - min_tank_lod, clippedOrigin.x, clippedOrigin.z, scale, scale, align,
-      align, worldBox[0].y, worldBox[1].y, &frustum, &worldBox2, cull_data, occlusion, lod0AreaSize, renderer.getDim(), true,
-      heightmapHeightCulling.get(), hmtd, nullptr, preparedWaterLevel, &world_pos);
+    if (occlusion)
+    {
+      cull_lod_grid(cull_data.lodGrid, cull_data.lodGrid.lodsCount - min_tank_lod, clippedOrigin.x, clippedOrigin.z, scale, scale,
+        align, align, worldBox[0].y, worldBox[1].y, &frustum, &worldBox2, cull_data, occlusion, lod0AreaSize, renderer.getDim(),
+        true, heightmapHeightCulling.get(), hmtd, nullptr, preparedWaterLevel, &world_pos);
+      return;
+    }
+
+    WinAutoLock lock(cullCacheCs);
+    LodGridCullCandidates &candidates = cullCandidates[cull_data.useHWTesselation ? 1 : 0];
+    build_lod_grid_cull_candidates(cull_data.lodGrid, cull_data.lodGrid.lodsCount - min_tank_lod, clippedOrigin.x, clippedOrigin.z,
+      scale, align, align, worldBox[0].y, worldBox[1].y, &worldBox2, candidates, renderer.getDim(), heightmapHeightCulling.get(),
+      cull_data.useHWTesselation);
+    CachedCullView *view = nullptr;
+    for (CachedCullView &cached : cullViewsCache)
+      if (cached.data.reuseDist == cullReuseDist &&
+          is_lod_grid_cull_reusable(candidates, frustum, cached.data, hmtd, preparedWaterLevel, &world_pos))
+      {
+        view = &cached;
+        break;
+      }
+    if (!view) // least recently used one
+    {
+      view = &cullViewsCache[0];
+      for (CachedCullView &cached : cullViewsCache)
+        if (cached.lastUsed < view->lastUsed)
+          view = &cached;
+      view->data.reuseDist = cullReuseDist;
+      cull_lod_grid_candidates(candidates, frustum, view->data, nullptr, hmtd, preparedWaterLevel, &world_pos);
+    }
+    view->lastUsed = ++cullViewsCounter;
+
+    const LodGridCullData &culled = view->data;
+    cull_data.patches = culled.patches;
+    cull_data.startFlipped = culled.startFlipped;
+    cull_data.originPos = culled.originPos;
+    cull_data.scaleX = culled.scaleX;
+    cull_data.lod0PatchesCount = culled.lod0PatchesCount;
+    cull_data.lodGrid = culled.lodGrid;
+    cull_data.worldToLod0 = culled.worldToLod0;
 #if DAGOR_DBGLEVEL > 0 && TIME_PROFILER_ENABLED
   };
   if (!hmtd)
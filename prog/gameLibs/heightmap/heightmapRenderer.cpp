@@ -62,11 +62,13 @@ static inline int generate_patch_indices_quads(int dim, It &&indices, int startI
 }
 static int hmap_tess_factorVarId = -1;
 
-bool get_hw_tesselation_usage(const LodGridCullData &cull_data)
+static bool get_hw_tesselation_usage(bool use_hw_tesselation_requested)
 {
-  return (hmap_tess_factorVarId != -1) && cull_data.useHWTesselation && use_hw_tesselation.get();
+  return (hmap_tess_factorVarId != -1) && use_hw_tesselation_requested && use_hw_tesselation.get();
 }
 
+bool get_hw_tesselation_usage(const LodGridCullData &cull_data) { return get_hw_tesselation_usage(cull_data.useHWTesselation); }
+
 static int get_tessellation_var_id()
 {
   if (d3d::get_driver_desc().caps.hasQuadTessellation)
@@ -366,20 +368,8 @@ static inline bool cull_node_by_clip(const Point3_vec4 &pos, const Point3_vec4 &
   return true;
 }
 
-static inline bool cull_node(const Point3_vec4 &pos, const Point3_vec4 &posRB, const GridCullingContext &ctx, float waterLevel,
-  const Point3 *viewPos)
+static inline bool cull_node_by_water(const Point3_vec4 &pos, const Point3_vec4 &posRB, float waterLevel, const Point3 *viewPos)
 {
-  if (ctx.frustum)
-  {
-    vec4f bmin = v_ld(&pos.x), bmax = v_ld(&posRB.x);
-    vec4f center2 = v_add(bmax, bmin);
-    vec4f extent2 = v_sub(bmax, bmin);
-    if (!ctx.frustum->testBoxExtentB(center2, extent2))
-      return false;
-    if (ctx.use_occlusion && ctx.use_occlusion->isOccludedBoxExtent2(center2, extent2))
-      return false;
-  }
-
   bool isWaterOnLevel = waterLevel > HeightmapHeightCulling::NO_WATER_ON_LEVEL;
   if (isWaterOnLevel && viewPos)
   {
@@ -414,6 +404,23 @@ static inline bool cull_node(const Point3_vec4 &pos, const Point3_vec4 &posRB, c
   return true;
 }
 
+static inline bool cull_node(const Point3_vec4 &pos, const Point3_vec4 &posRB, const GridCullingContext &ctx, float waterLevel,
+  const Point3 *viewPos)
+{
+  if (ctx.frustum)
+  {
+    vec4f bmin = v_ld(&pos.x), bmax = v_ld(&posRB.x);
+    vec4f center2 = v_add(bmax, bmin);
+    vec4f extent2 = v_sub(bmax, bmin);
+    if (!ctx.frustum->testBoxExtentB(center2, extent2))
+      return false;
+    if (ctx.use_occlusion && ctx.use_occlusion->isOccludedBoxExtent2(center2, extent2))
+      return false;
+  }
+
+  return cull_node_by_water(pos, posRB, waterLevel, viewPos);
+}
+
 static inline float bit_pack_ipoint2_to_float(const IPoint2 &pos)
 {
   uint32_t packed_pos = (pos.x << 16) | (pos.y & 0xFFFF);
@@ -441,6 +448,135 @@ static inline float float_pack_edges_tess(int edgeTessOut[4])
   return float(packed_edge_tess);
 }
 
+struct IPoint2Hasher
+{
+  typedef ska::power_of_two_hash_policy hash_policy;
+  auto operator()(const IPoint2 &p) const { return wyhash64(p.x, p.y); }
+};
+// Using integer coordinates to resolve edge tesselation. 1 unit is equal to LOD 0's gridSize.
+// Because LOD 0 can use subdivision (for software tesselation), for LOD > 0 coordinates should shift left by `lod0SubDiv`.
+typedef ska::flat_hash_map<IPoint2, int, IPoint2Hasher, eastl::equal_to<IPoint2>, framemem_allocator> PosLodMap;
+
+// adds visible node of lod > 0, splitting it to subpatches where tesselation is requested
+static void add_lod_patch(LodGridCullData &cull_data, PosLodMap &posLOD_map, const HMapTesselationData *hmap_tdata, const IPoint2 &xy,
+  int lod, int lod0SubDiv, float gridSize, float patchSize, const Point2 &origin, float scaleX)
+{
+  const int x = xy.x, y = xy.y;
+  if (BBox2 cellRoot(origin, origin + Point2(patchSize, patchSize));
+      SUBPATCHES_DEPTH > 0 && hmap_tdata && hmap_tdata->testRegionTesselated(cellRoot))
+  {
+    struct SubpatchQuad
+    {
+      BBox2 cell;
+      IPoint2 pos;
+      int depth;
+    };
+
+    // tessCellSize is equal of bigger than LOD 0 gridSize (without subdivision).
+    float tessCellSize = max(scaleX, hmap_tdata->getTessCellSize());
+    Tab<SubpatchQuad> subpatchesStack(framemem_ptr());
+    subpatchesStack.push_back({cellRoot, IPoint2(x, y) << (lod + lod0SubDiv), 1});
+    do
+    {
+      SubpatchQuad subpatch = subpatchesStack.back();
+      subpatchesStack.pop_back();
+
+      int patchLOD = lod - subpatch.depth;
+      int patchStep = 1 << (patchLOD + lod0SubDiv);
+      IPoint2 patchPos = subpatch.pos;
+      Point2 widthStep = subpatch.cell.width() * 0.5f;
+      BBox2 newCell(subpatch.cell.lim[0], subpatch.cell.lim[0]);
+      for (int j = 0; j < 2; ++j, newCell[0].y += widthStep.y, patchPos.y += patchStep)
+      {
+        patchPos.x = subpatch.pos.x;
+        newCell[0].x = subpatch.cell.lim[0].x;
+        for (int i = 0; i < 2; ++i, newCell[0].x += widthStep.x, patchPos.x += patchStep)
+        {
+          newCell[1] = newCell[0] + widthStep;
+          float newGridSize = gridSize * widthStep.x / cellRoot.width().x;
+          if (subpatch.depth < SUBPATCHES_DEPTH && newGridSize > tessCellSize && hmap_tdata->testRegionTesselated(newCell))
+          {
+            subpatchesStack.push_back({newCell, patchPos, subpatch.depth + 1});
+          }
+          else
+          {
+            cull_data.patches.push_back(
+              Point4(newGridSize, bit_pack_ipoint2_to_float(patchPos >> (patchLOD + lod0SubDiv)), newCell[0].x, newCell[0].y));
+            posLOD_map[patchPos] = patchLOD;
+          }
+        }
+      }
+    } while (subpatchesStack.size());
+  }
+  else
+  {
+    int patchStep = 1 << (lod + lod0SubDiv);
+    IPoint2 patchPos = IPoint2(x, y) << (lod + lod0SubDiv);
+    cull_data.patches.push_back(Point4(gridSize, bit_pack_ipoint2_to_float(IPoint2(x, y)), origin.x, origin.y));
+    posLOD_map[patchPos] = lod;
+  }
+}
+
+static void calc_edge_tesselation(LodGridCullData &cull_data, const PosLodMap &posLOD_map, const LodGrid &lodGrid, int numLods,
+  int lod0SubDiv, float scaleX)
+{
+  // Get heightmap area (without edges stretch), `area_bbox`
+  int lastLod = numLods - 1;
+  int lastLodSubdiv = lastLod == 0 ? lod0SubDiv : 0;
+  int lastLodRad = (lodGrid.lastLodRad << 1) << lastLodSubdiv;
+  int lastPatchLod = lastLod - lastLodSubdiv;
+  IBBox2 area_bbox(IPoint2(-lastLodRad, -lastLodRad) << (lastPatchLod + lod0SubDiv),
+    (IPoint2(lastLodRad, lastLodRad) << (lastPatchLod + lod0SubDiv)) - IPoint2::ONE);
+
+  // For each patch find edge tesselation transitioning.
+  TIME_PROFILE(edge_tessellation_search)
+  // For each patch we want to retrieve it's effective LOD, `patchLOD`. Where, `patchLOD = log2f(gridSize / scaleX)`.
+  float subDivFactor = float(1 << lod0SubDiv); // - Multiply by 2^lod0SubDiv, to avoid negative log2 results (from LOD 0 subdivision).
+  float scaleXFactor = subDivFactor / scaleX;  // - Turn float division into float multiplication.
+  for (auto &patch : cull_data.patches)
+  {
+    float gridSize = patch.x;
+    int patchLOD = get_log2i_of_pow2(round(gridSize * scaleXFactor)) - lod0SubDiv; // - Use `get_log2i_of_pow2` instead of `log2f`.
+                                                                                   // Then, remove `lod0SubDiv` bias which was added
+                                                                                   // above.
+    int patchStep = 1 << (patchLOD + lod0SubDiv);
+    IPoint2 patchPos = bit_unpack_float_to_ipoint2(patch.y) << (patchLOD + lod0SubDiv);
+
+    auto getNeighbourLOD = [&](IPoint2 pos, int baseLOD, int maxLOD) -> int {
+      for (int lod = baseLOD; lod <= maxLOD; ++lod)
+      {
+        // If we cannot find a subpatch, we can get ancestors position by masking least significant bits.
+        uint32_t mask = mask_0_LSb(lod + lod0SubDiv);
+        IPoint2 posRounded = IPoint2(pos.x & mask, pos.y & mask);
+        if (auto search = posLOD_map.find(posRounded); search != posLOD_map.end())
+          return search->second >= lod ? min(search->second, maxLOD) : -1;
+      }
+      return -1;
+    };
+
+    int edgeTessOut[4] = {0 /*left*/, 0 /*right*/, 0 /*top*/, 0 /*bottom*/};
+    for (int i = 0; i != 4; ++i)
+    {
+      IPoint2 ofs = i / 2 == 0 ? IPoint2(patchStep, 0) : IPoint2(0, patchStep);
+      ofs *= i % 2 == 0 ? -1 : 1;
+
+      IPoint2 nextPatchPos = patchPos + ofs;
+      if (area_bbox & nextPatchPos)
+      {
+        int neightbourLOD = getNeighbourLOD(nextPatchPos, patchLOD, patchLOD + 4);
+        if (neightbourLOD != -1)
+          edgeTessOut[i] = edge_tess_encode(neightbourLOD - patchLOD);
+      }
+      else
+      {
+        edgeTessOut[i] = edge_tess_encode(1 + lastLodSubdiv); // for last LOD edges stretch
+      }
+    }
+
+    patch.y = float_pack_edges_tess(edgeTessOut);
+  }
+}
+
 void cull_lod_grid(const LodGrid &lodGrid, int maxLod, float originPosX, float originPosY, float scaleX, float scaleY, float alignX,
   float alignY, float hMin, float hMax, const Frustum *frustum, const BBox2 *clip, LodGridCullData &cull_data,
   const Occlusion *use_occlusion, float &out_lod0_area_radius, int dim, bool fight_t_junctions,
@@ -514,14 +650,7 @@ void cull_lod_grid(const LodGrid &lodGrid, int maxLod, float originPosX, float o
     v_sti(&area, regionI);
   }
 
-  struct IPoint2Hasher
-  {
-    typedef ska::power_of_two_hash_policy hash_policy;
-    auto operator()(const IPoint2 &p) const { return wyhash64(p.x, p.y); }
-  };
-  // Using integer coordinates to resolve edge tesselation. 1 unit is equal to LOD 0's gridSize.
-  // Because LOD 0 can use subdivision (for software tesselation), for LOD > 0 coordinates should shift left by `lod0SubDiv`.
-  ska::flat_hash_map<IPoint2, int, IPoint2Hasher, eastl::equal_to<IPoint2>, framemem_allocator> posLOD_map;
+  PosLodMap posLOD_map;
   for (int nodeLodSize = 1, lod = 0; lod < numLods; ++lod, nodeLodSize <<= 1)
   {
     if (lod == flipLod)
@@ -661,59 +790,7 @@ void cull_lod_grid(const LodGrid &lodGrid, int maxLod, float originPosX, float o
           if (!cull_node(pos, posRB, ctx, waterLevel, viewPos))
             continue;
 
-          if (BBox2 cellRoot(origin, origin + Point2(patchSize, patchSize));
-              SUBPATCHES_DEPTH > 0 && hmap_tdata && hmap_tdata->testRegionTesselated(cellRoot))
-          {
-            struct SubpatchQuad
-            {
-              BBox2 cell;
-              IPoint2 pos;
-              int depth;
-            };
-
-            // tessCellSize is equal of bigger than LOD 0 gridSize (without subdivision).
-            float tessCellSize = max(scaleX, hmap_tdata->getTessCellSize());
-            Tab<SubpatchQuad> subpatchesStack(framemem_ptr());
-            subpatchesStack.push_back({cellRoot, IPoint2(x, y) << (lod + lod0SubDiv), 1});
-            do
-            {
-              SubpatchQuad subpatch = subpatchesStack.back();
-              subpatchesStack.pop_back();
-
-              int patchLOD = lod - subpatch.depth;
-              int patchStep = 1 << (patchLOD + lod0SubDiv);
-              IPoint2 patchPos = subpatch.pos;
-              Point2 widthStep = subpatch.cell.width() * 0.5f;
-              BBox2 newCell(subpatch.cell.lim[0], subpatch.cell.lim[0]);
-              for (int j = 0; j < 2; ++j, newCell[0].y += widthStep.y, patchPos.y += patchStep)
-              {
-                patchPos.x = subpatch.pos.x;
-                newCell[0].x = subpatch.cell.lim[0].x;
-                for (int i = 0; i < 2; ++i, newCell[0].x += widthStep.x, patchPos.x += patchStep)
-                {
-                  newCell[1] = newCell[0] + widthStep;
-                  float newGridSize = gridSize * widthStep.x / cellRoot.width().x;
-                  if (subpatch.depth < SUBPATCHES_DEPTH && newGridSize > tessCellSize && hmap_tdata->testRegionTesselated(newCell))
-                  {
-                    subpatchesStack.push_back({newCell, patchPos, subpatch.depth + 1});
-                  }
-                  else
-                  {
-                    cull_data.patches.push_back(
-                      Point4(newGridSize, bit_pack_ipoint2_to_float(patchPos >> (patchLOD + lod0SubDiv)), newCell[0].x, newCell[0].y));
-                    posLOD_map[patchPos] = patchLOD;
-                  }
-                }
-              }
-            } while (subpatchesStack.size());
-          }
-          else
-          {
-            int patchStep = 1 << (lod + lod0SubDiv);
-            IPoint2 patchPos = IPoint2(x, y) << (lod + lod0SubDiv);
-            cull_data.patches.push_back(Point4(gridSize, bit_pack_ipoint2_to_float(IPoint2(x, y)), origin.x, origin.y));
-            posLOD_map[patchPos] = lod;
-          }
+          add_lod_patch(cull_data, posLOD_map, hmap_tdata, IPoint2(x, y), lod, lod0SubDiv, gridSize, patchSize, origin, scaleX);
         }
       }
     }
@@ -726,59 +803,345 @@ void cull_lod_grid(const LodGrid &lodGrid, int maxLod, float originPosX, float o
     area.nextLod();
   }
 
-  // Get heightmap area (without edges stretch), `area_bbox`
-  int lastLod = numLods - 1;
-  int lastLodSubdiv = lastLod == 0 ? lod0SubDiv : 0;
-  int lastLodRad = (lodGrid.lastLodRad << 1) << lastLodSubdiv;
-  int lastPatchLod = lastLod - lastLodSubdiv;
-  IBBox2 area_bbox(IPoint2(-lastLodRad, -lastLodRad) << (lastPatchLod + lod0SubDiv),
-    (IPoint2(lastLodRad, lastLodRad) << (lastPatchLod + lod0SubDiv)) - IPoint2::ONE);
+  calc_edge_tesselation(cull_data, posLOD_map, lodGrid, numLods, lod0SubDiv, scaleX);
+}
 
-  // For each patch find edge tesselation transitioning.
-  TIME_PROFILE(edge_tessellation_search)
-  // For each patch we want to retrieve it's effective LOD, `patchLOD`. Where, `patchLOD = log2f(gridSize / scaleX)`.
-  float subDivFactor = float(1 << lod0SubDiv); // - Multiply by 2^lod0SubDiv, to avoid negative log2 results (from LOD 0 subdivision).
-  float scaleXFactor = subDivFactor / scaleX;  // - Turn float division into float multiplication.
-  for (auto &patch : cull_data.patches)
+static void add_candidates_cluster(LodGridCullCandidates &candidates, uint32_t first)
+{
+  const uint32_t count = candidates.nodes.size() - first;
+  if (!count)
+    return;
+  bbox3f box = candidates.nodes[first].box;
+  for (uint32_t i = first + 1, e = candidates.nodes.size(); i < e; ++i)
+    v_bbox3_add_box(box, candidates.nodes[i].box);
+  LodGridCullCandidates::Cluster &cluster = candidates.clusters.push_back();
+  cluster.box = box;
+  cluster.first = first;
+  cluster.count = count;
+}
+
+bool build_lod_grid_cull_candidates(const LodGrid &lodGrid, int maxLod, float originPosX, float originPosY, float scaleX, float alignX,
+  float alignY, float hMin, float hMax, const BBox2 *clip, LodGridCullCandidates &candidates, int dim,
+  const HeightmapHeightCulling *heightCulling, bool hw_tesselation)
+{
+  if (alignX < 0)
+    alignX = dim * scaleX;
+  if (alignY < 0)
+    alignY = dim * scaleX;
+
+  const int lod0SubDiv = !get_hw_tesselation_usage(hw_tesselation) ? lodGrid.lod0SubDiv : 0;
+
+  LodGridCullCandidates::Key key;
+  key.originScaleAlign = Point4(floorf(originPosX / alignX + 0.5f), floorf(originPosY / alignY + 0.5f), scaleX, alignX);
+  key.heights = Point2(hMin, hMax);
+  if (clip)
+    key.clip = *clip;
+  key.maxLod = maxLod;
+  key.dim = dim;
+  key.lod0SubDiv = lod0SubDiv;
+  key.heightsGeneration = heightCulling ? heightCulling->getGeneration() : 0;
+  key.lodsCount = lodGrid.lodsCount;
+  key.lodStep = lodGrid.lodStep;
+  key.lastLodRad = lodGrid.lastLodRad;
+  key.lastLodExtension = lodGrid.lastLodExtension;
+  key.alignY = alignY;
+  key.useHWTesselation = hw_tesselation;
+  if (candidates.generation && candidates.key == key)
+    return false;
+
+  TIME_PROFILE(hmap_build_cull_candidates);
+  const int patchesX = key.originScaleAlign.x, patchesY = key.originScaleAlign.y;
+  candidates.key = key;
+  candidates.nodes.clear();
+  candidates.clusters.clear();
+  candidates.lodGrid = lodGrid;
+  candidates.originPos = Point2(patchesX * alignX, patchesY * alignY);
+  candidates.scaleX = scaleX;
+  candidates.dim = dim;
+  candidates.numLods = min<int>(lodGrid.lodsCount, maxLod);
+  candidates.lod0SubDiv = lod0SubDiv;
+  candidates.useHWTesselation = hw_tesselation;
+  candidates.flipLod = ((patchesX + patchesY) & 1) ? get_log2w(dim) : 100000;
+  candidates.lod0AreaRadius = 0.f;
+  candidates.worldToLod0 = Point4::ZERO;
+  if (++candidates.generation == 0)
+    candidates.generation = 1;
+
+  // unlike cull_lod_grid() area is limited by clip box only, frustum is applied per view
+  alignas(16) struct Area
   {
-    float gridSize = patch.x;
-    int patchLOD = get_log2i_of_pow2(round(gridSize * scaleXFactor)) - lod0SubDiv; // - Use `get_log2i_of_pow2` instead of `log2f`.
-                                                                                   // Then, remove `lod0SubDiv` bias which was added
-                                                                                   // above.
-    int patchStep = 1 << (patchLOD + lod0SubDiv);
-    IPoint2 patchPos = bit_unpack_float_to_ipoint2(patch.y) << (patchLOD + lod0SubDiv);
+    int minX = -1000000, minY = -1000000, maxX = 1000000, maxY = 1000000;
+    void nextLod()
+    {
+      minX >>= 1;
+      minY >>= 1;
+      maxX = maxX >> 1;
+      maxY = maxY >> 1;
+    }
+  } area;
+  if (clip)
+  {
+    const float patchSize0 = scaleX * dim;
+    vec4f startCull = v_make_vec4f(candidates.originPos.x, candidates.originPos.y, 0, 0);
+    vec4f regionV = v_div(v_sub(v_ldu(&clip->lim[0].x), v_perm_xyxy(startCull)), v_splats(patchSize0));
+    v_sti(&area, v_cvt_floori(regionV));
+  }
 
-    auto getNeighbourLOD = [&](IPoint2 pos, int baseLOD, int maxLOD) -> int {
-      for (int lod = baseLOD; lod <= maxLOD; ++lod)
+  const int numLods = candidates.numLods;
+  const int lastLod = numLods - 1;
+  const float ext = lodGrid.lastLodExtension;
+  int lod = 0;
+  for (int nodeLodSize = 1; lod < numLods; ++lod, nodeLodSize <<= 1)
+  {
+    candidates.lodClusters[lod] = candidates.clusters.size();
+    int lodRad = lod == lastLod ? lodGrid.lastLodRad : lodGrid.lodStep;
+    int subdiv = lod == 0 ? lod0SubDiv : 0;
+    float gridSize = nodeLodSize * scaleX / (1 << subdiv);
+    float patchSize = gridSize * dim;
+    int rad1 = (lodRad << 1) << subdiv;
+    int prevRad1 = lod == 0 ? -1000000 : (lodGrid.lodStep);
+    int prevRad2 = prevRad1 - 1;
+    float lodArea = patchSize * rad1;
+
+    auto addNode = [&](int x, int y, float node_hmin, float node_hmax, bool ext_left, bool ext_top, bool ext_right, bool ext_bottom) {
+      Point2 origin = candidates.originPos + Point2(x, y) * patchSize;
+      Point3_vec4 pos(origin.x, node_hmin, origin.y);
+      Point3_vec4 posRB(pos.x + patchSize, node_hmax, pos.z + patchSize);
+      if (lod == lastLod) // water stretches last LOD edges to fill far water
       {
-        // If we cannot find a subpatch, we can get ancestors position by masking least significant bits.
-        uint32_t mask = mask_0_LSb(lod + lod0SubDiv);
-        IPoint2 posRounded = IPoint2(pos.x & mask, pos.y & mask);
-        if (auto search = posLOD_map.find(posRounded); search != posLOD_map.end())
-          return search->second >= lod ? min(search->second, maxLOD) : -1;
+        pos.x -= ext_left ? ext : 0.f;
+        pos.z -= ext_top ? ext : 0.f;
+        posRB.x += ext_right ? ext : 0.f;
+        posRB.z += ext_bottom ? ext : 0.f;
       }
-      return -1;
+      if (clip && (posRB.x <= clip->left() || pos.x >= clip->right() || posRB.z <= clip->top() || pos.z >= clip->bottom()))
+        return;
+      LodGridCullCandidates::Node &node = candidates.nodes.push_back();
+      node.box.bmin = v_ld(&pos.x);
+      node.box.bmax = v_ld(&posRB.x);
+      node.origin = origin;
+      node.pos = IPoint2(x, y);
+      node.gridSize = gridSize;
+      node.lod = lod;
     };
 
-    int edgeTessOut[4] = {0 /*left*/, 0 /*right*/, 0 /*top*/, 0 /*bottom*/};
-    for (int i = 0; i != 4; ++i)
+    if (lod == 0)
     {
-      IPoint2 ofs = i / 2 == 0 ? IPoint2(patchStep, 0) : IPoint2(0, patchStep);
-      ofs *= i % 2 == 0 ? -1 : 1;
-
-      IPoint2 nextPatchPos = patchPos + ofs;
-      if (area_bbox & nextPatchPos)
+      const int mnX = max(-rad1, area.minX << subdiv), mxX = min(rad1, (area.maxX + 1) << subdiv),
+                mnY = max(-rad1, area.minY << subdiv), mxY = min(rad1, (area.maxY + 1) << subdiv);
+      candidates.lod0AreaRadius = lodArea;
+      int cullStep = 2 * rad1, heightLod = 0;
+      if (heightCulling) // no need to calculate individual minmax for all patches
       {
-        int neightbourLOD = getNeighbourLOD(nextPatchPos, patchLOD, patchLOD + 4);
-        if (neightbourLOD != -1)
-          edgeTessOut[i] = edge_tess_encode(neightbourLOD - patchLOD);
+        cullStep = clamp((int)floorf(heightCulling->getChunkSize() / patchSize), 1, 2 * rad1);
+        heightLod = heightCulling->getLod(patchSize * cullStep);
       }
-      else
+
+      if (mxX - mnX > 0 && mxY - mnY > 0)
+        candidates.worldToLod0 = Point4(candidates.originPos.x + patchSize * mnX, candidates.originPos.y + patchSize * mnY,
+          1.0f / (patchSize * (mxX - mnX)), 1.0f / (patchSize * (mxY - mnY)));
+
+      for (int y = mnY; y < mxY; y += cullStep)
+        for (int x = mnX; x < mxX; x += cullStep)
+        {
+          float blockHMin = hMin, blockHMax = hMax;
+          if (heightCulling)
+            heightCulling->getMinMax(heightLod, candidates.originPos + Point2(x, y) * patchSize, patchSize * cullStep, blockHMin,
+              blockHMax);
+
+          const int mcY = min(y + cullStep, rad1), mcX = min(x + cullStep, rad1);
+          for (int ty = y; ty < mcY; ty += LodGridCullCandidates::CLUSTER_DIM)
+            for (int tx = x; tx < mcX; tx += LodGridCullCandidates::CLUSTER_DIM)
+            {
+              const uint32_t first = candidates.nodes.size();
+              for (int chunkY = ty, ey = min(ty + LodGridCullCandidates::CLUSTER_DIM, mcY); chunkY < ey; chunkY++)
+                for (int chunkX = tx, ex = min(tx + LodGridCullCandidates::CLUSTER_DIM, mcX); chunkX < ex; chunkX++)
+                  addNode(chunkX, chunkY, blockHMin, blockHMax, x == mnX && chunkX == x, y == mnY && chunkY == y,
+                    x + cullStep >= mxX && chunkX == mcX - 1, y + cullStep >= mxY && chunkY == mcY - 1);
+              add_candidates_cluster(candidates, first);
+            }
+        }
+    }
+    else // other lods
+    {
+      const int mnX = max(-rad1, area.minX), mxX = min(rad1, area.maxX + 1), mnY = max(-rad1, area.minY),
+                mxY = min(rad1, area.maxY + 1);
+      const int heightLod = heightCulling ? heightCulling->getLod(patchSize) : 0;
+
+      for (int ty = mnY; ty < mxY; ty += LodGridCullCandidates::CLUSTER_DIM)
+        for (int tx = mnX; tx < mxX; tx += LodGridCullCandidates::CLUSTER_DIM)
+        {
+          const uint32_t first = candidates.nodes.size();
+          for (int y = ty, ey = min(ty + LodGridCullCandidates::CLUSTER_DIM, mxY); y < ey; y++)
+            for (int x = tx, ex = min(tx + LodGridCullCandidates::CLUSTER_DIM, mxX); x < ex; x++)
+            {
+              if (x >= -prevRad1 && x <= prevRad2 && y >= -prevRad1 && y <= prevRad2)
+                continue;
+              float nodeHMin = hMin, nodeHMax = hMax;
+              if (heightCulling)
+                heightCulling->getMinMax(heightLod, candidates.originPos + Point2(x, y) * patchSize, patchSize, nodeHMin, nodeHMax);
+              addNode(x, y, nodeHMin, nodeHMax, x == mnX, y == mnY, x == mxX - 1, y == mxY - 1);
+            }
+          add_candidates_cluster(candidates, first);
+        }
+    }
+
+    if (clip && non_empty_boxes_inclusive(*clip, BBox2(Point2(candidates.originPos.x - lodArea, candidates.originPos.y - lodArea),
+                                                    Point2(candidates.originPos.x + lodArea, candidates.originPos.y + lodArea))))
+    {
+      ++lod;
+      break;
+    }
+    area.nextLod();
+  }
+  for (; lod <= LodGrid::MAX_LODS; ++lod)
+    candidates.lodClusters[lod] = candidates.clusters.size();
+  v_bbox3_init_empty(candidates.box);
+  for (const LodGridCullCandidates::Cluster &cluster : candidates.clusters)
+    v_bbox3_add_box(candidates.box, cluster.box);
+  return true;
+}
+
+// Point of box inside of frustum b is inside of frustum a with planes pushed out by dist, if no point of box moves relative to any
+// plane by more than dist, i.e. |dot(nb - na, p) + wb - wa| <= dist for all p in box
+static bool is_frustum_within_dist(const Frustum &a, const Frustum &b, bbox3f box, float dist)
+{
+  vec4f center = v_bbox3_center(box), ext = v_mul(v_bbox3_size(box), V_C_HALF);
+  vec4f maxDiff = v_zero();
+  for (int i = 0; i < 6; ++i)
+  {
+    vec4f diff = v_sub(b.camPlanes[i], a.camPlanes[i]);
+    maxDiff = v_max(maxDiff, v_add_x(v_abs(v_add_x(v_dot3_x(diff, center), v_splat_w(diff))), v_dot3_x(v_abs(diff), ext)));
+  }
+  return v_extract_x(maxDiff) <= dist;
+}
+
+static Frustum push_out_frustum_planes(const Frustum &frustum, float dist)
+{
+  Frustum res = frustum;
+  vec4f ofs = v_make_vec4f(0, 0, 0, dist);
+  for (plane3f &plane : res.camPlanes)
+    plane = v_add(plane, ofs);
+  res.plane03X = res.camPlanes[0];
+  res.plane03Y = res.camPlanes[1];
+  res.plane03Z = res.camPlanes[2];
+  res.plane03W = res.camPlanes[3];
+  v_mat44_transpose(res.plane03X, res.plane03Y, res.plane03Z, res.plane03W);
+  res.plane03W2 = v_add(res.plane03W, res.plane03W);
+  res.plane4W2 = v_perm_xyzd(res.camPlanes[4], v_add(res.camPlanes[4], res.camPlanes[4]));
+  res.plane5W2 = v_perm_xyzd(res.camPlanes[5], v_add(res.camPlanes[5], res.camPlanes[5]));
+  return res;
+}
+
+static Point4 get_view_pos_water_level(float waterLevel, const Point3 *viewPos)
+{
+  const bool waterCulling = waterLevel > HeightmapHeightCulling::NO_WATER_ON_LEVEL && viewPos;
+  return waterCulling ? Point4(viewPos->x, viewPos->y, viewPos->z, waterLevel) : Point4::ZERO;
+}
+
+bool is_lod_grid_cull_reusable(const LodGridCullCandidates &candidates, const Frustum &frustum, const LodGridCullData &cull_data,
+  const HMapTesselationData *hmap_tdata, float waterLevel, const Point3 *viewPos)
+{
+  hmap_tdata = (hmap_tdata && hmap_tdata->hasTesselation()) ? hmap_tdata : nullptr;
+  const uint32_t tessGeneration = hmap_tdata ? hmap_tdata->getGeneration() + 1 : 0;
+  if (!candidates.generation || cull_data.candidatesGeneration != candidates.generation ||
+      cull_data.tessGeneration != tessGeneration || !cull_data.culledFrustum)
+    return false;
+  // water culling is a heuristic for far underwater patches, so it tolerates view position change as frustum does
+  const Point4 viewPosWaterLevel = get_view_pos_water_level(waterLevel, viewPos);
+  const Point4 &culled = cull_data.culledViewPosWaterLevel;
+  if (viewPosWaterLevel.w != culled.w ||
+      (Point3::xyz(viewPosWaterLevel) - Point3::xyz(culled)).lengthSq() > sqr(cull_data.reuseDist))
+    return false;
+  if (cull_data.reuseDist <= 0)
+    return memcmp(cull_data.culledFrustum->camPlanes, frustum.camPlanes, sizeof(frustum.camPlanes)) == 0;
+  return is_frustum_within_dist(*cull_data.culledFrustum, frustum, candidates.box, cull_data.reuseDist);
+}
+
+bool cull_lod_grid_candidates(const LodGridCullCandidates &candidates, const Frustum &view_frustum, LodGridCullData &cull_data,
+  const Occlusion *occlusion, const HMapTesselationData *hmap_tdata, float waterLevel, const Point3 *viewPos)
+{
+  if (!occlusion && is_lod_grid_cull_reusable(candidates, view_frustum, cull_data, hmap_tdata, waterLevel, viewPos))
+    return false;
+
+  TIME_PROFILE(hmap_cull_candidates);
+  hmap_tdata = (hmap_tdata && hmap_tdata->hasTesselation()) ? hmap_tdata : nullptr;
+  const bool waterCulling = waterLevel > HeightmapHeightCulling::NO_WATER_ON_LEVEL && viewPos;
+  const Frustum frustum = cull_data.reuseDist > 0 ? push_out_frustum_planes(view_frustum, cull_data.reuseDist) : view_frustum;
+  cull_data.patches.clear();
+  cull_data.lodGrid = candidates.lodGrid;
+  cull_data.useHWTesselation = candidates.useHWTesselation;
+  cull_data.originPos = candidates.originPos;
+  cull_data.scaleX = candidates.scaleX;
+  cull_data.worldToLod0 = candidates.worldToLod0;
+  cull_data.startFlipped = 1000000;
+  cull_data.lod0PatchesCount = 0;
+
+  // same area limit by frustum bbox (in lod 0 patches without subdivision) as in cull_lod_grid(), it rejects nodes which pass
+  // conservative planes test near frustum corners
+  bbox3f frustumBox;
+  frustum.calcFrustumBBox(frustumBox);
+  vec4f startCull = v_make_vec4f(candidates.originPos.x, candidates.originPos.y, 0, 0);
+  vec4f regionV = v_div(v_sub(v_perm_xzac(frustumBox.bmin, frustumBox.bmax), v_perm_xyxy(startCull)),
+    v_splats(candidates.scaleX * candidates.dim));
+  alignas(16) IBBox2 area;
+  v_sti(&area, v_cvt_floori(regionV));
+
+  const int lod0SubDiv = candidates.lod0SubDiv;
+  PosLodMap posLOD_map;
+  for (int lod = 0; lod < candidates.numLods; ++lod)
+  {
+    if (lod == candidates.flipLod)
+      cull_data.startFlipped = cull_data.getCount();
+    const IBBox2 lodArea = lod == 0 ? IBBox2(area[0] << lod0SubDiv, ((area[1] + IPoint2::ONE) << lod0SubDiv) - IPoint2::ONE)
+                                    : IBBox2(area[0] >> lod, area[1] >> lod);
+    for (uint32_t ci = candidates.lodClusters[lod], ce = candidates.lodClusters[lod + 1]; ci < ce; ++ci)
+    {
+      // whole cluster is either rejected, accepted or tested node by node
+      const LodGridCullCandidates::Cluster &cluster = candidates.clusters[ci];
+      vec4f center2 = v_add(cluster.box.bmax, cluster.box.bmin), extent2 = v_sub(cluster.box.bmax, cluster.box.bmin);
+      const int clusterVis = frustum.testBoxExtent(center2, extent2);
+      if (clusterVis == Frustum::OUTSIDE || (occlusion && occlusion->isOccludedBoxExtent2(center2, extent2)))
+        continue;
+
+      for (const LodGridCullCandidates::Node &node : make_span_const(&candidates.nodes[cluster.first], cluster.count))
       {
-        edgeTessOut[i] = edge_tess_encode(1 + lastLodSubdiv); // for last LOD edges stretch
+        if (!(lodArea & node.pos))
+          continue;
+        center2 = v_add(node.box.bmax, node.box.bmin);
+        extent2 = v_sub(node.box.bmax, node.box.bmin);
+        if (clusterVis != Frustum::INSIDE && !frustum.testBoxExtentB(center2, extent2))
+          continue;
+        if (occlusion && occlusion->isOccludedBoxExtent2(center2, extent2))
+          continue;
+        if (waterCulling)
+        {
+          Point3_vec4 pos, posRB;
+          v_st(&pos.x, node.box.bmin);
+          v_st(&posRB.x, node.box.bmax);
+          if (!cull_node_by_water(pos, posRB, waterLevel, viewPos))
+            continue;
+        }
+
+        if (lod == 0)
+        {
+          cull_data.patches.push_back(Point4(node.gridSize, bit_pack_ipoint2_to_float(node.pos), node.origin.x, node.origin.y));
+          posLOD_map[node.pos] = -lod0SubDiv;
+        }
+        else
+          add_lod_patch(cull_data, posLOD_map, hmap_tdata, node.pos, lod, lod0SubDiv, node.gridSize, node.gridSize * candidates.dim,
+            node.origin, candidates.scaleX);
       }
     }
-
-    patch.y = float_pack_edges_tess(edgeTessOut);
+    if (lod == 0)
+      cull_data.lod0PatchesCount = cull_data.getCount();
   }
+
+  calc_edge_tesselation(cull_data, posLOD_map, candidates.lodGrid, candidates.numLods, lod0SubDiv, candidates.scaleX);
+
+  cull_data.candidatesGeneration = occlusion ? 0 : candidates.generation;
+  cull_data.tessGeneration = hmap_tdata ? hmap_tdata->getGeneration() + 1 : 0;
+  cull_data.culledViewPosWaterLevel = get_view_pos_water_level(waterLevel, viewPos);
+  cull_data.culledFrustum = view_frustum;
+  return true;
 }
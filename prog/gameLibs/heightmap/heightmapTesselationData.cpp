@@ -16,6 +16,7 @@ void HMapTesselationData::init(int buffer_size, float tess_cell_size)
 
   patchNum = handler.hmapWidth / bufferSize;
   patches.resize(patchNum.x * patchNum.y);
+  ++generation;
 }
 
 void HMapTesselationData::addTessSphere(const Point2 &pos, float radius)
@@ -40,6 +41,7 @@ void HMapTesselationData::addTessSphere(const Point2 &pos, float radius)
         continue;
       patches.set(getPatchNoFromXY(hmapCoord), true);
       patchHasTess = true;
+      ++generation;
     }
 }
 
@@ -132,6 +134,7 @@ void HMapTesselationData::addTessRectImpl(const Matrix3 &transform33)
         continue;
       patches.set(getPatchNoFromXY(hmapCoord), true);
       patchHasTess = true;
+      ++generation;
     }
 }
 
@@ -140,7 +143,10 @@ void HMapTesselationData::tesselatePatch(const IPoint2 &cell, bool enable)
   IPoint2 patchXY = getPatchXYFromCoord(cell);
   int patchIndex = getPatchNoFromXY(patchXY);
   if (enable)
+  {
     patches.set(patchIndex, true);
+    ++generation;
+  }
   patchHasTess |= enable;
 }
 
@@ -0,0 +1,144 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <heightmap/heightmapCulling.h>
+#include <math/dag_TMatrix4.h>
+#include <math/dag_frustum.h>
+#include <math/random/dag_random.h>
+#include <EASTL/sort.h>
+
+// Lod grid around one origin as HeightmapHandler sets it up, views are culled against candidates built for it
+struct LodGridFixture
+{
+  static constexpr float SCALE = 2.f;
+  static constexpr float H_MIN = 0.f, H_MAX = 40.f;
+  static constexpr int DIM = 16;
+
+  LodGrid lodGrid;
+  LodGridCullCandidates candidates;
+  Point2 origin = Point2(13.f, -27.f);
+  BBox2 clip = BBox2(Point2(-3000.f, -2500.f), Point2(2800.f, 3100.f));
+  int seed = 4321;
+
+  LodGridFixture()
+  {
+    lodGrid.init(6, 1, 1, 4);
+    build_lod_grid_cull_candidates(lodGrid, lodGrid.lodsCount, origin.x, origin.y, SCALE, DIM * SCALE, DIM * SCALE, H_MIN, H_MAX,
+      &clip, candidates, DIM, nullptr, false);
+  }
+
+  static Frustum makeFrustum(const Point3 &pos, const Point3 &dir)
+  {
+    TMatrix4 view = matrix_look_at_lh(pos, pos + dir, Point3(0.f, 1.f, 0.f));
+    return Frustum(view * matrix_perspective(1.f, 1.5f, 0.1f, 800.f));
+  }
+
+  Frustum randomFrustum(Point3 &pos)
+  {
+    pos = Point3(origin.x + _srnd(seed) * 50.f, 5.f + _frnd(seed) * 30.f, origin.y + _srnd(seed) * 50.f);
+    return makeFrustum(pos, normalize(Point3(_srnd(seed), -0.2f - _frnd(seed), _srnd(seed))));
+  }
+
+  // patches in canonical order, edge tesselation (y) depends on visible neighbours, it's dropped when only placement is compared
+  static Tab<Point4> sorted(const LodGridCullData &data, bool with_edges = true)
+  {
+    Tab<Point4> res(data.patches);
+    for (Point4 &p : res)
+      p.y = with_edges ? p.y : 0.f;
+    eastl::sort(res.begin(), res.end(), [](const Point4 &a, const Point4 &b) { return memcmp(&a, &b, sizeof(a)) < 0; });
+    return res;
+  }
+
+  static bool contains(const Tab<Point4> &sorted_patches, const Point4 &patch)
+  {
+    auto it = eastl::lower_bound(sorted_patches.begin(), sorted_patches.end(), patch,
+      [](const Point4 &a, const Point4 &b) { return memcmp(&a, &b, sizeof(a)) < 0; });
+    return it != sorted_patches.end() && memcmp(it, &patch, sizeof(patch)) == 0;
+  }
+};
+
+TEST_FIXTURE(LodGridFixture, CandidatesMatchCullLodGrid)
+{
+  for (int i = 0; i < 50; ++i)
+  {
+    Point3 pos;
+    const Frustum frustum = randomFrustum(pos);
+    LodGridCullData single;
+    single.useHWTesselation = false;
+    float lod0AreaRadius = 0.f;
+    cull_lod_grid(lodGrid, lodGrid.lodsCount, origin.x, origin.y, SCALE, SCALE, DIM * SCALE, DIM * SCALE, H_MIN, H_MAX, &frustum,
+      &clip, single, nullptr, lod0AreaRadius, DIM, true, nullptr, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL,
+      &pos);
+
+    LodGridCullData fromCandidates;
+    CHECK(cull_lod_grid_candidates(candidates, frustum, fromCandidates, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL,
+      &pos));
+    CHECK(single.getCount() > 0);
+    CHECK_EQUAL(single.getCount(), fromCandidates.getCount());
+    CHECK_EQUAL(single.lod0PatchesCount, fromCandidates.lod0PatchesCount);
+    CHECK(single.originPos == fromCandidates.originPos);
+    CHECK(sorted(single) == sorted(fromCandidates));
+  }
+}
+
+TEST_FIXTURE(LodGridFixture, SameFrustumIsReused)
+{
+  Point3 pos;
+  const Frustum frustum = randomFrustum(pos);
+  LodGridCullData data;
+  CHECK(cull_lod_grid_candidates(candidates, frustum, data, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &pos));
+  const Tab<Point4> first = sorted(data);
+  CHECK(!cull_lod_grid_candidates(candidates, frustum, data, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &pos));
+  CHECK(first == sorted(data));
+
+  // without reuse distance any change recalculates
+  const Point3 movedPos = pos + Point3(0.01f, 0.f, 0.f);
+  CHECK(cull_lod_grid_candidates(candidates, makeFrustum(movedPos, Point3(0.f, -0.5f, 1.f)), data, nullptr, nullptr,
+    HeightmapHeightCulling::NO_WATER_ON_LEVEL, &movedPos));
+
+  // rebuild of candidates (origin snapped to other cell) invalidates cull data
+  build_lod_grid_cull_candidates(lodGrid, lodGrid.lodsCount, origin.x + 100.f, origin.y, SCALE, DIM * SCALE, DIM * SCALE, H_MIN,
+    H_MAX, &clip, candidates, DIM, nullptr, false);
+  CHECK(!is_lod_grid_cull_reusable(candidates, frustum, data, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &movedPos));
+}
+
+// Patches culled with reuse distance are kept while frustum moves and turns a little, and always include all patches visible with
+// exact culling of current frustum
+TEST_FIXTURE(LodGridFixture, ReuseWithinDistanceIsConservative)
+{
+  constexpr float REUSE_DIST = 2.f;
+  int reused = 0, recalculated = 0;
+  for (int i = 0; i < 10; ++i)
+  {
+    Point3 pos;
+    randomFrustum(pos);
+    Point3 dir = normalize(Point3(_srnd(seed), -0.3f, _srnd(seed)));
+    LodGridCullData data;
+    data.reuseDist = REUSE_DIST;
+    for (int step = 0; step < 20; ++step)
+    {
+      pos += Point3(0.3f, 0.f, 0.1f);
+      dir = normalize(dir + Point3(0.f, 0.f, 0.0003f));
+      const Frustum frustum = makeFrustum(pos, dir);
+      const bool culled =
+        cull_lod_grid_candidates(candidates, frustum, data, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &pos);
+      CHECK(step > 0 || culled);
+      (culled ? recalculated : reused)++;
+
+      LodGridCullData exact;
+      cull_lod_grid_candidates(candidates, frustum, exact, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &pos);
+      const Tab<Point4> kept = sorted(data, false);
+      for (const Point4 &patch : sorted(exact, false))
+        CHECK(contains(kept, patch));
+    }
+  }
+  CHECK(reused > recalculated);
+
+  // moving farther than reuse distance recalculates
+  Point3 pos;
+  const Frustum frustum = randomFrustum(pos);
+  LodGridCullData data;
+  data.reuseDist = REUSE_DIST;
+  cull_lod_grid_candidates(candidates, frustum, data, nullptr, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &pos);
+  const Point3 farPos = pos + Point3(REUSE_DIST * 1.5f, 0.f, 0.f);
+  const Frustum farFrustum = makeFrustum(farPos, Point3(1.f, -0.3f, 0.f));
+  CHECK(!is_lod_grid_cull_reusable(candidates, farFrustum, data, nullptr, HeightmapHeightCulling::NO_WATER_ON_LEVEL, &farPos));
+}
@@ -13,6 +13,7 @@
 
 #define PROFILE_SIGNAL           SIGPROF
 #define MIN_SAMPLING_INTERVAL_US (25)
+#define STALLS_RATE_WINDOW_US    (60 * 1000000)
 
 extern int g_in_backtrace; // set by stackhlp_fill_stack
 namespace lagcatcher
@@ -32,6 +33,49 @@ struct Context
 {
   Context(int mem_budget) : collector(mem_budget - sizeof(*this)), deadlineTimer(NULL), samplingTimer(NULL) {}
 
+  void initStallDetector(int deadline_ms, int max_stalls_per_min)
+  {
+    stallDeadlineUs = deadline_ms > 0 ? deadline_ms * 1000 : 1;
+    maxStallsPerWindow = max_stalls_per_min;
+    resumeStallDetector();
+  }
+
+  void resumeStallDetector()
+  {
+    if (!stallDeadlineUs)
+      return;
+    lastCheckedTick = __atomic_load_n(&tickNo, __ATOMIC_RELAXED);
+    stalledUs = 0;
+    stallSampling = false;
+    start_timer(&samplingTimer, samplingIntervalUs, false); // periodic, it is not rearmed on ticks
+  }
+
+  // called from signal handler of periodic timer (on thread which calls tick()), so time is measured in timer intervals
+  bool shouldSampleStall()
+  {
+    if ((rateWindowUs += samplingIntervalUs) >= STALLS_RATE_WINDOW_US)
+      rateWindowUs = stallsInWindow = 0;
+    const unsigned curTick = __atomic_load_n(&tickNo, __ATOMIC_RELAXED);
+    if (curTick != lastCheckedTick)
+    {
+      lastCheckedTick = curTick;
+      stalledUs = 0;
+      stallSampling = false;
+      return false;
+    }
+    if (stalledUs < stallDeadlineUs && (stalledUs += samplingIntervalUs) < stallDeadlineUs)
+      return false;
+    if (!stallSampling)
+    {
+      if (stallsInWindow >= maxStallsPerWindow)
+        return false;
+      stallsInWindow++;
+      stallSampling = true;
+      collector.nextGen();
+    }
+    return true;
+  }
+
   bool init(int sampling_interval_us, int deadline_signal)
   {
     if (create_timer(PROFILE_SIGNAL, &samplingTimer, this) != 0)
@@ -72,6 +116,8 @@ struct Context
 
   void start(int deadline_ms)
   {
+    if (stallDeadlineUs)
+      return;
     stop();
     collector.nextGen();
     start_timer(&deadlineTimer, deadline_ms * 1000, true);
@@ -87,6 +133,7 @@ struct Context
   {
     stop();
     collector.clear();
+    resumeStallDetector();
   }
 
   template <int skip>
@@ -107,9 +154,13 @@ struct Context
     stop();
     FILE *log = fopen(log_path, "w");
     if (!log)
+    {
+      resumeStallDetector();
       return false;
+    }
     int ret = collector.flush(log);
     fclose(log);
+    resumeStallDetector();
     return ret;
   }
 
@@ -118,6 +169,16 @@ struct Context
   int deadlineSignal;
   int samplingIntervalUs;
 
+  // stall detector mode (if stallDeadlineUs != 0)
+  int stallDeadlineUs = 0;
+  int maxStallsPerWindow = 0;
+  unsigned tickNo = 0;
+  unsigned lastCheckedTick = 0;
+  int stalledUs = 0;
+  int rateWindowUs = 0;
+  int stallsInWindow = 0;
+  bool stallSampling = false;
+
   BTCollector collector;
 };
 
@@ -128,7 +189,10 @@ static void sampling_signal_handler(int, siginfo_t *sinfo, void *)
   if (sinfo->si_code != SI_TIMER)
     return;
   ErrnoSaver esave;
-  ((Context *)sinfo->si_ptr)->push_bt<2>(); // skip sigaction & this signal handler
+  Context *ctx = (Context *)sinfo->si_ptr;
+  if (ctx->stallDeadlineUs && !ctx->shouldSampleStall())
+    return;
+  ctx->push_bt<2>(); // skip sigaction & this signal handler
 }
 
 static void deadline_signal_handler(int, siginfo_t *sinfo, void *)
@@ -160,6 +224,20 @@ bool init(int sampling_interval_us, int mem_budget, int deadline_signal)
   return true;
 }
 
+bool init_stall_detector(int deadline_ms, int sampling_interval_us, int max_stalls_per_min, int mem_budget, int deadline_signal)
+{
+  if (!init(sampling_interval_us, mem_budget, deadline_signal))
+    return false;
+  lagcatcher_ctx->initStallDetector(deadline_ms, max_stalls_per_min);
+  return true;
+}
+
+void tick()
+{
+  if (lagcatcher_ctx) // only thread which is checked increments it, relaxed store is enough for its own signal handler
+    __atomic_store_n(&lagcatcher_ctx->tickNo, lagcatcher_ctx->tickNo + 1, __ATOMIC_RELAXED);
+}
+
 void shutdown()
 {
   delete lagcatcher_ctx;
@@ -182,7 +260,7 @@ int flush(const char *log_path) { return lagcatcher_ctx ? lagcatcher_ctx->flush(
 
 void stop()
 {
-  if (lagcatcher_ctx)
+  if (lagcatcher_ctx && !lagcatcher_ctx->stallDeadlineUs)
     lagcatcher_ctx->stop();
 }
 
@@ -226,6 +304,8 @@ namespace lagcatcher
 {
 void init_early(int) {}
 bool init(int, int, int) { return false; }
+bool init_stall_detector(int, int, int, int, int) { return false; }
+void tick() {}
 void shutdown() {}
 void start(int) {}
 void stop() {}
@@ -1,5 +1,7 @@
 #include <levelSplines/levelSplines.h>
 #include <memory/dag_framemem.h>
+#include <EASTL/heap.h>
+#include <EASTL/algorithm.h>
 
 namespace levelsplines
 {
@@ -53,9 +55,144 @@ struct PathFinderInfo
   uint8_t prevPointId;
   bool navigated;
 
-  PathFinderInfo() : prevEdge(), distToDst(FLT_MAX), prevPointId(0xff), navigated(false) {}
+  PathFinderInfo() : prevEdge(), distToDst(FLT_MAX), prevPointId(0xff), navigated(false) { prevEdge.dist = FLT_MAX; }
 };
 
+struct OpenNode
+{
+  float dist; // estimated total length of way through node
+  uint16_t nodeId;
+  bool operator<(const OpenNode &rhs) const { return dist > rhs.dist; } // min-heap
+};
+
+struct ReverseEdge
+{
+  float dist;
+  uint16_t fromNodeId;
+};
+
+// plain Dijkstra, dist_out[i * stride] is shortest distance from src to node i (FLT_MAX when unreachable)
+template <typename ForEachEdge>
+static void calc_dists_from(int size, uint16_t src, float *dist_out, int stride, ForEachEdge for_each_edge)
+{
+  for (int i = 0; i < size; ++i)
+    dist_out[i * stride] = FLT_MAX;
+  Tab<OpenNode> heap(framemem_ptr());
+  dist_out[src * stride] = 0.f;
+  heap.push_back(OpenNode{0.f, src});
+  while (!heap.empty())
+  {
+    eastl::pop_heap(heap.begin(), heap.end());
+    OpenNode cur = heap.back();
+    heap.pop_back();
+    if (cur.dist > dist_out[cur.nodeId * stride])
+      continue; // stale record
+    for_each_edge(cur.nodeId, [&](uint16_t next, float edge_dist) {
+      float dist = cur.dist + edge_dist;
+      if (dist < dist_out[next * stride])
+      {
+        dist_out[next * stride] = dist;
+        heap.push_back(OpenNode{dist, next});
+        eastl::push_heap(heap.begin(), heap.end());
+      }
+    });
+  }
+}
+
+void SplineIntersections::buildLandmarks()
+{
+  clear_and_shrink(landmarkDistFrom);
+  clear_and_shrink(landmarkDistTo);
+  landmarksCount = min<int>(MAX_LANDMARKS, size);
+  if (intersectionDataType != EIDT_EDGES || !landmarksCount)
+  {
+    landmarksCount = 0;
+    return;
+  }
+
+  Tab<int> revOfs(framemem_ptr());
+  Tab<ReverseEdge> revEdges(framemem_ptr());
+  revOfs.resize(size + 1);
+  mem_set_0(revOfs);
+  for (int i = 0; i < size; ++i)
+    for (const IntersectionSplineEdge &edge : nodes[i].edges)
+      revOfs[edge.nextPoint.nodeId + 1]++;
+  for (int i = 0; i < size; ++i)
+    revOfs[i + 1] += revOfs[i];
+  revEdges.resize(revOfs[size]);
+  Tab<int> revFill(revOfs, framemem_ptr());
+  for (int i = 0; i < size; ++i)
+    for (const IntersectionSplineEdge &edge : nodes[i].edges)
+      revEdges[revFill[edge.nextPoint.nodeId]++] = ReverseEdge{edge.dist, uint16_t(i)};
+
+  auto forwardEdges = [this](uint16_t node_id, auto cb) {
+    for (const IntersectionSplineEdge &edge : nodes[node_id].edges)
+      cb(edge.nextPoint.nodeId, edge.dist);
+  };
+  auto backwardEdges = [&](uint16_t node_id, auto cb) {
+    for (int i = revOfs[node_id]; i < revOfs[node_id + 1]; ++i)
+      cb(revEdges[i].fromNodeId, revEdges[i].dist);
+  };
+
+  clear_and_resize(landmarkDistFrom, size * landmarksCount);
+  clear_and_resize(landmarkDistTo, size * landmarksCount);
+
+  // farthest landmarks selection: each next landmark is the node farthest (by way length) from already selected ones,
+  // starting from the node farthest from node 0
+  Tab<float> minDist(framemem_ptr());
+  minDist.resize(size);
+  calc_dists_from(size, 0, minDist.data(), 1, forwardEdges);
+  for (int l = 0; l < landmarksCount; ++l)
+  {
+    int landmark = -1;
+    for (int i = 0; i < size; ++i)
+      if (minDist[i] < FLT_MAX && minDist[i] > 0.f && (landmark < 0 || minDist[i] > minDist[landmark]))
+        landmark = i;
+    if (landmark < 0)
+    {
+      landmarksCount = l;
+      break;
+    }
+    calc_dists_from(size, landmark, &landmarkDistFrom[l], landmarksCount, forwardEdges);
+    calc_dists_from(size, landmark, &landmarkDistTo[l], landmarksCount, backwardEdges);
+    for (int i = 0; i < size; ++i)
+      minDist[i] = min(minDist[i], landmarkDistFrom[i * landmarksCount + l]);
+  }
+  if (!landmarksCount)
+  {
+    clear_and_shrink(landmarkDistFrom);
+    clear_and_shrink(landmarkDistTo);
+  }
+  else if (landmarksCount * size != landmarkDistFrom.size()) // less landmarks were found, repack with smaller stride
+  {
+    const int stride = landmarkDistFrom.size() / size;
+    for (int i = 0; i < size; ++i)
+      for (int l = 0; l < landmarksCount; ++l)
+      {
+        landmarkDistFrom[i * landmarksCount + l] = landmarkDistFrom[i * stride + l];
+        landmarkDistTo[i * landmarksCount + l] = landmarkDistTo[i * stride + l];
+      }
+    landmarkDistFrom.resize(size * landmarksCount);
+    landmarkDistTo.resize(size * landmarksCount);
+  }
+}
+
+// lower bound of way length: straight line and triangle inequalities against landmarks (both are admissible and consistent)
+float SplineIntersections::estimateDist(uint16_t fromNodeId, uint16_t toNodeId) const
+{
+  float est = (nodes[toNodeId].position - nodes[fromNodeId].position).length();
+  const float *fromV = landmarkDistFrom.data() + fromNodeId * landmarksCount, *fromT = landmarkDistFrom.data() + toNodeId * landmarksCount;
+  const float *toV = landmarkDistTo.data() + fromNodeId * landmarksCount, *toT = landmarkDistTo.data() + toNodeId * landmarksCount;
+  for (int l = 0; l < landmarksCount; ++l)
+  {
+    if (fromT[l] < FLT_MAX && fromV[l] < FLT_MAX)
+      est = max(est, fromT[l] - fromV[l]); // d(L, t) - d(L, v)
+    if (toV[l] < FLT_MAX && toT[l] < FLT_MAX)
+      est = max(est, toV[l] - toT[l]); // d(v, L) - d(t, L)
+  }
+  return est;
+}
+
 SplineIntersections::Way *SplineIntersections::findWay(uint16_t fromNodeId, uint16_t toNodeId, int &nodeNum) const
 {
   if (fromNodeId == toNodeId)
@@ -67,12 +204,16 @@ SplineIntersections::Way *SplineIntersections::findWay(uint16_t fromNodeId, uint
     if (cachedWays[i].toNodeId != toNodeId)
       continue;
     if (cachedWays[i].fromNodeId == fromNodeId)
+    {
+      cachedWays[i].lastUsed = ++waysUseCounter;
       return &cachedWays[i];
+    }
     for (int j = 0; j < cachedWays[i].nodes.size(); ++j)
     {
       if (cachedWays[i].nodes[j].nodeId != fromNodeId)
         continue;
       nodeNum = j + 1;
+      cachedWays[i].lastUsed = ++waysUseCounter;
       return &cachedWays[i];
     }
   }
@@ -83,53 +224,42 @@ SplineIntersections::Way *SplineIntersections::findWay(uint16_t fromNodeId, uint
   pfInfos[fromNodeId].prevEdge.nextPoint.nodeId = fromNodeId;
   pfInfos[fromNodeId].prevEdge.nextPoint.nodePointId = 0;
   pfInfos[fromNodeId].prevPointId = 0;
-  pfInfos[fromNodeId].navigated = true;
-
-  Point2 dstPos = nodes[toNodeId].position;
-  for (int i = 0; i < size; ++i)
-    pfInfos[i].distToDst = (dstPos - nodes[i].position).length();
 
-  Tab<uint16_t> openNodes(framemem_ptr());
-  openNodes.push_back(fromNodeId);
+  Tab<OpenNode> openNodes(framemem_ptr());
+  pfInfos[fromNodeId].distToDst = estimateDist(fromNodeId, toNodeId);
+  openNodes.push_back(OpenNode{pfInfos[fromNodeId].distToDst, fromNodeId});
   while (!openNodes.empty())
   {
-    int shortest = -1;
-    float minDist = FLT_MAX;
-    for (int i = 0; i < openNodes.size(); ++i)
-    {
-      uint16_t nodeId = openNodes[i];
-      G_ASSERT(nodeId < size);
-      const PathFinderInfo &pfInfo = pfInfos[nodeId];
-      float dist = pfInfo.distToDst + pfInfo.prevEdge.dist;
-      if (dist < minDist)
-      {
-        shortest = i;
-        minDist = dist;
-      }
-    }
-    uint16_t nodeId = openNodes[shortest];
+    eastl::pop_heap(openNodes.begin(), openNodes.end());
+    uint16_t nodeId = openNodes.back().nodeId;
+    openNodes.pop_back();
+    G_ASSERT(nodeId < size);
+    PathFinderInfo &pfInfo = pfInfos[nodeId];
+    if (pfInfo.navigated)
+      continue; // stale record of node which was reached by shorter way later
     if (nodeId == toNodeId)
     {
-      // We have arrived. Cache this way and return.
-      Way *way = &cachedWays[currentWay];
+      // We have arrived. Cache this way (instead of least recently used one) and return.
+      Way *way = &cachedWays[0];
+      for (int i = 1; i < CACHED_WAYS_NUM; ++i)
+        if (cachedWays[i].lastUsed < way->lastUsed)
+          way = &cachedWays[i];
       way->clear();
       way->fromNodeId = fromNodeId;
       way->toNodeId = toNodeId;
       way->length = pfInfos[toNodeId].prevEdge.dist;
+      way->lastUsed = ++waysUseCounter;
       uint16_t curNode = toNodeId;
       while (curNode != fromNodeId)
       {
         const IntersectionSplineEdge &edge = pfInfos[curNode].prevEdge;
-        // const IntersectionSplineEdge& prevEdge = pfInfos[edge.nextPoint.nodeId].prevEdge;
         IntersectionNodePoint pnp = IntersectionNodePoint(curNode, pfInfos[curNode].prevPointId);
-        insert_items(way->nodes, 0, 1, &pnp);
+        way->nodes.push_back(pnp);
         curNode = edge.nextPoint.nodeId;
       }
-      currentWay = (currentWay + 1) % CACHED_WAYS_NUM;
+      eastl::reverse(way->nodes.begin(), way->nodes.end());
       return way;
     }
-    erase_items(openNodes, shortest, 1);
-    PathFinderInfo &pfInfo = pfInfos[nodeId];
     const IntersectionNode &node = nodes[nodeId];
     pfInfo.navigated = true;
     for (int i = 0; i < node.edges.size(); ++i)
@@ -140,22 +270,17 @@ SplineIntersections::Way *SplineIntersections::findWay(uint16_t fromNodeId, uint
       if (nextPfInfo.navigated)
         continue;
       float distance = pfInfo.prevEdge.dist + edge.dist;
-      bool proceedToNode = false;
-      if (find_value_idx(openNodes, edge.nextPoint.nodeId) < 0)
-      {
-        openNodes.push_back(edge.nextPoint.nodeId);
-        proceedToNode = true;
-      }
-      else
-        proceedToNode = distance < nextPfInfo.prevEdge.dist;
+      if (distance >= nextPfInfo.prevEdge.dist)
+        continue;
 
-      if (proceedToNode)
-      {
-        nextPfInfo.prevEdge.nextPoint.nodeId = nodeId;
-        nextPfInfo.prevEdge.nextPoint.nodePointId = edge.fromPointId;
-        nextPfInfo.prevEdge.dist = distance;
-        nextPfInfo.prevPointId = edge.nextPoint.nodePointId;
-      }
+      if (nextPfInfo.distToDst == FLT_MAX)
+        nextPfInfo.distToDst = estimateDist(edge.nextPoint.nodeId, toNodeId);
+      nextPfInfo.prevEdge.nextPoint.nodeId = nodeId;
+      nextPfInfo.prevEdge.nextPoint.nodePointId = edge.fromPointId;
+      nextPfInfo.prevEdge.dist = distance;
+      nextPfInfo.prevPointId = edge.nextPoint.nodePointId;
+      openNodes.push_back(OpenNode{distance + nextPfInfo.distToDst, edge.nextPoint.nodeId});
+      eastl::push_heap(openNodes.begin(), openNodes.end());
     }
   }
   return nullptr; // Nothing can be found.
@@ -218,6 +343,7 @@ float SplineIntersections::getDist(uint16_t fromNodeId, uint16_t toNodeId) const
             if (len <= 0)
               return FLT_MAX; // same as way == null or "way not found"
           }
+          curPoint = pathNode.nodeId;
         }
       }
     }
@@ -236,6 +362,11 @@ void SplineIntersections::clear()
 {
   clear_and_shrink(nodes);
   clear_and_shrink(table);
+  clear_and_shrink(landmarkDistFrom);
+  clear_and_shrink(landmarkDistTo);
+  landmarksCount = 0;
+  for (Way &way : cachedWays)
+    way.clear();
   size = 0;
 }
 
@@ -274,6 +405,7 @@ bool SplineIntersections::load(IGenLoad &crd)
   else
     G_ASSERT(false);
   crd.endBlock();
+  buildLandmarks();
   return true;
 }
 
@@ -3,9 +3,13 @@
 #include <math/dag_math2d.h>
 #include <memory/dag_framemem.h>
 #include <startup/dag_globalSettings.h>
+#include <vecmath/dag_vecMath.h>
 #include <EASTL/array.h>
 #include <EASTL/sort.h>
 
+static constexpr int ACCEL_GRID_MAX_DIM = 64;
+static constexpr float ACCEL_CONVEX_BOX_EPS = 0.01f;
+
 bool splineregions::RegionConvex::checkPoint(const Point2 &pt) const
 {
   for (const Line2 &line : lines)
@@ -14,14 +18,132 @@ bool splineregions::RegionConvex::checkPoint(const Point2 &pt) const
   return true;
 }
 
+static inline bool check_convex_lines(const splineregions::SplineRegion::ConvexLines4 *lines,
+  const splineregions::SplineRegion::ConvexLines4 *lines_end, vec4f px, vec4f py)
+{
+  // same as Line2::distance(), but 4 lines at once
+  for (; lines != lines_end; ++lines)
+    if (v_signmask(v_cmp_ge(v_add(v_add(v_mul(lines->nx, px), v_mul(lines->ny, py)), lines->d), v_zero())))
+      return false;
+  return true;
+}
+
 bool splineregions::SplineRegion::checkPoint(const Point2 &pt) const
 {
-  for (const RegionConvex &convex : convexes)
-    if (convex.checkPoint(pt))
+  if (accelLinesOfs.size() != convexes.size() + 1) // accel wasn't built
+  {
+    for (const RegionConvex &convex : convexes)
+      if (convex.checkPoint(pt))
+        return true;
+    return false;
+  }
+
+  const vec4f px = v_splats(pt.x), py = v_splats(pt.y);
+  const ConvexLines4 *lines = accelLines.data();
+  if (!accelGridW)
+  {
+    for (int i = 0; i < convexes.size(); ++i)
+      if (check_convex_lines(lines + accelLinesOfs[i], lines + accelLinesOfs[i + 1], px, py))
+        return true;
+    return false;
+  }
+
+  if (!(accelBox & pt))
+    return false;
+  const int x = clamp(int((pt.x - accelBox[0].x) * accelInvCellSize.x), 0, accelGridW - 1);
+  const int y = clamp(int((pt.y - accelBox[0].y) * accelInvCellSize.y), 0, accelGridH - 1);
+  const int cellI = y * accelGridW + x;
+  for (int ci = accelCellOfs[cellI], ce = accelCellOfs[cellI + 1]; ci < ce; ++ci)
+  {
+    const int i = accelCellConvexes[ci];
+    if (check_convex_lines(lines + accelLinesOfs[i], lines + accelLinesOfs[i + 1], px, py))
       return true;
+  }
   return false;
 }
 
+void splineregions::SplineRegion::buildAccel()
+{
+  clear_and_shrink(accelLines);
+  clear_and_shrink(accelCellOfs);
+  clear_and_shrink(accelCellConvexes);
+  clear_and_resize(accelLinesOfs, convexes.size() + 1);
+  accelGridW = accelGridH = 0;
+  accelBox.setempty();
+
+  for (int i = 0; i < convexes.size(); ++i)
+  {
+    const Tab<Line2> &lines = convexes[i].lines;
+    accelLinesOfs[i] = accelLines.size();
+    for (int l = 0; l < lines.size(); l += 4)
+    {
+      alignas(16) float nx[4] = {0.f, 0.f, 0.f, 0.f}, ny[4] = {0.f, 0.f, 0.f, 0.f}, d[4] = {-1.f, -1.f, -1.f, -1.f};
+      for (int k = 0; k < 4 && l + k < lines.size(); ++k)
+      {
+        nx[k] = lines[l + k].norm.x;
+        ny[k] = lines[l + k].norm.y;
+        d[k] = lines[l + k].d;
+      }
+      accelLines.push_back(ConvexLines4{v_ld(nx), v_ld(ny), v_ld(d)});
+    }
+  }
+  accelLinesOfs.back() = accelLines.size();
+
+  // bounds of convexes, vertices are intersections of adjacent lines
+  Tab<BBox2> convexBoxes(framemem_ptr());
+  convexBoxes.resize(convexes.size());
+  float convexesArea = 0.f;
+  for (int i = 0; i < convexes.size(); ++i)
+  {
+    const Tab<Line2> &lines = convexes[i].lines;
+    BBox2 &box = convexBoxes[i];
+    for (int l = 0, n = lines.size(); l < n; ++l)
+    {
+      const Line2 &ln0 = lines[l], &ln1 = lines[(l + 1) % n];
+      const float det = ln0.norm.x * ln1.norm.y - ln0.norm.y * ln1.norm.x;
+      if (n < 3 || fabsf(det) < 1e-6f) // unbounded convex, all of them are tested for each point then
+      {
+        accelBox.setempty();
+        return;
+      }
+      box += Point2(ln0.norm.y * ln1.d - ln1.norm.y * ln0.d, ln1.norm.x * ln0.d - ln0.norm.x * ln1.d) / det;
+    }
+    box[0] -= Point2(ACCEL_CONVEX_BOX_EPS, ACCEL_CONVEX_BOX_EPS);
+    box[1] += Point2(ACCEL_CONVEX_BOX_EPS, ACCEL_CONVEX_BOX_EPS);
+    accelBox += box;
+    convexesArea += box.width().x * box.width().y;
+  }
+  if (accelBox.isempty())
+    return;
+
+  // about one convex per cell
+  const Point2 width = accelBox.width();
+  const float cellSize = max(sqrtf(convexesArea / convexes.size()), max(width.x, width.y) / ACCEL_GRID_MAX_DIM);
+  accelGridW = clamp(int(ceilf(width.x / cellSize)), 1, ACCEL_GRID_MAX_DIM);
+  accelGridH = clamp(int(ceilf(width.y / cellSize)), 1, ACCEL_GRID_MAX_DIM);
+  accelInvCellSize = Point2(accelGridW / width.x, accelGridH / width.y);
+
+  auto forEachCell = [&](const BBox2 &box, auto cb) {
+    const int x0 = clamp(int((box[0].x - accelBox[0].x) * accelInvCellSize.x), 0, accelGridW - 1);
+    const int y0 = clamp(int((box[0].y - accelBox[0].y) * accelInvCellSize.y), 0, accelGridH - 1);
+    const int x1 = clamp(int((box[1].x - accelBox[0].x) * accelInvCellSize.x), 0, accelGridW - 1);
+    const int y1 = clamp(int((box[1].y - accelBox[0].y) * accelInvCellSize.y), 0, accelGridH - 1);
+    for (int y = y0; y <= y1; ++y)
+      for (int x = x0; x <= x1; ++x)
+        cb(y * accelGridW + x);
+  };
+  accelCellOfs.resize(accelGridW * accelGridH + 1);
+  mem_set_0(accelCellOfs);
+  for (const BBox2 &box : convexBoxes)
+    forEachCell(box, [&](int cellI) { accelCellOfs[cellI + 1]++; });
+  for (int i = 1; i < accelCellOfs.size(); ++i)
+    accelCellOfs[i] += accelCellOfs[i - 1];
+  accelCellConvexes.resize(accelCellOfs.back());
+  Tab<int> cellFill(accelCellOfs, framemem_ptr());
+  for (int i = 0; i < convexBoxes.size(); ++i)
+    forEachCell(convexBoxes[i], [&](int cellI) { accelCellConvexes[cellFill[cellI]++] = i; });
+}
+
 Point3 splineregions::SplineRegion::getAnyBorderPoint() const
 {
   if (border.empty())
@@ -140,6 +262,7 @@ void splineregions::construct_region_from_spline(SplineRegion &region, const lev
 
   region.name = spline.name;
   region.isVisible = true;
+  region.buildAccel();
 }
 
 void splineregions::load_regions_from_splines(LevelRegions &regions, dag::ConstSpan<levelsplines::Spline> splines,
@@ -159,3 +282,24 @@ void splineregions::load_regions_from_splines(LevelRegions &regions, dag::ConstS
     region.isVisible = regionBlk->getBool("visible", true);
   }
 }
+
+int splineregions::find_region(dag::ConstSpan<SplineRegion> regions, const Point2 &pt)
+{
+  for (int i = 0; i < regions.size(); ++i)
+    if (regions[i].checkPoint(pt))
+      return i;
+  return -1;
+}
+
+void splineregions::find_regions(dag::ConstSpan<SplineRegion> regions, dag::ConstSpan<Point2> points, dag::Span<int> out_region_idx)
+{
+  G_ASSERT(points.size() == out_region_idx.size());
+  mem_set_ff(out_region_idx); // -1
+  for (int ri = 0; ri < regions.size(); ++ri) // region by region, so its accel data stays in cache
+  {
+    const SplineRegion &region = regions[ri];
+    for (int i = 0; i < points.size(); ++i)
+      if (out_region_idx[i] < 0 && region.checkPoint(points[i]))
+        out_region_idx[i] = ri;
+  }
+}
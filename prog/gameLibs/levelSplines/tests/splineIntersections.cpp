@@ -0,0 +1,249 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <levelSplines/levelSplines.h>
+#include <ioSys/dag_memIo.h>
+#include <math/random/dag_random.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+#include <EASTL/vector.h>
+
+using namespace levelsplines;
+
+static const float WORLD_SIZE = 1000.f;
+static const int POINTS_PER_NODE = 4;
+
+// Random road graph: nodes are joined with nearest ones by edges not shorter than straight line (some edges are one way), so
+// straight line heuristic of the old A* is consistent and it finds shortest ways. Last node has no edges.
+struct RoadGraph
+{
+  struct Edge
+  {
+    uint16_t to;
+    uint8_t fromPointId, toPointId;
+    float dist;
+  };
+  eastl::vector<Point2> positions;
+  eastl::vector<eastl::vector<Edge>> edges;
+
+  RoadGraph(int count, int &seed) : positions(count), edges(count)
+  {
+    for (Point2 &pos : positions)
+      pos = Point2(_frnd(seed) * WORLD_SIZE, _frnd(seed) * WORLD_SIZE);
+    for (int i = 0; i < count - 1; ++i)
+    {
+      eastl::vector<int> nearest;
+      for (int j = 0; j < count - 1; ++j)
+        if (j != i)
+          nearest.push_back(j);
+      eastl::sort(nearest.begin(), nearest.end(), [&](int a, int b) {
+        return lengthSq(positions[a] - positions[i]) < lengthSq(positions[b] - positions[i]);
+      });
+      for (int n = 0; n < 3; ++n)
+      {
+        addEdge(i, nearest[n], seed);
+        if (_frnd(seed) > 0.2f)
+          addEdge(nearest[n], i, seed);
+      }
+    }
+  }
+
+  void addEdge(int from, int to, int &seed)
+  {
+    for (const Edge &edge : edges[from])
+      if (edge.to == to)
+        return;
+    const float dist = length(positions[to] - positions[from]) * (1.f + _frnd(seed) * 0.5f) + 0.1f;
+    edges[from].push_back(Edge{uint16_t(to), uint8_t(_rnd(seed) % POINTS_PER_NODE), uint8_t(_rnd(seed) % POINTS_PER_NODE), dist});
+  }
+
+  // in format of SplineIntersections::load() with edges data
+  void load(SplineIntersections &intersections) const
+  {
+    DynamicMemGeneralSaveCB cwr(tmpmem, 0, 4 << 10);
+    cwr.writeInt(positions.size());
+    for (int i = 0; i < positions.size(); ++i)
+    {
+      Tab<IntersectionSplinePoint> points;
+      for (int p = 0; p < POINTS_PER_NODE; ++p)
+        points.push_back(IntersectionSplinePoint{float(p), uint16_t(i), 0});
+      cwr.writeTab(points);
+    }
+    cwr.beginTaggedBlock(_MAKE4C('ncon'));
+    for (int i = 0; i < positions.size(); ++i)
+    {
+      cwr.write(&positions[i], sizeof(Point2));
+      Tab<IntersectionSplineEdge> nodeEdges;
+      for (const Edge &edge : edges[i])
+      {
+        IntersectionSplineEdge &e = nodeEdges.push_back();
+        memset(&e, 0, sizeof(e));
+        e.dist = edge.dist;
+        e.nextPoint = IntersectionNodePoint(edge.to, edge.toPointId);
+        e.fromPointId = edge.fromPointId;
+      }
+      cwr.writeTab(nodeEdges);
+    }
+    cwr.endBlock();
+    InPlaceMemLoadCB crd(cwr.data(), cwr.size());
+    intersections.load(crd);
+  }
+
+  // A* as it was before binary heap and landmarks: linear search of open node with least estimate, straight line heuristic
+  float oldFindWay(uint16_t from, uint16_t to, eastl::vector<IntersectionNodePoint> &way) const
+  {
+    struct NodeInfo
+    {
+      float dist = FLT_MAX;
+      float distToDst = 0.f;
+      uint16_t prevNodeId = 0xffff;
+      uint8_t prevPointId = 0xff;
+      bool navigated = false;
+    };
+    eastl::vector<NodeInfo> infos(positions.size());
+    for (int i = 0; i < positions.size(); ++i)
+      infos[i].distToDst = length(positions[to] - positions[i]);
+    infos[from].dist = 0.f;
+    infos[from].navigated = true;
+    eastl::vector<uint16_t> openNodes = {from};
+    way.clear();
+    while (!openNodes.empty())
+    {
+      int shortest = 0;
+      for (int i = 1; i < openNodes.size(); ++i)
+        if (infos[openNodes[i]].dist + infos[openNodes[i]].distToDst <
+            infos[openNodes[shortest]].dist + infos[openNodes[shortest]].distToDst)
+          shortest = i;
+      const uint16_t nodeId = openNodes[shortest];
+      if (nodeId == to)
+      {
+        for (uint16_t cur = to; cur != from; cur = infos[cur].prevNodeId)
+          way.push_back(IntersectionNodePoint(cur, infos[cur].prevPointId));
+        eastl::reverse(way.begin(), way.end());
+        return infos[to].dist;
+      }
+      openNodes.erase(openNodes.begin() + shortest);
+      infos[nodeId].navigated = true;
+      for (const Edge &edge : edges[nodeId])
+      {
+        NodeInfo &next = infos[edge.to];
+        if (next.navigated)
+          continue;
+        const float dist = infos[nodeId].dist + edge.dist;
+        bool proceed = true;
+        if (eastl::find(openNodes.begin(), openNodes.end(), edge.to) == openNodes.end())
+          openNodes.push_back(edge.to);
+        else
+          proceed = dist < next.dist;
+        if (proceed)
+        {
+          next.prevNodeId = nodeId;
+          next.prevPointId = edge.toPointId;
+          next.dist = dist;
+        }
+      }
+    }
+    return FLT_MAX;
+  }
+};
+
+// way as it is followed by next intersection points
+static eastl::vector<IntersectionNodePoint> follow_way(const SplineIntersections &intersections, uint16_t from, uint16_t to)
+{
+  eastl::vector<IntersectionNodePoint> way;
+  for (uint16_t cur = from; cur != to && way.size() < intersections.getNodesCount();)
+  {
+    IntersectionNodePoint next;
+    intersections.getNextIntersectionPoint(cur, to, next);
+    if (!next.isValid())
+      break;
+    way.push_back(next);
+    cur = next.nodeId;
+  }
+  return way;
+}
+
+TEST(HeapAltAStarMatchesOldAStar)
+{
+  int seed = 4242;
+  int found = 0, notFound = 0;
+  for (int g = 0; g < 4; ++g)
+  {
+    RoadGraph graph(30 + g * 15, seed);
+    const int count = graph.positions.size();
+    for (uint16_t from = 0; from < count; ++from)
+    {
+      // new intersections for each source node, so distances are not taken from middle of cached ways
+      SplineIntersections intersections;
+      graph.load(intersections);
+      CHECK_EQUAL(count, intersections.getNodesCount());
+      for (uint16_t to = 0; to < count; ++to)
+      {
+        if (to == from)
+          continue;
+        eastl::vector<IntersectionNodePoint> oldWay;
+        const float oldDist = graph.oldFindWay(from, to, oldWay);
+        const eastl::vector<IntersectionNodePoint> way = follow_way(intersections, from, to);
+        const float dist = intersections.getDist(from, to);
+        if (oldDist == FLT_MAX)
+        {
+          notFound++;
+          CHECK(way.empty());
+          CHECK_EQUAL(FLT_MAX, dist);
+          continue;
+        }
+        found++;
+        CHECK_EQUAL(oldDist, dist);
+        CHECK_EQUAL(oldWay.size(), way.size());
+        CHECK(oldWay == way);
+      }
+    }
+  }
+  CHECK(found > 0 && notFound > 0);
+}
+
+// Ways are evicted from LRU cache and found again with the same result, many ways are used through their middle nodes
+TEST(WayCacheGivesSameWays)
+{
+  int seed = 777;
+  RoadGraph graph(60, seed);
+  SplineIntersections intersections;
+  graph.load(intersections);
+  const int count = graph.positions.size();
+  for (int i = 0; i < 3000; ++i)
+  {
+    const uint16_t from = _rnd(seed) % count, to = (i % 7 == 0 ? _rnd(seed) : i / 100) % count;
+    if (from == to)
+      continue;
+    eastl::vector<IntersectionNodePoint> oldWay;
+    graph.oldFindWay(from, to, oldWay);
+    IntersectionNodePoint next;
+    intersections.getNextIntersectionPoint(from, to, next);
+    CHECK(oldWay.empty() ? !next.isValid() : next == oldWay[0]);
+  }
+}
+
+// Distance from node in the middle of cached way subtracts every edge of way before that node
+TEST(DistFromMiddleOfCachedWay)
+{
+  int seed = 31337;
+  RoadGraph graph(50, seed);
+  const int count = graph.positions.size();
+  int checkedLongWays = 0;
+  for (uint16_t from = 0; from < count; ++from)
+    for (uint16_t to = 0; to < count; ++to)
+    {
+      eastl::vector<IntersectionNodePoint> way;
+      if (to == from || graph.oldFindWay(from, to, way) == FLT_MAX || way.size() < 3)
+        continue;
+      SplineIntersections intersections;
+      graph.load(intersections);
+      intersections.getDist(from, to); // caches way
+      for (int i = 0; i + 1 < way.size(); ++i)
+      {
+        eastl::vector<IntersectionNodePoint> restWay;
+        const float restDist = graph.oldFindWay(way[i].nodeId, to, restWay);
+        CHECK_CLOSE(restDist, intersections.getDist(way[i].nodeId, to), restDist * 1e-4f);
+      }
+      checkedLongWays++;
+    }
+  CHECK(checkedLongWays > 0);
+}
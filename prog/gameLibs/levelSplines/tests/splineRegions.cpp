@@ -0,0 +1,122 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <levelSplines/splineRegions.h>
+#include <math/dag_mathBase.h>
+#include <math/random/dag_random.h>
+#include <EASTL/sort.h>
+#include <EASTL/vector.h>
+
+using splineregions::SplineRegion;
+
+static const float WORLD_SIZE = 1000.f;
+
+// star shaped polygon, so it's simple (not self intersecting)
+static void make_random_spline(levelsplines::Spline &spline, int &seed)
+{
+  const Point2 center(_frnd(seed) * WORLD_SIZE, _frnd(seed) * WORLD_SIZE);
+  const float maxRadius = 20.f + _frnd(seed) * 200.f;
+  const int count = 3 + _rnd(seed) % 30;
+  eastl::vector<float> angles;
+  for (int i = 0; i < count; ++i)
+    angles.push_back(_frnd(seed) * TWOPI);
+  eastl::sort(angles.begin(), angles.end());
+  spline.pathPoints.resize(count);
+  for (int i = 0; i < count; ++i)
+  {
+    const float radius = maxRadius * (0.3f + _frnd(seed) * 0.7f);
+    const Point2 p = center + Point2(cosf(angles[i]), sinf(angles[i])) * radius;
+    spline.pathPoints[i].pt = spline.pathPoints[i].bezIn = spline.pathPoints[i].bezOut = Point3(p.x, 0.f, p.y);
+  }
+}
+
+static bool check_point_brute_force(const SplineRegion &region, const Point2 &pt)
+{
+  for (const splineregions::RegionConvex &convex : region.convexes)
+    if (convex.checkPoint(pt))
+      return true;
+  return false;
+}
+
+static Point2 random_point(int &seed)
+{
+  return Point2(_frnd(seed) * WORLD_SIZE * 1.2f - WORLD_SIZE * 0.1f, _frnd(seed) * WORLD_SIZE * 1.2f - WORLD_SIZE * 0.1f);
+}
+
+TEST(SplineRegionAccelMatchesBruteForce)
+{
+  int seed = 9001;
+  for (int r = 0; r < 100; ++r)
+  {
+    levelsplines::Spline spline;
+    make_random_spline(spline, seed);
+    SplineRegion region;
+    splineregions::construct_region_from_spline(region, spline, r % 2 ? 2.f : 0.f);
+    CHECK_EQUAL(region.convexes.size() + 1, region.accelLinesOfs.size());
+    CHECK(region.accelGridW > 0);
+
+    // random points, vertices and points close to them
+    for (int i = 0; i < 2000; ++i)
+    {
+      Point2 pt = random_point(seed);
+      if (i % 4 == 0)
+      {
+        const Point3 &b = region.border[_rnd(seed) % region.border.size()];
+        pt = Point2(b.x, b.z) + Point2(_srnd(seed), _srnd(seed)) * (i % 8 ? 0.5f : 0.f);
+      }
+      CHECK_EQUAL(check_point_brute_force(region, pt), region.checkPoint(pt));
+    }
+  }
+}
+
+TEST(SplineRegionAccelUnboundedAndManualConvexes)
+{
+  int seed = 77;
+  SplineRegion region;
+  splineregions::RegionConvex &halfPlane = region.convexes.push_back();
+  halfPlane.lines.push_back(Line2(Point2(0, 0), Point2(0, 1))); // single line, not bounded
+  splineregions::RegionConvex &quad = region.convexes.push_back();
+  quad.lines.push_back(Line2(Point2(100, 100), Point2(200, 100)));
+  quad.lines.push_back(Line2(Point2(200, 100), Point2(200, 200)));
+  quad.lines.push_back(Line2(Point2(200, 200), Point2(100, 200)));
+  quad.lines.push_back(Line2(Point2(100, 200), Point2(100, 100)));
+  quad.lines.push_back(Line2(Point2(100, 100), Point2(200, 200))); // 5th line goes into second group of 4
+
+  // without accel data
+  for (int i = 0; i < 500; ++i)
+  {
+    const Point2 pt = random_point(seed);
+    CHECK_EQUAL(check_point_brute_force(region, pt), region.checkPoint(pt));
+  }
+  region.buildAccel();
+  CHECK_EQUAL(0, region.accelGridW); // unbounded convex, no grid
+  for (int i = 0; i < 2000; ++i)
+  {
+    const Point2 pt = random_point(seed) - Point2(WORLD_SIZE * 0.5f, 0.f);
+    CHECK_EQUAL(check_point_brute_force(region, pt), region.checkPoint(pt));
+  }
+}
+
+TEST(FindRegionsMatchesBruteForce)
+{
+  int seed = 31337;
+  LevelRegions regions;
+  for (int r = 0; r < 20; ++r)
+  {
+    levelsplines::Spline spline;
+    make_random_spline(spline, seed);
+    splineregions::construct_region_from_spline(regions.push_back(), spline);
+  }
+  eastl::vector<Point2> points;
+  for (int i = 0; i < 5000; ++i)
+    points.push_back(random_point(seed));
+  eastl::vector<int> found(points.size());
+  splineregions::find_regions(regions, make_span_const(points.data(), points.size()), make_span(found.data(), found.size()));
+  for (int i = 0; i < points.size(); ++i)
+  {
+    int expected = -1;
+    for (int r = 0; r < regions.size() && expected < 0; ++r)
+      if (check_point_brute_force(regions[r], points[i]))
+        expected = r;
+    CHECK_EQUAL(expected, found[i]);
+    CHECK_EQUAL(expected, splineregions::find_region(regions, points[i]));
+  }
+}
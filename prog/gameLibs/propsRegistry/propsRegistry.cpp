@@ -4,19 +4,184 @@
 #include <ADT/fastHashNameMap.h>
 #include <EASTL/string_view.h>
 #include <EASTL/vector_set.h>
+#include <EASTL/unique_ptr.h>
 #include <memory/dag_framemem.h>
 #include <debug/dag_debug.h>
+#include <osApiWrappers/dag_rwLock.h>
+#include <osApiWrappers/dag_miscApi.h>
+#include <osApiWrappers/dag_atomic.h>
+#include <util/dag_parallelFor.h>
+#include <generic/dag_tab.h>
+#include <dag/dag_vector.h>
+
+struct ClassRegistry;
+// per thread, props which this thread waits to be loaded by other thread, used to break cyclic waits
+struct PropsLoader
+{
+  const ClassRegistry *waitsForClass = nullptr;
+  int waitsForId = -1;
+  int listEntry = -1; // innermost entry of parallel register_props_list() which is loaded by this thread
+};
+static thread_local PropsLoader props_loader;
+
+// state of props id: pending (blk is set, loaded on demand by any thread), being loaded (by loader) or loaded (both are null)
+struct LoadingProps
+{
+  const DataBlock *blk;
+  const PropsLoader *loader;
+};
+
+// guards names and loading state of all classes, props themselves are loaded outside of it
+static OSReadWriteLock props_names_lock;
+static bool is_waiting_for(const PropsLoader *loader, const PropsLoader *waiter);
+
+// parallel register_props_list() in progress (only one at a time), its entries have ids [firstId, endId), set under names lock
+static struct
+{
+  ClassRegistry *cls = nullptr;
+  int firstId = 0, endId = 0;
+  volatile int loadedUpTo = 0; // entries before it are loaded
+
+  bool isEntry(const ClassRegistry *c, int id) const { return cls == c && id >= firstId && id < endId; }
+} list_load;
+static void load_list_entries_before(int id);
 
 struct ClassRegistry
 {
   FastHashNameMap propNames;
+  dag::Vector<LoadingProps> loadingProps; // per props id
+  // immutable copies of propNames for lock free lookups, last one is published. Previous ones can still be read, so they are kept
+  // till clear(), copy is published only when names count is at least doubled to bound their memory by twice the size of last one
+  dag::Vector<eastl::unique_ptr<FastHashNameMap>> namesSnapshots;
+  const FastHashNameMap *volatile namesSnapshot = nullptr;
+  volatile int namesCount = 0;
+  volatile int loadingCount = 0; // registered props which are not loaded yet
+  volatile int staleLookups = 0; // lookups which missed published snapshot, it is republished when copy cost is amortized
+  bool parallelLoad = false;     // props of register_props_list() are loaded on job threads, if all registries opted in
   eastl::vector_set<propsreg::PropsRegistry *> propsRegistries; // PropsRegistry is statically allocated
 
-  int getPropId(const char *name) const { return propNames.getNameId(name); }
+  // id of registered props, they are loaded on return unless it is cyclic lookup from their own load(). Lock free when published
+  // snapshot is up to date and no props of class are being loaded
+  int getPropId(const char *name)
+  {
+    if (props_loader.listEntry >= 0)
+      return getPropIdFromListEntry(name);
+    if (const FastHashNameMap *names = interlocked_acquire_load_ptr(namesSnapshot))
+    {
+      const int id = names->getNameId(name);
+      if (id >= 0 ? !interlocked_acquire_load(loadingCount) : (int)names->size() == interlocked_acquire_load(namesCount))
+        return id;
+    }
+    return getPropIdSlow(name);
+  }
+
+  int getPropIdSlow(const char *name)
+  {
+    int id;
+    bool loaded;
+    {
+      ScopedLockReadTemplate<OSReadWriteLock> lock(props_names_lock);
+      id = propNames.getNameId(name);
+      loaded = id < 0 || (!loadingProps[id].blk && !loadingProps[id].loader);
+    }
+    if (!loaded)
+      loadProps(id, true);
+    else if (!interlocked_acquire_load(loadingCount))
+    {
+      const FastHashNameMap *names = interlocked_acquire_load_ptr(namesSnapshot);
+      if (interlocked_increment(staleLookups) > (names ? (int)names->size() : 0) / 4)
+      {
+        ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+        publishNames();
+      }
+    }
+    return id;
+  }
 
-  void clear()
+  // load() of list entry sees the same props as with sequential registration of list: later entries are not registered yet, earlier
+  // ones and props registered from their load() are loaded
+  int getPropIdFromListEntry(const char *name)
   {
+    const int entry = props_loader.listEntry;
+    int id;
+    {
+      ScopedLockReadTemplate<OSReadWriteLock> lock(props_names_lock);
+      id = propNames.getNameId(name);
+    }
+    if (list_load.isEntry(this, id) && id >= entry)
+      return id == entry ? id : -1;
+    if (id < 0)
+    {
+      load_list_entries_before(entry);
+      ScopedLockReadTemplate<OSReadWriteLock> lock(props_names_lock);
+      id = propNames.getNameId(name);
+    }
+    if (id >= 0)
+      loadProps(id, true);
+    return id;
+  }
+
+  // loads pending props on this thread, or waits for thread which loads them if 'wait' is set. Wait which would be cyclic (loader
+  // of props waits for this thread) is skipped, props are left partially loaded then, as with nested sequential registration
+  void loadProps(int id, bool wait)
+  {
+    const DataBlock *blk = nullptr;
+    bool isListEntry = false;
+    {
+      ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+      LoadingProps &lp = loadingProps[id];
+      if (!lp.loader && !lp.blk)
+        return;
+      if (!lp.loader)
+      {
+        blk = lp.blk;
+        lp.blk = nullptr;
+        lp.loader = &props_loader;
+        isListEntry = list_load.isEntry(this, id);
+      }
+      else if (!wait || is_waiting_for(lp.loader, &props_loader))
+        return;
+      else
+      {
+        props_loader.waitsForClass = this;
+        props_loader.waitsForId = id;
+      }
+    }
+    if (blk)
+    {
+      const int prevEntry = props_loader.listEntry;
+      if (isListEntry)
+        props_loader.listEntry = id;
+      load(id, blk);
+      props_loader.listEntry = prevEntry;
+      finishLoading(id);
+      return;
+    }
+    spin_wait([&] {
+      ScopedLockReadTemplate<OSReadWriteLock> lock(props_names_lock);
+      return loadingProps[id].loader != nullptr;
+    });
+    ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+    props_loader.waitsForClass = nullptr;
+  }
+
+  int size() const { return interlocked_acquire_load(namesCount); }
+
+  void clearNames()
+  {
+    ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+    G_ASSERTF(!loadingCount, "props are cleared while being loaded");
+    interlocked_release_store_ptr(namesSnapshot, (const FastHashNameMap *)nullptr);
+    interlocked_release_store(namesCount, 0);
     propNames.clear();
+    loadingProps.clear();
+    namesSnapshots.clear();
+    interlocked_release_store(staleLookups, 0);
+  }
+
+  void clear()
+  {
+    clearNames();
     for (auto reg : propsRegistries)
       reg->clearProps();
     propsRegistries.clear();
@@ -25,27 +190,111 @@ struct ClassRegistry
 
   void cleanup()
   {
-    propNames.clear();
+    clearNames();
     for (auto reg : propsRegistries)
       reg->clearProps();
   }
 
-  const char *getNameSlow(int props_id) { return propNames.getNameSlow(props_id); }
+  const char *getNameSlow(int props_id)
+  {
+    ScopedLockReadTemplate<OSReadWriteLock> lock(props_names_lock);
+    return propNames.getNameSlow(props_id);
+  }
+
+  // returns true in second if name was inserted, then props are loaded on demand from pending_blk, or by this thread if it is null
+  eastl::pair<int, bool> insert(const char *name, const DataBlock *pending_blk)
+  {
+    ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+    return insertLocked(name, pending_blk);
+  }
+
+  eastl::pair<int, bool> insertLocked(const char *name, const DataBlock *pending_blk)
+  {
+    auto ins = propNames.insert(name);
+    if (ins.second)
+    {
+      G_ASSERT(ins.first == loadingProps.size());
+      loadingProps.push_back(LoadingProps{pending_blk, pending_blk ? nullptr : &props_loader});
+      interlocked_increment(loadingCount);
+      interlocked_release_store(namesCount, (int)propNames.size());
+    }
+    return ins;
+  }
+
+  void load(int props_id, const DataBlock *blk)
+  {
+    for (auto reg : propsRegistries)
+      reg->registerProps(props_id, blk);
+  }
+
+  void finishLoading(int props_id)
+  {
+    ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+    loadingProps[props_id].loader = nullptr;
+    interlocked_decrement(loadingCount);
+  }
+
+  // under write lock
+  void publishNames()
+  {
+    interlocked_release_store(staleLookups, 0);
+    const int publishedCount = namesSnapshots.empty() ? 0 : (int)namesSnapshots.back()->size();
+    if ((int)propNames.size() < (publishedCount ? publishedCount * 2 : 1))
+      return;
+    namesSnapshots.emplace_back(new FastHashNameMap(propNames));
+    interlocked_release_store_ptr(namesSnapshot, (const FastHashNameMap *)namesSnapshots.back().get());
+  }
 
   int registerProps(const char *name, const DataBlock *blk)
   {
     G_ASSERT(name != NULL);
     G_ASSERT(blk);
-    auto ins = propNames.insert(name);
-    if (ins.second) // if inserted
-      for (auto reg : propsRegistries)
-        reg->registerProps(ins.first, blk);
+    int id = getPropId(name);
+    if (id >= 0)
+      return id;
+    auto ins = insert(name, nullptr);
+    if (!ins.second) // registered by other thread meanwhile, or later entry of list which is being loaded
+    {
+      if (props_loader.listEntry < 0 || !list_load.isEntry(this, ins.first))
+        loadProps(ins.first, true);
+      return ins.first;
+    }
+    load(ins.first, blk);
+    finishLoading(ins.first);
     return ins.first;
   }
 
-  void addRegistry(propsreg::PropsRegistry &new_registry) { propsRegistries.insert(&new_registry); }
+  void addRegistry(propsreg::PropsRegistry &new_registry, bool parallel_load)
+  {
+    parallelLoad = (propsRegistries.empty() || parallelLoad) && parallel_load;
+    propsRegistries.insert(&new_registry);
+  }
 };
 
+// whether loader waits (maybe indirectly, via loaders of props it waits for) for waiter, under props_names_lock
+static bool is_waiting_for(const PropsLoader *loader, const PropsLoader *waiter)
+{
+  for (; loader; loader = loader->waitsForClass ? loader->waitsForClass->loadingProps[loader->waitsForId].loader : nullptr)
+    if (loader == waiter)
+      return true;
+  return false;
+}
+
+// Waits for (or loads) all entries of list before id. Entries wait only for earlier ones, and loader of the earliest not loaded one
+// doesn't wait, so it can't deadlock
+static void load_list_entries_before(int id)
+{
+  for (int i = interlocked_acquire_load(list_load.loadedUpTo); i < id; ++i)
+    list_load.cls->loadProps(i, true);
+  for (int upTo = interlocked_acquire_load(list_load.loadedUpTo); upTo < id;)
+  {
+    const int prev = interlocked_compare_exchange(list_load.loadedUpTo, id, upTo);
+    if (prev == upTo)
+      break;
+    upTo = prev;
+  }
+}
+
 static eastl::vector<ClassRegistry> class_registry;
 static FastHashNameMapT<eastl::string_view> type_classes; // key (strings) here are statically allocated
 
@@ -93,7 +342,7 @@ const char *propsreg::get_props_registered_name(int props_id, const char *class_
 
 bool propsreg::is_props_valid(int props_id, int prop_class_id)
 {
-  return (unsigned)props_id < class_registry[prop_class_id].propNames.size();
+  return (unsigned)props_id < (unsigned)class_registry[prop_class_id].size();
 }
 
 bool propsreg::is_props_valid(int props_id, const char *class_name)
@@ -125,14 +374,15 @@ void propsreg::cleanup_props()
     creg.cleanup();
 }
 
-void propsreg::register_props_class_internal(propsreg::PropsRegistry &new_registry, const char *prop_class, size_t len)
+void propsreg::register_props_class_internal(propsreg::PropsRegistry &new_registry, const char *prop_class, size_t len,
+  bool parallel_load)
 {
   G_ASSERT(prop_class != NULL);
   G_ASSERT(strlen(prop_class) == len);
   int classId = type_classes.addNameId(prop_class, (int)len);
   if (classId >= class_registry.size())
     class_registry.resize(classId + 1);
-  class_registry[classId].addRegistry(new_registry);
+  class_registry[classId].addRegistry(new_registry, parallel_load);
 }
 
 int propsreg::get_prop_class_dyn(const eastl::string_view &prop_class) { return type_classes.getNameId(prop_class); }
@@ -142,11 +392,49 @@ void propsreg::register_props_list(const DataBlock *blk, const char *class_name)
   int classId = type_classes.getNameId(class_name);
   G_ASSERT(classId >= 0);
   auto &reg = class_registry[classId];
-  for (int i = 0; i < blk->blockCount(); ++i)
+  // Names are inserted in list order, so ids of list are the same as with sequential registration. Props registered from load()
+  // of entries get ids after the list, ordered by entry, as load() of entry waits for all earlier ones to register new props (or
+  // to look up missing ones). Lookups from load() of later entries return -1 and pending earlier ones are loaded on demand.
+  bool parallel = reg.parallelLoad && props_loader.listEntry < 0;
+  int firstId = 0, endId = 0;
+  if (parallel)
+  {
+    ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+    parallel = !list_load.cls; // other list is being loaded
+    if (parallel)
+    {
+      firstId = reg.propNames.size();
+      for (int i = 0; i < blk->blockCount(); ++i)
+        reg.insertLocked(blk->getBlock(i)->getBlockName(), blk->getBlock(i));
+      endId = reg.propNames.size();
+      list_load.cls = &reg;
+      list_load.firstId = firstId;
+      list_load.endId = endId;
+      list_load.loadedUpTo = firstId;
+    }
+  }
+  if (!parallel)
+  {
+    for (int i = 0; i < blk->blockCount(); ++i)
+    {
+      const DataBlock *propBlk = blk->getBlock(i);
+      reg.registerProps(propBlk->getBlockName(), propBlk);
+    }
+    return;
+  }
+
+  if (firstId < endId)
   {
-    const DataBlock *propBlk = blk->getBlock(i);
-    reg.registerProps(propBlk->getBlockName(), propBlk);
+    threadpool::parallel_for(firstId, endId, 1, [&reg](uint32_t begin, uint32_t end, uint32_t) {
+      for (uint32_t id = begin; id < end; ++id)
+        reg.loadProps(id, false);
+    });
+    for (int id = firstId; id < endId; ++id) // some could be loaded on demand by other threads, and blocks of list must outlive it
+      reg.loadProps(id, true);
   }
+  ScopedLockWriteTemplate<OSReadWriteLock> lock(props_names_lock);
+  list_load.cls = nullptr;
+  reg.publishNames();
 }
 
 void propsreg::clear_props(const char *class_name)
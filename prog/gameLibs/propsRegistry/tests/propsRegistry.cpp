@@ -0,0 +1,178 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <propsRegistry/commonPropsRegistry.h>
+#include <ioSys/dag_dataBlock.h>
+#include <osApiWrappers/dag_miscApi.h>
+#include <util/dag_threadPool.h>
+#include <util/dag_string.h>
+
+// Props which refer to other props by name (and register nested ones) from load()
+struct TestProps
+{
+  int refId = -1;
+  bool refLoaded = false; // whether referred props were loaded when they were looked up
+  int nestedId = -1;
+  int64_t loadThreadId = 0;
+
+  static bool can_load(const DataBlock *) { return true; }
+  void load(const DataBlock *blk);
+};
+
+static const char *loading_class = nullptr;
+static const propsreg::CommonPropsRegistry<TestProps> *loading_registry = nullptr;
+
+void TestProps::load(const DataBlock *blk)
+{
+  sleep_msec(1); // so loads on different threads overlap
+  loadThreadId = get_current_thread_id();
+  if (const char *ref = blk->getStr("ref", nullptr))
+  {
+    refId = propsreg::get_props_id(ref, loading_class);
+    refLoaded = loading_registry->tryGetProps(refId) != nullptr;
+  }
+  if (const DataBlock *nested = blk->getBlockByName("nested"))
+    nestedId = propsreg::register_props(nested->getStr("name"), nested, loading_class);
+}
+
+static propsreg::CommonPropsRegistry<TestProps> seq_registry("test_seq");
+static propsreg::CommonPropsRegistry<TestProps> list_registry("test_list");
+static propsreg::CommonPropsRegistry<TestProps> refs_registry("test_refs");
+static propsreg::CommonPropsRegistry<TestProps> seq_refs_registry("test_seq_refs");
+static propsreg::CommonPropsRegistry<TestProps> nested_registry("test_nested");
+
+struct ThreadPoolFixture
+{
+  ThreadPoolFixture() { threadpool::init(3, 64); }
+  ~ThreadPoolFixture() { threadpool::shutdown(); }
+};
+
+TEST_FIXTURE(ThreadPoolFixture, ListIdsMatchSequentialRegistration)
+{
+  propsreg::register_props_class(seq_registry, "test_seq");
+  propsreg::register_props_class(list_registry, "test_list", true);
+  DataBlock list;
+  for (int i = 0; i < 32; ++i)
+    list.addNewBlock(String(0, "props_%d", i % 29)); // with duplicates
+  loading_class = "test_seq";
+  loading_registry = &seq_registry;
+  for (int i = 0; i < list.blockCount(); ++i)
+    propsreg::register_props(list.getBlock(i)->getBlockName(), list.getBlock(i), "test_seq");
+  loading_class = "test_list";
+  loading_registry = &list_registry;
+  propsreg::register_props_list(&list, "test_list");
+
+  for (int i = 0; i < list.blockCount(); ++i)
+  {
+    const char *name = list.getBlock(i)->getBlockName();
+    const int id = propsreg::get_props_id(name, "test_list");
+    CHECK_EQUAL(propsreg::get_props_id(name, "test_seq"), id);
+    CHECK(list_registry.tryGetProps(id) != nullptr);
+    CHECK_EQUAL(name, propsreg::get_props_registered_name(id, "test_list"));
+  }
+  CHECK(propsreg::is_props_valid(28, "test_list"));
+  CHECK(!propsreg::is_props_valid(29, "test_list"));
+  CHECK_EQUAL(-1, propsreg::get_props_id("unknown", "test_list"));
+  propsreg::clear_props("test_seq");
+  propsreg::clear_props("test_list");
+}
+
+// Classes which didn't opt in for parallel loading are loaded by calling thread
+TEST_FIXTURE(ThreadPoolFixture, DefaultListIsLoadedSequentially)
+{
+  propsreg::register_props_class(seq_registry, "test_seq");
+  loading_class = "test_seq";
+  loading_registry = &seq_registry;
+  DataBlock list;
+  for (int i = 0; i < 16; ++i)
+    list.addNewBlock(String(0, "props_%d", i))->setStr("ref", String(0, "props_%d", i + 1)); // not registered yet
+  propsreg::register_props_list(&list, "test_seq");
+
+  for (int i = 0; i < 16; ++i)
+  {
+    const TestProps *props = seq_registry.tryGetProps(i);
+    CHECK(props && props->loadThreadId == get_current_thread_id() && props->refId == -1);
+  }
+  propsreg::clear_props("test_seq");
+}
+
+// References (including cyclic ones) resolve to the same props as with sequential loading: later entries of list are not registered
+// yet, earlier ones are loaded
+TEST_FIXTURE(ThreadPoolFixture, CrossReferencesMatchSequentialLoading)
+{
+  propsreg::register_props_class(refs_registry, "test_refs", true);
+  propsreg::register_props_class(seq_refs_registry, "test_seq_refs");
+  constexpr int CHAIN_LENGTH = 30;
+  DataBlock list;
+  list.addNewBlock("a")->setStr("ref", "b");
+  list.addNewBlock("b")->setStr("ref", "a");
+  for (int i = 0; i < CHAIN_LENGTH; ++i)
+    list.addNewBlock(String(0, "c_%d", i))->setStr("ref", i + 1 < CHAIN_LENGTH ? String(0, "c_%d", i + 1).c_str() : "a");
+  for (int i = 0; i < CHAIN_LENGTH; ++i)
+    list.addNewBlock(String(0, "d_%d", i))->setStr("ref", i > 0 ? String(0, "d_%d", i - 1).c_str() : "c_0");
+  list.addNewBlock("e")->setStr("ref", "missing");
+
+  loading_class = "test_seq_refs";
+  loading_registry = &seq_refs_registry;
+  propsreg::register_props_list(&list, "test_seq_refs");
+  loading_class = "test_refs";
+  loading_registry = &refs_registry;
+  propsreg::register_props_list(&list, "test_refs");
+
+  for (int i = 0; i < list.blockCount(); ++i)
+  {
+    const TestProps *seq = seq_refs_registry.tryGetProps(i);
+    const TestProps *par = refs_registry.tryGetProps(i);
+    CHECK(seq && par);
+    if (seq && par)
+    {
+      CHECK_EQUAL(seq->refId, par->refId);
+      CHECK_EQUAL(seq->refLoaded, par->refLoaded);
+    }
+  }
+  const TestProps *b = refs_registry.tryGetProps(propsreg::get_props_id("b", "test_refs"));
+  CHECK(b && b->refId == 0 && b->refLoaded);
+  const TestProps *d = refs_registry.tryGetProps(propsreg::get_props_id("d_5", "test_refs"));
+  CHECK(d && d->refId == propsreg::get_props_id("d_4", "test_refs") && d->refLoaded);
+  propsreg::clear_props("test_seq_refs");
+  propsreg::clear_props("test_refs");
+}
+
+// Props registered from load() get ids after the list in order of entries which registered them, regardless of loading order
+TEST_FIXTURE(ThreadPoolFixture, NestedRegistrationIdsAreDeterministic)
+{
+  constexpr int COUNT = 16;
+  DataBlock list;
+  for (int i = 0; i < COUNT; ++i)
+  {
+    DataBlock *outer = list.addNewBlock(String(0, "outer_%d", i));
+    if (i > 0)
+      outer->setStr("ref", String(0, "inner_%d", i - 1)); // registered from load() of previous entry
+    DataBlock *nested = outer->addNewBlock("nested");
+    nested->setStr("name", String(0, "inner_%d", i));
+    nested->setStr("ref", String(0, "outer_%d", (i + 1) % COUNT));
+  }
+
+  for (int iter = 0; iter < 4; ++iter)
+  {
+    propsreg::register_props_class(nested_registry, "test_nested", true);
+    loading_class = "test_nested";
+    loading_registry = &nested_registry;
+    propsreg::register_props_list(&list, "test_nested");
+
+    for (int i = 0; i < COUNT; ++i)
+    {
+      const TestProps *outer = nested_registry.tryGetProps(i); // ids of list are in its order
+      CHECK(outer != nullptr);
+      if (!outer)
+        continue;
+      CHECK_EQUAL(COUNT + i, outer->nestedId);
+      CHECK_EQUAL(outer->nestedId, propsreg::get_props_id(String(0, "inner_%d", i), "test_nested"));
+      CHECK_EQUAL(i > 0 ? COUNT + i - 1 : -1, outer->refId);
+      CHECK_EQUAL(i > 0, outer->refLoaded);
+      const TestProps *inner = nested_registry.tryGetProps(outer->nestedId);
+      CHECK(inner && inner->refId == (i + 1 < COUNT ? -1 : 0)); // later entries are not registered yet
+    }
+    CHECK(propsreg::is_props_valid(COUNT * 2 - 1, "test_nested"));
+    CHECK(!propsreg::is_props_valid(COUNT * 2, "test_nested"));
+    propsreg::clear_props("test_nested");
+  }
+}
@@ -35,8 +35,47 @@ struct Cover
 };
 
 
+// Per cover data for queries, precomputed in the same order as covers (and scene nodes).
+// posDir is (x, z of cover position (middle of ground line), x, z of normalized cover dir), coneCos is cosine of half-angle
+// of protection cone around cover dir (the same for all covers)
+struct CoversQueryData
+{
+  Tab<vec4f> posDir;
+  Tab<float> posY;
+  float coneCos = 1.f;
+};
+
+struct CoverQuery
+{
+  Point3 pos = Point3(0, 0, 0); // position of agent looking for cover
+  float maxDist = 30.f;         // covers farther from pos are not considered
+  float maxHeightDiff = 4.f;    // same for vertical distance
+  float minThreatDist = 5.f;    // covers closer than that to any threat are rejected
+  float minCoveredPart = 1.f;   // part of threats which cover must protect from, (0..1]
+  float distWeight = 0.5f;      // score = covered part - distWeight * dist / maxDist
+};
+
+struct CoverQueryResult
+{
+  int coverIdx;
+  float score;
+};
+
 bool load(IGenLoad &crd, Tab<Cover> &covers_out);
 bool build(float max_tile_size, uint32_t split, const Tab<Cover> &covers, scene::TiledScene &scene_out);
+void build_query_data(const Tab<Cover> &covers, float cone_half_angle, CoversQueryData &data_out);
+
+// Finds up to max_count best (by score, descending) unoccupied covers protecting agent from threats.
+// occupied_bits is optional bit per cover index. With time_budget_usec > 0 stops when budget is exceeded and returns false,
+// results found so far are kept.
+bool find_best_covers(const CoversQueryData &data, const scene::TiledScene &scene, const CoverQuery &query,
+  dag::ConstSpan<Point3> threats, dag::ConstSpan<uint32_t> occupied_bits, int max_count, Tab<CoverQueryResult> &out,
+  int time_budget_usec = 0);
+// Same for several agents facing the same threats (i.e. squad), scene tiles are walked once for union of query areas.
+// Results for queries[i] are out[out_ofs[i]..out_ofs[i + 1]).
+bool find_best_covers_batch(const CoversQueryData &data, const scene::TiledScene &scene, dag::ConstSpan<CoverQuery> queries,
+  dag::ConstSpan<Point3> threats, dag::ConstSpan<uint32_t> occupied_bits, int max_count, Tab<CoverQueryResult> &out,
+  Tab<int> &out_ofs, int time_budget_usec = 0);
 
 void draw_cover(const Cover &cover, uint8_t alpha);
 void draw_debug(const Tab<Cover> &covers);
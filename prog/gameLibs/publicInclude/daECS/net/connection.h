@@ -64,8 +64,12 @@ public:
 
   void setEncryptionCtx(EncryptionCtx *ectx) { encryptionCtx = ectx; }
 
-  ObjectReplica *addObjectInScope(Object &obj); // Note: there is no 'remove' operation, objects removed from scope automatically on
-                                                // each update (unless 'setObjectInScopeAlways' is called)
+  // Note: there is no 'remove' operation, objects removed from scope automatically on each update (unless 'setObjectInScopeAlways' is
+  // called). 'priority' is relevance of object for this connection (e.g. by distance), it's multiplied by object's own priority (see
+  // Object::getReplicationPriority()), accumulated on each update while object stays dirty and defines replication order (i.e.
+  // objects with low priority are sent less often when budget is limited). Can be called again for object in scope to change priority.
+  // Objects set always in scope have their own priority only, unless they are also added with this method.
+  ObjectReplica *addObjectInScope(Object &obj, float priority = 1.f);
   ecs::entity_id_t setObjectInScopeAlways(Object &obj); // returns serverId of added object (or 0/invalid if addition failed)
   bool setEntityInScopeAlways(ecs::EntityId eid) override final;
   void clearObjectInScopeAlways(Object &obj);
@@ -98,6 +102,11 @@ public:
 
   void sendAckedPacket(const danet::BitStream &bs, int cur_time, int timeout_ms, uint8_t channel);
 
+  // Max bytes of replication (not creation/destruction) sent per syncStateUpdates() for this connection, 0 - unlimited.
+  // At least one packet is always sent, objects that didn't fit stay dirty and gain priority for the next update.
+  void setReplicationBudget(int bytes_per_update) { replicationBudgetBytes = bytes_per_update; }
+  int getReplicationBudget() const { return replicationBudgetBytes; }
+
   void update(int cur_time);
 
   void writeLastRecvdPacketAcks(danet::BitStream &bs);
@@ -155,6 +164,7 @@ private:
 
   int creationCurBytes = 0;
   int creationLastSentTime = 0;
+  int replicationBudgetBytes = 0;
 
   // If there is componentsSynced[server_cidx] is true
   //  serverToClientCidx[server_cidx] maps to client component. if serverToClientCidx[server_cidx] == invalid, then server component
@@ -53,6 +53,10 @@ public:
   ConnectionId getControlledBy() const { return controlledBy; }
   void setControlledBy(ConnectionId cid) { controlledBy = cid; }
   uint32_t getCreationOrder() const { return creationOrder; }
+  // Relevance of object for all connections (set from 'replication__priority' component on server), multiplied by per-connection
+  // priority given to Connection::addObjectInScope()
+  float getReplicationPriority() const { return replicationPriority; }
+  void setReplicationPriority(float priority);
 
   Object(const ecs::EntityManager &mgr, ecs::EntityId eid_, const ecs::ComponentsMap &map);
   ~Object();
@@ -93,6 +97,7 @@ private:
   uint16_t filteredComponentsBits = 0; // up to 16 filters. can be easily extended to 32 or 64 bits
   bool isReplicaFlag = false; // it actually is not even a bool (isReplica). if it's replica or not can be determ by connection type
   bool isMeantToBeDestroyed = false; // to be written by server-driven code
+  float replicationPriority = 1.f;
   static bool do_not_verify_destruction;
   static eastl::vector_set<ecs::EntityId> pending_destroys;
 
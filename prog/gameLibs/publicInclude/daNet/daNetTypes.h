@@ -107,8 +107,9 @@ namespace danet
 class BitStream;
 enum Options
 {
-  DUMP_REFLECTION = 1,        // dump all reflection var serialization and deserialization in log
-  AUTO_CONVERT_ENDIANESS = 2, // aut convert endianess in danet::BitStream
+  DUMP_REFLECTION = 1,           // dump all reflection var serialization and deserialization in log
+  AUTO_CONVERT_ENDIANESS = 2,    // aut convert endianess in danet::BitStream
+  NO_REFLECTION_ENCODE_PLAN = 4, // serialize every reflection var with its coder call (no precompiled per class plan)
 };
 extern uint32_t option_flags;
 
@@ -163,6 +163,7 @@ namespace danet
 class ReflectionVarMeta;
 class ReflectableObject;
 class ReplicatedObject;
+struct ReflectionEncodePlan;
 
 #define DANET_ENCODER_SIGNATURE int op, danet::ReflectionVarMeta *meta, const danet::ReflectableObject *ro, danet::BitStream *bs
 
@@ -286,6 +287,9 @@ public:
 
 private:
   uint32_t reflectionFlags;
+  const ReflectionEncodePlan *encodePlan; // built on first serialization, shared between objects with same vars layout
+
+  const ReflectionEncodePlan *getEncodePlan();
 
   // dummy mpi implementation
   virtual mpi::Message *dispatchMpiMessage(mpi::MessageID /*mid*/) { return NULL; }
@@ -298,6 +302,7 @@ protected: // only childs can create and delete this class
   ReflectableObject(mpi::ObjectID uid = mpi::INVALID_OBJECT_ID) :
     mpi::IObject(uid),
     reflectionFlags(EXCLUDED),
+    encodePlan(NULL),
     prevChanged(NULL),
     nextChanged(NULL),
     prev(NULL),
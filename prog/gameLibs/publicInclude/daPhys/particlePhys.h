@@ -9,6 +9,7 @@
 #include <math/dag_Point3.h>
 #include <math/dag_bounds3.h>
 #include <generic/dag_tab.h>
+#include <generic/dag_span.h>
 #include <util/dag_index16.h>
 
 class GeomNodeTree;
@@ -57,10 +58,13 @@ public:
   ParticlePoint *findParticle(dag::Index16 gn_node_id) const;
   int findParticleId(dag::Index16 gn_node_id) const;
   ParticlePoint *getParticle(int particle_id) const;
+  bool empty() const { return constraints.empty(); }
 
   void loadFromBlk(const DataBlock *blk, const GeomNodeTree *tree);
 
   void update();
+  // updates independent systems (of different objects) on threadpool workers
+  static void update_batch(dag::ConstSpan<ParticlePhysSystem *> systems);
   void updateGeomNodeTree(GeomNodeTree *tree, const TMatrix &render_space_tm);
 
   void renderDebug(const TMatrix &render_space_tm) const;
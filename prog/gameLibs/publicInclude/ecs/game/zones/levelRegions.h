@@ -15,5 +15,6 @@ ECS_DECLARE_RELOCATABLE_TYPE(LevelRegions);
 void create_level_splines(dag::ConstSpan<levelsplines::Spline> splines);
 void create_level_regions(dag::ConstSpan<levelsplines::Spline> splines, const DataBlock &regions_blk);
 const splineregions::SplineRegion *get_region_by_pos(const Point2 &pos);
+void get_regions_by_pos(dag::ConstSpan<Point2> pos, dag::Span<const splineregions::SplineRegion *> out_regions); // nullptr if none
 const char *get_region_name_by_pos(const Point2 &pos);
 void clean_up_level_entities();
@@ -16,6 +16,9 @@ namespace game
 {
 extern const BBox3 IDENTITY_BBOX3;
 void get_active_capzones_on_pos(const Point3 &pos, const char *tag_to_have_not_null, Tab<ecs::EntityId> &zones_in);
+// Batched version of get_active_capzones_on_pos, zones of points[i] are zones_in[zones_ofs[i]..zones_ofs[i + 1])
+void get_active_capzones_on_points(dag::ConstSpan<Point3> points, const char *tag_to_have_not_null, Tab<ecs::EntityId> &zones_in,
+  Tab<int> &zones_ofs);
 bool is_point_in_capzone(const Point3 &pos, ecs::EntityId zone_eid, float zone_scale = 1.f);
 bool is_entity_in_capzone(const ecs::EntityId eid, const ecs::EntityId zone_eid);
 bool is_point_in_poly_battle_area(const Point3 &pos, ecs::EntityId zone_eid);
@@ -7,6 +7,7 @@
 
 #include <EASTL/string.h>
 #include <EASTL/fixed_string.h>
+#include <frameTimeMetrics/frameTimeHistogram.h>
 
 class HudPrimitives;
 
@@ -32,6 +33,7 @@ class FrameTimeMetricsAggregator
   float lastAverageFps = 0.f;
   float lastMinFrameTime = 0.f;
   float lastMaxFrameTime = 0.f;
+  float lastP99FrameTime = 0.f;
   float minFrameTime = 0.f;
   float maxFrameTime = 0.f;
   float lastAverageLatency = 0.f;
@@ -39,6 +41,7 @@ class FrameTimeMetricsAggregator
   float lastAverageLatencyR = 0.f;
   PerfDisplayMode displayMode = PerfDisplayMode::OFF;
   bool achtung = false;
+  FrameTimeHistogram frameTimeHistogram;
 
 public:
   void update(float current_time_msec, uint32_t frame_no, float dt, PerfDisplayMode display_mode);
@@ -46,6 +49,7 @@ public:
   const auto &getLatencyInfoString() const { return latencyText; }
   float getLastMinFrameTime() const { return lastMinFrameTime; }
   float getLastMaxFrameTime() const { return lastMaxFrameTime; }
+  float getLastP99FrameTime() const { return lastP99FrameTime; }
   float getLastAverageFps() const { return lastAverageFps; }
   float getLastAverageFrameTime() const { return lastAverageFrameTime; }
   int getTextVersion() const { return textVersion; }
@@ -0,0 +1,76 @@
+//
+// Dagor Engine 6.5 - Game Libraries
+// Copyright (C) 2023  Gaijin Games KFT.  All rights reserved
+// (for conditions of use see prog/license.txt)
+//
+#pragma once
+
+#include <stdint.h>
+#include <math/dag_bits.h>
+
+// Log-linear (HDR-style) histogram of durations in microseconds, meant to be always enabled (e.g. on dedicated servers).
+// record() can be called from any thread without locks or allocations: each thread owns a shard and updates its counters with
+// relaxed loads and stores (no interlocked instructions), threads above MAX_SHARDS - 1 share the last shard with interlocked adds.
+// merge() only reads shard counters and keeps their last merged values, it is expected to be called at low capped rate (e.g. once
+// per several seconds) by one thread.
+class FrameTimeHistogram
+{
+public:
+  static constexpr int SUB_BUCKET_BITS = 4; // 16 linear buckets per power of 2, i.e. error is less than 1/16
+  static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static constexpr int BUCKETS_COUNT = (32 - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+  static constexpr int MAX_SHARDS = 16; // the last one is shared by threads above this count
+
+  struct Snapshot
+  {
+    uint32_t counts[BUCKETS_COUNT];
+    uint64_t count;
+    uint64_t sumUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+
+    Snapshot() { reset(); }
+    void reset();
+    void add(const Snapshot &other);
+    // lower bound of bucket which contains percentile (0..100) of recorded values, i.e. it is exact for values less than SUB_BUCKETS
+    uint32_t getPercentileUs(float percentile) const;
+    float getAverageUs() const { return count ? float(double(sumUs) / count) : 0.f; }
+  };
+
+  FrameTimeHistogram();
+
+  void record(uint32_t usec);
+  // adds everything recorded since previous merge() to out
+  void merge(Snapshot &out);
+
+  static int getBucket(uint32_t usec)
+  {
+    if (usec < SUB_BUCKETS)
+      return usec;
+    const int pow = __bsr_unsafe(int(usec)); // values above 2^31 are still fine: bit scan is unsigned
+    return ((pow - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) + ((usec >> (pow - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+  }
+  static uint32_t getBucketLowerBound(int bucket)
+  {
+    if (bucket < SUB_BUCKETS)
+      return bucket;
+    return uint32_t(SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << ((bucket >> SUB_BUCKET_BITS) - 1);
+  }
+
+private:
+  // counters only grow (and wrap around), so that writer doesn't need to be synchronized with merge()
+  struct alignas(64) Shard // cache line aligned so that threads don't write to same lines
+  {
+    volatile uint32_t counts[BUCKETS_COUNT];
+    volatile uint32_t sumUs; // wraps in ~71 minutes of recorded time, which is much longer than merge() period
+    volatile uint32_t minUs; // these two are reset by merge()
+    volatile uint32_t maxUs;
+  };
+  struct Merged
+  {
+    uint32_t counts[BUCKETS_COUNT];
+    uint32_t sumUs;
+  };
+  Shard shards[MAX_SHARDS];
+  Merged merged[MAX_SHARDS]; // values of shard counters at previous merge()
+};
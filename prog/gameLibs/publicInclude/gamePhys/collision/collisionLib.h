@@ -8,6 +8,7 @@
 #include <generic/dag_tab.h>
 
 #include <phys/dag_physDecl.h>
+#include <phys/dag_vehicle.h>
 #include <gamePhys/collision/collisionObject.h>
 #include <gamePhys/collision/physLayers.h>
 #include <scene/dag_physMat.h>
@@ -56,9 +57,10 @@ enum CollType : uint32_t
   ETF_HEIGHTMAP = 1 << 6,
   ETF_STATIC = 1 << 7,
   ETF_RI_TREES = 1 << 8,
-  ETF_RI_PHYS = 1 << 9, // Trace against PHYS_COLLIDABLE instead of TRACEABLE
+  ETF_RI_PHYS = 1 << 9,     // Trace against PHYS_COLLIDABLE instead of TRACEABLE
+  ETF_PHYS_WORLD = 1 << 10, // Trace bodies of physics world too (see phys_world_traceray_batch())
   ETF_DEFAULT = ETF_LMESH | ETF_HEIGHTMAP | ETF_FRT | ETF_RI | ETF_RESTORABLES | ETF_OBJECTS_GROUP | ETF_STRUCTURES,
-  ETF_ALL = -1 & ~ETF_RI_PHYS // Always specify use of phys collision explicitly
+  ETF_ALL = -1 & ~(ETF_RI_PHYS | ETF_PHYS_WORLD) // Always specify use of phys collision explicitly
 };
 
 enum class InitFlags
@@ -84,6 +86,19 @@ void term_collision_world();
 void destroy_static_collision();
 void clear_collision_world();
 
+// Additional collision worlds (e.g. several sessions on the same level in one server process) have their own physics world and
+// static collision bodies, but share static collision data (frt, landmesh, heightmap) with main world.
+// World is created with static collision which is already added to main world, static collision added later is added to all worlds.
+// Worlds must be destroyed before main one. All dacoll calls work with main world, additional worlds are used only by calls which
+// take world explicitly (world = nullptr is main one). Frt, landmesh, heightmap and rendinst traces don't depend on world, as
+// rendinst collision is shared by all worlds too, only ETF_PHYS_WORLD stage and game objects (see
+// set_gather_game_objects_on_ray_cb()) are queried in given world.
+struct CollisionWorld;
+CollisionWorld *create_collision_world();
+void destroy_collision_world(CollisionWorld *world);
+CollisionWorld *get_main_collision_world();
+PhysWorld *get_phys_world(const CollisionWorld *world); // nullptr for main world
+
 void set_add_instances_to_world(bool flag);
 void set_ttl_for_collision_instances(float value);
 
@@ -106,24 +121,35 @@ bool traceray_normalized_ri(const Point3 &p, const Point3 &dir, real &t, int *ou
   const TraceMeshFaces *handle = nullptr, rendinst::riex_handle_t skip_riex_handle = rendinst::RIEX_HANDLE_NULL);
 bool traceray_normalized_coll_type(const Point3 &p, const Point3 &dir, real &t, int *out_pmid, Point3 *out_norm,
   int flags = ETF_DEFAULT, rendinst::RendInstDesc *out_desc = nullptr, int *out_coll_type = nullptr, int ray_mat_id = -1,
-  const TraceMeshFaces *handle = nullptr);
+  const TraceMeshFaces *handle = nullptr, CollisionWorld *world = nullptr);
 bool traceray_normalized(const Point3 &p, const Point3 &dir, real &t, int *out_pmid, Point3 *out_norm, int flags = ETF_DEFAULT,
-  rendinst::RendInstDesc *out_desc = nullptr, int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr);
+  rendinst::RendInstDesc *out_desc = nullptr, int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr,
+  CollisionWorld *world = nullptr);
 
 bool rayhit_normalized_frt(const Point3 &p, const Point3 &dir, real t);
 bool rayhit_normalized_lmesh(const Point3 &p, const Point3 &dir, real t);
 bool rayhit_normalized_ri(const Point3 &p, const Point3 &dir, real t, rendinst::TraceFlags additional_trace_flags = {},
   int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr, rendinst::riex_handle_t skip_riex_handle = rendinst::RIEX_HANDLE_NULL);
 bool rayhit_normalized(const Point3 &p, const Point3 &dir, real t, int flags = ETF_DEFAULT, int ray_mat_id = -1,
-  const TraceMeshFaces *handle = nullptr, rendinst::riex_handle_t skip_riex_handle = rendinst::RIEX_HANDLE_NULL);
+  const TraceMeshFaces *handle = nullptr, rendinst::riex_handle_t skip_riex_handle = rendinst::RIEX_HANDLE_NULL,
+  CollisionWorld *world = nullptr);
 bool rayhit_normalized_transparency(const Point3 &p, const Point3 &dir, float t, float threshold = 1.f, int ray_mat_id = -1);
 
+// Same result for each trace as traceray_normalized() gives, rendinsts and physics world are queried once for all traces.
+// ri_desc is either empty or has description for each trace (invalidated if trace didn't hit rendinst)
 bool traceray_normalized_multiray(dag::Span<Trace> traces, dag::Span<rendinst::RendInstDesc> ri_desc, int flags = ETF_DEFAULT,
-  int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr);
+  int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr, CollisionWorld *world = nullptr);
+// Static world tracers for wheels of Bullet ray cars (IPhysVehicle::bulletSetStaticTracer() and bulletSetStaticMultiTracer()),
+// wheels traced one by one and in IPhysVehicle::bulletTraceWheelsBatch() get same results. Zero flags uninstall them.
+// Installed on init_collision_world() when phys{ staticWheelTraces:b=yes; } is in settings
+void set_vehicle_wheel_tracers(int flags = ETF_DEFAULT);
+bool vehicle_wheel_traceray(const Point3 &p, const Point3 &dir, float &t, Point3 &out_norm, int &out_pmid);
+void vehicle_wheel_trace_multiray(dag::Span<IPhysVehicle::WheelRay> rays);
 bool tracedown_normalized(const Point3 &p, real &t, int *out_pmid, Point3 *out_norm, int flags = ETF_DEFAULT,
-  rendinst::RendInstDesc *out_desc = nullptr, int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr);
+  rendinst::RendInstDesc *out_desc = nullptr, int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr,
+  CollisionWorld *world = nullptr);
 bool tracedown_normalized_multiray(dag::Span<Trace> traces, dag::Span<rendinst::RendInstDesc> ri_desc, int flags = ETF_DEFAULT,
-  int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr);
+  int ray_mat_id = -1, const TraceMeshFaces *handle = nullptr, CollisionWorld *world = nullptr);
 bool tracedown_hmap_cache_multiray(dag::Span<Trace> traces, const TraceMeshFaces *handle, Point3_vec4 *ray_start_pos_vec,
   Point3_vec4 *v_out_norm);
 
@@ -142,7 +168,8 @@ bool trace_game_objects(const Point3 &from, const Point3 &dir, float &t, Point3
 using GameObjectsCollisionsCb = eastl::fixed_function<6 * sizeof(void *), void(CollisionObject obj)>;
 typedef void (*gather_game_objects_collision_on_ray_cb)(const Point3 &from, const Point3 &to, float radius,
   GameObjectsCollisionsCb coll_cb);
-void set_gather_game_objects_on_ray_cb(gather_game_objects_collision_on_ray_cb cb);
+// game objects checked by sphere_cast_ex() and other shape casts in world (main one by default)
+void set_gather_game_objects_on_ray_cb(gather_game_objects_collision_on_ray_cb cb, CollisionWorld *world = nullptr);
 
 
 void tracemultiray_lmesh(dag::Span<Trace> &traces);
@@ -264,9 +291,25 @@ static constexpr int DEFAULT_SPHERE_CAST_MASK = EPL_ALL & ~(EPL_CHARACTER | EPL_
 bool sphere_cast_ex(const Point3 &from, const Point3 &to, float rad, ShapeQueryOutput &out, int cast_mat_id,
   dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle = nullptr, int mask = DEFAULT_SPHERE_CAST_MASK,
   int hmap_step = -1);
+bool sphere_cast_ex(CollisionWorld *world, const Point3 &from, const Point3 &to, float rad, ShapeQueryOutput &out, int cast_mat_id,
+  dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle = nullptr, int mask = DEFAULT_SPHERE_CAST_MASK,
+  int hmap_step = -1);
 bool box_cast_ex(const TMatrix &from, const TMatrix &to, Point3 rad, ShapeQueryOutput &out, int cast_mat_id,
   dag::ConstSpan<CollisionObject> ignore_objs, const TraceMeshFaces *handle, int mask, int hmap_step);
 
+// Batched queries against bodies of physics world only (frt, landmesh, heightmap, rendinsts which have bodies, game objects bodies),
+// unlike sphere_cast_ex() and traceray_normalized() rendinsts without created bodies are not checked. Run in parallel with Jolt.
+// Must not be called while physics simulation is running (see fetch_sim_res()).
+struct SphereCastDesc
+{
+  Point3 from, to;
+  float rad;
+};
+void phys_world_sphere_cast_batch(dag::ConstSpan<SphereCastDesc> casts, dag::Span<ShapeQueryOutput> out,
+  int mask = DEFAULT_SPHERE_CAST_MASK, CollisionWorld *world = nullptr);
+// traces must have normalized dir, on hit outT, outNorm and outMatId (PHYSMAT_DEFAULT) are updated, returns true if any trace hit
+bool phys_world_traceray_batch(dag::Span<Trace> traces, int mask = DEFAULT_SPHERE_CAST_MASK, CollisionWorld *world = nullptr);
+
 void draw_phys_body(const PhysBody *body);
 void draw_collision_object(const CollisionObject &co);
 void draw_collision_object(const CollisionObject &co, const TMatrix &tm);
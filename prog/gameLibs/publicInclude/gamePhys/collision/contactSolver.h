@@ -14,6 +14,7 @@
 #include <gamePhys/phys/commonPhysBase.h>
 #include <gamePhys/collision/collisionInfo.h>
 #include <gamePhys/collision/collisionLib.h>
+#include <gamePhys/collision/sweepAndPrune.h>
 
 #include <EASTL/bitset.h>
 
@@ -147,13 +148,22 @@ class ContactSolver
     void init(const BodyState &state_a, const BodyState &state_b);
   };
 
+  // range of constraints which share no bodies with other islands (ground excluded), solved independently
+  struct Island
+  {
+    int constraintsBegin = 0;
+    int constraintsEnd = 0;
+  };
+
   int atTick = 0;
 
   Cache cache;
 
   Tab<Body> bodies;
   Tab<BodyState> bodyStates;
-  Tab<Constraint> constraints;
+  Tab<Constraint> constraints; // grouped by islands
+  Tab<Island> islands;
+  gamephys::SweepAndPrune broadphase; // bounding spheres overlapping along X, kept between updates
 
   BodyState groundState;
 
@@ -161,10 +171,12 @@ class ContactSolver
   eastl::bitset<MAX_LAYERS_NUM * MAX_LAYERS_NUM> layersMask;
 
   BodyState &getState(int index);
+  BodyState &getState(int index, BodyState &ground) { return index >= 0 ? bodyStates[index] : ground; }
   void addFrictionConstraint(Constraint::Type type, const ContactManifoldPoint &info, double lambda, double friction,
     const DPoint3 &u);
   void addContactConstraint(const ContactManifoldPoint &info, double beta, double bias);
 
+  void gatherTestPairs(Tab<int> &test_pairs);
   void checkStaticCollisions(int body_no, const ContactSolver::Body &body, const TMatrix &tm, dag::Span<CollisionObject> coll_objects);
 
   void integrateVelocity(double dt);
@@ -174,8 +186,20 @@ class ContactSolver
   void initVelocityConstraints();
   void initPositionConstraints();
 
+  void buildIslands();
+  template <typename Cb>
+  void forEachIsland(Cb cb);
+  dag::Span<Constraint> getIslandConstraints(const Island &island)
+  {
+    return make_span(constraints.data() + island.constraintsBegin, island.constraintsEnd - island.constraintsBegin);
+  }
+
   void solveVelocityConstraints(double dt);
+  void solveIslandVelocityConstraints(const Island &island, double dt);
+  bool solveVelocityIteration(dag::Span<Constraint> island_constraints, BodyState &ground, double inv_dt);
   bool solvePositionConstraints();
+  bool solveIslandPositionConstraints(const Island &island);
+  bool solvePositionIteration(dag::Span<Constraint> island_constraints, BodyState &ground, int iteration, double &min_distance);
 
 public:
   enum Flags
@@ -0,0 +1,141 @@
+//
+// Dagor Engine 6.5 - Game Libraries
+// Copyright (C) 2023  Gaijin Games KFT.  All rights reserved
+// (for conditions of use see prog/license.txt)
+//
+#pragma once
+
+#include <generic/dag_tab.h>
+#include <memory/dag_framemem.h>
+#include <util/dag_stdint.h>
+#include <ska_hash_map/flat_hash_map2.hpp>
+#include <EASTL/sort.h>
+
+namespace gamephys
+{
+// Incremental sweep and prune along X with persistent set of pairs which intervals overlap (closed intervals).
+// Sorted endpoints and pairs are kept between updates. Objects move only a little per tick, so update costs about number of
+// objects plus number of endpoints swaps, pairs are added and removed only when endpoints of their objects swap.
+// Endpoints are sorted from scratch when number of objects or set of active ones changes.
+class SweepAndPrune
+{
+public:
+  // get_bounds(int idx, double &min_x, double &max_x) is called once for each object in order and returns false for inactive one.
+  // Objects indices must stay the same between updates, call reset() when they are shifted.
+  template <typename GetBounds>
+  void update(int count, GetBounds get_bounds);
+
+  // cb(int lower_idx, int higher_idx) for each pair of active objects which intervals overlap, in no particular order
+  template <typename Cb>
+  void forEachPair(Cb cb) const
+  {
+    for (uint64_t key : pairs)
+      cb(int(key >> 32), int(key & 0xFFFFFFFFu));
+  }
+
+  int getPairsCount() const { return int(pairs.size()); }
+
+  void reset()
+  {
+    clear_and_shrink(endpoints);
+    clear_and_shrink(active);
+    pairs.clear();
+  }
+
+private:
+  struct Endpoint
+  {
+    double value;
+    uint32_t idx : 31;
+    uint32_t isMax : 1;
+
+    // min goes before max of same value, so that touching intervals overlap
+    bool operator<(const Endpoint &rhs) const { return value < rhs.value || (value == rhs.value && !isMax && rhs.isMax); }
+  };
+
+  static uint64_t makeKey(uint32_t a, uint32_t b) { return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a; }
+
+  // default fibonacci policy takes only upper bits of hash, they barely change with lower index of pair, so mix both halves
+  struct PairHash
+  {
+    size_t operator()(uint64_t key) const { return size_t(uint32_t(key >> 32) * 0x9E3779B1u + uint32_t(key)); }
+  };
+
+  void rebuild(dag::ConstSpan<double> bounds);
+
+  Tab<Endpoint> endpoints;
+  Tab<bool> active;
+  ska::flat_hash_set<uint64_t, PairHash> pairs;
+};
+
+template <typename GetBounds>
+inline void SweepAndPrune::update(int count, GetBounds get_bounds)
+{
+  Tab<double> bounds(framemem_ptr());
+  bounds.resize(count * 2);
+  bool needRebuild = active.size() != count;
+  active.resize(count);
+  for (int i = 0; i < count; ++i)
+  {
+    const bool isActive = get_bounds(i, bounds[i * 2], bounds[i * 2 + 1]);
+    needRebuild |= active[i] != isActive;
+    active[i] = isActive;
+  }
+  if (needRebuild)
+  {
+    rebuild(bounds);
+    return;
+  }
+
+  // insertion sort, pair starts to overlap when min passes max of other object to the left and stops when max passes min
+  for (Endpoint &ep : endpoints)
+    ep.value = bounds[ep.idx * 2 + ep.isMax];
+  for (int i = 1, n = endpoints.size(); i < n; ++i)
+  {
+    const Endpoint ep = endpoints[i];
+    int j = i;
+    for (; j > 0 && ep < endpoints[j - 1]; --j)
+    {
+      const Endpoint &other = endpoints[j - 1];
+      if (!ep.isMax && other.isMax)
+        pairs.insert(makeKey(ep.idx, other.idx));
+      else if (ep.isMax && !other.isMax)
+        pairs.erase(makeKey(ep.idx, other.idx));
+      endpoints[j] = other;
+    }
+    endpoints[j] = ep;
+  }
+}
+
+inline void SweepAndPrune::rebuild(dag::ConstSpan<double> bounds)
+{
+  endpoints.clear();
+  pairs.clear();
+  for (int i = 0; i < active.size(); ++i)
+    if (active[i])
+    {
+      endpoints.push_back(Endpoint{bounds[i * 2], uint32_t(i), 0});
+      endpoints.push_back(Endpoint{bounds[i * 2 + 1], uint32_t(i), 1});
+    }
+  eastl::sort(endpoints.begin(), endpoints.end());
+
+  Tab<uint32_t> open(framemem_ptr());
+  for (const Endpoint &ep : endpoints)
+    if (!ep.isMax)
+    {
+      for (uint32_t idx : open)
+        pairs.insert(makeKey(ep.idx, idx));
+      open.push_back(ep.idx);
+    }
+    else
+    {
+      for (int i = 0; i < open.size(); ++i)
+        if (open[i] == ep.idx)
+        {
+          open[i] = open.back();
+          open.pop_back();
+          break;
+        }
+    }
+}
+} // namespace gamephys
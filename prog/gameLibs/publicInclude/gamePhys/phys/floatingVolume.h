@@ -8,6 +8,7 @@
 #include <math/dag_plane3.h>
 #include <gamePhys/collision/collisionLib.h>
 #include <gamePhys/phys/commonPhysBase.h>
+#include <EASTL/unique_ptr.h>
 
 namespace gamephys
 {
@@ -20,6 +21,56 @@ struct FloatingVolume
   Tab<BSphere3> floatingVolumes;
   float floatVolumesCd = 0.47f;
 };
+// Water heights sampled for volumes on previous ticks, see get_water_heights()
+struct WaterHeightsCache
+{
+  Point3 pos[MAX_VOLUMES];
+  float height[MAX_VOLUMES];
+  float time[MAX_VOLUMES];
+  float heightVel[MAX_VOLUMES]; // change rate of height between two last traces
+  int count = 0;
+
+  void reset() { count = 0; }
+};
+// Cached water height is reused while volume moved less than dist (in XZ) since it was traced and for no longer than time.
+// Height is reused only while it would drift less than maxHeightError at rate it changed with before, so fast waves are always traced.
+struct WaterHeightsReuse
+{
+  float dist = 0.f;
+  float time = 0.f;
+  float maxHeightError = 0.f;
+
+  bool isEnabled() const { return dist > 0.f && time > 0.f && maxHeightError > 0.f; }
+};
+// Cache owned by floating object, it is allocated only while heights reuse is enabled (so objects which never reuse heights
+// don't pay for it). Copy of object starts with empty cache, heights are traced again.
+class WaterHeightsCacheHolder
+{
+public:
+  WaterHeightsCacheHolder() = default;
+  WaterHeightsCacheHolder(const WaterHeightsCacheHolder &) {}
+  WaterHeightsCacheHolder(WaterHeightsCacheHolder &&) = default;
+  WaterHeightsCacheHolder &operator=(const WaterHeightsCacheHolder &)
+  {
+    cache.reset();
+    return *this;
+  }
+  WaterHeightsCacheHolder &operator=(WaterHeightsCacheHolder &&) = default;
+
+  // Returns cache to use with reuse (allocated on demand) or nullptr when reuse is disabled (and frees cache then).
+  WaterHeightsCache *prepare(const WaterHeightsReuse &reuse)
+  {
+    if (!reuse.isEnabled())
+      cache.reset();
+    else if (!cache)
+      cache = eastl::make_unique<WaterHeightsCache>();
+    return cache.get();
+  }
+  WaterHeightsCache *get() const { return cache.get(); }
+
+private:
+  eastl::unique_ptr<WaterHeightsCache> cache;
+};
 struct VolumeParams
 {
   bool canTraceWorld;
@@ -34,9 +85,18 @@ struct VolumeParams
 };
 bool init(FloatingVolume &volume, const DataBlock *floats_blk);
 bool update(const FloatingVolume &float_volume, float dt, const VolumeParams &params, DPoint3 &add_vel, DPoint3 &add_omega);
+// VolumeParams::waterPlane is ignored, water is traced under each volume at_time with get_water_heights(), cache is usually
+// taken from WaterHeightsCacheHolder::prepare() of ship.
+bool update(const FloatingVolume &float_volume, float at_time, float dt, const VolumeParams &params, DPoint3 &add_vel,
+  DPoint3 &add_omega, WaterHeightsCache *cache, const WaterHeightsReuse &reuse = {});
 // VolumeParams::waterPlane is ignored.
 bool update(const BSphere3 *volumes, int volume_count, float viscosity_cf, float dt, const VolumeParams &params,
   const float *water_dists, DPoint3 &add_vel, DPoint3 &add_omega);
+// Traces water heights under world positions of volumes (min coast dist for each is its radius + coast_dist_ofs).
+// With cache, previously traced height is used instead when allowed by reuse (reuse is disabled by default).
+void get_water_heights(const BSphere3 *volumes, int volume_count, const TMatrix &tm, float at_time, float trace_dist,
+  float coast_dist_ofs, Point3 *out_world_pos, float *out_heights, WaterHeightsCache *cache = nullptr,
+  const WaterHeightsReuse &reuse = {});
 bool update_visual(const FloatingVolume &volume, float at_time, const gamephys::Loc &visualLocation, float full_mass,
   bool can_trace_world);
 bool check_sailing(const FloatingVolume &volume, const gamephys::Loc &location, const Plane3 &water_plane);
@@ -31,6 +31,7 @@ struct RiFloatingPhys
   Point3 bboxHalfSize;
   Point2 xDir;
   int curTick = 0;
+  gamephys::floating_volumes::WaterHeightsCacheHolder waterHeights;
 };
 
 struct PhysFloatingModel
@@ -6,6 +6,9 @@
 #pragma once
 
 #include <math/dag_Point2.h>
+#include <math/dag_Point4.h>
+#include <math/dag_bounds2.h>
+#include <math/integer/dag_IPoint2.h>
 #include <math/dag_frustum.h>
 #include <generic/dag_carray.h>
 #include <generic/dag_smallTab.h>
@@ -50,8 +53,18 @@ public:
     mem_set_0(lodOffsets);
   }
   ~HeightmapHeightCulling();
-  void setUpDisplacement(float v) { displacementUpwardMaxOffset = v; };
-  void setDownDisplacement(float v) { displacementDownwardMaxOffset = v; };
+  void setUpDisplacement(float v)
+  {
+    displacementUpwardMaxOffset = v;
+    ++generation;
+  };
+  void setDownDisplacement(float v)
+  {
+    displacementDownwardMaxOffset = v;
+    ++generation;
+  };
+  // incremented whenever any min/max height may change
+  uint32_t getGeneration() const { return generation; }
 
 protected:
   static constexpr int HEIGHT_CULLING_BUFFER_SIZE = 128;
@@ -70,6 +83,7 @@ protected:
   int chunkSizeInTexels = 1;
   real absMin = MIN_REAL;
   real absMax = MAX_REAL;
+  uint32_t generation = 0;
 };
 
 struct LodGridCullData
@@ -83,10 +97,88 @@ struct LodGridCullData
   Point4 worldToLod0 = Point4::ZERO;
   bool useHWTesselation = true;
   eastl::optional<Frustum> frustum;
+  // when > 0, cull_lod_grid_candidates() culls with frustum planes pushed out by this distance and keeps patches while view frustum
+  // and view position stay within it
+  float reuseDist = 0;
+  // state of last cull_lod_grid_candidates() call, patches are reused as is while it matches
+  uint32_t candidatesGeneration = 0, tessGeneration = 0;
+  Point4 culledViewPosWaterLevel = Point4::ZERO;
+  eastl::optional<Frustum> culledFrustum; // view frustum of that call (not pushed out)
 
   LodGridCullData(IMemAlloc *mem = midmem) : patches(mem) {}
   int getCount() const { return patches.size(); }
-  void eraseAll() { patches.clear(); }
+  void eraseAll()
+  {
+    patches.clear();
+    candidatesGeneration = 0;
+  }
+};
+
+// Frustum independent part of lod grid culling: nodes of all lod rings around one grid origin with their height bounds.
+// It is rebuilt only when grid origin snaps to another cell or heights change, so it is reused between frames and shared
+// between all views culled around the same origin (main view, shadow cascades).
+struct LodGridCullCandidates
+{
+  static constexpr int CLUSTER_DIM = 4; // nodes are grouped in up to CLUSTER_DIM x CLUSTER_DIM clusters for hierarchical culling
+
+  struct Node
+  {
+    bbox3f box; // includes last lod water stretch
+    Point2 origin;
+    IPoint2 pos; // in node's lod units
+    float gridSize;
+    int lod;
+  };
+  struct Cluster
+  {
+    bbox3f box;
+    uint32_t first, count;
+  };
+
+  Tab<Node> nodes;
+  Tab<Cluster> clusters;
+  bbox3f box; // of all nodes
+  carray<uint32_t, LodGrid::MAX_LODS + 1> lodClusters; // clusters of lod are [lodClusters[lod], lodClusters[lod + 1])
+  LodGrid lodGrid;
+  Point2 originPos = Point2::ZERO;
+  Point4 worldToLod0 = Point4::ZERO;
+  float scaleX = 1;
+  int dim = default_patch_dim;
+  int numLods = 0;
+  int lod0SubDiv = 0;
+  int flipLod = 100000;
+  float lod0AreaRadius = 0;
+  bool useHWTesselation = true;
+  uint32_t generation = 0; // incremented on each rebuild, never 0 once built
+
+  // build parameters used to detect whether rebuild is needed
+  struct Key
+  {
+    Point4 originScaleAlign = Point4::ZERO; // snapped origin, scale, alignX
+    Point2 heights = Point2::ZERO;
+    float alignY = 0;
+    BBox2 clip;
+    int maxLod = 0, dim = 0, lod0SubDiv = 0;
+    uint32_t heightsGeneration = ~0u;
+    uint16_t lodsCount = 0, lodStep = 0, lastLodRad = 0;
+    float lastLodExtension = 0;
+    bool useHWTesselation = true;
+    bool operator==(const Key &k) const
+    {
+      return originScaleAlign == k.originScaleAlign && heights == k.heights && alignY == k.alignY && clip[0] == k.clip[0] &&
+             clip[1] == k.clip[1] && maxLod == k.maxLod && dim == k.dim && lod0SubDiv == k.lod0SubDiv &&
+             heightsGeneration == k.heightsGeneration && lodsCount == k.lodsCount && lodStep == k.lodStep &&
+             lastLodRad == k.lastLodRad && lastLodExtension == k.lastLodExtension && useHWTesselation == k.useHWTesselation;
+    }
+  } key;
+
+  LodGridCullCandidates(IMemAlloc *mem = midmem) : nodes(mem), clusters(mem) { mem_set_0(lodClusters); }
+  void clear()
+  {
+    clear_and_shrink(nodes);
+    clear_and_shrink(clusters);
+    key = Key();
+  }
 };
 
 class Occlusion;
@@ -97,3 +189,20 @@ void cull_lod_grid(const LodGrid &lodGrid, int max_lod, float originPosX, float
   const Occlusion *occlusion, float &out_lod0_area_radius, int dim = default_patch_dim, bool fight_t_junctions = true,
   const HeightmapHeightCulling *handler = NULL, const HMapTesselationData *hmap_tdata = NULL, BBox2 *lodsRegion = nullptr,
   float waterLevel = HeightmapHeightCulling::NO_WATER_ON_LEVEL, const Point3 *viewPos = nullptr);
+
+// Fills candidates with frustum independent nodes, same grid placement as cull_lod_grid() with the same parameters.
+// Returns false if candidates are already up to date and were kept as is.
+bool build_lod_grid_cull_candidates(const LodGrid &lodGrid, int max_lod, float originPosX, float originPosY, float scaleX,
+  float alignX, float alignY, float hMin, float hMax, const BBox2 *clip, LodGridCullCandidates &candidates, int dim = default_patch_dim,
+  const HeightmapHeightCulling *handler = NULL, bool hw_tesselation = true);
+
+// Per view part of culling. Cull data is kept from the previous call if neither candidates nor tesselation have changed since then,
+// and frustum planes and view position moved by no more than cull_data.reuseDist (see is_lod_grid_cull_reusable()). Temporal reuse
+// is disabled with occlusion. Returns false if cull data was kept. Safe to call concurrently for different cull_data.
+bool cull_lod_grid_candidates(const LodGridCullCandidates &candidates, const Frustum &frustum, LodGridCullData &cull_data,
+  const Occlusion *occlusion = nullptr, const HMapTesselationData *hmap_tdata = nullptr,
+  float waterLevel = HeightmapHeightCulling::NO_WATER_ON_LEVEL, const Point3 *viewPos = nullptr);
+// Whether patches of cull_data (result of cull_lod_grid_candidates()) include all patches visible with given parameters.
+bool is_lod_grid_cull_reusable(const LodGridCullCandidates &candidates, const Frustum &frustum, const LodGridCullData &cull_data,
+  const HMapTesselationData *hmap_tdata = nullptr, float waterLevel = HeightmapHeightCulling::NO_WATER_ON_LEVEL,
+  const Point3 *viewPos = nullptr);
@@ -14,6 +14,8 @@
 #include <math/integer/dag_IBBox2.h>
 #include <EASTL/bitvector.h>
 #include <generic/dag_smallTab.h>
+#include <generic/dag_carray.h>
+#include <osApiWrappers/dag_critSec.h>
 #include "heightmapRenderer.h"
 #include "heightmapCulling.h"
 #include "heightmapTesselationData.h"
@@ -66,10 +68,14 @@ public:
   bool prepare(const Point3 &world_pos, float camera_height, float water_level = HeightmapHeightCulling::NO_WATER_ON_LEVEL);
   void render(int min_tank_lod); // Uses parameters from prepare call.
 
-  void frustumCulling( // Independent from prepare for multithreading.
-    LodGridCullData &data, const Point3 &world_pos, float camera_height, const Frustum &frustum, int min_tank_lod,
+  // Independent from prepare for multithreading. Without occlusion grid nodes and their heights are built once and shared by all
+  // views until origin snaps or terrain changes, and results of recent views (main view, shadow cascades) are reused while their
+  // frustum and position stay within cull reuse distance (see setCullReuseDist()).
+  void frustumCulling(LodGridCullData &data, const Point3 &world_pos, float camera_height, const Frustum &frustum, int min_tank_lod,
     const Occlusion *occlusion, int lod0subdiv = 0, float lod0scale = 1.0f);
   void renderCulled(const LodGridCullData &);
+  // views are culled with frustum planes pushed out by dist (in meters) to reuse results in next frames, 0 reuses only same frustum
+  void setCullReuseDist(float dist) { cullReuseDist = dist; }
 
   void renderOnePatch(); // no tesselation, render whole area
   void invalidateCulling(const IBBox2 &);
@@ -125,6 +131,18 @@ protected:
   ska::flat_hash_set<int> heightChangesIndex;
   ska::flat_hash_map<uint32_t, uint16_t> visualHeights;
   HMapTesselationData hmapTData;
+
+  static constexpr int CULL_VIEWS_CACHE_SIZE = 8;
+  struct CachedCullView
+  {
+    LodGridCullData data;
+    uint32_t lastUsed = 0;
+  };
+  WinCritSec cullCacheCs;
+  LodGridCullCandidates cullCandidates[2]; // without and with hw tesselation (depth views don't use it)
+  carray<CachedCullView, CULL_VIEWS_CACHE_SIZE> cullViewsCache;
+  uint32_t cullViewsCounter = 0;
+  float cullReuseDist = 0.5f;
   UniqueTex hmapBuffer;
   bool needUpdate = true;
   bool enabledMipsUpdating = true;
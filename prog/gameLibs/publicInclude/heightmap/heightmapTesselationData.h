@@ -25,6 +25,8 @@ public:
   bool testRegionTesselated(const BBox2 &region) const;
   bool hasTesselation() const;
   float getTessCellSize() const;
+  // incremented whenever set of tesselated patches changes
+  uint32_t getGeneration() const { return generation; }
 
 private:
   void addTessRectImpl(const Matrix3 &transform33);
@@ -43,4 +45,5 @@ private:
   Point2 pivot = Point2::ZERO;
   Point2 worldSize = Point2::ZERO;
   float tessCellSize;
+  uint32_t generation = 0;
 };
@@ -30,6 +30,15 @@ void shutdown();
 void start(int deadline_ms);
 void stop();
 
+// Low overhead mode (e.g. for dedicated servers), alternative to start()/stop() pairs which rearm timer (syscall) every frame.
+// Single periodic timer checks whether tick() was called since previous check and, if frame is stalled for longer than deadline_ms,
+// collects backtraces of calling thread every sampling_interval_us until next tick(). At most max_stalls_per_min stalls are sampled.
+// Collecting never allocates (samples are stored within mem_budget). Note: start()/stop() are ignored in this mode.
+bool init_stall_detector(int deadline_ms, int sampling_interval_us = 10000, int max_stalls_per_min = 6, int mem_budget = 200 << 10,
+  int deadline_signal = LAGCATCHER_DEFAULT_DEADLINE_SIGNAL);
+// O(1), no syscalls, typically called once per frame/tick
+void tick();
+
 // stop collecting samples & clear collected data
 void clear();
 // stop collecting samples & flush collected samples to text file
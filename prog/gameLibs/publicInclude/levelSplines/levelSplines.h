@@ -112,6 +112,7 @@ class SplineIntersections
     float length;
     uint16_t fromNodeId;
     uint16_t toNodeId;
+    uint32_t lastUsed;
 
     Way() : nodes(midmem) { clear(); }
 
@@ -121,25 +122,34 @@ class SplineIntersections
       length = FLT_MAX;
       fromNodeId = 0xffff;
       toNodeId = 0xffff;
+      lastUsed = 0;
     }
   };
 
-  static const int CACHED_WAYS_NUM = 8;
+  static const int CACHED_WAYS_NUM = 32; // LRU
+  static const int MAX_LANDMARKS = 8;
 
   uint16_t size;
   Tab<IntersectionNode> nodes;
   SmallTab<IntersectionTableRecord, MidmemAlloc> table;
   int intersectionDataType;
 
+  // ALT (A*, landmarks, triangle inequality) data for EIDT_EDGES, landmarksCount values per node:
+  // shortest distances from landmarks to node and from node to landmarks (FLT_MAX when unreachable)
+  int landmarksCount;
+  SmallTab<float, MidmemAlloc> landmarkDistFrom, landmarkDistTo;
+
   mutable Way cachedWays[CACHED_WAYS_NUM];
-  mutable int currentWay;
+  mutable uint32_t waysUseCounter;
 
   Way *findWay(uint16_t fromNodeId, uint16_t toNodeId, int &nodeNum) const;
+  void buildLandmarks();
+  float estimateDist(uint16_t fromNodeId, uint16_t toNodeId) const;
 
   void resize(int count);
 
 public:
-  SplineIntersections() : size(0), intersectionDataType(0), nodes(midmem), currentWay(0) {}
+  SplineIntersections() : size(0), intersectionDataType(0), nodes(midmem), landmarksCount(0), waysUseCounter(0) {}
 
   void getNextIntersectionPoint(uint16_t fromNodeId, uint16_t toNodeId, IntersectionNodePoint &nextPoint) const;
   float getDist(uint16_t fromNodeId, uint16_t toNodeId) const;
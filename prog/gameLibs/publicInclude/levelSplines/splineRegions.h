@@ -6,8 +6,11 @@
 #pragma once
 
 #include <generic/dag_tab.h>
+#include <generic/dag_span.h>
 #include <math/dag_Point2.h>
+#include <math/dag_bounds2.h>
 #include <math/dag_polyUtils.h>
+#include <vecmath/dag_vecMathDecl.h>
 #include <levelSplines/levelSplines.h>
 #include <ioSys/dag_dataBlock.h>
 
@@ -43,6 +46,20 @@ struct SplineRegion
   float boundingRadius;
   Point3 center;
 
+  // Acceleration data for checkPoint(), built from convexes by buildAccel()
+  struct ConvexLines4 // up to 4 lines of convex in SoA, unused lanes never reject point
+  {
+    vec4f nx, ny, d;
+  };
+  Tab<ConvexLines4> accelLines;
+  Tab<int> accelLinesOfs; // convexes.size() + 1, ranges in accelLines
+  BBox2 accelBox;         // empty if some convex is unbounded, grid isn't used then
+  Point2 accelInvCellSize;
+  int accelGridW = 0, accelGridH = 0;
+  Tab<int> accelCellOfs;      // accelGridW * accelGridH + 1, ranges in accelCellConvexes
+  Tab<int> accelCellConvexes; // indices of convexes which bounds overlap cell
+
+  void buildAccel();
   bool checkPoint(const Point2 &pt) const;
   Point3 getAnyBorderPoint() const;
   Point3 getRandomBorderPoint() const;
@@ -58,4 +75,9 @@ struct SplineRegion
 
 void construct_region_from_spline(SplineRegion &region, const levelsplines::Spline &spline, float expand_dist = 0.f);
 void load_regions_from_splines(LevelRegions &regions, dag::ConstSpan<levelsplines::Spline> splines, const DataBlock &blk);
+
+// Index of first region which contains point, -1 if none
+int find_region(dag::ConstSpan<SplineRegion> regions, const Point2 &pt);
+// Batched find_region(), out_region_idx must have same size as points
+void find_regions(dag::ConstSpan<SplineRegion> regions, dag::ConstSpan<Point2> points, dag::Span<int> out_region_idx);
 }; // namespace splineregions
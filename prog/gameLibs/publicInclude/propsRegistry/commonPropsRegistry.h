@@ -6,18 +6,41 @@
 #pragma once
 
 #include <propsRegistry/propsRegistry.h>
-#include <EASTL/vector.h>
-#include <EASTL/unique_ptr.h>
+#include <osApiWrappers/dag_atomic.h>
 #include <ioSys/dag_dataBlock.h>
 #include <debug/dag_assert.h>
 #include <debug/dag_debug.h>
 
 namespace propsreg
 {
+// registerProps() can be called concurrently for different prop_id (see propsreg::register_props),
+// props are stored in chunks which are never moved, so getProps() is lock free and can be called meanwhile
 template <typename T>
 class CommonPropsRegistry : public PropsRegistry
 {
-  eastl::vector<eastl::unique_ptr<T>> propsRegistry;
+  static constexpr int CHUNK_BITS = 9;
+  static constexpr int CHUNK_SIZE = 1 << CHUNK_BITS;
+  static constexpr int MAX_CHUNKS = 128; // i.e. 64k props of class
+
+  struct Chunk
+  {
+    T *volatile props[CHUNK_SIZE];
+  };
+  mutable Chunk *volatile chunks[MAX_CHUNKS] = {}; // mutable only for atomic loads in const getters
+  volatile int propsCount = 0; // max registered prop_id + 1
+
+  Chunk *getChunkForWrite(int chunk_id)
+  {
+    if (Chunk *chunk = interlocked_acquire_load_ptr(chunks[chunk_id]))
+      return chunk;
+    Chunk *newChunk = new Chunk();
+    if (Chunk *chunk = interlocked_compare_exchange_ptr(chunks[chunk_id], newChunk, (Chunk *)nullptr)) // allocated by other thread
+    {
+      delete newChunk;
+      return chunk;
+    }
+    return newChunk;
+  }
 
 public:
 #if DAGOR_DBGLEVEL > 0
@@ -27,28 +50,61 @@ public:
   CommonPropsRegistry(const char *) {}
 #endif
 
+  ~CommonPropsRegistry() { clearProps(); }
+
   virtual void registerProps(int prop_id, const DataBlock *blk)
   {
-    if (prop_id >= propsRegistry.size())
-      propsRegistry.resize(prop_id + 1);
-    if (!propsRegistry[prop_id] && T::can_load(blk))
+    if ((unsigned)prop_id >= MAX_CHUNKS * CHUNK_SIZE)
+    {
+      logerr("%s: too many props, %d is registered for '%s'", __FUNCTION__, prop_id, blk ? blk->getBlockName() : "");
+      return;
+    }
+    Chunk *chunk = getChunkForWrite(prop_id >> CHUNK_BITS);
+    for (int count = interlocked_acquire_load(propsCount); count <= prop_id;)
+    {
+      const int prev = interlocked_compare_exchange(propsCount, prop_id + 1, count);
+      if (prev == count)
+        break;
+      count = prev;
+    }
+    T *volatile &slot = chunk->props[prop_id & (CHUNK_SIZE - 1)];
+    if (!interlocked_acquire_load_ptr(slot) && T::can_load(blk))
     {
       T *newProps = new T();
       newProps->load(blk);
-      propsRegistry[prop_id].reset(newProps);
+      interlocked_release_store_ptr(slot, newProps);
     }
   }
 
-  virtual void clearProps() { propsRegistry.clear(); }
+  // not thread safe, props must not be accessed meanwhile
+  virtual void clearProps()
+  {
+    for (Chunk *volatile &chunk : chunks)
+      if (chunk)
+      {
+        for (T *props : chunk->props)
+          delete props;
+        delete chunk;
+        chunk = nullptr;
+      }
+    propsCount = 0;
+  }
 
-  const T *tryGetProps(int prop_id) const { return (unsigned)prop_id < propsRegistry.size() ? propsRegistry[prop_id].get() : nullptr; }
+  const T *tryGetProps(int prop_id) const
+  {
+    if ((unsigned)prop_id >= (unsigned)interlocked_acquire_load(propsCount))
+      return nullptr;
+    const Chunk *chunk = interlocked_acquire_load_ptr(chunks[prop_id >> CHUNK_BITS]);
+    return chunk ? interlocked_acquire_load_ptr(chunk->props[prop_id & (CHUNK_SIZE - 1)]) : nullptr;
+  }
 
   const T *getProps(int prop_id) const
   {
 #if DAGOR_DBGLEVEL > 0
-    if (EASTL_UNLIKELY((unsigned)prop_id >= propsRegistry.size()))
+    const int count = interlocked_acquire_load(propsCount);
+    if (EASTL_UNLIKELY((unsigned)prop_id >= (unsigned)count))
     {
-      logerr("%s|%s: unsigned(%d) >= %d", __FUNCTION__, debugPropsClassName, prop_id, (int)propsRegistry.size());
+      logerr("%s|%s: unsigned(%d) >= %d", __FUNCTION__, debugPropsClassName, prop_id, count);
       return nullptr;
     }
 #endif
@@ -12,6 +12,13 @@ class DataBlock;
 
 namespace propsreg
 {
+// Props names can be registered and looked up from any thread, props classes are expected to be registered on startup.
+// registerProps() is called once per props_id. For classes registered with parallel_load, calls for different props_id run
+// concurrently on job threads within register_props_list(), so their loading (and loading of props it registers) must not modify
+// shared state without synchronization. Ids and props seen from load() are the same as with sequential registration, except that
+// props registered from load() of list entries get ids after the whole list.
+// get_props_id() returns id of loaded props (it loads pending ones of register_props_list() on demand), except for cyclic
+// references from props load(), and it is lock free when no props of class are being loaded.
 class PropsRegistry
 {
 public:
@@ -36,12 +43,13 @@ void cleanup_props();
 
 const char *get_props_registered_name(int props_id, const char *class_name);
 
-void register_props_class_internal(PropsRegistry &new_registry, const char *prop_class, size_t length);
+void register_props_class_internal(PropsRegistry &new_registry, const char *prop_class, size_t length, bool parallel_load);
+// parallel_load opts in for loading of props from register_props_list() on job threads, when all registries of class do it
 template <size_t N>
-inline void register_props_class(PropsRegistry &new_registry, const char (&prop_class)[N])
+inline void register_props_class(PropsRegistry &new_registry, const char (&prop_class)[N], bool parallel_load = false)
 {
   G_STATIC_ASSERT(N > 1); // not empty string
-  return register_props_class_internal(new_registry, &prop_class[0], N - 1);
+  return register_props_class_internal(new_registry, &prop_class[0], N - 1, parallel_load);
 }
 int get_prop_class_dyn(const eastl::string_view &prop_class);
 template <size_t N>
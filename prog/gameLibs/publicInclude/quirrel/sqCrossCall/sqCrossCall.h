@@ -17,4 +17,6 @@ SQInteger sq_cross_call(HSQUIRRELVM from, HSQUIRRELVM to, HSQOBJECT namespace_ob
 // * not all squirrel types are supported (i.e. only data types, not functions, weakrefs, etc...)
 // * unsafe, i.e. does not perform graph loop checks
 // * classes and instances are converted to tables
-bool sq_cross_push(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, String *err_msg);
+// With freeze == true all created containers (arrays, tables, blobs) are frozen, so result can be safely shared
+// between several consumers without further copying (only if caller asked for it, as consumers can't modify result).
+bool sq_cross_push(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, String *err_msg, bool freeze = false);
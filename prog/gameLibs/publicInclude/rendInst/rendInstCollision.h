@@ -132,6 +132,9 @@ bool traceRayRendInstsListAllNormalized(const Point3 &from, const Point3 &dir, f
 bool traceRayRIGenNormalized(dag::Span<Trace> traces, TraceFlags trace_flags, int ray_mat_id = -1,
   rendinst::RendInstDesc *ri_desc = nullptr, const TraceMeshFaces *ri_cache = nullptr,
   riex_handle_t skip_riex_handle = rendinst::RIEX_HANDLE_NULL);
+// Traces all rays in one traversal, out_ri_descs[i] is set if traces[i] hit rendinst (and isn't changed otherwise)
+bool traceRayRIGenNormalized(dag::Span<Trace> traces, dag::Span<RendInstDesc> out_ri_descs, TraceFlags trace_flags,
+  int ray_mat_id = -1, const TraceMeshFaces *ri_cache = nullptr, riex_handle_t skip_riex_handle = rendinst::RIEX_HANDLE_NULL);
 
 void initTraceTransparencyParameters(float tree_trunk_opacity, float tree_canopy_opacity);
 
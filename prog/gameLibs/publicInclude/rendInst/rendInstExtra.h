@@ -79,7 +79,12 @@ bool unregisterRiExtraDestructionCb(ri_destruction_cb cb);
 void onRiExtraDestruction(riex_handle_t id, bool is_dynamic, int32_t user_data = -1);
 bbox3f riex_get_lbb(int res_idx);
 float ries_get_bsph_rad(int res_idx);
-dag::ConstSpan<mat43f> riex_get_instance_matrices(int res_idx);
+// instances of pool (including dead ones), under riExtra read lock. Quantized transforms are decoded on access, so only
+// instances which are actually touched are decoded
+uint32_t riex_get_instance_count(int res_idx);
+bool riex_is_instance_valid(int res_idx, uint32_t inst_idx);
+mat43f riex_get_instance_matrix(int res_idx, uint32_t inst_idx);
+vec3f riex_get_instance_pos(int res_idx, uint32_t inst_idx);
 bool riex_is_instance_valid(const mat43f &ri_tm);
 
 void setGameClockForRIGenExtraDamage(const float *session_time);
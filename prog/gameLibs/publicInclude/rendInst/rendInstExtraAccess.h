@@ -25,7 +25,7 @@ bool get_riextra_immortality(riex_handle_t);
 uint32_t get_riextra_instance_seed(riex_handle_t);
 void set_riextra_instance_seed(riex_handle_t, int32_t data);
 
-const mat43f &getRIGenExtra43(riex_handle_t id);
+mat43f getRIGenExtra43(riex_handle_t id);
 void getRIGenExtra44(riex_handle_t id, mat44f &out_tm);
 
 void getRIExtraCollInfo(riex_handle_t id, CollisionResource **out_collision, BSphere3 *out_bsphere);
@@ -41,6 +41,36 @@ int getRIGenExtraParentForDestroyedRiIdx(uint32_t pool);
 bool isRIGenExtraDestroyedPhysResExist(uint32_t pool);
 int getRIGenExtraDestroyedRiIdx(uint32_t pool);
 vec4f getRIGenExtraBSphere(riex_handle_t id);
+
+// Lock-free snapshot of riExtra instance transforms and bspheres, disabled by default.
+// riex_publish_snapshot() is called once per frame on main thread (at the point where riExtra changes of frame are done),
+// it makes changes since previous publish visible and returns generation of front buffer.
+// Readers on any thread pin the last published buffer with riex_snapshot_acquire() and read it without taking riExtra lock,
+// all reads through one pin are from the same generation. Pinned buffer is never rewritten, publish is postponed (changes are
+// accumulated) while buffer it should write to is pinned, so pins are meant to be released within the frame.
+// Getters return false for dead instances and instances added after that publish.
+// Getters given non zero version (from riex_snapshot_instance_version()) also fail once instance slot is reused by other instance
+// (added while snapshot is enabled), handles themselves are never changed.
+struct RiexSnapshot;
+void riex_enable_snapshot(bool on); // publishes right away when enabled, all pins must be released before disabling
+uint32_t riex_publish_snapshot();
+const RiexSnapshot *riex_snapshot_acquire(); // nullptr if snapshot is disabled
+void riex_snapshot_release(const RiexSnapshot *snapshot);
+uint32_t riex_snapshot_generation(const RiexSnapshot *snapshot);
+uint16_t riex_snapshot_instance_version(const RiexSnapshot *snapshot, riex_handle_t id); // 0 if instance is not in snapshot
+bool riex_snapshot_get_tm(const RiexSnapshot *snapshot, riex_handle_t id, mat43f &out_tm, uint16_t version = 0);
+bool riex_snapshot_get_tm(const RiexSnapshot *snapshot, riex_handle_t id, mat44f &out_tm, uint16_t version = 0);
+bool riex_snapshot_get_bsphere(const RiexSnapshot *snapshot, riex_handle_t id, vec4f &out_xyzr, uint16_t version = 0);
+
+struct ScopedRiexSnapshot
+{
+  const RiexSnapshot *snapshot;
+  ScopedRiexSnapshot() : snapshot(riex_snapshot_acquire()) {}
+  ~ScopedRiexSnapshot() { riex_snapshot_release(snapshot); }
+  ScopedRiexSnapshot(const ScopedRiexSnapshot &) = delete;
+  ScopedRiexSnapshot &operator=(const ScopedRiexSnapshot &) = delete;
+  explicit operator bool() const { return snapshot != nullptr; }
+};
 // special values: 0 (default HP with regen), -1 (default HP no regen), -2 (invincible)
 void setRiGenExtraHp(riex_handle_t id, float hp);
 
@@ -10,6 +10,7 @@
 #include <rendInst/layerFlags.h>
 #include <3d/dag_texStreamingContext.h>
 #include <rendInst/riExtraRenderer.h>
+#include <generic/dag_span.h>
 
 
 struct RiGenVisibility;
@@ -60,6 +61,10 @@ void renderRIGenOptimizationDepth(RenderPass render_pass, const RiGenVisibility
   RenderGpuObjects gpu_objects = RenderGpuObjects::No, uint32_t instance_count_mul = 1,
   TexStreamingContext texCtx = TexStreamingContext(0));
 void renderRITreeDepth(const RiGenVisibility *visibility, const TMatrix &view_itm);
+// culls riGen for several shadow views (cascades) in one pass, renderRIGen(RenderPass::ToShadow, globtm, view_pos) of these views
+// uses prepared visibility instead of culling again until next prepare or clearPreparedRIGenShadowViews()
+void prepareRIGenShadowViews(dag::ConstSpan<mat44f> globtms, const Point3 &view_pos);
+void clearPreparedRIGenShadowViews();
 
 bool renderRIGenClipmapShadowsToTextures(const Point3 &sunDir0, bool for_sli, bool force_update = true);
 bool notRenderedClipmapShadowsBBox(BBox2 &box, int cascadeNo);
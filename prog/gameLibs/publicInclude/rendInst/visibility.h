@@ -10,6 +10,7 @@
 #include <3d/dag_texStreamingContext.h>
 #include <math/dag_frustum.h>
 #include <EASTL/fixed_function.h>
+#include <generic/dag_span.h>
 
 
 class Occlusion;
@@ -36,6 +37,14 @@ using VisibilityExternalFilter = eastl::fixed_function<sizeof(vec4f), bool(vec4f
 extern bool prepareRIGenVisibility(const Frustum &frustum, const Point3 &viewPos, RiGenVisibility *, bool forShadow,
   Occlusion *occlusion, bool for_visual_collision = false, const VisibilityExternalFilter &external_filter = {});
 
+// prepares visibility for several frustums sharing same view position (shadow cascades, cube faces) in one pass over cells.
+// visibilities[i] is filled for frustums[i] same as prepareRIGenVisibility would do it with occlusions[i] (if not empty),
+// views with forced lod are processed one by one.
+// returns false if nothing is visible in any of views
+extern bool prepareRIGenVisibilityMulti(dag::ConstSpan<Frustum> frustums, const Point3 &viewPos,
+  dag::ConstSpan<RiGenVisibility *> visibilities, bool forShadow, dag::ConstSpan<Occlusion *> occlusions = {},
+  const VisibilityExternalFilter &external_filter = {});
+
 extern void sortRIGenVisibility(RiGenVisibility *visibility, const Point3 &viewPos, const Point3 &viewDir, float vertivalFov,
   float horizontalFov, float areaThreshold);
 
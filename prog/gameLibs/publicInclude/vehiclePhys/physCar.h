@@ -9,6 +9,7 @@
 #include <math/dag_capsule.h>
 #include <phys/dag_physDecl.h>
 #include <3d/dag_texMgr.h>
+#include <generic/dag_span.h>
 
 class DynamicRenderableSceneInstance;
 class DynamicRenderableSceneLodsResource;
@@ -331,3 +332,7 @@ void get_raywheel_car_def_wheels(const char *car_name, String *front_and_rear[2]
 
 void set_global_car_wheel_friction_multiplier(float friction_mul);
 void set_global_car_wheel_friction_v_decay(float value);
+
+//! traces wheels of all actively simulated cars at once with static multi tracer (see IPhysVehicle::bulletSetStaticMultiTracer);
+//! call after physics simulation and before updateAfterSimulate() of cars
+void trace_raywheel_cars_wheels_batch(dag::ConstSpan<IPhysCar *> cars);
@@ -3,7 +3,7 @@
 #include <util/dag_string.h>
 #include <sqstdblob.h>
 
-static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int depth, String *err_msg = nullptr)
+static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int depth, String *err_msg = nullptr, bool freeze = false)
 {
   // In case of the same VM instead of pushing object reference make a deep copy
   // if (vm_from == vm_to)
@@ -15,6 +15,8 @@ static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int de
   SQInteger prevTopFrom = sq_gettop(vm_from), prevTopTo = sq_gettop(vm_to);
   (void)prevTopFrom;
   (void)prevTopTo;
+  if (idx < 0) // copy is pushed before source is read, which would shift relative index of the same VM
+    idx += prevTopFrom + 1;
 
   SQObjectType objType = sq_gettype(vm_from, idx);
   bool succeeded = true;
@@ -60,23 +62,25 @@ static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int de
     case OT_ARRAY:
     {
       SQInteger len = sq_getsize(vm_from, idx);
-      sq_push(vm_from, idx); // array working reference
-      SQInteger srcArrIdx = sq_gettop(vm_from);
       sq_newarray(vm_to, len);
       SQInteger dstArrIdx = sq_gettop(vm_to);
+      sq_push(vm_from, idx); // array working reference, after copy as vm_to can be the same VM (as with table)
+      SQInteger srcArrIdx = sq_gettop(vm_from);
       for (SQInteger i = 0; i < len; ++i)
       {
         sq_pushinteger(vm_from, i);
         G_VERIFY(SQ_SUCCEEDED(sq_get_noerr(vm_from, srcArrIdx))); // for array must always succeed
         SQInteger srcValIdx = sq_gettop(vm_from);
         sq_pushinteger(vm_to, i);
-        if (!repush(vm_from, srcValIdx, vm_to, depth + 1, err_msg))
+        if (!repush(vm_from, srcValIdx, vm_to, depth + 1, err_msg, freeze))
           succeeded = false;
 
         G_VERIFY(SQ_SUCCEEDED(sq_rawset(vm_to, dstArrIdx))); // for array must always succeed
         sq_pop(vm_from, 1);                                  // pop source item value
       }
       sq_pop(vm_from, 1); // array working reference
+      if (freeze)
+        G_VERIFY(SQ_SUCCEEDED(sq_freeze_inplace(vm_to, dstArrIdx)));
       break;
     }
     case OT_TABLE:
@@ -92,6 +96,8 @@ static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int de
         SQUserPointer destPtr = sqstd_createblob(vm_to, len);
         G_ASSERT(destPtr);
         memcpy(destPtr, blobData, len);
+        if (freeze)
+          G_VERIFY(SQ_SUCCEEDED(sq_freeze_inplace(vm_to, sq_gettop(vm_to))));
         break;
       }
 
@@ -104,9 +110,9 @@ static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int de
       while (SQ_SUCCEEDED(sq_next(vm_from, srcTableIdx)))
       {
         G_ASSERT(sq_gettop(vm_from) == iteratorIdx + 2);
-        if (!repush(vm_from, iteratorIdx + 1, vm_to, depth + 1, err_msg))
+        if (!repush(vm_from, iteratorIdx + 1, vm_to, depth + 1, err_msg, freeze))
           succeeded = false;
-        if (!repush(vm_from, iteratorIdx + 2, vm_to, depth + 1, err_msg))
+        if (!repush(vm_from, iteratorIdx + 2, vm_to, depth + 1, err_msg, freeze))
           succeeded = false;
 
         if (!succeeded)
@@ -125,6 +131,8 @@ static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int de
         sq_pop(vm_from, 2); // pops key and val before the next iteration
       }
       sq_pop(vm_from, 2); // pops the iterator and table
+      if (freeze)
+        G_VERIFY(SQ_SUCCEEDED(sq_freeze_inplace(vm_to, dstTableIdx)));
 
       break;
     }
@@ -151,9 +159,9 @@ static bool repush(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, int de
 }
 
 
-bool sq_cross_push(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, String *err_msg)
+bool sq_cross_push(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, String *err_msg, bool freeze)
 {
-  return repush(vm_from, idx, vm_to, 0, err_msg);
+  return repush(vm_from, idx, vm_to, 0, err_msg, freeze);
 }
 
 
@@ -124,7 +124,25 @@ static SQRESULT throw_send_error(HSQUIRRELVM vm_from, const char *err_msg, const
 }
 
 
-static SQInteger send_internal(HSQUIRRELVM vm_from, const char *evt_name, SQInteger idx, bool foreign_only, const char *source_id)
+static bool cross_push_message(HSQUIRRELVM vm_from, SQInteger idx, HSQUIRRELVM vm_to, bool freeze, String &err_msg, Sqrat::Object &msg)
+{
+  int prevTopTo = sq_gettop(vm_to);
+  if (!sq_cross_push(vm_from, idx, vm_to, &err_msg, freeze))
+  {
+    sq_settop(vm_to, prevTopTo);
+    return false;
+  }
+
+  HSQOBJECT hMsg;
+  sq_getstackobj(vm_to, -1, &hMsg);
+  msg = Sqrat::Object(hMsg, vm_to);
+  sq_settop(vm_to, prevTopTo);
+  return true;
+}
+
+
+static SQInteger send_internal(HSQUIRRELVM vm_from, const char *evt_name, SQInteger idx, bool foreign_only, const char *source_id,
+  bool shared = false)
 {
   SQInteger handledCount = 0;
   int prevTopFrom = sq_gettop(vm_from);
@@ -136,6 +154,10 @@ static SQInteger send_internal(HSQUIRRELVM vm_from, const char *evt_name, SQInte
 
   Tab<Sqrat::Function> handlersCopy(framemem_ptr());
 
+  // By default each handler gets its own deep copy of payload. If sender opted in for shared payload, all handlers of each VM get
+  // the same deep frozen copy. It is made for sender VM too: freeze() only marks reference, so sender can still change payload
+  // through other references to it.
+
   for (auto itVm = vms.begin(); itVm != vms.end(); ++itVm)
   {
     HSQUIRRELVM vm_to = itVm->first;
@@ -149,20 +171,24 @@ static SQInteger send_internal(HSQUIRRELVM vm_from, const char *evt_name, SQInte
 
     SqStackChecker stackCheckTo(vm_to);
 
-    for (Sqrat::Function &handler : handlersCopy)
+    Sqrat::Object sharedMsg;
+    if (shared)
     {
-      int prevTopTo = sq_gettop(vm_to);
-      if (!sq_cross_push(vm_from, idx, vm_to, &repushErrMsg))
+      if (!cross_push_message(vm_from, idx, vm_to, /*freeze*/ true, repushErrMsg, sharedMsg))
       {
-        sq_poptop(vm_to);
         String errMsg(0, "Cross-push failed, target VM = %p: %s", vm_to, repushErrMsg.c_str());
         return throw_send_error(vm_from, errMsg.c_str(), Sqrat::Var<Sqrat::Object>(vm_from, idx).value);
       }
+    }
 
-      HSQOBJECT hMsg;
-      sq_getstackobj(vm_to, -1, &hMsg);
-      Sqrat::Object msg = Sqrat::Object(hMsg, vm_to);
-      sq_settop(vm_to, prevTopTo);
+    for (Sqrat::Function &handler : handlersCopy)
+    {
+      Sqrat::Object msg = sharedMsg;
+      if (!shared && !cross_push_message(vm_from, idx, vm_to, /*freeze*/ false, repushErrMsg, msg))
+      {
+        String errMsg(0, "Cross-push failed, target VM = %p: %s", vm_to, repushErrMsg.c_str());
+        return throw_send_error(vm_from, errMsg.c_str(), Sqrat::Var<Sqrat::Object>(vm_from, idx).value);
+      }
 
       if (target.processingMode == ProcessingMode::IMMEDIATE)
       {
@@ -307,6 +333,16 @@ static SQInteger send(HSQUIRRELVM vm_from)
 }
 
 
+static SQInteger send_shared(HSQUIRRELVM vm_from)
+{
+  const char *eventName = nullptr;
+  sq_getstring(vm_from, 2, &eventName);
+  const char *vmId = nullptr;
+  G_VERIFY(SQ_SUCCEEDED(sq_getstring(vm_from, 4, &vmId)));
+  return send_internal(vm_from, eventName, 3, false, vmId, /*shared*/ true);
+}
+
+
 static SQInteger send_foreign(HSQUIRRELVM vm_from)
 {
   const char *eventName = nullptr;
@@ -491,6 +527,7 @@ void bind(SqModules *module_mgr, const char *vm_id, ProcessingMode mode)
     .SquirrelFunc("eventbus_unsubscribe", unsubscribe, 3, ".sc")
     .SquirrelFunc("send", send, 3, ".s.", nullptr, 1, &sqVmId)
     .SquirrelFunc("eventbus_send", send, 3, ".s.", nullptr, 1, &sqVmId)
+    .SquirrelFunc("eventbus_send_shared", send_shared, 3, ".s.", nullptr, 1, &sqVmId) // handlers get frozen payload
     .SquirrelFunc("send_foreign", send_foreign, 3, ".s.", nullptr, 1, &sqVmId)
     .SquirrelFunc("eventbus_send_foreign", send_foreign, 3, ".s.", nullptr, 1, &sqVmId)
     .SquirrelFunc("eventbus_has_listeners", has_listeners, 2, ".s", nullptr, 1, &sqVmId)
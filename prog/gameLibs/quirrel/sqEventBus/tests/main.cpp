@@ -0,0 +1 @@
+#include <unittest/main.inc.cpp>
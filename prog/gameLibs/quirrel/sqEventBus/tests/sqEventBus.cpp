@@ -0,0 +1,113 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <quirrel/sqEventBus/sqEventBus.h>
+#include <quirrel/sqModules/sqModules.h>
+#include <sqrat.h>
+#include <util/dag_string.h>
+#include <string.h>
+
+// Scripts are served from memory, each returns function which checks what handlers received and returns error text or null
+struct EventBusFixture : SqModules::IFileSystemOverride
+{
+  HSQUIRRELVM vm = nullptr;
+  SqModules *modules = nullptr;
+  const char *script = nullptr;
+
+  EventBusFixture()
+  {
+    vm = sq_open(1024);
+    modules = new SqModules(vm);
+    modules->setFileSystemOverride(this);
+    sqeventbus::bind(modules, "test", sqeventbus::ProcessingMode::MANUAL_PUMP);
+  }
+  ~EventBusFixture()
+  {
+    sqeventbus::unbind(vm);
+    delete modules;
+    sq_close(vm);
+  }
+
+  void resolveFileName(const char *requested_fn, String &res) override { res = requested_fn; }
+  bool readFile(const String &, const char *, Tab<char> &buf, String &) override
+  {
+    buf.resize(strlen(script));
+    memcpy(buf.data(), script, buf.size());
+    return true;
+  }
+
+  // runs script, pumps queued events and returns result of check function
+  String run(const char *code)
+  {
+    script = code;
+    Sqrat::Object exports;
+    String errMsg;
+    if (!modules->requireModule("test.nut", true, "test.nut", exports, errMsg))
+      return String(0, "script failed: %s", errMsg.c_str());
+    sqeventbus::process_events(vm);
+    Sqrat::Function check(vm, Sqrat::Object(vm).GetObject(), exports.GetObject());
+    Sqrat::Object res;
+    if (!check.Evaluate(res))
+      return String("check failed");
+    return res.IsNull() ? String() : String(res.GetVar<const char *>().value);
+  }
+};
+
+TEST_FIXTURE(EventBusFixture, SharedPayloadIsNotAliasedWithSender)
+{
+  String err = run(R"(
+let { eventbus_subscribe, eventbus_send_shared } = require("eventbus")
+let received = []
+eventbus_subscribe("test.shared", @(msg) received.append(msg))
+eventbus_subscribe("test.shared", function(msg) { received.append(msg) })
+
+// every level is passed by frozen reference, but freeze() marks only reference, objects stay mutable through other ones
+let inner = { b = 1 }
+let arr = [1, 2]
+let payload = { a = freeze(inner), arr = freeze(arr) }
+eventbus_send_shared("test.shared", freeze(payload))
+payload.x <- 1
+inner.b = 2
+arr.append(3)
+
+return function() {
+  if (received.len() != 2)
+    return $"handlers called {received.len()} times"
+  if (received[0] != received[1])
+    return "handlers got different copies"
+  let msg = received[0]
+  if ("x" in msg || msg.a.b != 1 || msg.arr.len() != 2)
+    return "handlers see changes made by sender after send"
+  local frozen = 0
+  try { msg.y <- 1 } catch (_) { frozen++ }
+  try { msg.a.b = 3 } catch (_) { frozen++ }
+  try { msg.arr.append(4) } catch (_) { frozen++ }
+  return frozen == 3 ? null : "payload is not deep frozen"
+}
+)");
+  CHECK_EQUAL("", err.c_str());
+}
+
+TEST_FIXTURE(EventBusFixture, RegularPayloadIsCopiedForEachHandler)
+{
+  String err = run(R"(
+let { eventbus_subscribe, eventbus_send } = require("eventbus")
+let received = []
+eventbus_subscribe("test.copied", @(msg) received.append(msg))
+eventbus_subscribe("test.copied", function(msg) { received.append(msg) })
+
+let payload = { a = { b = 1 } }
+eventbus_send("test.copied", payload)
+payload.a.b = 2
+
+return function() {
+  if (received.len() != 2)
+    return $"handlers called {received.len()} times"
+  if (received[0] == received[1] || received[0].a == received[1].a)
+    return "handlers share payload"
+  if (received[0].a.b != 1)
+    return "handlers see changes made by sender after send"
+  received[0].a.b = 3 // copies stay mutable
+  return received[1].a.b == 1 ? null : "handler changes are seen by other handler"
+}
+)");
+  CHECK_EQUAL("", err.c_str());
+}
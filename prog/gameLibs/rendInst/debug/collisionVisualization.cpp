@@ -272,8 +272,8 @@ static void get_ri_extra_collision(Tab<CollisionInfo> &out_collisions, mat44f_cr
 
       if (pool_vis != frustum.INSIDE)
       {
-        const float *src_mf = (const float *)&riPool.riTm[j];
-        Point3_vec4 pos(src_mf[3], src_mf[7], src_mf[11]);
+        Point3_vec4 pos;
+        v_st(&pos.x, riPool.riTm.getPos(j));
         unsigned dist2_i = bitwise_cast<unsigned, float>(lengthSq(pos - vpos) * rendinst::riExtraCullDistSqMul);
         if (dist2_i > riPool.distSqLOD_i[rendinst::RiExtraPool::MAX_LODS - 1])
           continue;
@@ -286,7 +286,7 @@ static void get_ri_extra_collision(Tab<CollisionInfo> &out_collisions, mat44f_cr
       v_stu_bbox3(info.localBBox, riPool.lbb);
 
       mat44f mat44;
-      v_mat43_transpose_to_mat44(mat44, riPool.riTm[j]);
+      riPool.riTm.get44(j, mat44);
       v_mat_43cu_from_mat44(info.tm.array, mat44);
 
       out_collisions.push_back(info);
@@ -75,7 +75,11 @@ void dumpAllCollisions(IGenSave &cb)
     cb.write(vertices.begin(), vertices.size() * sizeof(*vertices.data()));
 
     cb.writeInt(pool.riTm.size());
-    cb.write(pool.riTm.begin(), pool.riTm.size() * sizeof(mat43f));
+    for (uint32_t i = 0; i < pool.riTm.size(); ++i)
+    {
+      mat43f tm = pool.riTm.get(i);
+      cb.write(&tm, sizeof(tm));
+    }
   }
 }
 } // namespace rendinst
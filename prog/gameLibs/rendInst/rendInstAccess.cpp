@@ -157,7 +157,7 @@ static inline TMatrix getRIGenMatrixImpl(const rendinst::RendInstDesc &desc)
       tm = TMatrix::IDENT;
       return tm;
     }
-    v_mat43_transpose_to_mat44(tm44, rendinst::riExtra[desc.pool].riTm[desc.idx]);
+    rendinst::riExtra[desc.pool].riTm.get44(desc.idx, tm44);
     v_mat_43cu_from_mat44(tm.m[0], tm44);
     if (bLock)
       rendinst::ccExtra.unlockRead();
@@ -199,7 +199,7 @@ TMatrix rendinst::getRIGenMatrixDestr(const RendInstDesc &desc)
     {
       TMatrix tm;
       mat44f tm44;
-      v_mat43_transpose_to_mat44(tm44, riExtra[desc.pool].riTm[idx]);
+      riExtra[desc.pool].riTm.get44(idx, tm44);
       v_mat_43cu_from_mat44(tm.m[0], tm44);
       rendinst::ccExtra.unlockRead();
       return tm;
@@ -0,0 +1,286 @@
+#include "riGen/riCollisionCellCache.h"
+#include "riGen/genObjUtil.h"
+#include "riGen/riUtil.h"
+#include "riGen/riRotationPalette.h"
+
+#include <gameRes/dag_collisionResource.h>
+#include <osApiWrappers/dag_rwLock.h>
+#include <osApiWrappers/dag_atomic.h>
+#include <ska_hash_map/flat_hash_map2.hpp>
+#include <perfMon/dag_statDrv.h>
+#include <util/dag_convar.h>
+#include <memory/dag_framemem.h>
+#include <EASTL/sort.h>
+#include <EASTL/algorithm.h>
+#include <generic/dag_carray.h>
+
+
+#if DAGOR_DBGLEVEL > 0
+CONSOLE_BOOL_VAL("ri_coll", cell_cache, true);
+#else
+static constexpr bool cell_cache = true;
+#endif
+
+namespace rendinst::collcache
+{
+static constexpr int MAX_ENTRIES = 4096;
+static constexpr int EVICT_ENTRIES = MAX_ENTRIES / 4; // least recently used ones are dropped when cache is full
+static constexpr float INV_HASH_CELL_SIZE = 1.f / HASH_CELL_SIZE;
+static constexpr int MAX_LAYERS = 16; // same as rgLayer capacity
+
+struct Entry
+{
+  dag::Vector<Candidate> candidates;
+  BBox3 box;
+  carray<int, 4> cells;     // riGen cells region (x0, z0, x1, z1) candidates were gathered from
+  int cellsGeneration = 0;  // sum of generations of these cells when list was built
+  volatile int version = 0; // last world version entry was validated against, updated by readers
+  volatile int lastUsed = 0;
+  int epoch = 0;
+};
+
+static OSReadWriteLock cache_lock;
+static ska::flat_hash_map<uint64_t, Entry> entries;
+static volatile int cache_epoch = 0;
+static volatile int queries_counter = 0;
+static volatile int lists_built = 0;
+// per riGen cell of each layer, incremented whenever cell is (re)generated or freed, guarded by cache_lock
+static carray<dag::Vector<int>, MAX_LAYERS> cell_generations;
+
+static inline uint64_t make_key(int layer, int hx, int hz)
+{
+  return (uint64_t(layer) << 48) | (uint64_t(uint16_t(hz)) << 16) | uint64_t(uint16_t(hx));
+}
+
+static inline bool test_box_xz(bbox3f_cref a, bbox3f_cref b)
+{
+  vec4f a2d = v_perm_xzac(a.bmin, a.bmax), b2d = v_perm_xzac(b.bmin, b.bmax);
+  // a.min <= b.max && b.min <= a.max
+  return (v_signmask(v_cmp_gt(v_perm_xyab(a2d, b2d), v_perm_zwcd(b2d, a2d))) & 0xF) == 0;
+}
+
+// riGen cells which instances can intersect box, same region as in testObjToRIGenIntersectionNoCache
+static void get_cells_region(const RendInstGenData *rgl, bbox3f_cref box, carray<int, 4> &regions)
+{
+  const RendInstGenData::RtData &rtData = *rgl->rtData;
+  vec4f regionV = v_sub(v_perm_xzac(box.bmin, box.bmax), rgl->world0Vxz);
+  vec4f expandCellsRange = v_neg(
+    v_perm_xzac(v_max(v_sub(rtData.maxCellBbox.bmax, v_splats(rgl->cellSz)), v_zero()), v_min(rtData.maxCellBbox.bmin, v_zero())));
+  regionV = v_add(regionV, expandCellsRange);
+  regionV = v_max(v_add(v_mul(regionV, rgl->invGridCellSzV), v_make_vec4f(-1, -1, 1, 1)), v_zero());
+  regionV = v_min(regionV, rgl->lastCellXZXZ);
+  DECL_ALIGN16(int, r[4]);
+  v_sti(r, v_cvt_floori(regionV));
+  memcpy(regions.data(), r, sizeof(r));
+}
+
+// cache_lock must be locked
+static int get_cells_generation(int layer, const carray<int, 4> &regions, int cell_num_w)
+{
+  const dag::Vector<int> &gens = cell_generations[layer];
+  int sum = 0;
+  for (int z = regions[1]; z <= regions[3]; z++)
+    for (int cellI = z * cell_num_w + regions[0], cellE = cellI + regions[2] - regions[0]; cellI <= cellE; cellI++)
+      if (cellI < gens.size())
+        sum += gens[cellI];
+  return sum;
+}
+
+static void build_candidates(RendInstGenData *rgl, bbox3f_cref cell_box, const carray<int, 4> &regions, dag::Vector<Candidate> &out)
+{
+  const RendInstGenData::RtData &rtData = *rgl->rtData;
+  const float cellSz = rgl->grid2world * rgl->cellSz;
+  const int posStrideW = RIGEN_POS_STRIDE_B(rgl->perInstDataDwords) / 2;
+  const int tmStrideW = RIGEN_TM_STRIDE_B(rgl->perInstDataDwords) / 2;
+  constexpr int WORD_BITS = sizeof(eastl::BitvectorWordType) * CHAR_BIT;
+  for (int z = regions[1]; z <= regions[3]; z++)
+    for (int x = regions[0], cellI = z * rgl->cellNumW + regions[0]; x <= regions[2]; x++, cellI++)
+    {
+      const RendInstGenData::CellRtData *crt = rgl->cells[cellI].isReady();
+      if (!crt || !v_bbox3_test_box_intersect(crt->bbox[0], cell_box))
+        continue;
+      vec3f v_cell_add = crt->cellOrigin;
+      vec3f v_cell_mul = v_mul(rendinst::gen::VC_1div32767, v_make_vec4f(cellSz, crt->cellHeight, cellSz, 0));
+      for (int idx = 0; idx < RendInstGenData::SUBCELL_DIV * RendInstGenData::SUBCELL_DIV; idx++)
+      {
+        if (!v_bbox3_test_box_intersect(crt->bbox[idx + 1], cell_box))
+          continue;
+        for (int p = 0, pcnt = crt->pools.size(); p < pcnt; p++)
+        {
+          const RendInstGenData::CellRtData::SubCellSlice &scs = crt->getCellSlice(p, idx);
+          if (!scs.sz)
+            continue;
+          const eastl::BitvectorWordType bit = eastl::BitvectorWordType(1) << (p % WORD_BITS);
+          const bool isPosInst = (rtData.riPosInst.data()[p / WORD_BITS] & bit) != 0;
+          const bool paletteRotation = (rtData.riPaletteRotation.data()[p / WORD_BITS] & bit) != 0;
+          const CollisionResource *collRes = rtData.riCollRes[p].collRes;
+          const bbox3f collResBox = collRes ? collRes->vFullBBox : rtData.riCollResBb[p];
+          rendinst::gen::RotationPaletteManager::Palette palette;
+          if (isPosInst && paletteRotation)
+            palette = rendinst::gen::get_rotation_palette_manager()->getPalette({rtData.layerIdx, p});
+
+          const int16_t *data_s = (const int16_t *)(crt->sysMemData + scs.ofs);
+          const int strideW = isPosInst ? posStrideW : tmStrideW;
+          for (const int16_t *data = data_s, *data_e = data + scs.sz / 2; data < data_e; data += strideW)
+          {
+            // destroyed instances are kept, so that list stays valid if they are restored
+            Candidate c;
+            if (!isPosInst)
+            {
+              mat44f tm;
+              rendinst::gen::unpack_tm_full(tm, data, v_cell_add, v_cell_mul);
+              v_bbox3_init(c.wbb, tm, collResBox);
+            }
+            else if (paletteRotation)
+            {
+              vec3f v_pos, v_scale;
+              vec4i paletteId;
+              rendinst::gen::unpack_tm_pos(v_pos, v_scale, data, v_cell_add, v_cell_mul, paletteRotation, &paletteId);
+              mat44f tm;
+              v_mat44_compose(tm, v_pos, rendinst::gen::RotationPaletteManager::get_quat(palette, v_extract_xi(paletteId)), v_scale);
+              v_bbox3_init(c.wbb, tm, collResBox);
+            }
+            else
+            {
+              vec3f v_pos, v_scale;
+              rendinst::gen::unpack_tm_pos(v_pos, v_scale, data, v_cell_add, v_cell_mul, paletteRotation);
+              c.wbb.bmin = v_add(v_pos, v_mul(v_scale, collResBox.bmin));
+              c.wbb.bmax = v_add(v_pos, v_mul(v_scale, collResBox.bmax));
+            }
+            if (!test_box_xz(c.wbb, cell_box))
+              continue;
+            c.cellI = cellI;
+            c.dataOfs = int(intptr_t(data) - intptr_t(data_s));
+            c.pool = p;
+            c.subCell = idx;
+            c.flags = (isPosInst ? Candidate::POS_INST : 0) | (paletteRotation ? Candidate::PALETTE_ROTATION : 0);
+            out.push_back(c);
+          }
+        }
+      }
+    }
+}
+
+// instance intersecting several hash cells is returned only from the first of them (within query)
+static void append_candidates(dag::ConstSpan<Candidate> candidates, bbox3f_cref box, int hx, int hz, int x0, int z0,
+  Tab<Candidate> &out)
+{
+  for (const Candidate &c : candidates)
+  {
+    if (!v_bbox3_test_box_intersect(c.wbb, box))
+      continue;
+    const int ownerX = max((int)floorf(v_extract_x(c.wbb.bmin) * INV_HASH_CELL_SIZE), x0);
+    const int ownerZ = max((int)floorf(v_extract_z(c.wbb.bmin) * INV_HASH_CELL_SIZE), z0);
+    if (ownerX == hx && ownerZ == hz)
+      out.push_back(c);
+  }
+}
+
+// cache_lock must be write locked
+static void evict_least_recently_used(int query_no)
+{
+  // ages instead of raw counters, so that counter wrap around doesn't matter
+  dag::Vector<int, framemem_allocator> ages;
+  ages.reserve(entries.size());
+  for (const auto &it : entries)
+    ages.push_back(query_no - it.second.lastUsed);
+  eastl::nth_element(ages.begin(), ages.begin() + EVICT_ENTRIES - 1, ages.end(), eastl::greater<int>());
+  const int minAgeToEvict = ages[EVICT_ENTRIES - 1];
+  for (auto it = entries.begin(); it != entries.end();)
+    if (query_no - it->second.lastUsed >= minAgeToEvict)
+      it = entries.erase(it);
+    else
+      ++it;
+}
+
+bool gather_candidates(RendInstGenData *rgl, int layer, bbox3f_cref box, Tab<Candidate> &out)
+{
+  if (!cell_cache || (unsigned)layer >= MAX_LAYERS)
+    return false;
+  vec3f size = v_bbox3_size(box);
+  if (v_extract_x(size) > MAX_QUERY_SIZE || v_extract_z(size) > MAX_QUERY_SIZE)
+    return false;
+
+  const int x0 = (int)floorf(v_extract_x(box.bmin) * INV_HASH_CELL_SIZE);
+  const int z0 = (int)floorf(v_extract_z(box.bmin) * INV_HASH_CELL_SIZE);
+  const int x1 = (int)floorf(v_extract_x(box.bmax) * INV_HASH_CELL_SIZE);
+  const int z1 = (int)floorf(v_extract_z(box.bmax) * INV_HASH_CELL_SIZE);
+  const int epoch = interlocked_acquire_load(cache_epoch);
+  const int queryNo = interlocked_increment(queries_counter);
+  for (int hz = z0; hz <= z1; ++hz)
+    for (int hx = x0; hx <= x1; ++hx)
+    {
+      const uint64_t key = make_key(layer, hx, hz);
+      const BBox3 hashCellBox(Point3(hx * HASH_CELL_SIZE, -MAX_REAL / 4, hz * HASH_CELL_SIZE),
+        Point3((hx + 1) * HASH_CELL_SIZE, MAX_REAL / 4, (hz + 1) * HASH_CELL_SIZE));
+      carray<int, 4> cellsRegion;
+      get_cells_region(rgl, v_ldu_bbox3(hashCellBox), cellsRegion);
+      int cellsGeneration;
+      {
+        ScopedLockReadTemplate<OSReadWriteLock> lock(cache_lock);
+        cellsGeneration = get_cells_generation(layer, cellsRegion, rgl->cellNumW);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.epoch == epoch && it->second.cellsGeneration == cellsGeneration &&
+            !memcmp(it->second.cells.data(), cellsRegion.data(), sizeof(cellsRegion)))
+        {
+          Entry &entry = it->second;
+          const int prevVersion = interlocked_relaxed_load(entry.version);
+          int version = prevVersion; // world_version_check() may modify it, entry is shared between readers
+          if (riutil::world_version_check(version, entry.box))
+          {
+            // so that next queries take fast path, unless other reader has already stored its version
+            if (version != prevVersion)
+              interlocked_compare_exchange(entry.version, version, prevVersion);
+            interlocked_relaxed_store(entry.lastUsed, queryNo);
+            append_candidates(entry.candidates, box, hx, hz, x0, z0, out);
+            continue;
+          }
+        }
+      }
+
+      TIME_PROFILE_DEV(ri_coll_cell_cache_build);
+      Entry entry;
+      entry.epoch = epoch;
+      entry.lastUsed = queryNo;
+      entry.version = riutil::world_version_get(); // taken before build, so changes made meanwhile invalidate entry
+      entry.box = hashCellBox;
+      entry.cells = cellsRegion;
+      entry.cellsGeneration = cellsGeneration; // same, taken before build
+      build_candidates(rgl, v_ldu_bbox3(entry.box), cellsRegion, entry.candidates);
+      interlocked_increment(lists_built);
+      append_candidates(entry.candidates, box, hx, hz, x0, z0, out);
+
+      ScopedLockWriteTemplate<OSReadWriteLock> lock(cache_lock);
+      if (entries.size() >= MAX_ENTRIES && entries.find(key) == entries.end())
+        evict_least_recently_used(queryNo);
+      entries[key] = eastl::move(entry);
+    }
+  return true;
+}
+
+void invalidate_cell(const RendInstGenData *rgl, int cell_idx)
+{
+  const int layer = eastl::find(rgLayer.begin(), rgLayer.end(), rgl) - rgLayer.begin();
+  if (layer >= rgLayer.size() || layer >= MAX_LAYERS)
+  {
+    invalidate();
+    return;
+  }
+  ScopedLockWriteTemplate<OSReadWriteLock> lock(cache_lock);
+  dag::Vector<int> &gens = cell_generations[layer];
+  if (gens.size() < rgl->cells.size())
+    gens.resize(rgl->cells.size(), 0);
+  gens[cell_idx]++;
+}
+
+void invalidate()
+{
+  interlocked_increment(cache_epoch);
+  ScopedLockWriteTemplate<OSReadWriteLock> lock(cache_lock);
+  entries.clear();
+  for (dag::Vector<int> &gens : cell_generations)
+    gens.clear();
+}
+
+int get_built_lists_count() { return interlocked_acquire_load(lists_built); }
+} // namespace rendinst::collcache
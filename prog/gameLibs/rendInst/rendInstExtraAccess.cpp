@@ -54,7 +54,7 @@ void rendinst::set_riextra_instance_seed(rendinst::riex_handle_t handle, int32_t
   rendinst::set_instance_user_data(nodeId, 1, &data);
 }
 
-const mat43f &rendinst::getRIGenExtra43(riex_handle_t id)
+mat43f rendinst::getRIGenExtra43(riex_handle_t id)
 {
   uint32_t res_idx = handle_to_ri_type(id);
   uint32_t idx = handle_to_ri_inst(id);
@@ -63,11 +63,11 @@ const mat43f &rendinst::getRIGenExtra43(riex_handle_t id)
   if (idx >= pool.riTm.size())
   {
     logerr("%s idx out of range: idx=%d, count=%d (res_idx=%d)", __FUNCTION__, idx, pool.riTm.size(), res_idx);
-    static mat43f m43;
+    mat43f m43;
     m43.row0 = m43.row1 = m43.row2 = v_zero();
     return m43;
   }
-  return pool.riTm[idx];
+  return pool.riTm.get(idx);
 }
 
 namespace rendinst
@@ -0,0 +1,252 @@
+#include <rendInst/rendInstExtraAccess.h>
+#include <rendInst/rendInstExtra.h>
+
+#include "riGen/riExtraSnapshot.h"
+#include "riGen/riGenExtra.h"
+
+#include <osApiWrappers/dag_atomic.h>
+#include <osApiWrappers/dag_miscApi.h>
+#include <perfMon/dag_statDrv.h>
+#include <dag/dag_vector.h>
+
+
+namespace rendinst::snapshot
+{
+// more changes than that between two publishes are cheaper to copy as a whole
+static constexpr int MAX_DIRTY = 1 << 16;
+
+struct PoolData
+{
+  dag::Vector<mat43f> tm; // zero rows for dead instances, same as RiExtraPool::riTm
+  dag::Vector<vec4f> xyzr;
+  dag::Vector<uint16_t> version; // of instance slot, see riex_snapshot_instance_version()
+};
+} // namespace rendinst::snapshot
+
+struct rendinst::RiexSnapshot
+{
+  dag::Vector<snapshot::PoolData> pools;
+  uint32_t generation = 0;
+  volatile int readers = 0;
+  bool needFullCopy = true;
+};
+
+namespace rendinst::snapshot
+{
+using Buffer = RiexSnapshot;
+
+static Buffer buffers[2];
+static Buffer *volatile front = nullptr;
+// changes made since last publish, and changes already published to front buffer but not yet to back one
+static dag::Vector<riex_handle_t> dirtyCur, dirtyPrev;
+// per pool, per instance slot version, incremented on each add to slot (under riExtra write lock)
+static dag::Vector<dag::Vector<uint16_t>> slotVersions;
+static volatile int enabled = 0;
+static uint32_t lastGeneration = 0;
+
+static uint16_t get_slot_version(uint32_t res_idx, uint32_t idx)
+{
+  return res_idx < slotVersions.size() && idx < slotVersions[res_idx].size() ? slotVersions[res_idx][idx] : 0;
+}
+
+static void copy_instance(PoolData &dst, const RiExtraPool &pool, uint32_t res_idx, uint32_t idx)
+{
+  dst.tm[idx] = pool.riTm.get(idx);
+  dst.xyzr[idx] = pool.riXYZR[idx];
+  dst.version[idx] = get_slot_version(res_idx, idx);
+}
+
+static void copy_pool(PoolData &dst, const RiExtraPool &pool, uint32_t res_idx, uint32_t from)
+{
+  const uint32_t cnt = pool.riTm.size();
+  dst.tm.resize(cnt);
+  dst.xyzr.resize(cnt);
+  dst.version.resize(cnt);
+  for (uint32_t i = from; i < cnt; ++i)
+    copy_instance(dst, pool, res_idx, i);
+}
+
+static void apply_dirty(PoolData *pools, dag::ConstSpan<riex_handle_t> dirty)
+{
+  for (riex_handle_t h : dirty)
+  {
+    const uint32_t resIdx = handle_to_ri_type(h), idx = handle_to_ri_inst(h);
+    if (idx < pools[resIdx].tm.size())
+      copy_instance(pools[resIdx], riExtra[resIdx], resIdx, idx);
+  }
+}
+
+static void update_buffer(Buffer &buf)
+{
+  if (buf.pools.size() != riExtra.size())
+    buf.needFullCopy = true;
+  if (buf.needFullCopy)
+  {
+    buf.pools.resize(riExtra.size());
+    for (int p = 0; p < riExtra.size(); ++p)
+      copy_pool(buf.pools[p], riExtra[p], p, 0);
+    buf.needFullCopy = false;
+    return;
+  }
+  for (int p = 0; p < riExtra.size(); ++p) // pools grow and shrink from the end only, new instances are copied here
+    if (buf.pools[p].tm.size() != riExtra[p].riTm.size())
+      copy_pool(buf.pools[p], riExtra[p], p, min<uint32_t>(buf.pools[p].tm.size(), riExtra[p].riTm.size()));
+  apply_dirty(buf.pools.data(), dirtyPrev);
+  apply_dirty(buf.pools.data(), dirtyCur);
+}
+
+void mark_dirty(riex_handle_t id)
+{
+  if (!interlocked_relaxed_load(enabled))
+    return;
+  if (dirtyCur.size() < MAX_DIRTY)
+  {
+    dirtyCur.push_back(id);
+    return;
+  }
+  buffers[0].needFullCopy = buffers[1].needFullCopy = true;
+  dirtyCur.clear();
+  dirtyPrev.clear();
+}
+
+void mark_added(riex_handle_t id)
+{
+  if (!interlocked_relaxed_load(enabled))
+    return;
+  const uint32_t resIdx = handle_to_ri_type(id), idx = handle_to_ri_inst(id);
+  if (resIdx >= slotVersions.size())
+    slotVersions.resize(resIdx + 1);
+  dag::Vector<uint16_t> &versions = slotVersions[resIdx];
+  if (idx >= versions.size())
+    versions.resize(idx + 1, 0);
+  if (!++versions[idx]) // 0 is reserved for unchecked reads
+    versions[idx] = 1;
+  mark_dirty(id);
+}
+
+void reset()
+{
+  interlocked_release_store_ptr(front, (Buffer *)nullptr);
+  for (Buffer &buf : buffers)
+  {
+    G_ASSERTF(!interlocked_acquire_load(buf.readers), "riExtra snapshot is reset while pinned");
+    clear_and_shrink(buf.pools);
+    buf.needFullCopy = true;
+  }
+  clear_and_shrink(dirtyCur);
+  clear_and_shrink(dirtyPrev);
+  clear_and_shrink(slotVersions);
+}
+
+static const PoolData *get_pool_data(const Buffer *buf, riex_handle_t id, uint16_t version, uint32_t &idx)
+{
+  if (!buf || id == RIEX_HANDLE_NULL)
+    return nullptr;
+  const uint32_t resIdx = handle_to_ri_type(id);
+  idx = handle_to_ri_inst(id);
+  if (resIdx >= buf->pools.size() || idx >= buf->pools[resIdx].tm.size())
+    return nullptr;
+  const PoolData &pool = buf->pools[resIdx];
+  if (version && pool.version[idx] != version) // slot was reused by other instance
+    return nullptr;
+  const uint64_t *p0 = (const uint64_t *)&pool.tm[idx].row0; // same as RiExtraPool::isValid()
+  if (!p0[0] && !p0[1])
+    return nullptr;
+  return &pool;
+}
+} // namespace rendinst::snapshot
+
+using namespace rendinst::snapshot;
+
+void rendinst::riex_enable_snapshot(bool on)
+{
+  G_ASSERT(is_main_thread());
+  {
+    ScopedRIExtraWriteLock wr;
+    if (!on)
+      reset();
+    interlocked_relaxed_store(enabled, on ? 1 : 0);
+  }
+  if (on)
+    riex_publish_snapshot(); // so readers get snapshot right away and never fall back to live data
+}
+
+uint32_t rendinst::riex_publish_snapshot()
+{
+  if (!interlocked_relaxed_load(enabled))
+    return 0;
+  G_ASSERT(is_main_thread());
+  TIME_PROFILE(riex_publish_snapshot);
+  ScopedRIExtraReadLock rd; // excludes writers, dirty lists are modified only under write lock or here
+  Buffer *frontBuf = interlocked_relaxed_load_ptr(front);
+  Buffer &back = frontBuf == &buffers[0] ? buffers[1] : buffers[0];
+  // Readers pin buffer by incrementing its counter and then checking that it is still front one, so once back buffer is seen
+  // unpinned here, late readers of it will see other front and unpin it without reading
+  if (interlocked_acquire_load(back.readers))
+    return frontBuf ? frontBuf->generation : 0; // changes stay in dirtyCur till next publish
+  update_buffer(back);
+  back.generation = ++lastGeneration;
+  interlocked_release_store_ptr(front, &back);
+  eastl::swap(dirtyPrev, dirtyCur);
+  dirtyCur.clear();
+  return back.generation;
+}
+
+const rendinst::RiexSnapshot *rendinst::riex_snapshot_acquire()
+{
+  for (;;)
+  {
+    Buffer *buf = interlocked_acquire_load_ptr(front);
+    if (!buf)
+      return nullptr;
+    interlocked_increment(buf->readers);
+    if (interlocked_acquire_load_ptr(front) == buf)
+      return buf;
+    interlocked_decrement(buf->readers); // was republished meanwhile, it can be rewritten already
+  }
+}
+
+void rendinst::riex_snapshot_release(const RiexSnapshot *snapshot)
+{
+  if (snapshot)
+    interlocked_decrement(const_cast<RiexSnapshot *>(snapshot)->readers);
+}
+
+uint32_t rendinst::riex_snapshot_generation(const RiexSnapshot *snapshot) { return snapshot ? snapshot->generation : 0; }
+
+uint16_t rendinst::riex_snapshot_instance_version(const RiexSnapshot *snapshot, riex_handle_t id)
+{
+  uint32_t idx;
+  const PoolData *pool = get_pool_data(snapshot, id, 0, idx);
+  return pool ? pool->version[idx] : 0;
+}
+
+bool rendinst::riex_snapshot_get_tm(const RiexSnapshot *snapshot, riex_handle_t id, mat43f &out_tm, uint16_t version)
+{
+  uint32_t idx;
+  const PoolData *pool = get_pool_data(snapshot, id, version, idx);
+  if (!pool)
+    return false;
+  out_tm = pool->tm[idx];
+  return true;
+}
+
+bool rendinst::riex_snapshot_get_tm(const RiexSnapshot *snapshot, riex_handle_t id, mat44f &out_tm, uint16_t version)
+{
+  uint32_t idx;
+  const PoolData *pool = get_pool_data(snapshot, id, version, idx);
+  if (!pool)
+    return false;
+  v_mat43_transpose_to_mat44(out_tm, pool->tm[idx]);
+  return true;
+}
+
+bool rendinst::riex_snapshot_get_bsphere(const RiexSnapshot *snapshot, riex_handle_t id, vec4f &out_xyzr, uint16_t version)
+{
+  uint32_t idx;
+  const PoolData *pool = get_pool_data(snapshot, id, version, idx);
+  if (!pool)
+    return false;
+  out_xyzr = pool->xyzr[idx];
+  return true;
+}
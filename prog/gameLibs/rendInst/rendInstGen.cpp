@@ -6,10 +6,12 @@
 #include "riGen/riGenExtra.h"
 #include "riGen/riRotationPalette.h"
 #include "riGen/riGenData.h"
+#include "riGen/riCollisionCellCache.h"
 
 #include <util/dag_stlqsort.h>
 #include <util/dag_finally.h>
 #include <rendInst/rendInstGen.h>
+#include <rendInst/rendInstExtraAccess.h>
 #include <shaders/dag_rendInstRes.h>
 #include <shaders/dag_shaderResUnitedData.h>
 #include <regExp/regExp.h>
@@ -260,6 +262,7 @@ RendInstGenData::~RendInstGenData()
   }
   for (int i = 0; i < cells.size(); i++)
     del_it(cells[i].rtData);
+  rendinst::collcache::invalidate();
 
   if (unregCollCb && rtData)
     for (int i = 0; i < rtData->riCollRes.size(); i++)
@@ -2102,6 +2105,7 @@ static int scheduleRIGenPrepare(RendInstGenData *rgl, dag::ConstSpan<Point3> poi
         this->smd = eastl::exchange(crt->sysMemData, nullptr); // Stash to delete later
       rgl->rtData->loaded.delInt(idx);
       rgl->rtData->toUnload.delInt(idx);
+      rendinst::collcache::invalidate_cell(rgl, idx);
       if (wasReady)
       {
         int cell_stride = rgl->cellNumW;
@@ -2179,6 +2183,7 @@ static int scheduleRIGenPrepare(RendInstGenData *rgl, dag::ConstSpan<Point3> poi
         if (crt->sysMemData) // if is ready
           rgl->rtData->loadedCellsBBox += IPoint2(cx, cz);
         interlocked_release_store_ptr(rgl->cells[idx].rtData, crt); // This makes cell "ready"
+        rendinst::collcache::invalidate_cell(rgl, idx);
         last = rgl->rtData->toLoad.empty();
       }
 
@@ -2565,6 +2570,7 @@ void rendinst::prepareRIGen(bool init_sec_ri_extra_here, const DataBlock *level_
         rgl->precomputeCell(*crt, x, z);
         ScopedLockWrite lock(rgl->rtData->riRwCs);
         cell.rtData = crt;
+        rendinst::collcache::invalidate_cell(rgl, cellId);
       }
   }
   debug_cp();
@@ -2586,6 +2592,7 @@ void rendinst::precomputeRIGenCellsAndPregenerateRIExtra()
         ri_count += rgl->precomputeCell(*crt, x, z);
         cell.rtData = crt;
       }
+  rendinst::collcache::invalidate();
   debug("%s done, ri_count=%d", __FUNCTION__, ri_count);
 }
 
@@ -2594,6 +2601,7 @@ void rendinst::updateRIGen(uint32_t curFrame, float dt)
   FOR_EACH_PRIMARY_RG_LAYER_DO (rgl)
     if (rgl->rtData)
       rgl->rtData->updateDebris(curFrame, dt);
+  riex_publish_snapshot(); // no-op unless enabled with riex_enable_snapshot()
 }
 void rendinst::initRiGenDebris(const DataBlock &ri_blk, FxTypeByNameCallback get_fx_type_by_name, bool init_sec_ri_extra_here)
 {
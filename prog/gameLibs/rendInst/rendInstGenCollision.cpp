@@ -6,6 +6,7 @@
 #include "riGen/riGenExtra.h"
 #include "riGen/riUtil.h"
 #include "riGen/riRotationPalette.h"
+#include "riGen/riCollisionCellCache.h"
 
 #include <gameRes/dag_collisionResource.h>
 #include <math/dag_mathUtils.h>
@@ -150,6 +151,52 @@ struct TraceRayStrat : public MaterialRayStrat
   }
 };
 
+// Stores description of hit rendinst for each trace. Traversal tests each instance against all traces and passes result of trace to
+// strategy, so trace is found by address of its pos
+struct TraceRayMultiDescStrat : public TraceRayStrat
+{
+  dag::Span<Trace> traces;
+  dag::Span<rendinst::RendInstDesc> descs;
+
+  TraceRayMultiDescStrat(PhysMat::MatID ray_mat, TraceFlags trace_flags, dag::Span<Trace> traces_,
+    dag::Span<rendinst::RendInstDesc> descs_) :
+    TraceRayStrat(ray_mat, trace_flags), traces(traces_), descs(descs_)
+  {}
+
+  void storeDesc(const Point3 &pos, int layer_idx, int idx, int pool, int offs, int cell_idx)
+  {
+    const int rayId = int(reinterpret_cast<const Trace *>(&pos) - traces.data()); // pos is first member of Trace
+    G_FAST_ASSERT(rayId >= 0 && rayId < traces.size());
+    descs[rayId] = rendinst::RendInstDesc(cell_idx, idx, pool, offs, layer_idx);
+  }
+
+  bool executeForMesh(CollisionResource *coll_res, mat44f_cref tm, const Point3 &pos, const Point3 &dir, float &out_t,
+    Point3 &out_norm, rendinst::RendInstDesc *ri_desc, bool &have_collision, int layer_idx, int idx, int pool, int offs,
+    int &out_mat_id, int cell_idx)
+  {
+    bool hit = false;
+    bool res = TraceRayStrat::executeForMesh(coll_res, tm, pos, dir, out_t, out_norm, ri_desc, hit, layer_idx, idx, pool, offs,
+      out_mat_id, cell_idx);
+    if (hit)
+      storeDesc(pos, layer_idx, idx, pool, offs, cell_idx);
+    have_collision |= hit;
+    return res;
+  }
+
+  bool executeForPos(CollisionResource *coll_res, mat44f_cref tm, const BBox3 &box, const Point3 &pos, const Point3 &dir,
+    float &out_t, Point3 &out_norm, rendinst::RendInstDesc *ri_desc, bool &have_collision, int layer_idx, int idx, int pool,
+    int offs, int &out_mat_id, int cell_idx, const BBox3 &bbox_all)
+  {
+    bool hit = false;
+    bool res = TraceRayStrat::executeForPos(coll_res, tm, box, pos, dir, out_t, out_norm, ri_desc, hit, layer_idx, idx, pool, offs,
+      out_mat_id, cell_idx, bbox_all);
+    if (hit)
+      storeDesc(pos, layer_idx, idx, pool, offs, cell_idx);
+    have_collision |= hit;
+    return res;
+  }
+};
+
 struct TraceRayListStrat : public TraceRayStrat
 {
   RendInstsIntersectionsList list;
@@ -1065,10 +1112,11 @@ static bool rayTestIndividualNoLock(dag::Span<Trace> traces, const rendinst::Ren
   return haveCollision;
 }
 
-bool traceRayRIGenNormalized(dag::Span<Trace> traces, TraceFlags trace_flags, int ray_mat_id, rendinst::RendInstDesc *out_ri_descs,
-  const TraceMeshFaces *ri_cache, rendinst::riex_handle_t skip_riex_handle)
+template <typename Strategy>
+static bool trace_ray_ri_gen_normalized(dag::Span<Trace> traces, bool trace_meshes, rendinst::RendInstDesc *out_ri_desc,
+  dag::Span<rendinst::RendInstDesc> out_ri_descs, Strategy &traceRayStrategy, const TraceMeshFaces *ri_cache,
+  rendinst::riex_handle_t skip_riex_handle)
 {
-  TraceRayStrat traceRayStrategy(ray_mat_id, trace_flags);
   bool ret = false;
   if (ri_cache)
   {
@@ -1081,14 +1129,31 @@ bool traceRayRIGenNormalized(dag::Span<Trace> traces, TraceFlags trace_flags, in
       ri_cache->rendinstCache.foreachValid(rendinst::GatherRiTypeFlag::RiGenTmAndExtra,
         [&](const rendinst::RendInstDesc &ri_desc, bool) {
           if (rendinst::isRgLayerPrimary(ri_desc.layer))
-            ret |= rayTestIndividualNoLock(traces, ri_desc, {}, traceRayStrategy, rayBox, skip_riex_handle);
+            ret |= rayTestIndividualNoLock(traces, ri_desc, out_ri_descs, traceRayStrategy, rayBox, skip_riex_handle);
         });
 
       return ret;
     }
     trace_utils::draw_trace_handle_debug_cast_result(ri_cache, traces, false, true);
   }
-  return rayTraverse(traces, bool(trace_flags & TraceFlag::Meshes), out_ri_descs, traceRayStrategy, skip_riex_handle);
+  return rayTraverse(traces, trace_meshes, out_ri_desc, traceRayStrategy, skip_riex_handle);
+}
+
+bool traceRayRIGenNormalized(dag::Span<Trace> traces, TraceFlags trace_flags, int ray_mat_id, rendinst::RendInstDesc *out_ri_descs,
+  const TraceMeshFaces *ri_cache, rendinst::riex_handle_t skip_riex_handle)
+{
+  TraceRayStrat traceRayStrategy(ray_mat_id, trace_flags);
+  return trace_ray_ri_gen_normalized(traces, bool(trace_flags & TraceFlag::Meshes), out_ri_descs, {}, traceRayStrategy, ri_cache,
+    skip_riex_handle);
+}
+
+bool traceRayRIGenNormalized(dag::Span<Trace> traces, dag::Span<rendinst::RendInstDesc> out_ri_descs, TraceFlags trace_flags,
+  int ray_mat_id, const TraceMeshFaces *ri_cache, rendinst::riex_handle_t skip_riex_handle)
+{
+  G_ASSERT_RETURN(out_ri_descs.size() == traces.size(), false);
+  TraceRayMultiDescStrat traceRayStrategy(ray_mat_id, trace_flags, traces, out_ri_descs);
+  return trace_ray_ri_gen_normalized(traces, bool(trace_flags & TraceFlag::Meshes), nullptr, out_ri_descs, traceRayStrategy,
+    ri_cache, skip_riex_handle);
 }
 
 
@@ -2146,7 +2211,7 @@ static CheckBoxRIResultFlags testObjToRIGenIntersectionNoCache(int layer, const
         continue;
 
       mat44f riTm;
-      v_mat43_transpose_to_mat44(riTm, pool.riTm[riIdx]);
+      pool.riTm.get44(riIdx, riTm);
       if (!objectBounding.testIntersection(riTm, pool.collRes->vFullBBox))
         continue;
 
@@ -2210,6 +2275,80 @@ static CheckBoxRIResultFlags testObjToRIGenIntersectionNoCache(int layer, const
   int cellXStride = rgl->cellNumW - (regions[2] - regions[0] + 1);
   if (!rgl->rtData->riProperties.empty()) // we cannot run on empty properties. In most cases it's just a second layer
   {
+    Tab<collcache::Candidate> candidates(framemem_ptr());
+    if (collcache::gather_candidates(rgl, layer, v_ldu_bbox3(obj_world_aabb), candidates))
+    {
+      int prevPool = -1;
+      bool ignorePool = false;
+      CollisionResource *collRes = nullptr;
+      bbox3f v_collResBox;
+      BBox3 localBBox;
+      rendinst::gen::RotationPaletteManager::Palette palette;
+      for (const collcache::Candidate &c : candidates)
+      {
+        const bool isPosInst = c.flags & collcache::Candidate::POS_INST;
+        if (isPosInst && (result & CheckBoxRIResultFlag::HasCollidableRi))
+          continue;
+        const RendInstGenData::CellRtData *crt = rgl->cells[c.cellI].isReady();
+        if (!crt)
+          continue;
+        if (c.pool != prevPool)
+        {
+          prevPool = c.pool;
+          const RendInstGenData::RendinstProperties &riProp = rgl->rtData->riProperties[c.pool];
+          collRes = rgl->rtData->riCollRes[c.pool].collRes;
+          ignorePool = strategy.shouldIgnoreRendinst(isPosInst, riProp.immortal, riProp.matId) ||
+                       (!collRes && strategy.isCollisionRequired());
+          v_collResBox = collRes ? collRes->vFullBBox : rgl->rtData->riCollResBb[c.pool];
+          v_stu_bbox3(localBBox, v_collResBox);
+          if (isPosInst && (c.flags & collcache::Candidate::PALETTE_ROTATION))
+            palette = rendinst::gen::get_rotation_palette_manager()->getPalette({layer, c.pool});
+        }
+        if (ignorePool)
+          continue;
+
+        const int16_t *data = (const int16_t *)(crt->sysMemData + crt->getCellSlice(c.pool, c.subCell).ofs + c.dataOfs);
+        if (isPosInst ? is_pos_rendinst_data_destroyed(data) : is_tm_rendinst_data_destroyed(data))
+          continue;
+        vec3f v_cell_add = crt->cellOrigin;
+        vec3f v_cell_mul = v_mul(rendinst::gen::VC_1div32767, v_make_vec4f(cellSz, crt->cellHeight, cellSz, 0));
+        rendinst::RendInstDesc riDesc(c.cellI, c.subCell, c.pool, c.dataOfs, layer);
+        if (!isPosInst)
+        {
+          mat44f riTm;
+          rendinst::gen::unpack_tm_full(riTm, data, v_cell_add, v_cell_mul);
+          if (!objectBounding.testIntersection(riTm, v_collResBox))
+            continue;
+          G_FAST_ASSERT(++numDebugCbExecs <= MAX_SANE_NUM_CB_EXECS);
+          result |= strategy.executeForTm(rgl, riDesc, riTm, localBBox);
+        }
+        else if (c.flags & collcache::Candidate::PALETTE_ROTATION)
+        {
+          vec3f v_pos, v_scale;
+          vec4i paletteId;
+          rendinst::gen::unpack_tm_pos(v_pos, v_scale, data, v_cell_add, v_cell_mul, true, &paletteId);
+          mat44f tm;
+          v_mat44_compose(tm, v_pos, rendinst::gen::RotationPaletteManager::get_quat(palette, v_extract_xi(paletteId)), v_scale);
+          G_FAST_ASSERT(++numDebugCbExecs <= MAX_SANE_NUM_CB_EXECS);
+          result |= strategy.executeForPos(rgl, riDesc, tm, localBBox);
+        }
+        else
+        {
+          vec3f v_pos, v_scale;
+          rendinst::gen::unpack_tm_pos(v_pos, v_scale, data, v_cell_add, v_cell_mul, false);
+          G_FAST_ASSERT(++numDebugCbExecs <= MAX_SANE_NUM_CB_EXECS);
+          result |= strategy.executeForPos(rgl, riDesc, v_pos, v_scale, localBBox);
+        }
+#if DA_PROFILER_ENABLED
+        testedNum++;
+        trianglesNum += collRes ? collRes->getTrianglesCount(CollisionNode::PHYS_COLLIDABLE) : 0;
+#endif
+        if (result & CheckBoxRIResultFlag::HasTraceableRi)
+          break;
+      }
+      goto done;
+    }
+
     for (int z = regions[1], cellI = regions[1] * rgl->cellNumW + regions[0]; z <= regions[3]; z++, cellI += cellXStride)
     {
       for (int x = regions[0]; x <= regions[2]; x++, cellI++)
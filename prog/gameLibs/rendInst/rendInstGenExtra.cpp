@@ -4,6 +4,7 @@
 #include "riGen/riGenExtra.h"
 #include "riGen/riUtil.h"
 #include "riGen/riGenExtraMaxHeight.h"
+#include "riGen/riExtraSnapshot.h"
 #include "riGen/riGrid.h"
 #include "riGen/riGridDebug.h"
 #include "render/extraRender.h"
@@ -140,6 +141,7 @@ void rendinst::termRIGenExtra()
   interlocked_relaxed_store(maxRiExtraHeight, 0);
   ri_extra_max_height_on_terminate();
   term_ri_extra_grids();
+  snapshot::reset();
   for (int i = 0; i < countof(riExPoolIdxPerStage); i++)
     riExPoolIdxPerStage[i].clear();
   clear_and_shrink(riExtra);
@@ -384,6 +386,9 @@ int rendinst::addRIGenExtraResIdx(const char *ri_res_name, int ri_pool_ref, int
   riExtra[id].useVsm = getRiParamsBlockByName(ri_res_name).getBool("useVsm", false);
 
   riExtra[id].isDynamicRendinst = bool(ri_flags & AddRIFlag::Dynamic);
+  // dynamic instances are moved every frame, re-encoding them costs more than memory saved
+  if (!riExtra[id].isDynamicRendinst && paramsBlock.getBool("quantizedTm", false))
+    riExtra[id].riTm.setQuantized(true);
 
   riExtra[id].riPoolRef = ri_pool_ref;
   riExtra[id].riPoolRefLayer = ri_pool_ref_layer;
@@ -901,14 +906,15 @@ dag::Vector<BBox3> rendinst::getRIGenExtraInstancesWorldBboxesByGrid(int res_idx
   IPoint2 cellMax(grid_cells - IPoint2(1, 1));
 
   dag::Vector<BBox3> gridBoxes(grid_cells.x * grid_cells.y);
-  for (const mat43f &riTm : rendinst::riExtra[res_idx].riTm)
+  const RiExtraPool &pool = rendinst::riExtra[res_idx];
+  for (uint32_t i = 0, n = pool.riTm.size(); i < n; ++i)
   {
     mat44f riTm44f;
-    v_mat43_transpose_to_mat44(riTm44f, riTm);
+    pool.riTm.get44(i, riTm44f);
 
     bbox3f vBox;
     v_bbox3_init_empty(vBox);
-    v_bbox3_add_transformed_box(vBox, riTm44f, rendinst::riExtra[res_idx].lbb);
+    v_bbox3_add_transformed_box(vBox, riTm44f, pool.lbb);
 
     BBox3 box;
     v_stu_bbox3(box, vBox);
@@ -957,11 +963,12 @@ bbox3f rendinst::getRIGenExtraOverallInstancesWorldBbox(int res_idx)
   v_bbox3_init_empty(result);
   if (res_idx >= 0 && res_idx < riExtra.size())
   {
-    for (const mat43f &riTm : rendinst::riExtra[res_idx].riTm)
+    const RiExtraPool &pool = rendinst::riExtra[res_idx];
+    for (uint32_t i = 0, n = pool.riTm.size(); i < n; ++i)
     {
       mat44f riTm44f;
-      v_mat43_transpose_to_mat44(riTm44f, riTm);
-      v_bbox3_add_transformed_box(result, riTm44f, rendinst::riExtra[res_idx].lbb);
+      pool.riTm.get44(i, riTm44f);
+      v_bbox3_add_transformed_box(result, riTm44f, pool.lbb);
     }
   }
   return result;
@@ -999,18 +1006,19 @@ riex_handle_t rendinst::addRIGenExtra43(int res_idx, bool /*m*/, mat43f_cref tm,
         logerr_ctx("RI overflow (%d) for %s", pool.riTm.size(), riExtraMap.getName(res_idx));
         return RIEX_HANDLE_NULL;
       }
-      idx = append_items(pool.riTm, 1);
+      idx = pool.riTm.append();
       // debug_ctx("idx=%d tm=%d col=%d cf=%d", idx, pool.riTm.size(), pool.riColPair.size(), pool.riCollFlag.size());
       append_items(pool.riHP, 1);
       append_items(pool.riUniqueData, 1);
       append_items(pool.riXYZR, 1);
     }
 
-    pool.riTm[idx] = tm;
+    pool.riTm.set(idx, tm);
     pool.riHP[idx].init(pool.initialHP);
     pool.riUniqueData[idx].cellId = orig_cell;
     pool.riUniqueData[idx].offset = orig_offset;
     h = make_handle(res_idx, idx);
+    snapshot::mark_added(h);
 
     mat44f tm44;
     v_mat43_transpose_to_mat44(tm44, tm);
@@ -1107,7 +1115,7 @@ bool rendinst::moveRIGenExtra43(riex_handle_t id, mat43f_cref tm, bool moved, bo
     mat44f tm44_old;
     bbox3f wabb0;
 
-    v_mat43_transpose_to_mat44(tm44_old, pool.riTm[idx]);
+    pool.riTm.get44(idx, tm44_old);
     v_bbox3_init(wabb0, tm44_old, pool.collBb);
     vec4f oldWbsph = pool.riXYZR[idx];
 
@@ -1132,7 +1140,8 @@ bool rendinst::moveRIGenExtra43(riex_handle_t id, mat43f_cref tm, bool moved, bo
     pool.riXYZR[idx] = v_perm_xyzd(bsphere, v_or(bsphere, V_CI_SIGN_MASK));
     v_bbox3_add_box(pool.fullWabb, wabb1);
   }
-  pool.riTm[idx] = tm;
+  pool.riTm.set(idx, tm);
+  snapshot::mark_dirty(id);
 
   return true;
 }
@@ -1170,7 +1179,7 @@ bool rendinst::delRIGenExtra(riex_handle_t id)
   {
     mat44f tm44;
     bbox3f wabb;
-    v_mat43_transpose_to_mat44(tm44, pool.riTm[idx]);
+    pool.riTm.get44(idx, tm44);
     v_bbox3_init(wabb, tm44, pool.collBb);
 
     riExtraGrid.erase(id, pool.riXYZR[idx]);
@@ -1190,13 +1199,14 @@ bool rendinst::delRIGenExtra(riex_handle_t id)
   }
   else
   {
-    pool.riTm[idx].row0 = pool.riTm[idx].row1 = pool.riTm[idx].row2 = v_zero();
+    pool.riTm.setZero(idx);
     pool.riHP[idx].init(0);
     pool.riUniqueData[idx].cellId = pool.riUniqueData[idx].offset = -1;
     pool.riXYZR[idx] = v_perm_xyzd(v_zero(), v_splats(-1.f));
     pool.uuIdx.push_back(idx);
     if (idx < pool.tsNodeIdx.size())
       pool.tsNodeIdx[idx] = scene::INVALID_NODE;
+    snapshot::mark_dirty(id);
   }
   if (pool.riTm.size() == pool.uuIdx.size())
   {
@@ -1257,11 +1267,12 @@ bool rendinst::removeRIGenExtraFromGrid(riex_handle_t id)
   {
     mat44f tm44;
     bbox3f wabb;
-    v_mat43_transpose_to_mat44(tm44, pool.riTm[idx]);
+    pool.riTm.get44(idx, tm44);
     v_bbox3_init(wabb, tm44, pool.collBb);
     riExtraGrid.erase(id, pool.riXYZR[idx]);
     pool.riXYZR[idx] = v_perm_xyzd(pool.riXYZR[idx], v_or(pool.riXYZR[idx], V_CI_SIGN_MASK));
     riutil::world_version_inc(wabb);
+    snapshot::mark_dirty(id);
     return true;
   }
   return false;
@@ -1486,7 +1497,7 @@ bool rayHitRiExtraInstance(const Point3 &from, const Point3 &dir, float len, ren
   }
 
   mat44f tm;
-  v_mat43_transpose_to_mat44(tm, pool.riTm[idx]);
+  pool.riTm.get44(idx, tm);
 
   CollisionResource *collRes = rendinst::riExtra[res_idx].collRes;
 
@@ -1577,7 +1588,7 @@ void rendinst::getRendinstLandclassData(TempRiLandclassVec &ri_landclasses)
     RendinstLandclassData landclassData;
     {
       mat44f riTm44, riInvTm44;
-      v_mat43_transpose_to_mat44(riTm44, pool.riTm[firstValidTmId]);
+      pool.riTm.get44(firstValidTmId, riTm44);
       v_mat44_orthonormal_inverse43_to44(riInvTm44, riTm44);
       alignas(16) TMatrix riTm;
       v_mat_43ca_from_mat44(riTm.m[0], riInvTm44);
@@ -1707,10 +1718,13 @@ void rendinst::onRiExtraDestruction(riex_handle_t id, bool is_dynamic, int32_t u
     cb(id, is_dynamic, user_data);
 }
 
-dag::ConstSpan<mat43f> rendinst::riex_get_instance_matrices(int res_idx)
-{
-  return res_idx < riExtra.size() ? make_span_const(riExtra[res_idx].riTm) : dag::ConstSpan<mat43f>();
-}
+uint32_t rendinst::riex_get_instance_count(int res_idx) { return (unsigned)res_idx < riExtra.size() ? riExtra[res_idx].riTm.size() : 0; }
+
+bool rendinst::riex_is_instance_valid(int res_idx, uint32_t inst_idx) { return !riExtra[res_idx].riTm.isZero(inst_idx); }
+
+mat43f rendinst::riex_get_instance_matrix(int res_idx, uint32_t inst_idx) { return riExtra[res_idx].riTm.get(inst_idx); }
+
+vec3f rendinst::riex_get_instance_pos(int res_idx, uint32_t inst_idx) { return riExtra[res_idx].riTm.getPos(inst_idx); }
 
 bool rendinst::riex_is_instance_valid(const mat43f &ri_tm)
 {
@@ -71,10 +71,10 @@ float ri_extra_max_height_get_max_height(int variableId)
       pool.variableIdsToUpdateMaxHeight.push_back(variableId);
 
       // Add contribution of existing instances
-      for (const mat43f &tm : pool.riTm)
+      for (uint32_t i = 0, n = pool.riTm.size(); i < n; ++i)
       {
         mat44f tm44;
-        v_mat43_transpose_to_mat44(tm44, tm);
+        pool.riTm.get44(i, tm44);
         bbox3f wabb;
         v_bbox3_init(wabb, tm44, pool.lbb);
         it->second = max(it->second, v_extract_y(wabb.bmax));
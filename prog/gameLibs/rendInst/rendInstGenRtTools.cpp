@@ -5,6 +5,7 @@
 #include "riGen/landClassData.h"
 #include "riGen/riUtil.h"
 #include "riGen/riRotationPalette.h"
+#include "riGen/riCollisionCellCache.h"
 
 #include <3d/dag_drv3d.h>
 #include <3d/dag_drv3dCmd.h>
@@ -172,6 +173,7 @@ static void clearRigenRtdata(RendInstGenData *rgl)
     ScopedLockWrite lock(rgl->rtData->riRwCs);
     for (int i = 0; i < rgl->cells.size(); i++)
       del_it(rgl->cells[i].rtData);
+    rendinst::collcache::invalidate();
     rgl->rtData->clear();
     rgl->beforeReleaseRtData();
   }
@@ -345,6 +347,7 @@ void rendinst::discard_rigen_rect(int gx0, int gz0, int gx1, int gz1)
         {
           rgl->rtData->loaded.delInt(i);
           del_it(rgl->cells[i].rtData);
+          rendinst::collcache::invalidate_cell(rgl, i);
           rigenNeedSyncPrepare = true;
         }
       }
@@ -362,6 +365,7 @@ void rendinst::discard_rigen_all()
   FOR_EACH_RG_LAYER_DO (rgl)
     for (int i = 0; i < rgl->cells.size(); i++)
       del_it(rgl->cells[i].rtData);
+  rendinst::collcache::invalidate();
 }
 
 void rendinst::set_rigen_sweep_mask(rendinst::EditableHugeBitmask *bm, float ox, float oz, float scale)
@@ -460,6 +464,7 @@ bool rendinst::compute_rt_rigen_tight_ht_limits(int layer_idx, int cx, int cz, f
     del_it(rgl->cells[idx].rtData);
     rgl->rtData->loaded.delInt(idx);
   }
+  rendinst::collcache::invalidate_cell(rgl, idx);
   out_hmin = rgl->cells[idx].htMin;
   out_hdelta = rgl->cells[idx].htDelta;
   return true;
@@ -491,6 +496,7 @@ static void gen_rt_rigen_cells(RendInstGenData *rgl, const BBox3 &area)
       rgl->rtData->toLoad.delInt(idx);
       if (rgl->cells[idx].isReady())
         rgl->rtData->loadedCellsBBox += IPoint2(cx, cz);
+      rendinst::collcache::invalidate_cell(rgl, idx);
     }
   debug_cp();
 }
@@ -769,6 +775,7 @@ void rendinst::notify_ri_moved(int ri_idx, float ox, float oz, float nx, float n
       if (rgl->cells[idx0].rtData->pregenAdd)
         rgl->cells[idx0].rtData->pregenAdd->needsUpdate = true;
     }
+    rendinst::collcache::invalidate_cell(rgl, idx0);
   }
   else
   {
@@ -778,12 +785,14 @@ void rendinst::notify_ri_moved(int ri_idx, float ox, float oz, float nx, float n
       if (rgl->rtData->loaded.hasInt(idx0))
         rgl->rtData->loaded.delInt(idx0);
       del_it(rgl->cells[idx0].rtData);
+      rendinst::collcache::invalidate_cell(rgl, idx0);
     }
     if (idx1 >= 0)
     {
       if (rgl->rtData->loaded.hasInt(idx1))
         rgl->rtData->loaded.delInt(idx1);
       del_it(rgl->cells[idx1].rtData);
+      rendinst::collcache::invalidate_cell(rgl, idx1);
     }
   }
   rigenNeedSyncPrepare = true;
@@ -801,6 +810,7 @@ void rendinst::notify_ri_deleted(int ri_idx, float ox, float oz)
     if (rgl->rtData->loaded.hasInt(idx))
       rgl->rtData->loaded.delInt(idx);
     del_it(rgl->cells[idx].rtData);
+    rendinst::collcache::invalidate_cell(rgl, idx);
   }
   rigenNeedSyncPrepare = true;
 }
@@ -685,7 +685,7 @@ static void repopulate_tiled_scenes()
         continue;
       vec4f sphere = v_zero();
       mat44f tm44;
-      v_mat43_transpose_to_mat44(tm44, pool.riTm[idx]);
+      pool.riTm.get44(idx, tm44);
       scene::node_index ni =
         (pool.tsIndex >= 0) ? alloc_instance_for_tiled_scene(pool, res_idx, idx, tm44, sphere) : scene::INVALID_NODE;
       if (ni != scene::INVALID_NODE)
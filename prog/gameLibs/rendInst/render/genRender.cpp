@@ -4,6 +4,7 @@
 #include <rendInst/rotation_palette_consts.hlsli>
 #include <rendInst/impostorTextureMgr.h>
 #include <rendInst/rendInstExtraRender.h>
+#include <rendInst/visibility.h>
 
 #include "riGen/riGenExtra.h"
 #include "riGen/riGenData.h"
@@ -33,6 +34,8 @@
 #include <scene/dag_occlusion.h>
 #include <shaders/dag_overrideStates.h>
 #include <EASTL/array.h>
+#include <EASTL/vector.h>
+#include <dag/dag_vector.h>
 #include <gpuObjects/gpuObjects.h>
 #include <math/dag_mathUtils.h>
 #include <render/debugMesh.h>
@@ -392,6 +395,42 @@ static void fillRendInstVBs()
 }
 
 
+namespace rendinst::render
+{
+// riGen visibilities of shadow views culled together by prepareRIGenShadowViews(), picked up by renderRIGen()
+struct PreparedShadowView
+{
+  mat44f globtm;
+  RiGenVisibility *visibility = nullptr;
+};
+static eastl::vector<PreparedShadowView> prepared_shadow_views;
+static int prepared_shadow_views_count = 0;
+static Point3 prepared_shadow_views_pos;
+
+static void close_prepared_shadow_views()
+{
+  for (PreparedShadowView &view : prepared_shadow_views)
+    destroyRIGenVisibility(view.visibility);
+  prepared_shadow_views.clear();
+  prepared_shadow_views_count = 0;
+}
+
+static const RiGenVisibility *find_prepared_shadow_view(mat44f_cref globtm, const Point3 &view_pos)
+{
+  if (!prepared_shadow_views_count || view_pos != prepared_shadow_views_pos)
+    return nullptr;
+  for (int i = 0; i < prepared_shadow_views_count; ++i)
+  {
+    mat44f_cref tm = prepared_shadow_views[i].globtm;
+    vec4f eq = v_and(v_and(v_cmp_eq(tm.col0, globtm.col0), v_cmp_eq(tm.col1, globtm.col1)),
+      v_and(v_cmp_eq(tm.col2, globtm.col2), v_cmp_eq(tm.col3, globtm.col3)));
+    if (v_signmask(eq) == 0xF)
+      return prepared_shadow_views[i].visibility;
+  }
+  return nullptr;
+}
+} // namespace rendinst::render
+
 void RendInstGenData::termRenderGlobals()
 {
   rendinst::closeImpostorShadowTempTex();
@@ -410,6 +449,7 @@ void RendInstGenData::termRenderGlobals()
   rendinst::render::riGenMultidrawContext.close();
   index_buffer::release_quads_16bit();
   rendinst::render::closeClipmapShadows();
+  rendinst::render::close_prepared_shadow_views();
   rendinst::render::close_depth_VDECL();
   rendinst::close_debug_collision_visualization();
   termImpostorsGlobals();
@@ -1419,6 +1459,28 @@ void rendinst::render::renderRITreeDepth(const RiGenVisibility *visibility, cons
       rgl->renderOptimizationDepthPrepass(visibility[_layer], view_itm);
 }
 
+void rendinst::render::prepareRIGenShadowViews(dag::ConstSpan<mat44f> globtms, const Point3 &view_pos)
+{
+  prepared_shadow_views_count = 0;
+  if (!RendInstGenData::renderResRequired || RendInstGenData::isLoading || globtms.empty())
+    return;
+  dag::Vector<Frustum, framemem_allocator> frustums(globtms.size());
+  dag::Vector<RiGenVisibility *, framemem_allocator> visibilities(globtms.size());
+  for (int i = 0; i < globtms.size(); ++i)
+  {
+    if (i >= prepared_shadow_views.size())
+      prepared_shadow_views.push_back().visibility = createRIGenVisibility(midmem);
+    prepared_shadow_views[i].globtm = globtms[i];
+    frustums[i].construct(globtms[i]);
+    visibilities[i] = prepared_shadow_views[i].visibility;
+  }
+  prepareRIGenVisibilityMulti(frustums, view_pos, visibilities, true);
+  prepared_shadow_views_count = globtms.size();
+  prepared_shadow_views_pos = view_pos;
+}
+
+void rendinst::render::clearPreparedRIGenShadowViews() { prepared_shadow_views_count = 0; }
+
 void rendinst::render::renderRIGen(RenderPass render_pass, mat44f_cref globtm, const Point3 &view_pos, const TMatrix &view_itm,
   LayerFlags layer_flags, bool for_vsm, TexStreamingContext texCtx)
 {
@@ -1458,9 +1520,13 @@ void rendinst::render::renderRIGen(RenderPass render_pass, mat44f_cref globtm, c
     bool shouldUseSeparateAlpha = !(layer_flags & LayerFlag::NoSeparateAlpha);
     if (shouldUseSeparateAlpha)
       disableRendinstAlphaForNormalPassWithZPrepass();
+    // views prepared together with other shadow views have same visibility as culled here (they are prepared without forced lod)
+    const RiGenVisibility *prepared =
+      for_shadow && visibility.forcedLod < 0 ? find_prepared_shadow_view(globtm, view_pos) : nullptr;
     FOR_EACH_RG_LAYER_RENDER (rgl, rgRenderMaskO)
-      if (rgl->prepareVisibility(frustum, view_pos, visibility, for_shadow, layer_flags, nullptr))
-        rgl->render(render_pass, visibility, view_itm, (layer_flags & ~LayerFlag::Decals), false);
+      if (prepared ? prepared[_layer].vismask != 0
+                   : rgl->prepareVisibility(frustum, view_pos, visibility, for_shadow, layer_flags, nullptr))
+        rgl->render(render_pass, prepared ? prepared[_layer] : visibility, view_itm, (layer_flags & ~LayerFlag::Decals), false);
     if (shouldUseSeparateAlpha)
       restoreRendinstAlphaForNormalPassWithZPrepass();
   }
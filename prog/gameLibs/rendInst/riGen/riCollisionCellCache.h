@@ -0,0 +1,46 @@
+#pragma once
+
+#include "riGen/riGenData.h"
+
+#include <vecmath/dag_vecMathDecl.h>
+#include <generic/dag_tab.h>
+
+
+namespace rendinst::collcache
+{
+inline constexpr float HASH_CELL_SIZE = 32.f;
+// queries larger than this (in XZ) walk riGen cells directly, cache is meant for small boxes repeated many times
+inline constexpr float MAX_QUERY_SIZE = HASH_CELL_SIZE * 2.f;
+
+// riGen instance which collision bbox intersects hash cell
+struct Candidate
+{
+  enum : uint8_t
+  {
+    POS_INST = 1 << 0,
+    PALETTE_ROTATION = 1 << 1,
+  };
+
+  bbox3f wbb; // world bbox of collision (or riCollResBb if there is no collision) of instance
+  int cellI;
+  int dataOfs; // instance data offset from start of its subcell slice, in bytes
+  uint16_t pool;
+  uint8_t subCell;
+  uint8_t flags;
+};
+
+// Gathers riGen instances of layer which bboxes intersect box, each instance once.
+// Candidate lists are built per fixed world cell on first use and reused until rendinst world changes there (riutil::worldVersion)
+// or riGen cells they were gathered from are regenerated or freed. Instances destroyed after list was built are still returned, caller checks data as usual.
+// rgl->rtData->riRwCs must be read locked by caller.
+// Returns false if box is too big for cache or caching is disabled, out is not touched then.
+bool gather_candidates(RendInstGenData *rgl, int layer, bbox3f_cref box, Tab<Candidate> &out);
+
+// drops cached lists gathered from riGen cell, must be called whenever cell data is (re)generated or freed
+void invalidate_cell(const RendInstGenData *rgl, int cell_idx);
+// drops all cached lists, for changes of whole layer
+void invalidate();
+
+// number of candidate lists built so far, for tests and profiling
+int get_built_lists_count();
+} // namespace rendinst::collcache
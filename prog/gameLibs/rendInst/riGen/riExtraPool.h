@@ -7,6 +7,7 @@
 #include <generic/dag_tab.h>
 #include <util/dag_simpleString.h>
 #include <scene/dag_tiledScene.h>
+#include "riGen/riExtraTmStorage.h"
 
 
 class RenderableInstanceLodsResource;
@@ -80,7 +81,7 @@ struct RiExtraPool
     }
   };
 
-  Tab<mat43f> riTm;
+  RiExtraTmStorage riTm; // quantized when pool has quantizedTm:b=yes in ri params
   Tab<vec4f> riXYZR; // R<0 mean 'not in grid'
   E3DCOLOR poolColors[2] = {};
   Tab<uint16_t> uuIdx;
@@ -176,8 +177,7 @@ struct RiExtraPool
   {
     if (idx >= riTm.size())
       return false;
-    uint64_t *p = (uint64_t *)&riTm.data()[idx];
-    return p[0] || p[1];
+    return !riTm.isZero(idx);
   }
   bool isInGrid(int idx) const
   {
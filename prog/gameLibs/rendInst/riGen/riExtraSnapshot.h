@@ -0,0 +1,15 @@
+#pragma once
+
+#include <rendInst/riexHandle.h>
+
+
+// Double buffered copy of riExtra instance transforms and bspheres for lock-free readers, see riex_publish_snapshot()
+namespace rendinst::snapshot
+{
+// records instance change, must be called under riExtra write lock
+void mark_dirty(riex_handle_t id);
+// same, for instance added to (possibly reused) slot, so that versioned handles of previous instance fail
+void mark_added(riex_handle_t id);
+// drops both buffers, called when riExtra pools are destroyed
+void reset();
+} // namespace rendinst::snapshot
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <vecmath/dag_vecMath.h>
+#include <math/dag_mathBase.h>
+#include <generic/dag_tab.h>
+#include <util/dag_stdint.h>
+#include <util/dag_globDef.h>
+
+
+namespace rendinst
+{
+
+// Compact riExtra instance transform: fixed point world position, smallest-three quaternion and uniform scale.
+// 20 bytes instead of 48 for mat43f, only rigid transforms with uniform scale can be stored.
+// Lossy: position is rounded to POS_SCALE step and rotation to 10 bits per component (~0.2 degree), only scale is kept as is.
+struct QuantizedTm
+{
+  static constexpr float POS_SCALE = 1024.f; // 1/1024m (~1mm) step
+  static constexpr float MAX_POS = float(0x7fffffff) / POS_SCALE * 0.99f;
+  static constexpr int ROT_BITS = 10;
+  static constexpr int ROT_MASK = (1 << ROT_BITS) - 1;
+
+  int32_t pos[3];
+  uint32_t rot; // (2:10:10:10) index of the largest quaternion component, then other three components
+  float scale;  // 0 means dead instance
+
+  static bool encode(QuantizedTm &dest, mat43f_cref tm)
+  {
+    const uint64_t *p0 = (const uint64_t *)&tm.row0; // same as RiExtraPool::isValid()
+    if (!p0[0] && !p0[1])
+    {
+      memset(&dest, 0, sizeof(dest));
+      return true;
+    }
+    mat44f tm44;
+    v_mat43_transpose_to_mat44(tm44, tm);
+    vec4f lenSq = v_make_vec4f(v_extract_x(v_length3_sq_x(tm44.col0)), v_extract_x(v_length3_sq_x(tm44.col1)),
+      v_extract_x(v_length3_sq_x(tm44.col2)), 0);
+    float scaleSq = v_extract_x(lenSq);
+    if (scaleSq < 1e-12f)
+      return false;
+    const float eps = 1e-3f * scaleSq;
+    if (fabsf(v_extract_y(lenSq) - scaleSq) > eps || fabsf(v_extract_z(lenSq) - scaleSq) > eps ||
+        fabsf(v_extract_x(v_dot3_x(tm44.col0, tm44.col1))) > eps || fabsf(v_extract_x(v_dot3_x(tm44.col0, tm44.col2))) > eps ||
+        fabsf(v_extract_x(v_dot3_x(tm44.col1, tm44.col2))) > eps ||
+        v_extract_x(v_dot3_x(v_cross3(tm44.col0, tm44.col1), tm44.col2)) <= 0.f) // skew, non-uniform scale or mirroring
+      return false;
+    vec4f posMax = v_abs(tm44.col3);
+    if (v_extract_x(posMax) > MAX_POS || v_extract_y(posMax) > MAX_POS || v_extract_z(posMax) > MAX_POS)
+      return false;
+
+    const float scale = sqrtf(scaleSq);
+    const vec4f invScale = v_splats(1.f / scale);
+    alignas(16) float q[4];
+    v_st(q, v_norm4(v_quat_from_mat(v_mul(tm44.col0, invScale), v_mul(tm44.col1, invScale), v_mul(tm44.col2, invScale))));
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+      if (fabsf(q[i]) > fabsf(q[largest]))
+        largest = i;
+    const float sign = q[largest] < 0.f ? -1.f : 1.f;
+    dest.rot = uint32_t(largest) << (ROT_BITS * 3);
+    for (int i = 0, shift = ROT_BITS * 2; i < 4; ++i)
+      if (i != largest)
+      {
+        const float c = clamp(q[i] * sign * float(M_SQRT2) * 0.5f + 0.5f, 0.f, 1.f);
+        dest.rot |= uint32_t(c * ROT_MASK + 0.5f) << shift;
+        shift -= ROT_BITS;
+      }
+
+    alignas(16) float p[4];
+    v_st(p, tm44.col3);
+    for (int i = 0; i < 3; ++i)
+      dest.pos[i] = int32_t(floorf(p[i] * POS_SCALE + 0.5f));
+    dest.scale = scale;
+    return true;
+  }
+
+  bool isZero() const { return scale == 0.f; }
+
+  vec3f decodePos() const
+  {
+    return v_mul(v_cvt_vec4f(v_make_vec4i(pos[0], pos[1], pos[2], 0)), v_splats(1.f / POS_SCALE));
+  }
+
+  void decode(mat44f &dest) const
+  {
+    if (isZero())
+    {
+      dest.col0 = dest.col1 = dest.col2 = dest.col3 = v_zero();
+      return;
+    }
+    alignas(16) float q[4];
+    const int largest = rot >> (ROT_BITS * 3);
+    float sumSq = 0.f;
+    for (int i = 0, shift = ROT_BITS * 2; i < 4; ++i)
+      if (i != largest)
+      {
+        q[i] = (float((rot >> shift) & ROT_MASK) * (1.f / ROT_MASK) - 0.5f) * float(M_SQRT2);
+        sumSq += q[i] * q[i];
+        shift -= ROT_BITS;
+      }
+    q[largest] = sqrtf(max(0.f, 1.f - sumSq));
+    mat33f m;
+    v_mat33_from_quat(m, v_ld(q));
+    const vec4f vScale = v_splats(scale);
+    dest.col0 = v_mul(m.col0, vScale);
+    dest.col1 = v_mul(m.col1, vScale);
+    dest.col2 = v_mul(m.col2, vScale);
+    dest.col3 = v_perm_xyzd(decodePos(), V_C_UNIT_0001);
+  }
+
+  void decode(mat43f &dest) const
+  {
+    mat44f tm44;
+    decode(tm44);
+    v_mat44_transpose_to_mat43(dest, tm44);
+  }
+};
+
+// Instance transforms of riExtra pool, stored either as plain mat43f or as QuantizedTm.
+// Quantized pool silently switches back to plain storage once transform which can't be quantized is set.
+class RiExtraTmStorage
+{
+public:
+  uint32_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  bool isQuantized() const { return quantized; }
+  size_t memoryUsage() const { return full.capacity() * sizeof(mat43f) + packed.capacity() * sizeof(QuantizedTm); }
+
+  // plain matrices, nullptr for quantized storage
+  const mat43f *fullData() const { return quantized ? nullptr : full.data(); }
+
+  mat43f get(uint32_t idx) const
+  {
+    if (!quantized)
+      return full.data()[idx];
+    mat43f tm;
+    packed.data()[idx].decode(tm);
+    return tm;
+  }
+  void get44(uint32_t idx, mat44f &tm) const
+  {
+    if (quantized)
+      packed.data()[idx].decode(tm);
+    else
+      v_mat43_transpose_to_mat44(tm, full.data()[idx]);
+  }
+  vec3f getPos(uint32_t idx) const
+  {
+    if (quantized)
+      return packed.data()[idx].decodePos();
+    const mat43f &tm = full.data()[idx];
+    return v_perm_xyab(v_perm_xaxa(v_splat_w(tm.row0), v_splat_w(tm.row1)), v_splat_w(tm.row2));
+  }
+  bool isZero(uint32_t idx) const
+  {
+    if (quantized)
+      return packed.data()[idx].isZero();
+    const uint64_t *p = (const uint64_t *)&full.data()[idx];
+    return !p[0] && !p[1];
+  }
+
+  void set(uint32_t idx, mat43f_cref tm)
+  {
+    if (!quantized)
+      full[idx] = tm;
+    else if (!QuantizedTm::encode(packed[idx], tm))
+    {
+      setQuantized(false);
+      full[idx] = tm;
+    }
+  }
+  void setZero(uint32_t idx)
+  {
+    if (quantized)
+      memset(&packed[idx], 0, sizeof(QuantizedTm));
+    else
+      full[idx].row0 = full[idx].row1 = full[idx].row2 = v_zero();
+  }
+  uint32_t append()
+  {
+    if (quantized)
+      packed.push_back();
+    else
+      full.push_back();
+    return count++;
+  }
+  void pop_back()
+  {
+    G_ASSERT(count);
+    if (quantized)
+      packed.pop_back();
+    else
+      full.pop_back();
+    count--;
+  }
+  void clear()
+  {
+    full.clear();
+    packed.clear();
+    count = 0;
+  }
+
+  // converts existing instances, returns false if some of them can't be quantized (storage stays plain then)
+  bool setQuantized(bool on)
+  {
+    if (on == quantized)
+      return true;
+    if (on)
+    {
+      Tab<QuantizedTm> tmp;
+      tmp.resize(count);
+      for (uint32_t i = 0; i < count; ++i)
+        if (!QuantizedTm::encode(tmp[i], full[i]))
+          return false;
+      packed = eastl::move(tmp);
+      clear_and_shrink(full);
+    }
+    else
+    {
+      full.resize(count);
+      for (uint32_t i = 0; i < count; ++i)
+        packed[i].decode(full[i]);
+      clear_and_shrink(packed);
+    }
+    quantized = on;
+    return true;
+  }
+
+private:
+  Tab<mat43f> full;
+  Tab<QuantizedTm> packed;
+  uint32_t count = 0;
+  bool quantized = false;
+};
+
+} // namespace rendinst
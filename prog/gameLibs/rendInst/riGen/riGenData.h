@@ -37,6 +37,11 @@ class CollisionResource;
 class DynamicPhysObjectData;
 struct Frustum;
 struct RiGenVisibility;
+namespace rendinst
+{
+template <int max_visible_cells, int subcell_div>
+struct VisibleCells;
+}
 typedef void *file_ptr_t;
 namespace rendinst::gen::land
 {
@@ -466,6 +471,20 @@ public:
   bool prepareVisibility(const Frustum &frustum, const Point3 &vpos, RiGenVisibility &visibility, bool forShadow,
     rendinst::LayerFlags layer_flags, Occlusion *use_occlusion, bool for_visual_collision = false,
     const rendinst::VisibilityExternalFilter &external_filter = {});
+  using VisibleCellsData = rendinst::VisibleCells<MAX_VISIBLE_CELLS, SUBCELL_DIV>;
+  void calcCellsRegion(bbox3f_cref world_bbox, int *regions) const;
+  template <bool use_external_filter>
+  bool fillVisibility(const VisibleCellsData &visData, const Frustum &frustum, vec3f curViewPos, float forcedLodDist,
+    float forcedLodDistSq, RiGenVisibility &visibility, bool forShadow, rendinst::LayerFlags layer_flags, Occlusion *use_occlusion,
+    bool for_visual_collision, const rendinst::VisibilityExternalFilter &external_filter);
+  // must be called under rtData->riRwCs read lock, return false if view position is out of grid
+  bool gatherVisibleCells(const Frustum &frustum, const Point3 &vpos, Occlusion *use_occlusion, VisibleCellsData &vis_data);
+  bool gatherVisibleCellsMulti(const Frustum *const *frustums, Occlusion *const *occlusions, int count, const Point3 &vpos,
+    VisibleCellsData *vis_data);
+  template <bool use_external_filter = false>
+  bool prepareVisibilityMulti(dag::ConstSpan<Frustum> frustums, const Point3 &vpos, dag::ConstSpan<RiGenVisibility *> visibilities,
+    bool forShadow, rendinst::LayerFlags layer_flags, dag::ConstSpan<Occlusion *> occlusions = {},
+    const rendinst::VisibilityExternalFilter &external_filter = {});
   void sortRIGenVisibility(RiGenVisibility &visibility, const Point3 &viewPos, const Point3 &viewDir, float vertivalFov,
     float horizontalFov, float value);
   void renderPreparedOpaque(rendinst::RenderPass renderPass, rendinst::LayerFlags layer_flags, const RiGenVisibility &visibility,
@@ -25,7 +25,7 @@ struct RiGridObject
     uint32_t riInstance = rendinst::handle_to_ri_inst(handle);
     const rendinst::RiExtraPool &pool = rendinst::riExtra.data()[riType];
     mat44f tm;
-    v_mat43_transpose_to_mat44(tm, pool.riTm.data()[riInstance]);
+    pool.riTm.get44(riInstance, tm);
     bbox3f bbox;
     v_bbox3_init(bbox, tm, pool.collBb);
     return bbox;
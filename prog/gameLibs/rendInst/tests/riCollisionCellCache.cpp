@@ -0,0 +1,173 @@
+#include <UnitTest++/UnitTestPP.h>
+#include "../riGen/riCollisionCellCache.h"
+#include "../riGen/genObjUtil.h"
+#include <math/random/dag_random.h>
+#include <EASTL/sort.h>
+#include <EASTL/vector.h>
+
+using namespace rendinst;
+
+// Single riGen layer of CELL_NUM x CELL_NUM ready cells with one pool of position instances, all in first subcell
+struct CellCacheFixture
+{
+  static constexpr int CELL_NUM = 4;
+  static constexpr int CELL_SZ = 64;
+  static constexpr float CELL_HEIGHT = 64.f;
+
+  RendInstGenData *rgl = nullptr;
+  eastl::vector<RendInstGenData::Cell> cells;
+  int seed = 12345;
+
+  CellCacheFixture()
+  {
+    collcache::invalidate();
+    void *mem = memalloc(sizeof(RendInstGenData), midmem);
+    memset(mem, 0, sizeof(RendInstGenData));
+    rgl = new (mem, _NEW_INPLACE) RendInstGenData;
+    cells.resize(CELL_NUM * CELL_NUM);
+    rgl->cells.init(cells.data(), cells.size());
+    rgl->cellNumW = rgl->cellNumH = CELL_NUM;
+    rgl->cellSz = CELL_SZ;
+    rgl->grid2world = 1.f;
+    rgl->perInstDataDwords = 0;
+    rgl->world0Vxz = v_zero();
+    rgl->invGridCellSzV = v_splats(1.f / CELL_SZ);
+    rgl->lastCellXZXZ = v_splats(CELL_NUM - 0.9f);
+    rgl->rtData = new RendInstGenData::RtData(0);
+    rgl->rtData->riPosInst.resize(1, true);
+    rgl->rtData->riPaletteRotation.resize(1, false);
+    rgl->rtData->riCollRes.resize(1);
+    rgl->rtData->riCollRes[0].collRes = nullptr;
+    clear_and_resize(rgl->rtData->riCollResBb, 1);
+    rgl->rtData->riCollResBb[0] = bbox3f{v_splats(-1.f), v_splats(1.f)};
+    rendinst::rgLayer.push_back(rgl);
+    for (int i = 0; i < cells.size(); ++i)
+      generateCell(i, 32);
+  }
+  ~CellCacheFixture()
+  {
+    collcache::invalidate();
+    rendinst::rgLayer.pop_back();
+    for (RendInstGenData::Cell &cell : cells)
+      del_it(cell.rtData);
+    del_it(rgl->rtData);
+    rgl->cells.init(nullptr, 0);
+    memfree(rgl, midmem); // ~RendInstGenData() releases level resources, there are none here
+  }
+
+  void generateCell(int cell_idx, int count)
+  {
+    del_it(cells[cell_idx].rtData);
+    const int cx = cell_idx % CELL_NUM, cz = cell_idx / CELL_NUM;
+    auto *crt = new RendInstGenData::CellRtData(1, rgl->rtData);
+    crt->cellOrigin = v_make_vec4f(cx * CELL_SZ, 0, cz * CELL_SZ, 0);
+    crt->cellHeight = CELL_HEIGHT;
+    clear_and_resize(crt->scsRemap, 1);
+    crt->scsRemap[0] = 0;
+    clear_and_resize(crt->scs, RendInstGenData::SUBCELL_DIV * RendInstGenData::SUBCELL_DIV);
+    mem_set_0(crt->scs);
+    clear_and_resize(crt->bbox, RendInstGenData::SUBCELL_DIV * RendInstGenData::SUBCELL_DIV + 1);
+    for (bbox3f &b : crt->bbox)
+      v_bbox3_init_empty(b);
+
+    crt->sysMemData = new uint8_t[count * RIGEN_POS_STRIDE_B(0)];
+    gen::InstancePackData packData{float(cx * CELL_SZ), 0.f, float(cz * CELL_SZ), float(CELL_SZ), CELL_HEIGHT, 0};
+    for (int i = 0; i < count; ++i)
+    {
+      const Point3 pos(cx * CELL_SZ + _frnd(seed) * CELL_SZ, _srnd(seed) * 8.f, cz * CELL_SZ + _frnd(seed) * CELL_SZ);
+      const float scale = 0.5f + _frnd(seed) * 3.f;
+      gen::pack_entity_pos_inst_16(packData, pos, scale, -1, crt->sysMemData + i * RIGEN_POS_STRIDE_B(0));
+    }
+    crt->scs[0].sz = count * RIGEN_POS_STRIDE_B(0);
+    for (int i = 0; i < count; ++i)
+    {
+      bbox3f wbb = instanceBox(crt, i * RIGEN_POS_STRIDE_B(0));
+      v_bbox3_add_box(crt->bbox[0], wbb);
+      v_bbox3_add_box(crt->bbox[1], wbb);
+    }
+    cells[cell_idx].rtData = crt;
+  }
+
+  bbox3f instanceBox(const RendInstGenData::CellRtData *crt, int ofs) const
+  {
+    vec3f pos, scale;
+    vec3f mul = v_mul(gen::VC_1div32767, v_make_vec4f(CELL_SZ, CELL_HEIGHT, CELL_SZ, 0));
+    gen::unpack_tm_pos(pos, scale, (const int16_t *)(crt->sysMemData + ofs), crt->cellOrigin, mul, false);
+    const bbox3f &collBox = rgl->rtData->riCollResBb[0];
+    return bbox3f{v_add(pos, v_mul(scale, collBox.bmin)), v_add(pos, v_mul(scale, collBox.bmax))};
+  }
+
+  static uint64_t key(int cell_idx, int ofs) { return (uint64_t(cell_idx) << 32) | uint32_t(ofs); }
+
+  eastl::vector<uint64_t> gatherCached(bbox3f_cref box)
+  {
+    Tab<collcache::Candidate> candidates;
+    rgl->rtData->riRwCs.lockRead();
+    const bool cached = collcache::gather_candidates(rgl, 0, box, candidates);
+    rgl->rtData->riRwCs.unlockRead();
+    CHECK(cached);
+    eastl::vector<uint64_t> keys;
+    for (const collcache::Candidate &c : candidates)
+      keys.push_back(key(c.cellI, c.dataOfs));
+    eastl::sort(keys.begin(), keys.end());
+    return keys;
+  }
+
+  eastl::vector<uint64_t> gatherBruteForce(bbox3f_cref box)
+  {
+    eastl::vector<uint64_t> keys;
+    for (int cellI = 0; cellI < cells.size(); ++cellI)
+      if (const RendInstGenData::CellRtData *crt = cells[cellI].isReady())
+        for (int ofs = 0; ofs < crt->scs[0].sz; ofs += RIGEN_POS_STRIDE_B(0))
+          if (v_bbox3_test_box_intersect(instanceBox(crt, ofs), box))
+            keys.push_back(key(cellI, ofs));
+    eastl::sort(keys.begin(), keys.end());
+    return keys;
+  }
+
+  bbox3f randomQueryBox()
+  {
+    const float worldSz = CELL_NUM * CELL_SZ;
+    vec3f center = v_make_vec4f(_frnd(seed) * worldSz, _srnd(seed) * 8.f, _frnd(seed) * worldSz, 0);
+    vec3f ext = v_make_vec4f(0.5f + _frnd(seed) * 20.f, 0.5f + _frnd(seed) * 8.f, 0.5f + _frnd(seed) * 20.f, 0);
+    return bbox3f{v_sub(center, ext), v_add(center, ext)};
+  }
+};
+
+TEST_FIXTURE(CellCacheFixture, CandidatesMatchBruteForce)
+{
+  for (int i = 0; i < 2000; ++i)
+  {
+    bbox3f box = randomQueryBox();
+    CHECK(gatherCached(box) == gatherBruteForce(box));
+  }
+}
+
+TEST_FIXTURE(CellCacheFixture, UnrelatedCellChangeKeepsLists)
+{
+  const bbox3f box{v_make_vec4f(10, -4, 10, 0), v_make_vec4f(20, 4, 20, 0)}; // inside cell 0
+  const eastl::vector<uint64_t> expected = gatherBruteForce(box);
+  CHECK(gatherCached(box) == expected);
+  const int built = collcache::get_built_lists_count();
+  CHECK(gatherCached(box) == expected);
+  CHECK_EQUAL(built, collcache::get_built_lists_count());
+
+  // far cell is regenerated, list of cell 0 stays valid
+  const int farCell = CELL_NUM * CELL_NUM - 1;
+  generateCell(farCell, 16);
+  collcache::invalidate_cell(rgl, farCell);
+  CHECK(gatherCached(box) == expected);
+  CHECK_EQUAL(built, collcache::get_built_lists_count());
+
+  // cell under query is regenerated, list is rebuilt from new data
+  generateCell(0, 48);
+  collcache::invalidate_cell(rgl, 0);
+  const eastl::vector<uint64_t> changed = gatherBruteForce(box);
+  CHECK(gatherCached(box) == changed);
+  CHECK_EQUAL(built + 1, collcache::get_built_lists_count());
+
+  // freed cell
+  del_it(cells[0].rtData);
+  collcache::invalidate_cell(rgl, 0);
+  CHECK(gatherCached(box) == gatherBruteForce(box));
+}
@@ -0,0 +1,158 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <rendInst/rendInstExtraAccess.h>
+#include <rendInst/rendInstExtra.h>
+#include <osApiWrappers/dag_atomic.h>
+#include "../riGen/riGenExtra.h"
+#include "../riGen/riExtraSnapshot.h"
+#include <thread>
+
+using namespace rendinst;
+
+static mat43f make_tm(float pos)
+{
+  mat43f tm;
+  tm.row0 = v_make_vec4f(1, 0, 0, pos);
+  tm.row1 = v_make_vec4f(0, 1, 0, pos);
+  tm.row2 = v_make_vec4f(0, 0, 1, pos);
+  return tm;
+}
+
+// One pool of instances, all of them are moved to the same position by writer on each frame
+struct SnapshotFixture
+{
+  static constexpr uint32_t COUNT = 256;
+
+  SnapshotFixture()
+  {
+    ScopedRIExtraWriteLock wr;
+    riExtra.resize(1);
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+      riExtra[0].riTm.set(riExtra[0].riTm.append(), make_tm(0.f));
+      riExtra[0].riXYZR.push_back(v_make_vec4f(0, 0, 0, 1));
+    }
+  }
+  ~SnapshotFixture()
+  {
+    riex_enable_snapshot(false);
+    ScopedRIExtraWriteLock wr;
+    riExtra.clear();
+  }
+
+  static void moveAll(float pos)
+  {
+    ScopedRIExtraWriteLock wr;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+      riExtra[0].riTm.set(i, make_tm(pos));
+      riExtra[0].riXYZR[i] = v_make_vec4f(pos, pos, pos, 1);
+      snapshot::mark_dirty(make_handle(0, i));
+    }
+  }
+};
+
+TEST_FIXTURE(SnapshotFixture, PublishedOnEnable)
+{
+  CHECK(riex_snapshot_acquire() == nullptr);
+  riex_enable_snapshot(true);
+  ScopedRiexSnapshot pin;
+  CHECK(pin);
+  mat43f tm;
+  CHECK(riex_snapshot_get_tm(pin.snapshot, make_handle(0, COUNT - 1), tm));
+  CHECK(!riex_snapshot_get_tm(pin.snapshot, make_handle(0, COUNT), tm));
+  CHECK(!riex_snapshot_get_tm(pin.snapshot, make_handle(1, 0), tm));
+}
+
+// Each pin sees all instances from the same publish, and readers never see older publish after newer one
+TEST_FIXTURE(SnapshotFixture, ConcurrentReadersSeeConsistentFrames)
+{
+  riex_enable_snapshot(true);
+  constexpr int READERS = 4, FRAMES = 500;
+  volatile int done = 0, errors = 0, reads = 0;
+  auto reader = [&]() {
+    float lastPos = 0.f;
+    while (!interlocked_acquire_load(done))
+    {
+      ScopedRiexSnapshot pin;
+      if (!pin)
+      {
+        interlocked_increment(errors);
+        return;
+      }
+      mat43f tm;
+      vec4f xyzr;
+      float pos = -1.f;
+      for (uint32_t i = 0; i < COUNT; ++i)
+      {
+        if (!riex_snapshot_get_tm(pin.snapshot, make_handle(0, i), tm) || !riex_snapshot_get_bsphere(pin.snapshot, make_handle(0, i), xyzr))
+        {
+          interlocked_increment(errors);
+          continue;
+        }
+        const float tmPos = v_extract_w(tm.row0);
+        if (i == 0)
+          pos = tmPos;
+        if (tmPos != pos || v_extract_x(xyzr) != pos || v_extract_w(tm.row2) != pos)
+          interlocked_increment(errors);
+      }
+      if (pos < lastPos)
+        interlocked_increment(errors);
+      lastPos = pos;
+      interlocked_increment(reads);
+    }
+  };
+  std::thread threads[READERS];
+  for (std::thread &t : threads)
+    t = std::thread(reader);
+  uint32_t lastGeneration = 0;
+  for (int frame = 1; frame <= FRAMES; ++frame)
+  {
+    moveAll(float(frame));
+    const uint32_t generation = riex_publish_snapshot();
+    CHECK(generation >= lastGeneration);
+    lastGeneration = generation;
+  }
+  interlocked_release_store(done, 1);
+  for (std::thread &t : threads)
+    t.join();
+  CHECK_EQUAL(0, errors);
+  CHECK(reads > 0);
+
+  // changes postponed while readers were pinning back buffer are published at last
+  moveAll(float(FRAMES + 1));
+  riex_publish_snapshot();
+  ScopedRiexSnapshot pin;
+  mat43f tm;
+  CHECK(riex_snapshot_get_tm(pin.snapshot, make_handle(0, COUNT / 2), tm));
+  CHECK_EQUAL(float(FRAMES + 1), v_extract_w(tm.row0));
+}
+
+TEST_FIXTURE(SnapshotFixture, ReusedSlotFailsVersionedRead)
+{
+  riex_enable_snapshot(true);
+  const riex_handle_t h = make_handle(0, 7);
+  auto addToSlot = [&](float pos) { // same as add of instance to free slot (addRIGenExtra43())
+    ScopedRIExtraWriteLock wr;
+    riExtra[0].riTm.set(7, make_tm(pos));
+    snapshot::mark_added(h);
+  };
+  addToSlot(50.f);
+  riex_publish_snapshot();
+  uint16_t version;
+  {
+    ScopedRiexSnapshot pin;
+    version = riex_snapshot_instance_version(pin.snapshot, h);
+    mat43f tm;
+    CHECK(version != 0);
+    CHECK(riex_snapshot_get_tm(pin.snapshot, h, tm, version));
+  }
+  addToSlot(100.f); // slot is reused by other instance
+  riex_publish_snapshot();
+  ScopedRiexSnapshot pin;
+  mat43f tm;
+  CHECK(riex_snapshot_get_tm(pin.snapshot, h, tm)); // unchecked read sees new instance
+  CHECK_EQUAL(100.f, v_extract_w(tm.row0));
+  CHECK(!riex_snapshot_get_tm(pin.snapshot, h, tm, version));
+  CHECK(riex_snapshot_get_tm(pin.snapshot, h, tm, riex_snapshot_instance_version(pin.snapshot, h)));
+  CHECK_EQUAL(7u, handle_to_ri_inst(h)); // handles are never changed
+}
@@ -0,0 +1,190 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <riGen/riExtraTmStorage.h>
+#include <vecmath/dag_vecMath.h>
+#include <math/dag_mathUtils.h>
+#include <math/random/dag_random.h>
+
+using rendinst::QuantizedTm;
+using rendinst::RiExtraTmStorage;
+
+static constexpr float POS_EPS = 0.5f / QuantizedTm::POS_SCALE + 1e-4f; // rounding plus float precision of test positions
+static constexpr float ROT_EPS = 3e-3f;                                  // per axis component, relative to scale
+
+static mat43f make_tm(const vec3f &axis, float angle, float scale, const vec3f &pos)
+{
+  mat33f rot;
+  v_mat33_make_rot_cw(rot, v_norm3(axis), v_splats(angle));
+  mat44f tm44;
+  tm44.col0 = v_mul(rot.col0, v_splats(scale));
+  tm44.col1 = v_mul(rot.col1, v_splats(scale));
+  tm44.col2 = v_mul(rot.col2, v_splats(scale));
+  tm44.col3 = v_perm_xyzd(pos, V_C_UNIT_0001);
+  mat43f tm;
+  v_mat44_transpose_to_mat43(tm, tm44);
+  return tm;
+}
+
+static mat43f random_tm(int &seed)
+{
+  vec3f axis = v_make_vec4f(_srnd(seed), _srnd(seed), _srnd(seed), 0);
+  if (v_extract_x(v_length3_sq_x(axis)) < 1e-4f)
+    axis = V_C_UNIT_0100;
+  const float scale = 0.05f + _frnd(seed) * 20.f;
+  const vec3f pos = v_make_vec4f(_srnd(seed) * 8000.f, _srnd(seed) * 500.f, _srnd(seed) * 8000.f, 0);
+  return make_tm(axis, _srnd(seed) * PI, scale, pos);
+}
+
+static float max_abs_diff(const vec4f &a, const vec4f &b) { return v_extract_x(v_hmax3(v_abs(v_sub(a, b)))); }
+
+static void check_close(const mat43f &src, const mat43f &decoded, float scale)
+{
+  mat44f a, b;
+  v_mat43_transpose_to_mat44(a, src);
+  v_mat43_transpose_to_mat44(b, decoded);
+  CHECK(max_abs_diff(a.col0, b.col0) <= ROT_EPS * scale);
+  CHECK(max_abs_diff(a.col1, b.col1) <= ROT_EPS * scale);
+  CHECK(max_abs_diff(a.col2, b.col2) <= ROT_EPS * scale);
+  CHECK(max_abs_diff(a.col3, b.col3) <= POS_EPS);
+}
+
+TEST(QuantizedTmRoundTripIsWithinErrorBounds)
+{
+  int seed = 12345;
+  for (int i = 0; i < 4096; ++i)
+  {
+    const mat43f tm = random_tm(seed);
+    mat44f tm44;
+    v_mat43_transpose_to_mat44(tm44, tm);
+    const float scale = v_extract_x(v_length3_x(tm44.col0));
+
+    QuantizedTm q;
+    CHECK(QuantizedTm::encode(q, tm));
+    CHECK(!q.isZero());
+    CHECK_EQUAL(scale, q.scale); // scale is kept as is
+
+    mat43f decoded;
+    q.decode(decoded);
+    check_close(tm, decoded, scale);
+    CHECK(max_abs_diff(tm44.col3, q.decodePos()) <= POS_EPS);
+
+    // decoded transform is quantized again into the same bits
+    QuantizedTm q2;
+    CHECK(QuantizedTm::encode(q2, decoded));
+    CHECK(abs(q2.pos[0] - q.pos[0]) <= 1 && abs(q2.pos[1] - q.pos[1]) <= 1 && abs(q2.pos[2] - q.pos[2]) <= 1);
+    mat43f decoded2;
+    q2.decode(decoded2);
+    check_close(decoded, decoded2, scale);
+  }
+}
+
+TEST(QuantizedTmIdentityAndZero)
+{
+  mat43f tm = make_tm(V_C_UNIT_0100, 0.f, 1.f, v_make_vec4f(1.f, 2.f, 3.f, 0));
+  QuantizedTm q;
+  CHECK(QuantizedTm::encode(q, tm));
+  mat43f decoded;
+  q.decode(decoded);
+  check_close(tm, decoded, 1.f);
+  CHECK_EQUAL(1024, q.pos[0]);
+  CHECK_EQUAL(2048, q.pos[1]);
+  CHECK_EQUAL(3072, q.pos[2]);
+
+  tm.row0 = tm.row1 = tm.row2 = v_zero();
+  CHECK(QuantizedTm::encode(q, tm));
+  CHECK(q.isZero());
+  mat44f decoded44;
+  q.decode(decoded44);
+  CHECK(v_extract_x(v_hmax(v_abs(decoded44.col0))) == 0.f && v_extract_x(v_hmax(v_abs(decoded44.col3))) == 0.f);
+}
+
+TEST(QuantizedTmRejectsNonRigid)
+{
+  QuantizedTm q;
+  mat44f tm44;
+  mat43f tm;
+  v_mat44_ident(tm44);
+
+  tm44.col1 = v_mul(tm44.col1, v_splats(2.f)); // non-uniform scale
+  v_mat44_transpose_to_mat43(tm, tm44);
+  CHECK(!QuantizedTm::encode(q, tm));
+
+  v_mat44_ident(tm44);
+  tm44.col1 = v_add(tm44.col1, v_mul(tm44.col0, v_splats(0.3f))); // skew
+  v_mat44_transpose_to_mat43(tm, tm44);
+  CHECK(!QuantizedTm::encode(q, tm));
+
+  v_mat44_ident(tm44);
+  tm44.col2 = v_neg(tm44.col2); // mirroring
+  v_mat44_transpose_to_mat43(tm, tm44);
+  CHECK(!QuantizedTm::encode(q, tm));
+
+  v_mat44_ident(tm44);
+  tm44.col3 = v_make_vec4f(QuantizedTm::MAX_POS * 2.f, 0, 0, 1); // position out of range
+  v_mat44_transpose_to_mat43(tm, tm44);
+  CHECK(!QuantizedTm::encode(q, tm));
+}
+
+TEST(TmStorageQuantizedAccessorsMatch)
+{
+  RiExtraTmStorage storage;
+  int seed = 777;
+  constexpr int COUNT = 256;
+  mat43f src[COUNT];
+  for (int i = 0; i < COUNT; ++i)
+  {
+    src[i] = random_tm(seed);
+    storage.set(storage.append(), src[i]);
+  }
+  storage.setZero(7);
+  CHECK(storage.setQuantized(true));
+  CHECK(storage.isQuantized());
+  CHECK(storage.fullData() == nullptr);
+  CHECK_EQUAL(COUNT, storage.size());
+
+  for (int i = 0; i < COUNT; ++i)
+  {
+    CHECK_EQUAL(i == 7, storage.isZero(i));
+    if (i == 7)
+      continue;
+    mat44f src44;
+    v_mat43_transpose_to_mat44(src44, src[i]);
+    const float scale = v_extract_x(v_length3_x(src44.col0));
+    const mat43f tm = storage.get(i);
+    check_close(src[i], tm, scale);
+    mat44f tm44, got44;
+    v_mat43_transpose_to_mat44(tm44, tm);
+    storage.get44(i, got44);
+    CHECK(max_abs_diff(tm44.col0, got44.col0) == 0.f && max_abs_diff(tm44.col3, got44.col3) == 0.f);
+    CHECK(max_abs_diff(tm44.col3, storage.getPos(i)) == 0.f);
+  }
+}
+
+TEST(TmStorageFallsBackToPlain)
+{
+  RiExtraTmStorage storage;
+  int seed = 42;
+  const mat43f rigid = random_tm(seed);
+  storage.set(storage.append(), rigid);
+  CHECK(storage.setQuantized(true));
+
+  mat44f skew44;
+  v_mat44_ident(skew44);
+  skew44.col1 = v_add(skew44.col1, v_mul(skew44.col0, v_splats(0.3f)));
+  mat43f skew;
+  v_mat44_transpose_to_mat43(skew, skew44);
+  storage.set(storage.append(), skew);
+
+  CHECK(!storage.isQuantized()); // switched back, non-rigid transform is kept exactly
+  CHECK(storage.fullData() != nullptr);
+  const mat43f got = storage.get(1);
+  CHECK(max_abs_diff(got.row0, skew.row0) == 0.f && max_abs_diff(got.row1, skew.row1) == 0.f &&
+        max_abs_diff(got.row2, skew.row2) == 0.f);
+  mat44f rigid44;
+  v_mat43_transpose_to_mat44(rigid44, rigid);
+  check_close(rigid, storage.get(0), v_extract_x(v_length3_x(rigid44.col0)));
+
+  CHECK(!storage.setQuantized(true)); // can't be quantized while skewed instance is alive
+  CHECK(!storage.isQuantized());
+  storage.pop_back();
+  CHECK(storage.setQuantized(true));
+}
@@ -0,0 +1,163 @@
+#include <UnitTest++/UnitTestPP.h>
+#include "../riGen/riGenData.h"
+#include "../visibility/cellVisibility.h"
+#include <math/dag_TMatrix4.h>
+#include <math/random/dag_random.h>
+#include <EASTL/vector.h>
+
+using namespace rendinst;
+
+// Single riGen layer of CELL_NUM x CELL_NUM ready cells with random subcell bounds (some subcells are empty)
+struct CellVisibilityFixture
+{
+  static constexpr int CELL_NUM = 16;
+  static constexpr int CELL_SZ = 32;
+  static constexpr int SUBCELLS = RendInstGenData::SUBCELL_DIV * RendInstGenData::SUBCELL_DIV;
+  using VisibleCellsData = RendInstGenData::VisibleCellsData;
+
+  RendInstGenData *rgl = nullptr;
+  eastl::vector<RendInstGenData::Cell> cells;
+  int seed = 54321;
+
+  CellVisibilityFixture()
+  {
+    void *mem = memalloc(sizeof(RendInstGenData), midmem);
+    memset(mem, 0, sizeof(RendInstGenData));
+    rgl = new (mem, _NEW_INPLACE) RendInstGenData;
+    cells.resize(CELL_NUM * CELL_NUM);
+    rgl->cells.init(cells.data(), cells.size());
+    rgl->cellNumW = rgl->cellNumH = CELL_NUM;
+    rgl->cellSz = CELL_SZ;
+    rgl->grid2world = 1.f;
+    rgl->world0Vxz = v_zero();
+    rgl->invGridCellSzV = v_splats(1.f / CELL_SZ);
+    rgl->lastCellXZXZ = v_splats(CELL_NUM - 0.9f);
+    rgl->rtData = new RendInstGenData::RtData(0);
+    rgl->rtData->loadedCellsBBox = IBBox2(IPoint2(0, 0), IPoint2(CELL_NUM - 1, CELL_NUM - 1));
+    for (int i = 0; i < cells.size(); ++i)
+      generateCell(i);
+  }
+  ~CellVisibilityFixture()
+  {
+    for (RendInstGenData::Cell &cell : cells)
+      del_it(cell.rtData);
+    del_it(rgl->rtData);
+    rgl->cells.init(nullptr, 0);
+    memfree(rgl, midmem); // ~RendInstGenData() releases level resources, there are none here
+  }
+
+  void generateCell(int cell_idx)
+  {
+    const int cx = cell_idx % CELL_NUM, cz = cell_idx / CELL_NUM;
+    auto *crt = new RendInstGenData::CellRtData(1, rgl->rtData);
+    crt->sysMemData = new uint8_t[1]; // cell is ready
+    clear_and_resize(crt->bbox, SUBCELLS + 1);
+    v_bbox3_init_empty(crt->bbox[0]);
+    const float subcellSz = float(CELL_SZ) / RendInstGenData::SUBCELL_DIV;
+    for (int i = 0; i < SUBCELLS; ++i)
+    {
+      bbox3f &box = crt->bbox[i + 1];
+      if (_frnd(seed) < 0.2f)
+      {
+        v_bbox3_init_empty(box);
+        continue;
+      }
+      const Point3 p0(cx * CELL_SZ + (i % RendInstGenData::SUBCELL_DIV) * subcellSz, _srnd(seed) * 10.f,
+        cz * CELL_SZ + (i / RendInstGenData::SUBCELL_DIV) * subcellSz);
+      const Point3 p1 = p0 + Point3(subcellSz, 2.f + _frnd(seed) * 30.f, subcellSz);
+      box.bmin = v_ldu(&p0.x);
+      box.bmax = v_ldu(&p1.x);
+      v_bbox3_add_box(crt->bbox[0], box);
+    }
+    cells[cell_idx].rtData = crt;
+  }
+
+  Point3 randomViewPos()
+  {
+    return Point3((0.2f + _frnd(seed) * 0.6f) * CELL_NUM * CELL_SZ, 5.f + _frnd(seed) * 20.f,
+      (0.2f + _frnd(seed) * 0.6f) * CELL_NUM * CELL_SZ);
+  }
+
+  // perspective views of random directions and ortho views (shadow cascades) of growing size around view position
+  Frustum randomFrustum(const Point3 &pos, int view)
+  {
+    if (view & 1)
+    {
+      const Point3 dir = normalize(Point3(_srnd(seed), -0.2f - _frnd(seed), _srnd(seed)));
+      TMatrix4 tm = matrix_look_at_lh(pos, pos + dir, Point3(0.f, 1.f, 0.f));
+      return Frustum(tm * matrix_perspective(1.f + _frnd(seed), 1.5f, 0.1f, 50.f + _frnd(seed) * 300.f));
+    }
+    const Point3 toSun = normalize(Point3(0.3f + _srnd(seed) * 0.2f, 1.f, 0.2f));
+    const float size = 20.f * (view + 1);
+    TMatrix4 tm = matrix_look_at_lh(pos + toSun * 200.f, pos, Point3(0.f, 0.f, 1.f));
+    return Frustum(tm * matrix_ortho_lh(size, size, 0.f, 400.f));
+  }
+
+  static void checkSameCells(const VisibleCellsData &expected, const VisibleCellsData &actual)
+  {
+    CHECK_EQUAL(expected.cells.size(), actual.cells.size());
+    if (expected.cells.size() != actual.cells.size())
+      return;
+    for (int i = 0; i < expected.cells.size(); ++i)
+    {
+      const Cell &e = expected.cells[i], &a = actual.cells[i];
+      CHECK(e.x == a.x && e.z == a.z && e.distance == a.distance);
+      CHECK_EQUAL(e.rangesCount, a.rangesCount);
+      for (int r = 0; r < min(e.rangesCount, a.rangesCount); ++r)
+      {
+        const SubCellRange &er = expected.subCellRanges[e.rangesStart + r], &ar = actual.subCellRanges[a.rangesStart + r];
+        CHECK(er.start == ar.start && er.end == ar.end);
+      }
+    }
+  }
+};
+
+TEST_FIXTURE(CellVisibilityFixture, MultiViewCellsMatchSingleViews)
+{
+  int visibleCells = 0;
+  for (int iter = 0; iter < 30; ++iter)
+  {
+    const Point3 pos = randomViewPos();
+    const int count = 1 + iter % MultiFrustum4::MAX_VIEWS;
+    Frustum frustums[MultiFrustum4::MAX_VIEWS];
+    const Frustum *frustumPtrs[MultiFrustum4::MAX_VIEWS];
+    Occlusion *occlusions[MultiFrustum4::MAX_VIEWS] = {};
+    for (int i = 0; i < count; ++i)
+    {
+      frustums[i] = randomFrustum(pos, i);
+      frustumPtrs[i] = &frustums[i];
+    }
+
+    eastl::vector<VisibleCellsData> multi(count);
+    CHECK(rgl->gatherVisibleCellsMulti(frustumPtrs, occlusions, count, pos, multi.data()));
+    for (int i = 0; i < count; ++i)
+    {
+      eastl::vector<VisibleCellsData> single(1);
+      CHECK(rgl->gatherVisibleCells(frustums[i], pos, nullptr, single[0]));
+      checkSameCells(single[0], multi[i]);
+      visibleCells += single[0].cells.size();
+    }
+  }
+  CHECK(visibleCells > 0);
+}
+
+// Cells which are not ready are skipped in all views
+TEST_FIXTURE(CellVisibilityFixture, MultiViewSkipsNotReadyCells)
+{
+  const Point3 pos = randomViewPos();
+  const int cellX = int(pos.x) / CELL_SZ, cellZ = int(pos.z) / CELL_SZ;
+  delete[] cells[cellX + cellZ * CELL_NUM].rtData->sysMemData;
+  cells[cellX + cellZ * CELL_NUM].rtData->sysMemData = nullptr;
+
+  Frustum frustums[2] = {randomFrustum(pos, 0), randomFrustum(pos, 2)};
+  const Frustum *frustumPtrs[2] = {&frustums[0], &frustums[1]};
+  Occlusion *occlusions[MultiFrustum4::MAX_VIEWS] = {};
+  eastl::vector<VisibleCellsData> multi(2);
+  CHECK(rgl->gatherVisibleCellsMulti(frustumPtrs, occlusions, 2, pos, multi.data()));
+  for (const VisibleCellsData &view : multi)
+  {
+    CHECK(view.cells.size() > 0);
+    for (const Cell &cell : view.cells)
+      CHECK(cell.x != cellX || cell.z != cellZ);
+  }
+}
@@ -112,6 +112,64 @@ struct VisibleCells
       cells.emplace_back(eastl::move(cell));
     }
   }
+
+  // Same as calcCellVisibility, but for several views in one pass: cell and subcell boxes are tested against all views at once
+  // and visible subcell ranges are appended to views[i] for each visible view. occlusions[i] (can be null) is used for views[i].
+  static inline void calcCellVisibilityMulti(VisibleCells *views, const MultiFrustum4 &frustums, Occlusion *const *occlusions,
+    int cell_x, int cell_z, vec3f view_pos, const bbox3f *__restrict bbox)
+  {
+    uint32_t insideMask = 0;
+    uint32_t visMask = frustums.testBox(bbox[CELL_BBOX_OFFSET].bmin, bbox[CELL_BBOX_OFFSET].bmax, insideMask);
+    for (uint32_t v = 0; v < MultiFrustum4::MAX_VIEWS; ++v)
+      if ((visMask & (1u << v)) &&
+          (views[v].cells.size() >= max_visible_cells ||
+            (occlusions[v] && occlusions[v]->isOccludedBox(bbox[CELL_BBOX_OFFSET].bmin, bbox[CELL_BBOX_OFFSET].bmax))))
+        visMask &= ~(1u << v);
+    if (!visMask)
+      return;
+
+    Cell cell[MultiFrustum4::MAX_VIEWS];
+    const float distance = v_extract_x(v_sqrt_x(v_distance_sq_to_bbox_x(bbox[0].bmin, bbox[0].bmax, view_pos)));
+    for (uint32_t v = 0; v < MultiFrustum4::MAX_VIEWS; ++v)
+    {
+      if (!(visMask & (1u << v)))
+        continue;
+      cell[v].distance = distance;
+      cell[v].x = cell_x;
+      cell[v].z = cell_z;
+      cell[v].rangesStart = views[v].subCellRanges.size();
+      if (insideMask & (1u << v))
+        views[v].calcInsideVisibility(cell[v], bbox, occlusions[v]);
+    }
+
+    if (const uint32_t intersectMask = visMask & ~insideMask)
+    {
+      for (uint8_t range = 0; range < subcell_div * subcell_div; ++range)
+      {
+        const auto bboxIdx = range + SUBCELL_BBOX_OFFSET;
+        uint32_t subInsideMask;
+        const uint32_t subVisMask = frustums.testBox(bbox[bboxIdx].bmin, bbox[bboxIdx].bmax, subInsideMask) & intersectMask;
+        for (uint32_t v = 0; v < MultiFrustum4::MAX_VIEWS; ++v)
+        {
+          if (!(subVisMask & (1u << v)) ||
+              (occlusions[v] && occlusions[v]->isOccludedBox(bbox[bboxIdx].bmin, bbox[bboxIdx].bmax)))
+            continue;
+          auto &ranges = views[v].subCellRanges;
+          if (!cell[v].rangesCount || ranges.back().end != range - 1)
+          {
+            ranges.emplace_back(SubCellRange{range, range});
+            cell[v].rangesCount++;
+          }
+          else
+            ranges.back().end = range;
+        }
+      }
+    }
+
+    for (uint32_t v = 0; v < MultiFrustum4::MAX_VIEWS; ++v)
+      if ((visMask & (1u << v)) && cell[v].rangesCount != 0)
+        views[v].cells.emplace_back(cell[v]);
+  }
 };
 
 } // namespace rendinst
@@ -65,3 +65,53 @@ __forceinline int test_box_planesb(vec4f bmin, vec4f bmax, const vec4f *__restri
   return !v_test_vec_x_lt_0(res);
 #endif
 }
+
+// Planes of up to 4 frustums transposed so that a box is tested against all of them at once, one view per vector lane.
+struct MultiFrustum4
+{
+  static constexpr int MAX_VIEWS = 4;
+
+  vec4f planeX[6], planeY[6], planeZ[6], planeW[6];
+  vec4f absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+  uint32_t viewsMask = 0;
+
+  void init(const Frustum *const *frustums, int count)
+  {
+    G_ASSERT(count > 0 && count <= MAX_VIEWS);
+    viewsMask = (1u << count) - 1;
+    for (int p = 0; p < 6; ++p)
+    {
+      vec4f pl[MAX_VIEWS];
+      for (int v = 0; v < MAX_VIEWS; ++v)
+        pl[v] = v < count ? frustums[v]->camPlanes[p] : v_make_vec4f(0, 0, 0, -1); // unused lane rejects everything
+      v_mat44_transpose(pl[0], pl[1], pl[2], pl[3]);
+      planeX[p] = pl[0];
+      planeY[p] = pl[1];
+      planeZ[p] = pl[2];
+      planeW[p] = pl[3];
+      absPlaneX[p] = v_abs(pl[0]);
+      absPlaneY[p] = v_abs(pl[1]);
+      absPlaneZ[p] = v_abs(pl[2]);
+    }
+  }
+
+  // returns mask of views box is visible in, views which contain box completely are also set in inside_mask
+  __forceinline uint32_t testBox(vec4f bmin, vec4f bmax, uint32_t &inside_mask) const
+  {
+    vec4f center = v_mul(v_add(bmax, bmin), V_C_HALF);
+    vec4f extent = v_mul(v_sub(bmax, bmin), V_C_HALF);
+    vec4f cx = v_splat_x(center), cy = v_splat_y(center), cz = v_splat_z(center);
+    vec4f ex = v_splat_x(extent), ey = v_splat_y(extent), ez = v_splat_z(extent);
+    vec4f outside = v_zero(), intersect = v_zero();
+    for (int p = 0; p < 6; ++p)
+    {
+      vec4f dist = v_madd(planeX[p], cx, v_madd(planeY[p], cy, v_madd(planeZ[p], cz, planeW[p])));
+      vec4f rad = v_madd(absPlaneX[p], ex, v_madd(absPlaneY[p], ey, v_mul(absPlaneZ[p], ez)));
+      outside = v_or(outside, v_add(dist, rad)); // sign bit is set if box is behind the plane
+      intersect = v_or(intersect, v_sub(dist, rad));
+    }
+    const uint32_t visible = ~uint32_t(v_signmask(outside)) & viewsMask;
+    inside_mask = ~uint32_t(v_signmask(intersect)) & visible;
+    return visible;
+  }
+};
@@ -8,6 +8,8 @@
 #include "visibility/cullingMath.h"
 
 #include <osApiWrappers/dag_cpuJobs.h>
+#include <memory/dag_framemem.h>
+#include <dag/dag_vector.h>
 
 
 RiGenVisibility *rendinst::createRIGenVisibility(IMemAlloc *mem)
@@ -82,6 +84,27 @@ bool rendinst::prepareRIGenVisibility(const Frustum &frustum, const Point3 &vpos
   return ret;
 }
 
+bool rendinst::prepareRIGenVisibilityMulti(dag::ConstSpan<Frustum> frustums, const Point3 &vpos,
+  dag::ConstSpan<RiGenVisibility *> visibilities, bool forShadow, dag::ConstSpan<Occlusion *> occlusions,
+  const rendinst::VisibilityExternalFilter &external_filter)
+{
+  if (!RendInstGenData::renderResRequired || RendInstGenData::isLoading)
+    return false;
+  G_ASSERT(frustums.size() == visibilities.size());
+  bool ret = false;
+  FOR_EACH_RG_LAYER_DO (rgl)
+  {
+    dag::Vector<RiGenVisibility *, framemem_allocator> layerVisibilities(visibilities.size());
+    for (int i = 0; i < visibilities.size(); ++i)
+      layerVisibilities[i] = visibilities[i] + _layer;
+    if (!external_filter ? rgl->prepareVisibilityMulti(frustums, vpos, layerVisibilities, forShadow, {}, occlusions)
+                         : rgl->prepareVisibilityMulti<true>(frustums, vpos, layerVisibilities, forShadow, {}, occlusions,
+                             external_filter))
+      ret = true;
+  }
+  return ret;
+}
+
 void rendinst::sortRIGenVisibility(RiGenVisibility *visibility, const Point3 &viewPos, const Point3 &viewDir, float vertivalFov,
   float horizontalFov, float areaThreshold)
 {
@@ -95,6 +118,106 @@ struct SortByY
   bool operator()(const IPoint2 &a, const IPoint2 &b) const { return a.y < b.y; }
 };
 
+template <typename Cb>
+static inline void walk_cells_spiral(int cell_num_w, int cell_num_h, int start_x, int start_z, const int *regions, const Cb &cb)
+{
+  int maxRadius = max(max((regions[3] - start_z), (start_z - regions[1])), max((regions[2] - start_x), (start_x - regions[0])));
+  if (start_x >= 0 && start_x < cell_num_w && start_z < cell_num_h && start_z >= 0)
+    cb(start_x + start_z * cell_num_w, start_x, start_z);
+
+  int minX, maxX;
+  int minZ, maxZ;
+  for (int radius = 1; radius <= maxRadius; ++radius)
+  {
+    minX = start_x - radius, maxX = start_x + radius;
+    minZ = start_z - radius, maxZ = start_z + radius;
+
+    if (minZ >= regions[1] && minZ <= regions[3])
+      for (int x = max(minX, regions[0]), cellI = minZ * cell_num_w + x; x <= min(maxX, regions[2]); x++, cellI++)
+        cb(cellI, x, minZ);
+
+    if (maxZ <= regions[3] && maxZ >= regions[1])
+      for (int x = max(minX, regions[0]), cellI = maxZ * cell_num_w + x; x <= min(maxX, regions[2]); x++, cellI++)
+        cb(cellI, x, maxZ);
+
+    if (minX >= regions[0] && minX <= regions[2])
+      for (int z = max(minZ + 1, regions[1]), cellI = z * cell_num_w + minX; z <= min(maxZ - 1, regions[3]); z++, cellI += cell_num_w)
+        cb(cellI, minX, z);
+
+    if (maxX <= regions[2] && maxX >= regions[0])
+      for (int z = max(minZ + 1, regions[1]), cellI = z * cell_num_w + maxX; z <= min(maxZ - 1, regions[3]); z++, cellI += cell_num_w)
+        cb(cellI, maxX, z);
+  }
+}
+
+void RendInstGenData::calcCellsRegion(bbox3f_cref world_bbox, int *regions) const
+{
+  vec4f worldBboxXZ = v_perm_xzac(world_bbox.bmin, world_bbox.bmax);
+  vec4f grid2worldcellSzV = v_splats(grid2world * cellSz);
+  worldBboxXZ = v_add(worldBboxXZ, v_perm_xzac(v_neg(grid2worldcellSzV), grid2worldcellSzV));
+  vec4f regionV = v_sub(worldBboxXZ, world0Vxz);
+  regionV = v_max(v_mul(regionV, invGridCellSzV), v_zero());
+  regionV = v_min(regionV, lastCellXZXZ);
+  v_sti(regions, v_cvt_floori(regionV));
+}
+
+// calls cb(cell_x, cell_z, cell_bboxes) for ready loaded cells of world_bbox region in spiral order around view position cell
+template <typename Cb>
+static bool walk_ready_cells(RendInstGenData &rgl, bbox3f_cref world_bbox, const Point3 &vpos, const Cb &cb)
+{
+  DECL_ALIGN16(int, regions[4]);
+  rgl.calcCellsRegion(world_bbox, regions);
+  rgl.rtData->loadedCellsBBox.clip(regions[0], regions[1], regions[2], regions[3]);
+
+  float grid2worldCellSz = v_extract_x(rgl.invGridCellSzV);
+  int startCellX = (int)((vpos.x - rgl.world0x()) * grid2worldCellSz);
+  int startCellZ = (int)((vpos.z - rgl.world0z()) * grid2worldCellSz);
+
+  // in not yet known circumstances, values go out of range (in release mode)
+  // trying to avoid infinite loop
+  if (startCellX == 0x80000000 || startCellZ == 0x80000000)
+  {
+    debug("prepareVisibility_overflow");
+    return false;
+  }
+
+  walk_cells_spiral(rgl.cellNumW, rgl.cellNumH, startCellX, startCellZ, regions, [&](int cell_idx, int cell_x, int cell_z) {
+    if (const auto cellRtData = rgl.cells[cell_idx].isReady())
+      cb(cell_x, cell_z, cellRtData->bbox.data());
+  });
+  return true;
+}
+
+bool RendInstGenData::gatherVisibleCells(const Frustum &frustum, const Point3 &vpos, Occlusion *use_occlusion,
+  VisibleCellsData &vis_data)
+{
+  bbox3f worldBBox;
+  frustum.calcFrustumBBox(worldBBox);
+  const vec3f viewPos = v_ldu(&vpos.x);
+  return walk_ready_cells(*this, worldBBox, vpos, [&](int cell_x, int cell_z, const bbox3f *bbox) {
+    vis_data.calcCellVisibility(cell_x, cell_z, viewPos, frustum, bbox, use_occlusion);
+  });
+}
+
+bool RendInstGenData::gatherVisibleCellsMulti(const Frustum *const *frustums, Occlusion *const *occlusions, int count,
+  const Point3 &vpos, VisibleCellsData *vis_data)
+{
+  bbox3f worldBBox;
+  v_bbox3_init_empty(worldBBox);
+  for (int i = 0; i < count; ++i)
+  {
+    bbox3f box;
+    frustums[i]->calcFrustumBBox(box);
+    v_bbox3_add_box(worldBBox, box);
+  }
+  MultiFrustum4 multiFrustum;
+  multiFrustum.init(frustums, count);
+  const vec3f viewPos = v_ldu(&vpos.x);
+  return walk_ready_cells(*this, worldBBox, vpos, [&](int cell_x, int cell_z, const bbox3f *bbox) {
+    VisibleCellsData::calcCellVisibilityMulti(vis_data, multiFrustum, occlusions, cell_x, cell_z, viewPos, bbox);
+  });
+}
+
 template <bool use_external_filter>
 bool RendInstGenData::prepareVisibility(const Frustum &frustum, const Point3 &camera_pos, RiGenVisibility &visibility, bool forShadow,
   rendinst::LayerFlags layer_flags, Occlusion *use_occlusion, bool for_visual_collision,
@@ -108,7 +231,6 @@ bool RendInstGenData::prepareVisibility(const Frustum &frustum, const Point3 &ca
   if (rendinst::ri_game_render_mode == 0)
     use_occlusion = nullptr;
   vec3f curViewPos = v_ldu(&camera_pos.x);
-  Tab<RenderRanges> &riRenderRanges = visibility.renderRanges;
   Frustum curFrustum = frustum;
   if (!forShadow)
   {
@@ -130,83 +252,28 @@ bool RendInstGenData::prepareVisibility(const Frustum &frustum, const Point3 &ca
     forcedLodDist = rad;
     forcedLodDistSq = forcedLodDist * forcedLodDist;
   }
-  bbox3f worldBBox;
-  float grid2worldcellSz = grid2world * cellSz;
-
-  curFrustum.calcFrustumBBox(worldBBox);
   if (!check_occluders)
     use_occlusion = nullptr;
 
-  vec4f worldBboxXZ = v_perm_xzac(worldBBox.bmin, worldBBox.bmax);
-  vec4f grid2worldcellSzV = v_splats(grid2worldcellSz);
-  worldBboxXZ = v_add(worldBboxXZ, v_perm_xzac(v_neg(grid2worldcellSzV), grid2worldcellSzV));
-  vec4f regionV = v_sub(worldBboxXZ, world0Vxz);
-  regionV = v_max(v_mul(regionV, invGridCellSzV), v_zero());
-  regionV = v_min(regionV, lastCellXZXZ);
-  vec4i regionI = v_cvt_floori(regionV);
-  DECL_ALIGN16(int, regions[4]);
-  v_sti(regions, regionI);
-  float grid2worldcellSzDiag = grid2worldcellSz * 1.4142f;
   visibility.subCells.clear();
   visibility.resizeRanges(rtData->riRes.size(), forShadow ? 4 : 8);
 
   ScopedLockRead lock(rtData->riRwCs);
-  rendinst::VisibleCells<RendInstGenData::MAX_VISIBLE_CELLS, RendInstGenData::SUBCELL_DIV> visData;
-
-  rtData->loadedCellsBBox.clip(regions[0], regions[1], regions[2], regions[3]);
-
-  float grid2worldCellSz = v_extract_x(invGridCellSzV);
-  int startCellX = (int)((viewPos.x - world0x()) * grid2worldCellSz);
-  int startCellZ = (int)((viewPos.z - world0z()) * grid2worldCellSz);
-
-  // in not yet known circumstances, values go out of range (in release mode)
-  // trying to avoid infinite loop
-  if (startCellX == 0x80000000 || startCellZ == 0x80000000)
-  {
-    debug("prepareVisibility_overflow");
+  VisibleCellsData visData;
+  if (!gatherVisibleCells(curFrustum, viewPos, use_occlusion, visData) || !visData.cells.size())
     return false;
-  }
-
-  unsigned int startCellI = startCellX + startCellZ * cellNumW;
-  {
-    const auto calcRiCellVisibility = [&](int cell_idx, int cell_x, int cell_z) {
-      const auto cellRtData = cells[cell_idx].isReady();
-      if (cellRtData)
-        visData.calcCellVisibility(cell_x, cell_z, curViewPos, curFrustum, cellRtData->bbox.data(), use_occlusion);
-    };
-
-    int maxRadius =
-      max(max((regions[3] - startCellZ), (startCellZ - regions[1])), max((regions[2] - startCellX), (startCellX - regions[0])));
-    if (startCellX >= 0 && startCellX < cellNumW && startCellZ < cellNumH && startCellZ >= 0)
-      calcRiCellVisibility(startCellI, startCellX, startCellZ);
-
-    int minX, maxX;
-    int minZ, maxZ;
-    for (int radius = 1; radius <= maxRadius; ++radius)
-    {
-      minX = startCellX - radius, maxX = startCellX + radius;
-      minZ = startCellZ - radius, maxZ = startCellZ + radius;
-
-      if (minZ >= regions[1] && minZ <= regions[3])
-        for (int x = max(minX, regions[0]), cellI = minZ * cellNumW + x; x <= min(maxX, regions[2]); x++, cellI++)
-          calcRiCellVisibility(cellI, x, minZ);
-
-      if (maxZ <= regions[3] && maxZ >= regions[1])
-        for (int x = max(minX, regions[0]), cellI = maxZ * cellNumW + x; x <= min(maxX, regions[2]); x++, cellI++)
-          calcRiCellVisibility(cellI, x, maxZ);
-
-      if (minX >= regions[0] && minX <= regions[2])
-        for (int z = max(minZ + 1, regions[1]), cellI = z * cellNumW + minX; z <= min(maxZ - 1, regions[3]); z++, cellI += cellNumW)
-          calcRiCellVisibility(cellI, minX, z);
+  return fillVisibility<use_external_filter>(visData, frustum, curViewPos, forcedLodDist, forcedLodDistSq, visibility, forShadow,
+    layer_flags, use_occlusion, for_visual_collision, external_filter);
+}
 
-      if (maxX <= regions[2] && maxX >= regions[0])
-        for (int z = max(minZ + 1, regions[1]), cellI = z * cellNumW + maxX; z <= min(maxZ - 1, regions[3]); z++, cellI += cellNumW)
-          calcRiCellVisibility(cellI, maxX, z);
-    }
-  }
-#undef PREPARE_CELL
-  if (!visData.cells.size())
-    return false;
+template <bool use_external_filter>
+bool RendInstGenData::fillVisibility(const VisibleCellsData &visData, const Frustum &frustum, vec3f curViewPos, float forcedLodDist,
+  float forcedLodDistSq, RiGenVisibility &visibility, bool forShadow, rendinst::LayerFlags layer_flags, Occlusion *use_occlusion,
+  bool for_visual_collision, const rendinst::VisibilityExternalFilter &external_filter)
+{
+  const float grid2worldcellSz = grid2world * cellSz;
+  const float grid2worldcellSzDiag = grid2worldcellSz * 1.4142f;
+  Tab<RenderRanges> &riRenderRanges = visibility.renderRanges;
   mem_set_0(visibility.instNumberCounter);
   float subCellOfsSize = grid2worldcellSz * ((rendinst::render::per_instance_visibility_for_everyone ? 0.75f : 0.25f) *
                                               (rendinst::render::globalDistMul * 1.f / RendInstGenData::SUBCELL_DIV));
@@ -613,3 +680,69 @@ template bool RendInstGenData::prepareVisibility<true>(const Frustum &, const Po
   Occlusion *, bool, const rendinst::VisibilityExternalFilter &);
 template bool RendInstGenData::prepareVisibility<false>(const Frustum &, const Point3 &, RiGenVisibility &, bool, rendinst::LayerFlags,
   Occlusion *, bool, const rendinst::VisibilityExternalFilter &);
+
+template <bool use_external_filter>
+bool RendInstGenData::prepareVisibilityMulti(dag::ConstSpan<Frustum> frustums, const Point3 &camera_pos,
+  dag::ConstSpan<RiGenVisibility *> visibilities, bool forShadow, rendinst::LayerFlags layer_flags,
+  dag::ConstSpan<Occlusion *> occlusions, const rendinst::VisibilityExternalFilter &external_filter)
+{
+  TIME_D3D_PROFILE(prepare_ri_visibility_multi);
+  G_ASSERT(frustums.size() == visibilities.size());
+  G_ASSERT(occlusions.empty() || occlusions.size() == frustums.size());
+  const bool useOcclusion = rendinst::ri_game_render_mode != 0 && check_occluders;
+  bool ret = false;
+  const vec3f curViewPos = v_ldu(&camera_pos.x);
+  const float maxRIDist = rtData->get_trees_last_range(rtData->rendinstFarPlane);
+
+  for (int groupStart = 0; groupStart < frustums.size(); groupStart += MultiFrustum4::MAX_VIEWS)
+  {
+    Frustum curFrustums[MultiFrustum4::MAX_VIEWS];
+    const Frustum *curFrustumPtrs[MultiFrustum4::MAX_VIEWS];
+    Occlusion *curOcclusions[MultiFrustum4::MAX_VIEWS] = {};
+    int groupViews[MultiFrustum4::MAX_VIEWS];
+    int count = 0;
+    for (int i = groupStart, e = min<int>(groupStart + MultiFrustum4::MAX_VIEWS, frustums.size()); i < e; ++i)
+    {
+      RiGenVisibility &visibility = *visibilities[i];
+      Occlusion *occlusion = occlusions.empty() ? nullptr : occlusions[i];
+      // forced lod views use frustum center as view position, so they can't share cell distances with the rest
+      if (visibility.forcedLod >= 0)
+      {
+        if (prepareVisibility<use_external_filter>(frustums[i], camera_pos, visibility, forShadow, layer_flags, occlusion, false,
+              external_filter))
+          ret = true;
+        continue;
+      }
+      visibility.vismask = 0;
+      visibility.subCells.clear();
+      visibility.resizeRanges(rtData->riRes.size(), forShadow ? 4 : 8);
+      Frustum &curFrustum = curFrustums[count];
+      curFrustum = frustums[i];
+      if (!forShadow)
+        shrink_frustum_zfar(curFrustum, curViewPos, v_splats(maxRIDist));
+      curFrustumPtrs[count] = &curFrustum;
+      curOcclusions[count] = useOcclusion ? occlusion : nullptr;
+      groupViews[count++] = i;
+    }
+    if (!count)
+      continue;
+
+    ScopedLockRead lock(rtData->riRwCs);
+    dag::Vector<VisibleCellsData, framemem_allocator> visData(count); // too big for stack
+    if (!gatherVisibleCellsMulti(curFrustumPtrs, curOcclusions, count, camera_pos, visData.data()))
+      return ret;
+    for (int i = 0; i < count; ++i)
+      if (visData[i].cells.size() &&
+          fillVisibility<use_external_filter>(visData[i], frustums[groupViews[i]], curViewPos, 0.f, 0.f,
+            *visibilities[groupViews[i]], forShadow, layer_flags, curOcclusions[i], false, external_filter))
+        ret = true;
+  }
+  return ret;
+}
+
+template bool RendInstGenData::prepareVisibilityMulti<true>(dag::ConstSpan<Frustum>, const Point3 &,
+  dag::ConstSpan<RiGenVisibility *>, bool, rendinst::LayerFlags, dag::ConstSpan<Occlusion *>,
+  const rendinst::VisibilityExternalFilter &);
+template bool RendInstGenData::prepareVisibilityMulti<false>(dag::ConstSpan<Frustum>, const Point3 &,
+  dag::ConstSpan<RiGenVisibility *>, bool, rendinst::LayerFlags, dag::ConstSpan<Occlusion *>,
+  const rendinst::VisibilityExternalFilter &);
@@ -35,7 +35,16 @@ GLOBAL_VARS_LIST
 #undef VAR
 
 extern const CollisionResource *lru_collision_get_collres(uint32_t i);
-extern mat43f lru_collision_get_transform(rendinst::riex_handle_t h);
+namespace rendinst
+{
+struct RiexSnapshot;
+}
+// batch transforms are read from one riExtra snapshot (enabled while collision is used), so they are consistent and read without
+// riExtra lock
+extern void lru_collision_use_transforms_snapshot(bool on);
+extern const rendinst::RiexSnapshot *lru_collision_pin_transforms();
+extern void lru_collision_unpin_transforms(const rendinst::RiexSnapshot *snapshot);
+extern bool lru_collision_get_transform(const rendinst::RiexSnapshot *snapshot, rendinst::riex_handle_t h, mat43f &tm);
 extern uint32_t lru_collision_get_type(rendinst::riex_handle_t h);
 
 uint32_t LRURendinstCollision::getMaxBatchSize() const { return MAX_VOXELIZATION_INSTANCES; }
@@ -79,10 +88,12 @@ LRURendinstCollision::LRURendinstCollision() :
       "collision_voxelization_indirect");
     debug("%s support multi draw indirect", __FUNCTION__);
   }
+  lru_collision_use_transforms_snapshot(true);
 }
 
 LRURendinstCollision::~LRURendinstCollision()
 {
+  lru_collision_use_transforms_snapshot(false);
   if (multiDrawBuf && voxelizeCollisionElem)
     d3d::delete_vdecl(voxelizeCollisionElem->getEffectiveVDecl());
 }
@@ -427,6 +438,7 @@ void LRURendinstCollision::batchInstances(const rendinst::riex_handle_t *begin,
       auto batchEnd = begin + handlesBatchSize;
       uint32_t prevType = ~0u;
       uint32_t addedInstances = 0;
+      const rendinst::RiexSnapshot *snapshot = lru_collision_pin_transforms();
       for (; begin < batchEnd; ++begin)
       {
         const rendinst::riex_handle_t h = *begin;
@@ -434,19 +446,20 @@ void LRURendinstCollision::batchInstances(const rendinst::riex_handle_t *begin,
         if (riToLRUmap.size() <= type)
           continue;
         const LRUEntry &lruEntry = riToLRUmap[type];
-        if (!lruEntry.vb || !lruEntry.ib)
+        mat43f tm;
+        if (!lruEntry.vb || !lruEntry.ib || !lru_collision_get_transform(snapshot, h, tm))
           continue;
         if (type != prevType)
         {
           instanceTypesCounts.push_back(prevType = type);
           instanceTypesCounts.push_back(0);
         }
-        mat43f tm = lru_collision_get_transform(h);
         memcpy(dataPtr, &tm, sizeof(tm));
         dataPtr += sizeof(mat43f) / sizeof(vec4f);
         addedInstances++;
         instanceTypesCounts.back()++;
       }
+      lru_collision_unpin_transforms(snapshot);
       return addedInstances;
     };
     const uint32_t offsetBytes = startInstance * sizeof(mat43f);
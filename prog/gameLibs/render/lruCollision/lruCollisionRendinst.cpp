@@ -3,5 +3,31 @@
 
 
 const CollisionResource *lru_collision_get_collres(uint32_t i) { return rendinst::getRIGenExtraCollRes(i); }
-mat43f lru_collision_get_transform(rendinst::riex_handle_t h) { return rendinst::getRIGenExtra43(h); }
+static int snapshot_users = 0;
+void lru_collision_use_transforms_snapshot(bool on)
+{
+  if (on ? snapshot_users++ == 0 : --snapshot_users == 0)
+    rendinst::riex_enable_snapshot(on);
+}
+const rendinst::RiexSnapshot *lru_collision_pin_transforms()
+{
+  const rendinst::RiexSnapshot *snapshot = rendinst::riex_snapshot_acquire();
+  if (!snapshot) // disabled externally, live data is read under lock then
+    rendinst::riex_lock_read();
+  return snapshot;
+}
+void lru_collision_unpin_transforms(const rendinst::RiexSnapshot *snapshot)
+{
+  if (snapshot)
+    rendinst::riex_snapshot_release(snapshot);
+  else
+    rendinst::riex_unlock_read();
+}
+bool lru_collision_get_transform(const rendinst::RiexSnapshot *snapshot, rendinst::riex_handle_t h, mat43f &tm)
+{
+  if (snapshot) // instances which are dead or were added after publish are skipped till next one
+    return rendinst::riex_snapshot_get_tm(snapshot, h, tm);
+  tm = rendinst::getRIGenExtra43(h);
+  return rendinst::riex_is_instance_valid(tm);
+}
 uint32_t lru_collision_get_type(rendinst::riex_handle_t h) { return rendinst::handle_to_ri_type(h); }
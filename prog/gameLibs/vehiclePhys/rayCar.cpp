@@ -9,6 +9,8 @@
 #include <generic/dag_tabSort.h>
 #include <debug/dag_debug.h>
 #include <osApiWrappers/dag_direct.h>
+#include <memory/dag_framemem.h>
+#include <perfMon/dag_statDrv.h>
 
 #ifndef NO_3D_GFX
 #include <debug/dag_debug3d.h>
@@ -2022,6 +2024,22 @@ void RayCar::setWheelParamsPreset(const char *front_tyre, const char *rear_tyre)
 
 const char *RayCar::getWheelParamsPreset(bool front) { return front ? frontWheelPreset : rearWheelPreset; }
 
+void RayCar::trace_wheels_batch(dag::ConstSpan<IPhysCar *> cars)
+{
+  TIME_PROFILE(trace_car_wheels_batch);
+  Tab<IPhysVehicle *> vehicles(framemem_ptr());
+  vehicles.reserve(cars.size());
+  for (IPhysCar *c : cars)
+  {
+    RayCar *car = static_cast<RayCar *>(c);
+    if (car->vehicle && car->carPhysMode == CPM_ACTIVE_PHYS && car->getPhysBody()->isActive())
+      vehicles.push_back(car->vehicle);
+  }
+  IPhysVehicle::bulletTraceWheelsBatch(vehicles);
+}
+
+void trace_raywheel_cars_wheels_batch(dag::ConstSpan<IPhysCar *> cars) { RayCar::trace_wheels_batch(cars); }
+
 bool RayCar::traceRay(const Point3 &p, const Point3 &dir, float &mint, Point3 *normal, int &pmid)
 {
   if (!getPhysBody())
@@ -143,6 +143,8 @@ public:
 
   virtual bool traceRay(const Point3 &p, const Point3 &dir, float &mint, Point3 *normal, int &pmid);
 
+  static void trace_wheels_batch(dag::ConstSpan<IPhysCar *> cars);
+
   //--------------------------------------------------------
   // settings
   virtual void addImpulse(const Point3 &point, const Point3 &force_x_dt, IPhysCar *from = NULL);
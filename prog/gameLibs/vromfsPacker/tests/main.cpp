@@ -0,0 +1,5 @@
+#include <osApiWrappers/dag_basePath.h>
+
+// test data files are created relative to current dir
+#define CUSTOM_UNITTEST_CODE dd_add_base_path("");
+#include <unittest/main.inc.cpp>
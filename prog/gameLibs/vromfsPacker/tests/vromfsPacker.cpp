@@ -0,0 +1,94 @@
+#include <UnitTest++/UnitTestPP.h>
+#include <ioSys/dag_dataBlock.h>
+#include <ioSys/dag_fileIo.h>
+#include <osApiWrappers/dag_direct.h>
+#include <osApiWrappers/dag_files.h>
+#include <math/random/dag_random.h>
+#include <perfMon/dag_cpuFreq.h>
+#include <generic/dag_span.h>
+#include <generic/dag_tab.h>
+#include <util/dag_string.h>
+#include <vromfsPacker/vromfsPacker.h>
+
+static const char *TEST_ROOT = "vromfsPackerTests";
+
+// Source folder with BLKs of random params and sub-blocks, packed to vrom with shared namemap (BLKs are compressed one by one)
+struct VromfsPackerFixture
+{
+  static constexpr int BLK_COUNT = 32;
+
+  int seed = 1357;
+
+  VromfsPackerFixture()
+  {
+    for (int i = 0; i < BLK_COUNT; ++i)
+    {
+      DataBlock blk;
+      for (int b = 0, bcnt = 1 + _rnd(seed) % 8; b < bcnt; ++b)
+      {
+        DataBlock *sub = blk.addNewBlock(String(0, "block%d", _rnd(seed) % 16));
+        for (int p = 0, pcnt = 4 + _rnd(seed) % 32; p < pcnt; ++p)
+          if (_rnd(seed) & 1)
+            sub->addReal(String(0, "param%d", _rnd(seed) % 64), _frnd(seed) * 100.f);
+          else
+            sub->addStr(String(0, "name%d", _rnd(seed) % 64), String(0, "value_%d_%d", i, _rnd(seed) % 256));
+      }
+      String fn(0, "%s/src/file%02d.blk", TEST_ROOT, i);
+      dd_mkpath(fn);
+      CHECK(blk.saveToTextFile(fn));
+    }
+  }
+
+  ~VromfsPackerFixture()
+  {
+    for (int i = 0; i < BLK_COUNT; ++i)
+      dd_erase(String(0, "%s/src/file%02d.blk", TEST_ROOT, i));
+    dd_erase(String(0, "%s/out/data.vromfs.bin", TEST_ROOT));
+    dd_erase(String(0, "%s/nm/data.vromfs.bin-shared_nm.bin", TEST_ROOT));
+  }
+
+  // builds the same vrom (and shared namemap, which is created by first build and reused by next ones) and returns its content
+  static Tab<char> build(int jobs, const char *cache_dir = nullptr)
+  {
+    DataBlock rules;
+    rules.setBool("blkUseSharedNamemap", true);
+    rules.setStr("blkSharedNamemapLocation", String(0, "%s/nm", TEST_ROOT));
+    rules.setBool("allowMkDir", true);
+    String src(0, "-B:%s/src", TEST_ROOT), out(0, "-out:%s/out/data.vromfs.bin", TEST_ROOT), jobs_opt(0, "-jobs:%d", jobs);
+    String cache_opt(0, "-blkComprCacheDir:%s", cache_dir);
+    const char *argv[] = {"vromfsPacker", src, out, "-packBlk+", jobs_opt, cache_opt};
+    CHECK_EQUAL(0, buildVromfs(&rules, make_span_const(argv, cache_dir ? countof(argv) : countof(argv) - 1)));
+
+    Tab<char> data;
+    FullFileLoadCB crd(out.str() + 5);
+    if (crd.fileHandle)
+    {
+      data.resize(df_length(crd.fileHandle));
+      crd.readTabData(data);
+    }
+    return data;
+  }
+};
+
+TEST_FIXTURE(VromfsPackerFixture, ParallelPackingMatchesSequential)
+{
+  build(1);
+  const Tab<char> sequential = build(1);
+  const Tab<char> parallel = build(4);
+  CHECK(!sequential.empty());
+  CHECK(sequential.size() == parallel.size() && memcmp(sequential.data(), parallel.data(), sequential.size()) == 0);
+}
+
+// Compressed BLKs taken from cache give the same vrom as packed ones, both for cold and warm cache
+TEST_FIXTURE(VromfsPackerFixture, CachedPackingMatchesSequential)
+{
+  build(1);
+  const Tab<char> sequential = build(1);
+  String cache_dir(0, "%s/cache-%llx", TEST_ROOT, (unsigned long long)ref_time_ticks()); // new (cold) cache for each run
+  for (int jobs : {4, 4, 1})
+  {
+    const Tab<char> cached = build(jobs, cache_dir);
+    CHECK(sequential.size() == cached.size() && memcmp(sequential.data(), cached.data(), sequential.size()) == 0);
+  }
+  CHECK(dd_dir_exist(cache_dir));
+}
@@ -14,10 +14,17 @@
 #include <osApiWrappers/dag_vromfs.h>
 #include <osApiWrappers/dag_basePath.h>
 #include <math/integer/dag_IPoint2.h>
+#include <math/dag_adjpow2.h>
 #include <util/dag_roNameMap.h>
 #include <util/dag_fastIntList.h>
 #include <util/dag_strUtil.h>
 #include <util/dag_base32.h>
+#include <util/dag_threadPool.h>
+#include <util/dag_parallelForInline.h>
+#include <osApiWrappers/dag_cpuJobs.h>
+#include <osApiWrappers/dag_miscApi.h>
+#include <osApiWrappers/dag_atomic.h>
+#include <perfMon/dag_perfTimer.h>
 #include <debug/dag_debug.h>
 #include <stdio.h>
 #include <stddef.h> // offsetof
@@ -47,6 +54,7 @@
 #define MD5_FINAL(ctx_, out_) MD5_Final(out_, ctx_)
 #endif
 #include <hash/BLAKE3/blake3.h>
+#include <arc/zstd-1.4.5/zstd.h>
 
 namespace dblk
 {
@@ -68,6 +76,7 @@ static unsigned write_version = 0;
 static const char *version_legacy_fn = "version";
 OAHashNameMap<true> preproc_defines;
 static const char *export_data_for_dict_dir = nullptr;
+static int pack_jobs_count = 0; // 0 means number of physical cores
 
 static unsigned get_target_code(const char *targetStr)
 {
@@ -381,6 +390,60 @@ namespace dblk
 extern bool add_name_to_name_map(DBNameMap &nm, const char *s);
 }
 
+// BLK packed with shared namemap (zstd clev=18, optionally with dictionary) depends only on its unpacked dump, dictionary and
+// zstd library version, so compressed data is stored in content-addressed cache (when cache_dir is set) and reused by
+// subsequent builds; cache key includes ZSTD_versionNumber() since other zstd version may compress the same data differently;
+// returns true when data was taken from cache
+static bool pack_blk_with_shared_namemap(const DataBlock &blk, const DBNameMap *shared_nm, const ZSTD_CDict_s *cdict,
+  const uint8_t *dict_digest, const char *cache_dir, DynamicMemGeneralSaveCB &dest)
+{
+  if (!cache_dir || !*cache_dir)
+  {
+    blk.saveBinDumpWithSharedNamemap(dest, shared_nm, true, cdict);
+    return false;
+  }
+
+  static const char CACHE_KEY_VER[] = "blk-snm-zstd18-v1";
+  const unsigned zstd_ver = ZSTD_versionNumber();
+  DynamicMemGeneralSaveCB unpacked(tmpmem, 64 << 10);
+  blk.saveBinDumpWithSharedNamemap(unpacked, shared_nm, false);
+
+  uint8_t key[BLAKE3_OUT_LEN];
+  blake3_hasher hasher;
+  blake3_hasher_init(&hasher);
+  blake3_hasher_update(&hasher, CACHE_KEY_VER, sizeof(CACHE_KEY_VER));
+  blake3_hasher_update(&hasher, &zstd_ver, sizeof(zstd_ver));
+  blake3_hasher_update(&hasher, dict_digest, BLAKE3_OUT_LEN);
+  blake3_hasher_update(&hasher, unpacked.data(), unpacked.size());
+  blake3_hasher_finalize(&hasher, key, BLAKE3_OUT_LEN);
+
+  String key_str, cache_fn;
+  data_to_str_hex(key_str, key, BLAKE3_OUT_LEN);
+  cache_fn.printf(0, "%s/%.2s/%s.bin", cache_dir, key_str.str(), key_str.str());
+  if (file_ptr_t fp = df_open(cache_fn, DF_READ | DF_IGNORE_MISSING))
+  {
+    copy_file_to_stream(fp, dest);
+    df_close(fp);
+    return true;
+  }
+
+  blk.saveBinDumpWithSharedNamemap(dest, shared_nm, true, cdict);
+
+  // write to unique temp file and rename, so concurrent builds sharing the cache never see partially written entry
+  String tmp_fn(0, "%s.%llx-%llx.tmp", cache_fn.str(), (unsigned long long)get_current_thread_id(),
+    (unsigned long long)ref_time_ticks());
+  dd_mkpath(tmp_fn);
+  {
+    FullFileSaveCB cwr(tmp_fn);
+    if (!cwr.fileHandle)
+      return false;
+    cwr.write(dest.data(), dest.size());
+  }
+  if (!dd_rename(tmp_fn, cache_fn))
+    dd_erase(tmp_fn);
+  return false;
+}
+
 bool buildVromfsDump(const char *fname, unsigned targetCode, FastNameMapEx &files, Tab<String> &dst_files,
   OAHashNameMap<true> &parse_ext, bool zpack, const DataBlock &inp, bool content_sha1, const char *alt_outdir)
 {
@@ -630,6 +693,7 @@ bool buildVromfsDump(const char *fname, unsigned targetCode, FastNameMapEx &file
     }
   }
 
+  const char *blk_compr_cache_dir = READ_PROP(Str, "blkComprCacheDir", nullptr);
   FullFileSaveCB cwr_data_for_dict;
   if (export_data_for_dict_dir)
   {
@@ -649,6 +713,35 @@ bool buildVromfsDump(const char *fname, unsigned targetCode, FastNameMapEx &file
   }
 #undef READ_PROP
 
+  // pack BLKs with shared namemap in parallel; results are written in the same (sorted) order below, so output is identical
+  // to sequential build regardless of jobs count
+  Tab<DynamicMemGeneralSaveCB *> packed_blk;
+  int packed_blk_cache_hits = 0;
+  if (shared_nm && !export_data_for_dict_dir)
+  {
+    packed_blk.resize(files.nameCount());
+    mem_set_0(packed_blk);
+    for (int id = 0; id < files.nameCount(); id++)
+      if (preloaded_blk[id])
+        packed_blk[id] = new DynamicMemGeneralSaveCB(tmpmem, 0, 16 << 10);
+
+    if (!cpujobs::is_inited())
+      cpujobs::init();
+    int jobs = pack_jobs_count > 0 ? pack_jobs_count : cpujobs::get_physical_core_count();
+    jobs = min(jobs, blk2_packed_count);
+    if (jobs > 1)
+      threadpool::init(jobs - 1, get_bigger_pow2(files.nameCount()), 256 << 10);
+    threadpool::parallel_for_inline(0, files.nameCount(), 1, [&](uint32_t begin, uint32_t end, uint32_t) {
+      for (uint32_t id = begin; id < end; id++)
+        if (preloaded_blk[id])
+          if (pack_blk_with_shared_namemap(*preloaded_blk[id], shared_nm, zstd_cdict, zstd_dict_blake3_digest, blk_compr_cache_dir,
+                *packed_blk[id]))
+            interlocked_increment(packed_blk_cache_hits);
+    });
+    if (jobs > 1)
+      threadpool::shutdown();
+  }
+
   cwr.align16();
   data_ofs.resize(files.nameCount());
   int mi = 0;
@@ -683,7 +776,7 @@ bool buildVromfsDump(const char *fname, unsigned targetCode, FastNameMapEx &file
     {
       G_ASSERT(shared_nm);
       if (!export_data_for_dict_dir)
-        preloaded_blk[id]->saveBinDumpWithSharedNamemap(*file_data_cwr, shared_nm, true, zstd_cdict);
+        file_data_cwr->write(packed_blk[id]->data(), packed_blk[id]->size());
       else
       {
         cwr_data_for_dict.beginBlock();
@@ -794,6 +887,7 @@ bool buildVromfsDump(const char *fname, unsigned targetCode, FastNameMapEx &file
     mi++;
   }
   clear_all_ptr_items(preloaded_blk);
+  clear_all_ptr_items(packed_blk);
   if (shared_nm)
     dblk::destroy_db_names(shared_nm);
   zstd_destroy_cdict(zstd_cdict);
@@ -912,6 +1006,8 @@ bool buildVromfsDump(const char *fname, unsigned targetCode, FastNameMapEx &file
   if (!shared_namemap_fn.empty())
     printf(", used sharedNameMap (%dK, %d names) for %d BLKs, clev=%d", shared_nm_sz >> 10, shared_nm_nm, blk2_packed_count,
       ZSTD_BLK_CLEVEL);
+  if (packed_blk_cache_hits)
+    printf(", %d BLKs taken from compr. cache", packed_blk_cache_hits);
 
   printf(" [for %.3f sec]\n", (get_time_msec() - reft) / 1e3f);
   fcwr.close();
@@ -1364,6 +1460,8 @@ static void print_usage()
     "  -forceLegacyFormat                use legacy VROMFS format even when -writeVersion is specified\n"
     "  -exportDataForDict:<dest_dir>     export data for compr. dict. instead of building vromfs\n"
     "  -blkSharedNamemapLocation:<dir>   override blkSharedNamemapLocation:t option of build.blk\n"
+    "  -blkComprCacheDir:<dir>           override blkComprCacheDir:t option of build.blk\n"
+    "  -jobs:<N>                         number of threads to pack BLKs with shared namemap, def: physical cores count\n"
     "  -makeDict:<dest_file>:<data_dir>  build compr. dict. from data files instead of building vromfs\n"
     "additional options for -B case:\n"
     "  -dest_path:<path>       set dest root path for files in vrom (-dest_path:* uses name of src_folder)\n"
@@ -1386,6 +1484,7 @@ static void print_usage()
     "  //blkShareStrParams:b=      // [optional] adds value of str params to shared namemap (when it is used), def=false\n"
     "  //blkUseComprDict:t=        // [optional] use compression dictionary to pack all BLKs in vrom (BLK will be saved compressed)\n"
     "  //embedComprDictToVrom:b=   // [optional] add compression dictionary to vrom as <BLAKE3-hash>.dict named file, def=false\n"
+    "  //blkComprCacheDir:t=       // [optional] cache dir for packed BLKs with shared namemap (reused when BLK content is unchanged)\n"
     "  output:t=\"game.vromfs.bin\"  // filename to build vromfs to\n"
     "  output_[CODE]:t=\"pc/game.vromfs.bin\" // per-CODE filename to build vromfs to\n"
     "  //sign_private_key:t=\"private.pem\"   // [optional] sign contents of vromfs with PEM private key\n"
@@ -1798,6 +1897,10 @@ int buildVromfs(DataBlock *explicit_build_rules, dag::ConstSpan<const char *> ar
         ; // skip
       else if (strnicmp("-blkSharedNamemapLocation:", argv[i], 26) == 0)
         inp.setStr("blkSharedNamemapLocation", argv[i] + 26);
+      else if (strnicmp("-blkComprCacheDir:", argv[i], 18) == 0)
+        inp.setStr("blkComprCacheDir", argv[i] + 18);
+      else if (strnicmp("-jobs:", argv[i], 6) == 0)
+        pack_jobs_count = atoi(argv[i] + 6);
       else if (strnicmp("-addpath:", argv[i], 9) == 0)
         ; // skip
       else if (strnicmp("-config:", argv[i], 8) == 0)
@@ -0,0 +1,45 @@
+from "%darg/ui_imports.nut" import *
+import "eventbus"
+
+let {get_time_msec} = require("dagor.time")
+
+// Compares delivery of big payload to several subscribers: regular send deep copies it for each handler,
+// shared send makes one frozen copy for all handlers. Payload is copied on send, so time is measured the same way
+// whether handlers are called immediately or queued.
+const handlersNum = 8
+const itemsNum = 1000
+const sendsNum = 200
+
+for (local i = 0; i < handlersNum; ++i)
+  eventbus.eventbus_subscribe("bench.payload", @(_msg) null)
+
+function makePayload() {
+  let items = array(itemsNum).map(@(_, i) { id = i, name = $"item_{i}", tags = [i, i * 2, i * 3] })
+  return { items, total = itemsNum }
+}
+
+function measure(send, payload) {
+  local handled = 0
+  let t0 = get_time_msec()
+  for (local i = 0; i < sendsNum; ++i)
+    handled += send("bench.payload", payload)
+  return { msec = get_time_msec() - t0, handled }
+}
+
+let copied = measure(eventbus.eventbus_send, makePayload())
+let shared = measure(eventbus.eventbus_send_shared, makePayload())
+let results = [
+  $"{sendsNum} sends x {handlersNum} handlers, {itemsNum} items"
+  $"regular send: {copied.msec} ms ({copied.handled} handler calls)"
+  $"shared send: {shared.msec} ms ({shared.handled} handler calls)"
+]
+results.each(@(r) dlog(r))
+
+return {
+  size = flex()
+  flow = FLOW_VERTICAL
+  halign = ALIGN_CENTER
+  valign = ALIGN_CENTER
+  gap = hdpx(10)
+  children = results.map(@(text) { rendObj = ROBJ_TEXT, text })
+}
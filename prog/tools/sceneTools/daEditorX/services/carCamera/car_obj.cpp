@@ -161,6 +161,8 @@ void VehicleViewer::actObjects(float dt)
     driver->update(car, dt);
     car->updateBeforeSimulate(dt);
     carphyssimulator::simulate(dt);
+    if (physType == carphyssimulator::PHYS_BULLET)
+      trace_raywheel_cars_wheels_batch(make_span_const(&car, 1));
     car->updateAfterSimulate(dt, simulationTime);
 
     if (physType == carphyssimulator::PHYS_BULLET)
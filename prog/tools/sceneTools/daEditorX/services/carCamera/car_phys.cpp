@@ -17,6 +17,7 @@
 #include <math/dag_capsule.h>
 #include <math/dag_rayIntersectBox.h>
 #include <phys/dag_physResource.h>
+#include <phys/dag_vehicle.h>
 
 #include "../Clipping/clippingPlugin.h"
 #include "../Clipping/clippingCm.h"
@@ -42,6 +43,7 @@ extern void phys_bullet_add_impulse(int body_ind, const Point3 &pos, const Point
   real dt);
 extern bool phys_bullet_load_collision(IGenLoad &crd);
 extern void phys_bullet_install_tracer(bool (*traceray)(const Point3 &p, const Point3 &d, float &mt, Point3 &out_n, int &out_pmid));
+extern void phys_bullet_install_multi_tracer(void (*trace_multiray)(dag::Span<IPhysVehicle::WheelRay> rays));
 
 
 static bool needSimulate = false;
@@ -54,6 +56,11 @@ static inline bool phys_traceray_normal(const Point3 &p, const Point3 &dir, real
 {
   return phys_frt.traceray(p, dir, t, pmid, n);
 }
+static void phys_trace_wheels_multiray(dag::Span<IPhysVehicle::WheelRay> rays)
+{
+  for (IPhysVehicle::WheelRay &r : rays)
+    r.hit = phys_frt.tracerayNormalized(r.pos, r.dir, r.t, r.pmid, r.norm);
+}
 
 
 namespace carphyssimulator
@@ -166,6 +173,7 @@ bool setCollisionsToWorld(mkbindump::BinDumpSaveCB &cwr)
         if (id == -1)
           break;
         phys_bullet_install_tracer(&phys_traceray_normal);
+        phys_bullet_install_multi_tracer(&phys_trace_wheels_multiray);
       }
       break;
 
@@ -263,6 +271,7 @@ void end()
   needSimulate = false;
 
   phys_bullet_install_tracer(nullptr);
+  phys_bullet_install_multi_tracer(nullptr);
   phys_frt.delAllRtDumps();
   phys_bullet_close();
 }
@@ -37,3 +37,7 @@ void phys_bullet_install_tracer(bool (*traceray)(const Point3 &p, const Point3 &
 {
   IPhysVehicle::bulletSetStaticTracer(traceray);
 }
+void phys_bullet_install_multi_tracer(void (*trace_multiray)(dag::Span<IPhysVehicle::WheelRay> rays))
+{
+  IPhysVehicle::bulletSetStaticMultiTracer(trace_multiray);
+}
@@ -26,6 +26,7 @@
 #include <3d/dag_textureIDHolder.h>
 #include <rendInst/rendInstGenRtTools.h>
 #include <rendInst/debugCollisionVisualization.h>
+#include <rendInst/rendInstGenRender.h>
 #include <math/dag_cube_matrix.h>
 #include <math/dag_TMatrix4more.h>
 #include <math/dag_mathAng.h>
@@ -970,6 +971,7 @@ public:
     if (renderShadow)
     {
       deferredCsm->renderShadowsCascades();
+      rendinst::render::clearPreparedRIGenShadowViews();
       prepareVSM();
     }
 
@@ -1134,6 +1136,17 @@ public:
 #endif
   }
   virtual void getCascadeShadowAnchorPoint(float cascade_from, Point3 &out_anchor) { out_anchor = -::grs_cur_view.itm.getcol(3); }
+  virtual void prepareRenderShadowCascades()
+  {
+    // riGen of all cascades is culled in one pass, riMgr service renders prepared visibility for each cascade
+    if (!renderShadow)
+      return;
+    carray<mat44f, CascadeShadows::MAX_CASCADES> globtms;
+    const int cascades = deferredCsm->getNumCascadesToRender();
+    for (int i = 0; i < cascades; ++i)
+      v_mat44_make_from_44cu(globtms[i], &deferredCsm->getWorldRenderMatrix(i)._11);
+    rendinst::render::prepareRIGenShadowViews(make_span_const(globtms.data(), cascades), ::grs_cur_view.pos);
+  }
   virtual void renderCascadeShadowDepth(int cascade_no, const Point2 &znzf)
   {
     d3d::settm(TM_VIEW, TMatrix::IDENT);
@@ -1683,7 +1696,10 @@ public:
     rendinst::set_global_shadows_needed(renderShadow);
     if (!renderShadow)
       if (rtype == RTYPE_DYNAMIC_DEFERRED)
+      {
         deferredCsm->renderShadowsCascades();
+        rendinst::render::clearPreparedRIGenShadowViews();
+      }
     updateVsm();
   }
 